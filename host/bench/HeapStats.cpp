@@ -0,0 +1,75 @@
+#include "HeapStats.h"
+
+#include <malloc.h>
+
+#include <cerrno>
+
+// glibc's allocator, which the wrappers below forward to
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+// The benchmark is single threaded, like the layout and rendering code it measures
+HeapStats stats = {0, 0, 0};
+
+void* track(void* ptr) {
+  if (ptr) {
+    stats.allocations++;
+    stats.currentBytes += malloc_usable_size(ptr);
+    if (stats.currentBytes > stats.peakBytes) {
+      stats.peakBytes = stats.currentBytes;
+    }
+  }
+  return ptr;
+}
+
+void untrack(void* ptr) {
+  if (ptr) {
+    stats.currentBytes -= malloc_usable_size(ptr);
+  }
+}
+}  // namespace
+
+HeapStats heapStats() { return stats; }
+
+void resetHeapPeak() { stats.peakBytes = stats.currentBytes; }
+
+extern "C" {
+void* malloc(const size_t size) { return track(__libc_malloc(size)); }
+
+void* calloc(const size_t count, const size_t size) { return track(__libc_calloc(count, size)); }
+
+void* realloc(void* ptr, const size_t size) {
+  const size_t oldBytes = ptr ? malloc_usable_size(ptr) : 0;
+  void* result = __libc_realloc(ptr, size);
+  if (!result && size > 0) {
+    // Failed, the old block is still allocated
+    return nullptr;
+  }
+  stats.currentBytes -= oldBytes;
+  return track(result);
+}
+
+void free(void* ptr) {
+  untrack(ptr);
+  __libc_free(ptr);
+}
+
+void* memalign(const size_t alignment, const size_t size) { return track(__libc_memalign(alignment, size)); }
+
+void* aligned_alloc(const size_t alignment, const size_t size) { return memalign(alignment, size); }
+
+int posix_memalign(void** result, const size_t alignment, const size_t size) {
+  void* ptr = memalign(alignment, size);
+  if (!ptr) {
+    return ENOMEM;
+  }
+  *result = ptr;
+  return 0;
+}
+}
@@ -0,0 +1,16 @@
+#pragma once
+// Heap accounting for the benchmark. malloc and friends are wrapped for the whole program, so the counts include
+// expat, miniz and everything allocated through operator new.
+
+#include <cstddef>
+#include <cstdint>
+
+struct HeapStats {
+  uint64_t allocations;
+  size_t currentBytes;
+  size_t peakBytes;
+};
+
+HeapStats heapStats();
+// Start a new peak from the current heap size
+void resetHeapPeak();
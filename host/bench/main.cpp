@@ -0,0 +1,417 @@
+// Benchmark of the book libraries on the synthetic corpus in host/bench/corpus (see docs/native-build.md).
+// Every stage runs a few times; the report has the median and fastest wall time and, from the last run, the heap and
+// SD card traffic of the stage. The JSON report is meant to be compared between commits with
+// scripts/compare_bench.py.
+
+#include <Arduino.h>
+#include <EInkDisplay.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/ParsedText.h>
+#include <Epub/Section.h>
+#include <Epub/hyphenation/Hyphenator.h>
+#include <GfxRenderer.h>
+#include <HostReader.h>
+#include <SDCardManager.h>
+#include <Txt.h>
+#include <Xtc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HeapStats.h"
+
+namespace {
+namespace fs = std::filesystem;
+using hostReader::CACHE_DIR;
+
+EInkDisplay einkDisplay;
+GfxRenderer renderer(einkDisplay);
+
+struct Options {
+  std::string corpusDir;
+  std::string sdRoot = "/tmp/crosspoint-bench";
+  std::string reportPath;
+  std::string only;
+  int runs = 5;
+  bool verbose = false;
+};
+
+struct StageResult {
+  std::string book;
+  std::string stage;
+  uint64_t medianUs;
+  uint64_t minUs;
+  uint64_t allocations;
+  size_t peakHeapBytes;
+  uint64_t sdReadBytes;
+  uint64_t sdWriteBytes;
+  uint32_t sdOpens;
+  uint32_t sdSeeks;
+  uint32_t sdReads;
+  uint32_t sdWrites;
+};
+
+Options options;
+std::vector<StageResult> results;
+// A stage could not do its work, its numbers are not comparable, or went over its budget
+bool failed = false;
+// Most line_layout may take relative to line_layout_plain
+constexpr double HYPHENATION_BUDGET = 2.0;
+
+void printUsage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s <corpus-dir> [options]\n"
+          "  <corpus-dir>   books to measure, e.g. host/bench/corpus\n"
+          "  --sd DIR       scratch directory used as the SD card (default /tmp/crosspoint-bench)\n"
+          "  --runs N       repetitions of every stage (default 5)\n"
+          "  --report FILE  write the results as JSON\n"
+          "  --only BOOK    only measure books whose file name contains BOOK\n"
+          "  --verbose      keep the serial log, which slows the stages down\n",
+          program);
+}
+
+bool parseOptions(const int argc, char** argv) {
+  if (argc < 2) {
+    return false;
+  }
+  options.corpusDir = argv[1];
+  for (int i = 2; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--sd") == 0 && hasValue) {
+      options.sdRoot = argv[++i];
+    } else if (strcmp(argv[i], "--runs") == 0 && hasValue) {
+      options.runs = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--report") == 0 && hasValue) {
+      options.reportPath = argv[++i];
+    } else if (strcmp(argv[i], "--only") == 0 && hasValue) {
+      options.only = argv[++i];
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      options.verbose = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * Run a stage options.runs times and record it. setup runs before every repetition and is not measured, it puts
+ * the card and the objects the stage needs into the same state each time (e.g. deletes the cache for a cold open).
+ */
+void measure(const std::string& book, const std::string& stage, const std::function<void()>& setup,
+             const std::function<void()>& run) {
+  StageResult result{};
+  result.book = book;
+  result.stage = stage;
+  std::vector<uint64_t> times;
+  for (int i = 0; i < options.runs; i++) {
+    if (setup) {
+      setup();
+    }
+    const HeapStats heapBefore = heapStats();
+    const SdHostStats sdBefore = sdHostStats();
+    resetHeapPeak();
+    const uint64_t start = nowUs();
+    run();
+    const uint64_t elapsed = nowUs() - start;
+    const HeapStats heapAfter = heapStats();
+    const SdHostStats& sdAfter = sdHostStats();
+    times.push_back(elapsed);
+
+    result.allocations = heapAfter.allocations - heapBefore.allocations;
+    result.peakHeapBytes = heapAfter.peakBytes - heapBefore.currentBytes;
+    result.sdReadBytes = sdAfter.bytesRead - sdBefore.bytesRead;
+    result.sdWriteBytes = sdAfter.bytesWritten - sdBefore.bytesWritten;
+    result.sdOpens = sdAfter.opens - sdBefore.opens;
+    result.sdSeeks = sdAfter.seeks - sdBefore.seeks;
+    result.sdReads = sdAfter.reads - sdBefore.reads;
+    result.sdWrites = sdAfter.writes - sdBefore.writes;
+  }
+  std::sort(times.begin(), times.end());
+  result.medianUs = times[times.size() / 2];
+  result.minUs = times.front();
+  results.push_back(result);
+
+  printf("%-22s %-16s %10.2f ms %9llu allocs %9zu B heap %10llu B read %9llu B written\n", book.c_str(),
+         stage.c_str(), result.medianUs / 1000.0, static_cast<unsigned long long>(result.allocations),
+         result.peakHeapBytes, static_cast<unsigned long long>(result.sdReadBytes),
+         static_cast<unsigned long long>(result.sdWriteBytes));
+}
+
+void benchEpub(const std::string& name) {
+  const std::string path = "/" + name;
+  const hostReader::Viewport viewport = hostReader::getViewport(renderer);
+  std::shared_ptr<Epub> epub;
+
+  measure(
+      name, "open_cold",
+      [&] {
+        epub = std::make_shared<Epub>(path, CACHE_DIR);
+        epub->clearCache();
+      },
+      [&] { epub->load(); });
+  measure(
+      name, "open_warm", [&] { epub = std::make_shared<Epub>(path, CACHE_DIR); }, [&] { epub->load(); });
+
+  // Section::createSectionFile for every chapter, from a cache without sections
+  measure(
+      name, "layout",
+      [&] {
+        for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+          Section(epub, i, renderer).clearCache();
+        }
+      },
+      [&] {
+        using namespace hostReader;
+        for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+          Section section(epub, i, renderer);
+          section.createSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                                    HYPHENATION, viewport.width, viewport.height);
+        }
+      });
+
+  // Every page of every chapter read back from the section files, passed to onPage
+  const auto loadPages = [&](const std::function<void(std::unique_ptr<Page>)>& onPage) {
+    using namespace hostReader;
+    for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+      Section section(epub, i, renderer);
+      if (!section.loadSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                                   HYPHENATION, viewport.width, viewport.height)) {
+        continue;
+      }
+      for (section.currentPage = 0; section.currentPage < section.pageCount; section.currentPage++) {
+        if (auto page = section.loadPageFromSectionFile()) {
+          onPage(std::move(page));
+        }
+      }
+    }
+  };
+
+  // Each page is freed once loaded, like the reader does when it shows the next one
+  measure(name, "page_load", nullptr, [&] { loadPages([](std::unique_ptr<Page>) {}); });
+
+  // Page::render of every page into the frame buffer, without refreshing the display. The pages are loaded first,
+  // outside of the measurement.
+  std::vector<std::unique_ptr<Page>> pages;
+  measure(
+      name, "page_render",
+      [&] {
+        pages.clear();
+        loadPages([&pages](std::unique_ptr<Page> page) { pages.push_back(std::move(page)); });
+      },
+      [&] {
+        for (const auto& page : pages) {
+          renderer.clearScreen();
+          page->render(renderer, hostReader::FONT_ID, viewport.marginLeft, viewport.marginTop);
+        }
+      });
+}
+
+// Split a text file into paragraphs of words at blank lines
+std::vector<std::vector<std::string>> readParagraphs(const Txt& txt) {
+  std::string text(txt.getFileSize(), '\0');
+  if (!txt.readContent(reinterpret_cast<uint8_t*>(&text[0]), 0, text.size())) {
+    fprintf(stderr, "Could not read %s\n", txt.getPath().c_str());
+    failed = true;
+    return {};
+  }
+
+  std::vector<std::vector<std::string>> paragraphs(1);
+  size_t lineStart = 0;
+  while (lineStart < text.size()) {
+    size_t lineEnd = text.find('\n', lineStart);
+    if (lineEnd == std::string::npos) {
+      lineEnd = text.size();
+    }
+    if (lineEnd == lineStart) {
+      if (!paragraphs.back().empty()) {
+        paragraphs.emplace_back();
+      }
+    } else {
+      size_t wordStart = lineStart;
+      while (wordStart < lineEnd) {
+        size_t wordEnd = text.find(' ', wordStart);
+        wordEnd = std::min(wordEnd == std::string::npos ? lineEnd : wordEnd, lineEnd);
+        if (wordEnd > wordStart) {
+          paragraphs.back().push_back(text.substr(wordStart, wordEnd - wordStart));
+        }
+        wordStart = wordEnd + 1;
+      }
+    }
+    lineStart = lineEnd + 1;
+  }
+  return paragraphs;
+}
+
+void benchTxt(const std::string& name) {
+  const std::string path = "/" + name;
+  std::unique_ptr<Txt> txt;
+
+  measure(
+      name, "open", [&] { txt.reset(new Txt(path, CACHE_DIR)); }, [&] { txt->load(); });
+
+  std::vector<uint8_t> buffer(4096);
+  measure(name, "read", nullptr, [&] {
+    for (size_t offset = 0; offset < txt->getFileSize(); offset += buffer.size()) {
+      if (!txt->readContent(buffer.data(), offset, std::min(buffer.size(), txt->getFileSize() - offset))) {
+        fprintf(stderr, "Could not read %s at %zu\n", name.c_str(), offset);
+        failed = true;
+        break;
+      }
+    }
+  });
+
+  // ParsedText::layoutAndExtractLines on the paragraphs of the text, fed in windows like ChapterHtmlSlimParser does
+  const auto paragraphs = readParagraphs(*txt);
+  const uint16_t viewportWidth = hostReader::getViewport(renderer).width;
+  const auto layoutParagraphs = [&](const Hyphenator* hyphenator) {
+    size_t lines = 0;
+    const auto countLine = [&lines](const std::shared_ptr<TextBlock>&) { lines++; };
+    for (const auto& words : paragraphs) {
+      ParsedText text(TextBlock::JUSTIFIED, hostReader::EXTRA_PARAGRAPH_SPACING, hyphenator);
+      for (const auto& word : words) {
+        text.addWord(word, EpdFontFamily::REGULAR);
+        if (text.size() >= ParsedText::LAYOUT_WINDOW_WORDS) {
+          text.layoutAndExtractLines(renderer, hostReader::FONT_ID, viewportWidth, countLine, false);
+        }
+      }
+      text.layoutAndExtractLines(renderer, hostReader::FONT_ID, viewportWidth, countLine);
+    }
+  };
+  measure(name, "line_layout_plain", nullptr, [&] { layoutParagraphs(nullptr); });
+  measure(name, "line_layout", nullptr, [&] { layoutParagraphs(Hyphenator::forLanguage("en")); });
+
+  // Hyphenation is only tried where lines end, it must not multiply the layout time again
+  const uint64_t plainUs = results[results.size() - 2].minUs;
+  const uint64_t hyphenatedUs = results.back().minUs;
+  if (hyphenatedUs > plainUs * HYPHENATION_BUDGET) {
+    fprintf(stderr, "%s: line layout with hyphenation took %.1fx as long as without, the budget is %.1fx\n",
+            name.c_str(), static_cast<double>(hyphenatedUs) / std::max<uint64_t>(plainUs, 1), HYPHENATION_BUDGET);
+    failed = true;
+  }
+}
+
+void benchXtc(const std::string& name) {
+  const std::string path = "/" + name;
+  std::unique_ptr<Xtc> xtc;
+
+  measure(
+      name, "open_cold",
+      [&] {
+        xtc.reset(new Xtc(path, CACHE_DIR));
+        xtc->clearCache();
+      },
+      [&] { xtc->load(); });
+
+  std::vector<uint8_t> buffer;
+  measure(name, "page_load", nullptr, [&] {
+    for (uint32_t page = 0; page < xtc->getPageCount(); page++) {
+      const size_t planeSize = (static_cast<size_t>(xtc->getPageWidth()) * xtc->getPageHeight() + 7) / 8;
+      buffer.resize(planeSize * 2);
+      xtc->loadPage(page, buffer.data(), buffer.size());
+    }
+  });
+}
+
+bool hasExtension(const std::string& name, const char* extension) {
+  const size_t length = strlen(extension);
+  return name.size() >= length && strcasecmp(name.c_str() + name.size() - length, extension) == 0;
+}
+
+// Copy the corpus onto the scratch card: books at the root, hyphenation packs where the reader looks for them
+bool prepareCard(std::vector<std::string>& books) {
+  std::error_code error;
+  fs::create_directories(fs::path(options.sdRoot) / ".crosspoint" / "hyphenation", error);
+  for (const auto& entry : fs::directory_iterator(options.corpusDir, error)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    const std::string name = entry.path().filename().string();
+    fs::copy_file(entry.path(), fs::path(options.sdRoot) / name, fs::copy_options::overwrite_existing, error);
+    if (options.only.empty() || name.find(options.only) != std::string::npos) {
+      books.push_back(name);
+    }
+  }
+  const fs::path packs = fs::path(options.corpusDir) / "hyphenation";
+  for (const auto& entry : fs::directory_iterator(packs, error)) {
+    fs::copy_file(entry.path(), fs::path(options.sdRoot) / ".crosspoint" / "hyphenation" / entry.path().filename(),
+                  fs::copy_options::overwrite_existing, error);
+  }
+  std::sort(books.begin(), books.end());
+  return !books.empty();
+}
+
+void writeReport() {
+  FILE* out = fopen(options.reportPath.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "Could not write %s\n", options.reportPath.c_str());
+    return;
+  }
+  fprintf(out, "{\n  \"version\": \"%s\",\n  \"runs\": %d,\n  \"results\": [\n", CROSSPOINT_VERSION, options.runs);
+  for (size_t i = 0; i < results.size(); i++) {
+    const StageResult& r = results[i];
+    fprintf(out,
+            "    {\"book\": \"%s\", \"stage\": \"%s\", \"wall_us_median\": %llu, \"wall_us_min\": %llu, "
+            "\"allocations\": %llu, \"peak_heap_bytes\": %zu, \"sd_read_bytes\": %llu, \"sd_write_bytes\": %llu, "
+            "\"sd_opens\": %u, \"sd_seeks\": %u, \"sd_reads\": %u, \"sd_writes\": %u}%s\n",
+            r.book.c_str(), r.stage.c_str(), static_cast<unsigned long long>(r.medianUs),
+            static_cast<unsigned long long>(r.minUs), static_cast<unsigned long long>(r.allocations),
+            r.peakHeapBytes, static_cast<unsigned long long>(r.sdReadBytes),
+            static_cast<unsigned long long>(r.sdWriteBytes), r.sdOpens, r.sdSeeks, r.sdReads, r.sdWrites,
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "  ]\n}\n");
+  fclose(out);
+  printf("Wrote %s\n", options.reportPath.c_str());
+}
+}  // namespace
+
+int main(const int argc, char** argv) {
+  if (!parseOptions(argc, argv)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  if (!options.verbose) {
+    setenv("CROSSPOINT_QUIET", "1", 1);
+  }
+
+  std::vector<std::string> books;
+  if (!prepareCard(books)) {
+    fprintf(stderr, "No books found in %s\n", options.corpusDir.c_str());
+    return 1;
+  }
+  sdSetHostRoot(options.sdRoot);
+  if (!SdMan.begin()) {
+    return 1;
+  }
+  einkDisplay.begin();
+  hostReader::setupRenderer(renderer);
+
+  for (const auto& book : books) {
+    if (hasExtension(book, ".epub")) {
+      benchEpub(book);
+    } else if (hasExtension(book, ".txt")) {
+      benchTxt(book);
+    } else if (hasExtension(book, ".xtc") || hasExtension(book, ".xtch")) {
+      benchXtc(book);
+    }
+  }
+
+  if (!options.reportPath.empty()) {
+    writeReport();
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+
+namespace {
+const auto startTime = std::chrono::steady_clock::now();
+
+bool serialQuiet() {
+  static const bool quiet = [] {
+    const char* value = getenv("CROSSPOINT_QUIET");
+    return value && strcmp(value, "0") != 0;
+  }();
+  return quiet;
+}
+}  // namespace
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(const unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+size_t Print::write(const char* str) {
+  if (!str) {
+    return 0;
+  }
+  return write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+}
+
+size_t Print::println(const char* str) { return write(str) + write("\r\n"); }
+
+size_t Print::printf(const char* format, ...) {
+  char small[256];
+  va_list args;
+  va_start(args, format);
+  const int length = vsnprintf(small, sizeof(small), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  if (static_cast<size_t>(length) < sizeof(small)) {
+    return write(reinterpret_cast<const uint8_t*>(small), length);
+  }
+
+  std::vector<char> large(length + 1);
+  va_start(args, format);
+  vsnprintf(large.data(), large.size(), format, args);
+  va_end(args);
+  return write(reinterpret_cast<const uint8_t*>(large.data()), length);
+}
+
+void HardwareSerial::begin(unsigned long) {}
+
+void HardwareSerial::flush() { fflush(stdout); }
+
+size_t HardwareSerial::write(const uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buffer, const size_t size) {
+  if (serialQuiet()) {
+    return size;
+  }
+  return fwrite(buffer, 1, size, stdout);
+}
@@ -0,0 +1,26 @@
+#pragma once
+// Stand-in for the parts of the Arduino core used by the libraries, for the native build
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "HardwareSerial.h"
+#include "Print.h"
+
+using std::max;
+using std::min;
+
+// Milliseconds/microseconds since the program started
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+inline void yield() {}
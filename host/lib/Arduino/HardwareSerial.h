@@ -0,0 +1,20 @@
+#pragma once
+// As in the Arduino core, the serial header brings in the rest of the core (millis, string and math functions)
+#include "Arduino.h"
+#include "Print.h"
+
+// Serial port stand-in that writes to stdout. Set CROSSPOINT_QUIET=1 to drop the log, e.g. while profiling.
+class HardwareSerial final : public Print {
+ public:
+  void begin(unsigned long baud);
+  operator bool() const { return true; }
+  int available() { return 0; }
+  int read() { return -1; }
+  void flush();
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,35 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+using std::max;
+using std::min;
+
+class Print {
+ public:
+  virtual ~Print() = default;
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written])) {
+      written++;
+    }
+    return written;
+  }
+  size_t write(const char* str);
+
+  int getWriteError() const { return writeError; }
+  void clearWriteError() { writeError = 0; }
+
+  size_t print(const char* str) { return write(str); }
+  size_t println(const char* str = "");
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+ protected:
+  void setWriteError(const int error = 1) { writeError = error; }
+
+ private:
+  int writeError = 0;
+};
@@ -0,0 +1,12 @@
+#pragma once
+// Stand-in for the SDK's battery monitor for the native build, always reports a full battery
+
+#include <cstdint>
+
+class BatteryMonitor {
+ public:
+  explicit BatteryMonitor(uint8_t /*adcPin*/, float /*dividerMultiplier*/ = 2.0f) {}
+
+  uint16_t readPercentage() const { return 100; }
+  uint16_t readMillivolts() const { return 4200; }
+};
@@ -0,0 +1,102 @@
+#include "EInkDisplay.h"
+
+#include <HardwareSerial.h>
+#include <miniz.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+void EInkDisplay::clearScreen(const uint8_t color) { memset(frameBuffer, color, BUFFER_SIZE); }
+
+void EInkDisplay::drawImage(const uint8_t* imageData, const uint16_t x, const uint16_t y, const uint16_t w,
+                            const uint16_t h, bool) {
+  const int rowBytes = (w + 7) / 8;
+  for (int row = 0; row < h && y + row < DISPLAY_HEIGHT; row++) {
+    for (int col = 0; col < w && x + col < DISPLAY_WIDTH; col++) {
+      const bool white = imageData[row * rowBytes + col / 8] & (0x80 >> (col % 8));
+      uint8_t& target = frameBuffer[(y + row) * DISPLAY_WIDTH_BYTES + (x + col) / 8];
+      const uint8_t bit = 0x80 >> ((x + col) % 8);
+      target = white ? target | bit : target & ~bit;
+    }
+  }
+}
+
+void EInkDisplay::displayBuffer(const RefreshMode mode) {
+  refreshCounts[mode]++;
+  dumpFrame();
+}
+
+void EInkDisplay::copyGrayscaleLsbBuffers(const uint8_t* buffer) { memcpy(lsbBuffer, buffer, BUFFER_SIZE); }
+
+void EInkDisplay::copyGrayscaleMsbBuffers(const uint8_t* buffer) { memcpy(msbBuffer, buffer, BUFFER_SIZE); }
+
+// Only counted, the dumped frames show the black and white pass
+void EInkDisplay::displayGrayBuffer() { grayRefreshCount++; }
+
+void EInkDisplay::cleanupGrayscaleBuffers(const uint8_t*) {}
+
+void EInkDisplay::grayscaleRevert() {}
+
+void EInkDisplay::setDumpDirectory(const std::string& directory, const DumpFormat format, const bool portrait) {
+  dumpDirectory = directory;
+  dumpFormat = format;
+  dumpPortrait = portrait;
+  ::mkdir(directory.c_str(), 0755);
+}
+
+void EInkDisplay::dumpFrame() {
+  if (dumpDirectory.empty()) {
+    return;
+  }
+
+  // Upright image, 1 = black
+  const int width = dumpPortrait ? DISPLAY_HEIGHT : DISPLAY_WIDTH;
+  const int height = dumpPortrait ? DISPLAY_WIDTH : DISPLAY_HEIGHT;
+  const auto isBlack = [this](const int panelX, const int panelY) {
+    return !(frameBuffer[panelY * DISPLAY_WIDTH_BYTES + panelX / 8] & (0x80 >> (panelX % 8)));
+  };
+  // Inverse of GfxRenderer's portrait rotation: logical (x, y) is panel (y, DISPLAY_HEIGHT - 1 - x)
+  const auto pixel = [&](const int x, const int y) {
+    return dumpPortrait ? isBlack(y, DISPLAY_HEIGHT - 1 - x) : isBlack(x, y);
+  };
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%04u.%s", dumpDirectory.c_str(), static_cast<unsigned>(dumpedFrames++),
+           dumpFormat == DUMP_PNG ? "png" : "pbm");
+  FILE* out = fopen(path, "wb");
+  if (!out) {
+    Serial.printf("[%lu] [EPD] Could not write %s\n", millis(), path);
+    return;
+  }
+
+  if (dumpFormat == DUMP_PBM) {
+    fprintf(out, "P4\n%d %d\n", width, height);
+    std::vector<uint8_t> row((width + 7) / 8);
+    for (int y = 0; y < height; y++) {
+      std::fill(row.begin(), row.end(), 0);
+      for (int x = 0; x < width; x++) {
+        if (pixel(x, y)) {
+          row[x / 8] |= 0x80 >> (x % 8);
+        }
+      }
+      fwrite(row.data(), 1, row.size(), out);
+    }
+  } else {
+    std::vector<uint8_t> gray(width * height);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        gray[y * width + x] = pixel(x, y) ? 0x00 : 0xFF;
+      }
+    }
+    size_t pngSize = 0;
+    void* png = tdefl_write_image_to_png_file_in_memory_ex(gray.data(), width, height, 1, &pngSize, 6, MZ_FALSE);
+    if (png) {
+      fwrite(png, 1, pngSize, out);
+      mz_free(png);
+    }
+  }
+  fclose(out);
+}
@@ -0,0 +1,61 @@
+#pragma once
+// Stand-in for the SDK's e-ink display driver for the native build: a framebuffer in RAM. Every refresh can be
+// written to an image file (see setDumpDirectory) and is counted by mode.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr size_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  enum RefreshMode {
+    FULL_REFRESH,  // Full refresh with complete waveform
+    HALF_REFRESH,  // Half refresh (1720ms) - balanced quality and speed
+    FAST_REFRESH   // Fast refresh using custom LUT
+  };
+
+  enum DumpFormat { DUMP_PBM, DUMP_PNG };
+
+  EInkDisplay() = default;
+  // Same signature as the device driver, the pins are ignored
+  EInkDisplay(int8_t /*sclk*/, int8_t /*mosi*/, int8_t /*cs*/, int8_t /*dc*/, int8_t /*rst*/, int8_t /*busy*/) {}
+
+  void begin() {}
+  void deepSleep() {}
+
+  uint8_t* getFrameBuffer() { return frameBuffer; }
+  void clearScreen(uint8_t color = 0xFF);
+  void drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool fromProgmem = false);
+  void displayBuffer(RefreshMode mode = FAST_REFRESH);
+
+  void copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer);
+  void copyGrayscaleMsbBuffers(const uint8_t* msbBuffer);
+  void displayGrayBuffer();
+  void cleanupGrayscaleBuffers(const uint8_t* bwBuffer);
+  void grayscaleRevert();
+
+  // Host only: write every refreshed frame to <directory>/frame_NNNN.<pbm|png>. Portrait frames are turned upright.
+  void setDumpDirectory(const std::string& directory, DumpFormat format, bool portrait);
+  // Host only: refreshes since start, by mode, and grayscale refreshes
+  uint32_t getRefreshCount(RefreshMode mode) const { return refreshCounts[mode]; }
+  uint32_t getGrayRefreshCount() const { return grayRefreshCount; }
+
+ private:
+  uint8_t frameBuffer[BUFFER_SIZE] = {};
+  uint8_t lsbBuffer[BUFFER_SIZE] = {};
+  uint8_t msbBuffer[BUFFER_SIZE] = {};
+  uint32_t refreshCounts[3] = {};
+  uint32_t grayRefreshCount = 0;
+
+  std::string dumpDirectory;
+  DumpFormat dumpFormat = DUMP_PNG;
+  bool dumpPortrait = true;
+  uint32_t dumpedFrames = 0;
+
+  void dumpFrame();
+};
@@ -0,0 +1,37 @@
+#include "HostReader.h"
+
+#include <GfxRenderer.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+
+namespace {
+constexpr int SCREEN_MARGIN = 5;
+constexpr int STATUS_BAR_MARGIN = 19;
+
+EpdFont bookerly14RegularFont(&bookerly_14_regular);
+EpdFont bookerly14BoldFont(&bookerly_14_bold);
+EpdFont bookerly14ItalicFont(&bookerly_14_italic);
+EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
+EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
+                                   &bookerly14BoldItalicFont);
+}  // namespace
+
+void hostReader::setupRenderer(GfxRenderer& renderer) {
+  renderer.insertFont(FONT_ID, bookerly14FontFamily);
+  renderer.setOrientation(GfxRenderer::Portrait);
+}
+
+hostReader::Viewport hostReader::getViewport(const GfxRenderer& renderer) {
+  Viewport viewport{};
+  renderer.getOrientedViewableTRBL(&viewport.marginTop, &viewport.marginRight, &viewport.marginBottom,
+                                   &viewport.marginLeft);
+  viewport.marginTop += SCREEN_MARGIN;
+  viewport.marginLeft += SCREEN_MARGIN;
+  viewport.marginRight += SCREEN_MARGIN;
+  viewport.marginBottom += STATUS_BAR_MARGIN;
+  viewport.width = renderer.getScreenWidth() - viewport.marginLeft - viewport.marginRight;
+  viewport.height = renderer.getScreenHeight() - viewport.marginTop - viewport.marginBottom;
+  return viewport;
+}
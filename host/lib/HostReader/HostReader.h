@@ -0,0 +1,32 @@
+#pragma once
+// Reader settings shared by the native driver and the benchmark: the defaults of CrossPointSettings and the page
+// geometry of EpubReaderActivity, so both lay out books the way a fresh device does.
+
+#include <fontIds.h>
+
+#include <cstdint>
+
+class GfxRenderer;
+
+namespace hostReader {
+constexpr char CACHE_DIR[] = "/.crosspoint";
+constexpr int FONT_ID = BOOKERLY_14_FONT_ID;
+constexpr float LINE_COMPRESSION = 1.0f;
+constexpr bool EXTRA_PARAGRAPH_SPACING = true;
+constexpr uint8_t PARAGRAPH_ALIGNMENT = 0;  // Justified
+constexpr bool HYPHENATION = true;
+
+struct Viewport {
+  int marginTop;
+  int marginRight;
+  int marginBottom;
+  int marginLeft;
+  uint16_t width;
+  uint16_t height;
+};
+
+// Register the reader font and turn the renderer to portrait
+void setupRenderer(GfxRenderer& renderer);
+// The area pages are laid out in, inside the screen margins and above the status bar
+Viewport getViewport(const GfxRenderer& renderer);
+}  // namespace hostReader
@@ -0,0 +1,77 @@
+#include "InputManager.h"
+
+#include <HardwareSerial.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+constexpr const char* BUTTON_NAMES[] = {"back", "confirm", "left", "right", "up", "down", "power"};
+}  // namespace
+
+void InputManager::update() {
+  justPressed = false;
+  justReleased = false;
+  if (pressed) {
+    pressed = false;
+    justReleased = true;
+    return;
+  }
+  if (next < script.size()) {
+    current = script[next++];
+    pressed = true;
+    justPressed = true;
+  }
+}
+
+void InputManager::addPress(const uint8_t button, const unsigned long holdMs, const unsigned count) {
+  for (unsigned i = 0; i < count; i++) {
+    script.push_back({button, holdMs});
+  }
+}
+
+bool InputManager::loadScript(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    Serial.printf("[%lu] [INP] Could not open input script %s\n", millis(), path.c_str());
+    return false;
+  }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    std::istringstream words(line);
+    std::string name;
+    if (!(words >> name) || name[0] == '#') {
+      continue;
+    }
+
+    int button = -1;
+    for (size_t i = 0; i < sizeof(BUTTON_NAMES) / sizeof(BUTTON_NAMES[0]); i++) {
+      if (name == BUTTON_NAMES[i]) {
+        button = static_cast<int>(i);
+      }
+    }
+    if (button < 0) {
+      Serial.printf("[%lu] [INP] %s:%d: unknown button '%s'\n", millis(), path.c_str(), lineNumber, name.c_str());
+      return false;
+    }
+
+    unsigned long holdMs = 100;
+    unsigned count = 1;
+    std::string word;
+    while (words >> word) {
+      if (word[0] == 'x') {
+        count = strtoul(word.c_str() + 1, nullptr, 10);
+      } else {
+        holdMs = strtoul(word.c_str(), nullptr, 10);
+      }
+    }
+    addPress(static_cast<uint8_t>(button), holdMs, count);
+  }
+  Serial.printf("[%lu] [INP] Loaded %u scripted presses\n", millis(), static_cast<unsigned>(script.size()));
+  return true;
+}
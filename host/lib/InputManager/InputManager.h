@@ -0,0 +1,53 @@
+#pragma once
+// Stand-in for the SDK's button input for the native build. Presses come from a script instead of GPIOs.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class InputManager {
+ public:
+  static constexpr uint8_t BTN_BACK = 0;
+  static constexpr uint8_t BTN_CONFIRM = 1;
+  static constexpr uint8_t BTN_LEFT = 2;
+  static constexpr uint8_t BTN_RIGHT = 3;
+  static constexpr uint8_t BTN_UP = 4;
+  static constexpr uint8_t BTN_DOWN = 5;
+  static constexpr uint8_t BTN_POWER = 6;
+  static constexpr uint8_t POWER_BUTTON_PIN = 3;
+
+  void begin() {}
+  // Advance the script: a press takes two updates, one where the button goes down and one where it is released
+  void update();
+
+  bool isPressed(uint8_t button) const { return pressed && current.button == button; }
+  bool wasPressed(uint8_t button) const { return justPressed && current.button == button; }
+  bool wasReleased(uint8_t button) const { return justReleased && current.button == button; }
+  bool wasAnyPressed() const { return justPressed; }
+  bool wasAnyReleased() const { return justReleased; }
+  // The scripted hold time of the current press
+  unsigned long getHeldTime() const { return pressed || justReleased ? current.holdMs : 0; }
+
+  /**
+   * Host only: load presses from a script, one per line:
+   *   <back|confirm|left|right|up|down|power> [hold ms] [xN]
+   * e.g. "right x20" turns 20 pages, "right 800" is a long press. Empty lines and lines starting with # are skipped.
+   */
+  bool loadScript(const std::string& path);
+  void addPress(uint8_t button, unsigned long holdMs = 100, unsigned count = 1);
+  // Host only: true once every scripted press has been released
+  bool isScriptDone() const { return next >= script.size() && !pressed; }
+
+ private:
+  struct Press {
+    uint8_t button;
+    unsigned long holdMs;
+  };
+
+  std::vector<Press> script;
+  size_t next = 0;
+  Press current = {0, 0};
+  bool pressed = false;
+  bool justPressed = false;
+  bool justReleased = false;
+};
@@ -0,0 +1,111 @@
+#include "SDCardManager.h"
+
+#include <HardwareSerial.h>
+#include <SdHostIo.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+SDCardManager SdMan;
+
+namespace {
+bool removeTree(const std::string& hostPath) {
+  struct stat st {};
+  if (lstat(hostPath.c_str(), &st) != 0) {
+    return false;
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    return unlink(hostPath.c_str()) == 0;
+  }
+
+  DIR* dir = opendir(hostPath.c_str());
+  if (!dir) {
+    return false;
+  }
+  bool ok = true;
+  while (const dirent* entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+      ok &= removeTree(hostPath + "/" + entry->d_name);
+    }
+  }
+  closedir(dir);
+  return ok && ::rmdir(hostPath.c_str()) == 0;
+}
+}  // namespace
+
+bool SDCardManager::begin() {
+  struct stat st {};
+  initialized = stat(sdHostPath("/").c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  if (!initialized) {
+    Serial.printf("[%lu] [SD] Host directory %s not found\n", millis(), sdHostPath("/").c_str());
+  }
+  return initialized;
+}
+
+bool SDCardManager::exists(const char* path) {
+  struct stat st {};
+  return stat(sdHostPath(path).c_str(), &st) == 0;
+}
+
+bool SDCardManager::remove(const char* path) { return unlink(sdHostPath(path).c_str()) == 0; }
+
+bool SDCardManager::mkdir(const char* path, const bool pFlag) {
+  const std::string hostPath = sdHostPath(path);
+  if (pFlag) {
+    // Create the parents first, like mkdir -p
+    for (size_t slash = hostPath.find('/', 1); slash != std::string::npos; slash = hostPath.find('/', slash + 1)) {
+      ::mkdir(hostPath.substr(0, slash).c_str(), 0755);
+    }
+  }
+  return ::mkdir(hostPath.c_str(), 0755) == 0 || (pFlag && errno == EEXIST);
+}
+
+bool SDCardManager::rmdir(const char* path) { return ::rmdir(sdHostPath(path).c_str()) == 0; }
+
+bool SDCardManager::rename(const char* oldPath, const char* newPath) {
+  return ::rename(sdHostPath(oldPath).c_str(), sdHostPath(newPath).c_str()) == 0;
+}
+
+bool SDCardManager::removeDir(const char* path) { return removeTree(sdHostPath(path)); }
+
+FsFile SDCardManager::open(const char* path, const oflag_t oflag) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  FsFile file;
+  file.open(path, oflag);
+  return file;
+}
+
+bool SDCardManager::openFileForRead(const char* moduleName, const char* path, FsFile& file) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  if (!exists(path)) {
+    Serial.printf("[%lu] [%s] File does not exist: %s\n", millis(), moduleName, path);
+    return false;
+  }
+  if (!file.open(path, O_RDONLY)) {
+    Serial.printf("[%lu] [%s] Failed to open file for reading: %s\n", millis(), moduleName, path);
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::openFileForRead(const char* moduleName, const std::string& path, FsFile& file) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  return openFileForRead(moduleName, path.c_str(), file);
+}
+
+bool SDCardManager::openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  if (!file.open(path, O_RDWR | O_CREAT | O_TRUNC)) {
+    Serial.printf("[%lu] [%s] Failed to open file for writing: %s\n", millis(), moduleName, path);
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::openFileForWrite(const char* moduleName, const std::string& path, FsFile& file) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  return openFileForWrite(moduleName, path.c_str(), file);
+}
@@ -0,0 +1,32 @@
+#pragma once
+// Stand-in for the SDK's SD card manager for the native build. Paths are resolved under the host directory set with
+// sdSetHostRoot (the current directory by default).
+
+#include <SdFat.h>
+
+#include <string>
+
+class SDCardManager {
+ public:
+  bool begin();
+  bool ready() const { return initialized; }
+
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool mkdir(const char* path, bool pFlag = true);
+  bool rmdir(const char* path);
+  bool rename(const char* oldPath, const char* newPath);
+  // Delete a directory and everything in it
+  bool removeDir(const char* path);
+
+  FsFile open(const char* path, oflag_t oflag = O_RDONLY);
+  bool openFileForRead(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForRead(const char* moduleName, const std::string& path, FsFile& file);
+  bool openFileForWrite(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForWrite(const char* moduleName, const std::string& path, FsFile& file);
+
+ private:
+  bool initialized = false;
+};
+
+extern SDCardManager SdMan;
@@ -0,0 +1,290 @@
+#include "SdFat.h"
+
+#include "SdHostIo.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+
+namespace {
+std::string hostRoot = ".";
+SdHostStats stats;
+
+std::string joinPath(const std::string& dir, const char* name) {
+  if (!dir.empty() && dir.back() == '/') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+}  // namespace
+
+void sdSetHostRoot(const std::string& root) {
+  hostRoot = root;
+  while (hostRoot.size() > 1 && hostRoot.back() == '/') {
+    hostRoot.pop_back();
+  }
+}
+
+const SdHostStats& sdHostStats() { return stats; }
+
+std::string sdHostPath(const char* path) {
+  if (!path || path[0] != '/') {
+    return hostRoot + "/" + (path ? path : "");
+  }
+  return hostRoot + path;
+}
+
+FsFile::FsFile(FsFile&& other) noexcept
+    : file(std::exchange(other.file, nullptr)),
+      dir(std::exchange(other.dir, nullptr)),
+      path(std::move(other.path)),
+      id(std::exchange(other.id, 0)),
+      lastWasWrite(other.lastWasWrite) {}
+
+FsFile& FsFile::operator=(FsFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    file = std::exchange(other.file, nullptr);
+    lastWasWrite = other.lastWasWrite;
+    dir = std::exchange(other.dir, nullptr);
+    path = std::move(other.path);
+    id = std::exchange(other.id, 0);
+  }
+  return *this;
+}
+
+bool FsFile::open(const char* filePath, const oflag_t oflag) {
+  close();
+  path = filePath;
+  const std::string hostPath = sdHostPath(filePath);
+
+  struct stat st {};
+  const bool exists = stat(hostPath.c_str(), &st) == 0;
+  if (exists && S_ISDIR(st.st_mode)) {
+    dir = opendir(hostPath.c_str());
+    return dir != nullptr;
+  }
+
+  const int access = oflag & O_ACCMODE;
+  const char* mode;
+  if (access == O_RDONLY) {
+    mode = "rb";
+  } else if (oflag & O_TRUNC || (!exists && oflag & O_CREAT)) {
+    mode = access == O_WRONLY ? "wb" : "w+b";
+  } else {
+    mode = "r+b";
+  }
+  if (!exists && !(oflag & O_CREAT) && access != O_RDONLY) {
+    return false;
+  }
+
+  file = fopen(hostPath.c_str(), mode);
+  lastWasWrite = false;
+  if (!file) {
+    return false;
+  }
+  stats.opens++;
+  if (sdHostIo::enabled()) {
+    id = sdHostIo::nextFileId();
+    sdHostIo::record(sdHostIo::OPEN, id, 0, 0, sdHostIo::site(__builtin_return_address(0)), filePath,
+                     access != O_RDONLY);
+  }
+  if (oflag & (O_AT_END | O_APPEND)) {
+    fseek(file, 0, SEEK_END);
+  }
+  return true;
+}
+
+bool FsFile::close() {
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+  if (id) {
+    sdHostIo::record(sdHostIo::CLOSE, id, 0, 0, nullptr);
+    id = 0;
+  }
+  if (dir) {
+    closedir(dir);
+    dir = nullptr;
+  }
+  return true;
+}
+
+void FsFile::switchDirection(const bool write) {
+  if (lastWasWrite != write) {
+    fseeko(file, 0, SEEK_CUR);
+    lastWasWrite = write;
+  }
+}
+
+int FsFile::read() {
+  if (!file) {
+    return -1;
+  }
+  switchDirection(false);
+  const uint64_t offset = id ? position() : 0;
+  const int c = fgetc(file);
+  if (c == EOF) {
+    return -1;
+  }
+  stats.bytesRead++;
+  stats.reads++;
+  if (id) {
+    sdHostIo::record(sdHostIo::READ, id, offset, 1, sdHostIo::site(__builtin_return_address(0)));
+  }
+  return c;
+}
+
+int FsFile::read(void* buffer, const size_t size) {
+  if (!file) {
+    return -1;
+  }
+  switchDirection(false);
+  const uint64_t offset = id ? position() : 0;
+  const size_t bytesRead = fread(buffer, 1, size, file);
+  stats.bytesRead += bytesRead;
+  stats.reads++;
+  if (id) {
+    sdHostIo::record(sdHostIo::READ, id, offset, bytesRead, sdHostIo::site(__builtin_return_address(0)));
+  }
+  return static_cast<int>(bytesRead);
+}
+
+int FsFile::peek() {
+  // Served from the sector cache in SdFat, not counted as a read
+  if (!file) {
+    return -1;
+  }
+  switchDirection(false);
+  const int c = fgetc(file);
+  if (c == EOF) {
+    return -1;
+  }
+  ungetc(c, file);
+  return c;
+}
+
+int FsFile::available() {
+  if (!file) {
+    return 0;
+  }
+  const uint64_t remaining = size() - position();
+  return remaining > INT32_MAX ? INT32_MAX : static_cast<int>(remaining);
+}
+
+size_t FsFile::write(const uint8_t c) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  return write(&c, 1);
+}
+
+size_t FsFile::write(const uint8_t* buffer, const size_t size) {
+  if (!file) {
+    setWriteError();
+    return 0;
+  }
+  switchDirection(true);
+  const uint64_t offset = id ? position() : 0;
+  const size_t written = fwrite(buffer, 1, size, file);
+  stats.bytesWritten += written;
+  stats.writes++;
+  if (id) {
+    sdHostIo::record(sdHostIo::WRITE, id, offset, written, sdHostIo::site(__builtin_return_address(0)));
+  }
+  if (written != size) {
+    setWriteError();
+  }
+  return written;
+}
+
+bool FsFile::seekTo(const int64_t offset, const int whence, const void* returnAddress) {
+  stats.seeks++;
+  if (!file || fseeko(file, offset, whence) != 0) {
+    return false;
+  }
+  if (id) {
+    sdHostIo::record(sdHostIo::SEEK, id, position(), 0, sdHostIo::site(returnAddress));
+  }
+  return true;
+}
+
+bool FsFile::seekSet(const uint64_t position) {
+  return seekTo(static_cast<int64_t>(position), SEEK_SET, __builtin_return_address(0));
+}
+
+bool FsFile::seekCur(const int64_t offset) { return seekTo(offset, SEEK_CUR, __builtin_return_address(0)); }
+
+bool FsFile::seekEnd(const int64_t offset) { return seekTo(offset, SEEK_END, __builtin_return_address(0)); }
+
+uint64_t FsFile::position() const { return file ? ftello(file) : 0; }
+
+uint64_t FsFile::size() const {
+  if (!file) {
+    return 0;
+  }
+  fflush(file);
+  struct stat st {};
+  return fstat(fileno(file), &st) == 0 ? st.st_size : 0;
+}
+
+bool FsFile::truncate(const uint64_t length) {
+  if (!file) {
+    return false;
+  }
+  fflush(file);
+  if (ftruncate(fileno(file), length) != 0) {
+    return false;
+  }
+  // SdFat leaves the position at the new end of the file
+  return seekTo(static_cast<int64_t>(length), SEEK_SET, __builtin_return_address(0));
+}
+
+bool FsFile::sync() { return file && fflush(file) == 0; }
+
+size_t FsFile::getName(char* name, const size_t size) const {
+  if (size == 0) {
+    return 0;
+  }
+  const size_t slash = path.find_last_of('/');
+  const std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+  strncpy(name, base.c_str(), size - 1);
+  name[size - 1] = '\0';
+  return strlen(name);
+}
+
+FsFile FsFile::openNextFile(const oflag_t oflag) {
+  const sdHostIo::SiteScope site(__builtin_return_address(0));
+  FsFile next;
+  if (!dir) {
+    return next;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    next.open(joinPath(path, entry->d_name).c_str(), oflag);
+    break;
+  }
+  return next;
+}
+
+void FsFile::rewindDirectory() {
+  if (dir) {
+    rewinddir(dir);
+  }
+}
+
+bool FsFile::rename(const char* newPath) {
+  if (::rename(sdHostPath(path.c_str()).c_str(), sdHostPath(newPath).c_str()) != 0) {
+    return false;
+  }
+  path = newPath;
+  return true;
+}
+
+bool FsFile::remove() {
+  close();
+  return ::remove(sdHostPath(path.c_str()).c_str()) == 0;
+}
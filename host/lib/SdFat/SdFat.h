@@ -0,0 +1,93 @@
+#pragma once
+// Stand-in for SdFat's FsFile for the native build, backed by a directory on the host (see sdHostRoot)
+
+// Like the real library, this brings in the Arduino core (Serial, millis, string and math functions)
+#include <Arduino.h>
+#include <dirent.h>
+#include <fcntl.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#ifndef O_AT_END
+#define O_AT_END 0x4000
+#endif
+#define O_READ O_RDONLY
+#define O_WRITE O_WRONLY
+#define FILE_READ O_RDONLY
+#define FILE_WRITE (O_RDWR | O_CREAT | O_AT_END)
+
+typedef int oflag_t;
+
+// Host directory that stands in for the root of the SD card
+void sdSetHostRoot(const std::string& root);
+std::string sdHostPath(const char* path);
+
+// Host only: traffic through FsFile since the program started, read by the benchmark
+struct SdHostStats {
+  uint64_t bytesRead = 0;
+  uint64_t bytesWritten = 0;
+  uint32_t opens = 0;
+  uint32_t seeks = 0;
+  uint32_t reads = 0;
+  uint32_t writes = 0;
+};
+const SdHostStats& sdHostStats();
+
+class FsFile : public Print {
+  FILE* file = nullptr;
+  DIR* dir = nullptr;
+  std::string path;  // Path on the card
+  uint32_t id = 0;   // For SD access accounting, see SdHostIo.h
+  // C streams need a seek between reading and writing, SdFat files don't
+  bool lastWasWrite = false;
+
+  void switchDirection(bool write);
+  bool seekTo(int64_t offset, int whence, const void* returnAddress);
+
+ public:
+  FsFile() = default;
+  FsFile(const FsFile&) = delete;
+  FsFile& operator=(const FsFile&) = delete;
+  // Copying an SdFat file shares the handle, moving it is enough for how the libraries use it
+  FsFile(FsFile&& other) noexcept;
+  FsFile& operator=(FsFile&& other) noexcept;
+  ~FsFile() override { close(); }
+
+  bool open(const char* path, oflag_t oflag = O_RDONLY);
+  bool close();
+  operator bool() const { return file || dir; }
+  bool isOpen() const { return file || dir; }
+  bool isDirectory() const { return dir != nullptr; }
+  bool isDir() const { return dir != nullptr; }
+
+  int read();
+  int read(void* buffer, size_t size);
+  int peek();
+  int available();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t write(const void* buffer, const size_t size) { return write(static_cast<const uint8_t*>(buffer), size); }
+  using Print::write;
+
+  bool seek(uint64_t position) { return seekSet(position); }
+  bool seekSet(uint64_t position);
+  bool seekCur(int64_t offset);
+  bool seekEnd(int64_t offset = 0);
+  uint64_t position() const;
+  uint64_t curPosition() const { return position(); }
+  uint64_t size() const;
+  uint64_t fileSize() const { return size(); }
+  bool truncate(uint64_t length);
+  bool truncate() { return truncate(position()); }
+  bool preAllocate(uint64_t) { return true; }
+  bool sync();
+  void flush() { sync(); }
+
+  size_t getName(char* name, size_t size) const;
+  FsFile openNextFile(oflag_t oflag = O_RDONLY);
+  void rewindDirectory();
+  bool rename(const char* newPath);
+  bool remove();
+};
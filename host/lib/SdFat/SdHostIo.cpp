@@ -0,0 +1,226 @@
+#include "SdHostIo.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct SiteStats {
+  std::string name;
+  uint32_t opens = 0;
+  uint32_t seeks = 0;
+  uint32_t reads[SD_HOST_SIZE_BUCKETS] = {};
+  uint32_t writes[SD_HOST_SIZE_BUCKETS] = {};
+  uint64_t bytesRead = 0;
+  uint64_t bytesWritten = 0;
+
+  uint64_t operations() const {
+    uint64_t total = opens + seeks;
+    for (size_t i = 0; i < SD_HOST_SIZE_BUCKETS; i++) {
+      total += reads[i] + writes[i];
+    }
+    return total;
+  }
+};
+
+bool siteStatsEnabled = false;
+FILE* traceFile = nullptr;
+uint32_t fileIds = 0;
+std::mutex lock;
+
+// Return addresses resolve to the function they are in, which is what a site is
+std::unordered_map<const void*, size_t> siteByAddress;
+std::unordered_map<const void*, size_t> siteByFunction;
+std::vector<SiteStats> sites;
+
+thread_local const void* scopeSite = nullptr;
+
+size_t sizeBucket(const size_t length) {
+  size_t bucket = 0;
+  for (size_t limit = 1; bucket + 1 < SD_HOST_SIZE_BUCKETS && length > limit; limit *= 4) {
+    bucket++;
+  }
+  return bucket;
+}
+
+// Demangled function name without its parameters, or module+offset for addr2line if the symbol is not exported
+std::string siteName(const void* address, const Dl_info& info) {
+  if (info.dli_sname) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+    free(demangled);
+    int depth = 0;
+    for (size_t i = 0; i < name.size(); i++) {
+      if (name[i] == '<') {
+        depth++;
+      } else if (name[i] == '>') {
+        depth--;
+      } else if (name[i] == '(' && depth == 0) {
+        name.resize(i);
+        break;
+      }
+    }
+    return name;
+  }
+
+  const char* module = info.dli_fname ? info.dli_fname : "?";
+  const char* slash = strrchr(module, '/');
+  char name[256];
+  snprintf(name, sizeof(name), "%s+0x%lx", slash ? slash + 1 : module,
+           static_cast<unsigned long>(static_cast<const char*>(address) - static_cast<const char*>(info.dli_fbase)));
+  return name;
+}
+
+size_t siteFor(const void* address) {
+  const auto known = siteByAddress.find(address);
+  if (known != siteByAddress.end()) {
+    return known->second;
+  }
+
+  Dl_info info{};
+  // The return address is just past the call, step back into it so calls at the end of a function resolve right
+  const void* callAddress = static_cast<const char*>(address) - 1;
+  const bool resolved = dladdr(callAddress, &info) != 0;
+  const void* function = resolved && info.dli_saddr ? info.dli_saddr : address;
+
+  size_t site;
+  const auto existing = siteByFunction.find(function);
+  if (existing != siteByFunction.end()) {
+    site = existing->second;
+  } else {
+    site = sites.size();
+    sites.emplace_back();
+    sites.back().name = resolved ? siteName(callAddress, info) : "?";
+    siteByFunction[function] = site;
+    if (traceFile) {
+      fprintf(traceFile, "S %zu %s\n", site, sites.back().name.c_str());
+    }
+  }
+  siteByAddress[address] = site;
+  return site;
+}
+
+std::string histogram(const uint32_t* buckets) {
+  std::string text;
+  for (size_t i = 0; i < SD_HOST_SIZE_BUCKETS; i++) {
+    text += (i ? "/" : "") + std::to_string(buckets[i]);
+  }
+  return text;
+}
+}  // namespace
+
+void sdHostEnableSiteStats() { siteStatsEnabled = true; }
+
+bool sdHostStartTrace(const std::string& path) {
+  sdHostStopTrace();
+  traceFile = fopen(path.c_str(), "w");
+  if (!traceFile) {
+    fprintf(stderr, "Could not write %s\n", path.c_str());
+    return false;
+  }
+  fprintf(traceFile, "# crosspoint sd trace v1\n");
+  // Sites already named before the trace started
+  for (size_t i = 0; i < sites.size(); i++) {
+    fprintf(traceFile, "S %zu %s\n", i, sites[i].name.c_str());
+  }
+  return true;
+}
+
+void sdHostStopTrace() {
+  if (traceFile) {
+    fclose(traceFile);
+    traceFile = nullptr;
+  }
+}
+
+void sdHostWriteSiteStats(FILE* out) {
+  std::vector<const SiteStats*> sorted;
+  for (const SiteStats& stats : sites) {
+    sorted.push_back(&stats);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const SiteStats* a, const SiteStats* b) { return a->operations() > b->operations(); });
+
+  fprintf(out, "%-48s %7s %7s %9s %11s %9s %11s  %s\n", "site", "opens", "seeks", "reads", "bytes read", "writes",
+          "written", "read / write sizes (<=1/4/16/64/256/1K/4K/more)");
+  for (const SiteStats* stats : sorted) {
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    for (size_t i = 0; i < SD_HOST_SIZE_BUCKETS; i++) {
+      reads += stats->reads[i];
+      writes += stats->writes[i];
+    }
+    std::string name = stats->name;
+    if (name.size() > 48) {
+      name = "..." + name.substr(name.size() - 45);
+    }
+    fprintf(out, "%-48s %7u %7u %9u %11llu %9u %11llu  %s", name.c_str(), stats->opens, stats->seeks, reads,
+            static_cast<unsigned long long>(stats->bytesRead), writes,
+            static_cast<unsigned long long>(stats->bytesWritten), reads ? histogram(stats->reads).c_str() : "-");
+    fprintf(out, "  %s\n", writes ? histogram(stats->writes).c_str() : "-");
+  }
+}
+
+bool sdHostIo::enabled() { return siteStatsEnabled || traceFile; }
+
+uint32_t sdHostIo::nextFileId() { return ++fileIds; }
+
+void sdHostIo::record(const Op op, const uint32_t file, const uint64_t offset, const size_t length,
+                      const void* returnAddress, const char* path, const bool write) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (op == CLOSE) {
+    if (traceFile) {
+      fprintf(traceFile, "c %u\n", file);
+    }
+    return;
+  }
+
+  const size_t site = siteFor(returnAddress);
+  SiteStats& stats = sites[site];
+  switch (op) {
+    case OPEN:
+      stats.opens++;
+      if (traceFile) {
+        fprintf(traceFile, "o %u %c %zu %s\n", file, write ? 'w' : 'r', site, path ? path : "");
+      }
+      break;
+    case SEEK:
+      stats.seeks++;
+      if (traceFile) {
+        fprintf(traceFile, "s %u %llu %zu\n", file, static_cast<unsigned long long>(offset), site);
+      }
+      break;
+    case READ:
+    case WRITE:
+      (op == READ ? stats.reads : stats.writes)[sizeBucket(length)]++;
+      (op == READ ? stats.bytesRead : stats.bytesWritten) += length;
+      if (traceFile) {
+        fprintf(traceFile, "%c %u %llu %zu %zu\n", op == READ ? 'r' : 'w', file,
+                static_cast<unsigned long long>(offset), length, site);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+sdHostIo::SiteScope::SiteScope(const void* returnAddress) : owner(scopeSite == nullptr) {
+  if (owner) {
+    scopeSite = returnAddress;
+  }
+}
+
+sdHostIo::SiteScope::~SiteScope() {
+  if (owner) {
+    scopeSite = nullptr;
+  }
+}
+
+const void* sdHostIo::site(const void* returnAddress) { return scopeSite ? scopeSite : returnAddress; }
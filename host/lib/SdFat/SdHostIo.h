@@ -0,0 +1,52 @@
+#pragma once
+// Host only: SD access accounting for the native build. Every open, seek, read and write through FsFile / SdMan is
+// attributed to the function that made it, so access patterns (byte-at-a-time reads, seek-heavy lookups, files opened
+// over and over) can be found without guessing. Both are off unless enabled, see docs/native-build.md.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Read and write sizes are counted in buckets of up to 1, 4, 16, 64, 256, 1K, 4K and more bytes
+constexpr size_t SD_HOST_SIZE_BUCKETS = 8;
+
+// Count operations per call site, print them with sdHostWriteSiteStats
+void sdHostEnableSiteStats();
+void sdHostWriteSiteStats(FILE* out);
+
+/**
+ * Log every operation to path, one per line, for scripts/replay_sd_trace.py:
+ *   S <site> <name>                    call site, before its first use
+ *   o <file> <r|w> <site> <path>       open, file ids are never reused
+ *   c <file>                           close
+ *   s <file> <offset> <site>           seek, offset is the new position
+ *   r <file> <offset> <length> <site>  read, length is what was actually read
+ *   w <file> <offset> <length> <site>  write
+ */
+bool sdHostStartTrace(const std::string& path);
+void sdHostStopTrace();
+
+// Used by the FsFile and SDCardManager stand-ins
+namespace sdHostIo {
+enum Op : uint8_t { OPEN, CLOSE, SEEK, READ, WRITE };
+
+bool enabled();
+// Record an operation made by the code at returnAddress, on the file with the given id
+void record(Op op, uint32_t file, uint64_t offset, size_t length, const void* returnAddress, const char* path = nullptr,
+            bool write = false);
+uint32_t nextFileId();
+
+// SdMan methods open files through FsFile, the outermost scope on the stack names the call site
+class SiteScope {
+  bool owner;
+
+ public:
+  explicit SiteScope(const void* returnAddress);
+  ~SiteScope();
+  SiteScope(const SiteScope&) = delete;
+  SiteScope& operator=(const SiteScope&) = delete;
+};
+// The site set by the outermost SiteScope, or returnAddress if there is none
+const void* site(const void* returnAddress);
+}  // namespace sdHostIo
@@ -0,0 +1,27 @@
+#pragma once
+// Stand-in for the SDK's mbed TLS message digests for the native build, only SHA-256 is provided
+
+#include <cstddef>
+#include <cstdint>
+
+enum mbedtls_md_type_t { MBEDTLS_MD_NONE = 0, MBEDTLS_MD_SHA256 = 6 };
+
+struct mbedtls_md_info_t {
+  mbedtls_md_type_t type;
+};
+
+struct mbedtls_md_context_t {
+  const mbedtls_md_info_t* info;
+  uint32_t state[8];
+  uint64_t length;
+  uint8_t block[64];
+  size_t used;
+};
+
+const mbedtls_md_info_t* mbedtls_md_info_from_type(mbedtls_md_type_t type);
+void mbedtls_md_init(mbedtls_md_context_t* ctx);
+void mbedtls_md_free(mbedtls_md_context_t* ctx);
+int mbedtls_md_setup(mbedtls_md_context_t* ctx, const mbedtls_md_info_t* info, int hmac);
+int mbedtls_md_starts(mbedtls_md_context_t* ctx);
+int mbedtls_md_update(mbedtls_md_context_t* ctx, const unsigned char* input, size_t length);
+int mbedtls_md_finish(mbedtls_md_context_t* ctx, unsigned char* output);
@@ -0,0 +1,123 @@
+#include "mbedtls/md.h"
+
+#include <cstring>
+
+namespace {
+// FIPS 180-4 SHA-256
+constexpr uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr mbedtls_md_info_t SHA256_INFO = {MBEDTLS_MD_SHA256};
+
+uint32_t rotateRight(const uint32_t x, const int n) { return (x >> n) | (x << (32 - n)); }
+
+void processBlock(mbedtls_md_context_t* ctx, const uint8_t* block) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+           static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+  }
+  for (int i = 16; i < 64; i++) {
+    const uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t v[8];
+  memcpy(v, ctx->state, sizeof(v));
+  for (int i = 0; i < 64; i++) {
+    const uint32_t s1 = rotateRight(v[4], 6) ^ rotateRight(v[4], 11) ^ rotateRight(v[4], 25);
+    const uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+    const uint32_t t1 = v[7] + s1 + ch + ROUND_CONSTANTS[i] + w[i];
+    const uint32_t s0 = rotateRight(v[0], 2) ^ rotateRight(v[0], 13) ^ rotateRight(v[0], 22);
+    const uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+    memmove(v + 1, v, sizeof(uint32_t) * 7);
+    v[4] += t1;
+    v[0] = t1 + s0 + maj;
+  }
+  for (int i = 0; i < 8; i++) {
+    ctx->state[i] += v[i];
+  }
+}
+}  // namespace
+
+const mbedtls_md_info_t* mbedtls_md_info_from_type(const mbedtls_md_type_t type) {
+  return type == MBEDTLS_MD_SHA256 ? &SHA256_INFO : nullptr;
+}
+
+void mbedtls_md_init(mbedtls_md_context_t* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+
+void mbedtls_md_free(mbedtls_md_context_t* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+
+int mbedtls_md_setup(mbedtls_md_context_t* ctx, const mbedtls_md_info_t* info, const int hmac) {
+  if (!info || hmac != 0) {
+    return -1;
+  }
+  ctx->info = info;
+  return 0;
+}
+
+int mbedtls_md_starts(mbedtls_md_context_t* ctx) {
+  if (!ctx->info) {
+    return -1;
+  }
+  static constexpr uint32_t INITIAL_STATE[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(ctx->state, INITIAL_STATE, sizeof(INITIAL_STATE));
+  ctx->length = 0;
+  ctx->used = 0;
+  return 0;
+}
+
+int mbedtls_md_update(mbedtls_md_context_t* ctx, const unsigned char* input, size_t length) {
+  if (!ctx->info) {
+    return -1;
+  }
+  ctx->length += length;
+  while (length > 0) {
+    const size_t take = length < sizeof(ctx->block) - ctx->used ? length : sizeof(ctx->block) - ctx->used;
+    memcpy(ctx->block + ctx->used, input, take);
+    ctx->used += take;
+    input += take;
+    length -= take;
+    if (ctx->used == sizeof(ctx->block)) {
+      processBlock(ctx, ctx->block);
+      ctx->used = 0;
+    }
+  }
+  return 0;
+}
+
+int mbedtls_md_finish(mbedtls_md_context_t* ctx, unsigned char* output) {
+  if (!ctx->info) {
+    return -1;
+  }
+  const uint64_t bitLength = ctx->length * 8;
+  // Padding: a 1 bit, zeros up to 56 bytes into a block, then the message length in bits
+  ctx->block[ctx->used++] = 0x80;
+  if (ctx->used > 56) {
+    memset(ctx->block + ctx->used, 0, sizeof(ctx->block) - ctx->used);
+    processBlock(ctx, ctx->block);
+    ctx->used = 0;
+  }
+  memset(ctx->block + ctx->used, 0, 56 - ctx->used);
+  for (int i = 0; i < 8; i++) {
+    ctx->block[56 + i] = static_cast<uint8_t>(bitLength >> (56 - i * 8));
+  }
+  processBlock(ctx, ctx->block);
+
+  for (int i = 0; i < 8; i++) {
+    output[i * 4] = static_cast<uint8_t>(ctx->state[i] >> 24);
+    output[i * 4 + 1] = static_cast<uint8_t>(ctx->state[i] >> 16);
+    output[i * 4 + 2] = static_cast<uint8_t>(ctx->state[i] >> 8);
+    output[i * 4 + 3] = static_cast<uint8_t>(ctx->state[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,364 @@
+// Native build entry point: opens a book from a host directory that stands in for the SD card and pages through it
+// with the same libraries the firmware uses, so layout, rendering and parsing can be profiled on Linux.
+
+#include <Arduino.h>
+#include <EInkDisplay.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <GfxRenderer.h>
+#include <HostReader.h>
+#include <InputManager.h>
+#include <SDCardManager.h>
+#include <SdHostIo.h>
+#include <Txt.h>
+#include <Xtc.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "activities/reader/RefreshScheduler.h"
+
+namespace {
+using hostReader::CACHE_DIR;
+
+EInkDisplay einkDisplay;
+InputManager inputManager;
+GfxRenderer renderer(einkDisplay);
+// Picks the refresh of each page like the readers do
+RefreshScheduler refreshScheduler;
+
+struct Options {
+  std::string sdRoot;
+  std::string bookPath;
+  std::string scriptPath;
+  std::string dumpDirectory;
+  std::string sdTracePath;
+  EInkDisplay::DumpFormat dumpFormat = EInkDisplay::DUMP_PNG;
+  int maxPages = -1;
+  // Pages between half refreshes, the reader's refresh frequency setting
+  int refreshFrequency = 15;
+  bool clearCache = false;
+  bool sdStats = false;
+};
+
+void printUsage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s <sd-dir> <book> [options]\n"
+          "  <sd-dir>          host directory used as the SD card root\n"
+          "  <book>            path of the book on the card, e.g. /books/moby.epub (.epub, .xtc, .xtch, .txt)\n"
+          "  --script FILE     scripted button presses, see InputManager.h (default: turn pages to the end)\n"
+          "  --pages N         stop after showing N pages\n"
+          "  --dump DIR        write every refreshed frame to DIR\n"
+          "  --format png|pbm  image format of the dumped frames (default png)\n"
+          "  --refresh N       refresh frequency setting, pages between half refreshes (default 15)\n"
+          "  --clear-cache     delete the book's cache first, to measure a cold open\n"
+          "  --sd-stats        print SD opens, seeks, reads and writes per call site\n"
+          "  --sd-trace FILE   log every SD operation to FILE, for scripts/replay_sd_trace.py\n"
+          "Set CROSSPOINT_QUIET=1 to silence the serial log.\n",
+          program);
+}
+
+bool parseOptions(const int argc, char** argv, Options& options) {
+  if (argc < 3) {
+    return false;
+  }
+  options.sdRoot = argv[1];
+  options.bookPath = argv[2];
+  for (int i = 3; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--script") == 0 && hasValue) {
+      options.scriptPath = argv[++i];
+    } else if (strcmp(argv[i], "--pages") == 0 && hasValue) {
+      options.maxPages = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--dump") == 0 && hasValue) {
+      options.dumpDirectory = argv[++i];
+    } else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+      options.dumpFormat = strcmp(argv[++i], "pbm") == 0 ? EInkDisplay::DUMP_PBM : EInkDisplay::DUMP_PNG;
+    } else if (strcmp(argv[i], "--refresh") == 0 && hasValue) {
+      options.refreshFrequency = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--clear-cache") == 0) {
+      options.clearCache = true;
+    } else if (strcmp(argv[i], "--sd-stats") == 0) {
+      options.sdStats = true;
+    } else if (strcmp(argv[i], "--sd-trace") == 0 && hasValue) {
+      options.sdTracePath = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool hasExtension(const std::string& path, const char* extension) {
+  const size_t length = strlen(extension);
+  return path.size() >= length && strcasecmp(path.c_str() + path.size() - length, extension) == 0;
+}
+
+// Turns the page on scripted presses, or forward on every update without a script. Returns -1, 0 or +1.
+int nextPageTurn(const bool scripted) {
+  if (!scripted) {
+    return 1;
+  }
+  inputManager.update();
+  if (inputManager.wasReleased(InputManager::BTN_RIGHT) || inputManager.wasReleased(InputManager::BTN_DOWN)) {
+    return 1;
+  }
+  if (inputManager.wasReleased(InputManager::BTN_LEFT) || inputManager.wasReleased(InputManager::BTN_UP)) {
+    return -1;
+  }
+  return 0;
+}
+
+bool isFinished(const Options& options, const int pagesShown) {
+  if (options.maxPages >= 0 && pagesShown >= options.maxPages) {
+    return true;
+  }
+  return !options.scriptPath.empty() && inputManager.isScriptDone();
+}
+
+class EpubSession {
+  std::shared_ptr<Epub> epub;
+  std::unique_ptr<Section> section;
+  int spineIndex = 0;
+  hostReader::Viewport viewport;
+
+ public:
+  unsigned long layoutMs = 0;
+  unsigned long renderMs = 0;
+
+  explicit EpubSession(std::shared_ptr<Epub> epub)
+      : epub(std::move(epub)), viewport(hostReader::getViewport(renderer)) {}
+
+  // Load or lay out the chapter at spineIndex, like EpubReaderActivity does before showing it
+  bool openSection(const int index) {
+    using namespace hostReader;
+    spineIndex = index;
+    section.reset(new Section(epub, spineIndex, renderer));
+    const unsigned long start = millis();
+    if (!section->loadSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                                  HYPHENATION, viewport.width, viewport.height) ||
+        !section->isComplete()) {
+      if (!section->createSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                                      HYPHENATION, viewport.width, viewport.height)) {
+        Serial.printf("[%lu] [HST] Failed to lay out spine item %d\n", millis(), spineIndex);
+        return false;
+      }
+    }
+    layoutMs += millis() - start;
+    return true;
+  }
+
+  // Move by one page, crossing into neighbouring chapters. False at either end of the book.
+  bool turn(const int direction) {
+    if (direction > 0 && section->currentPage + 1 < section->pageCount) {
+      section->currentPage++;
+      return true;
+    }
+    if (direction < 0 && section->currentPage > 0) {
+      section->currentPage--;
+      return true;
+    }
+    for (int index = spineIndex + direction; index >= 0 && index < epub->getSpineItemsCount(); index += direction) {
+      if (openSection(index) && section->pageCount > 0) {
+        section->currentPage = direction > 0 ? 0 : section->pageCount - 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool start() {
+    return (openSection(0) && section->pageCount > 0) || turn(1);
+  }
+
+  void render(const int refreshFrequency) {
+    const unsigned long start = millis();
+    auto page = section->loadPageFromSectionFile();
+    renderer.clearScreen();
+    if (page) {
+      page->render(renderer, hostReader::FONT_ID, viewport.marginLeft, viewport.marginTop);
+    }
+    renderMs += millis() - start;
+    refreshScheduler.display(renderer, refreshFrequency);
+  }
+};
+
+int readEpub(const Options& options) {
+  auto epub = std::make_shared<Epub>(options.bookPath, CACHE_DIR);
+  if (options.clearCache) {
+    epub->clearCache();
+  }
+  const unsigned long loadStart = millis();
+  if (!epub->load()) {
+    Serial.printf("[%lu] [HST] Could not load %s\n", millis(), options.bookPath.c_str());
+    return 1;
+  }
+  const unsigned long loadMs = millis() - loadStart;
+
+  EpubSession session(epub);
+  if (!session.start()) {
+    Serial.printf("[%lu] [HST] Book has no pages\n", millis());
+    return 1;
+  }
+  session.render(options.refreshFrequency);
+  int pagesShown = 1;
+  while (!isFinished(options, pagesShown)) {
+    const int direction = nextPageTurn(!options.scriptPath.empty());
+    if (direction == 0) {
+      continue;
+    }
+    if (!session.turn(direction)) {
+      if (options.scriptPath.empty()) {
+        break;
+      }
+      continue;
+    }
+    session.render(options.refreshFrequency);
+    pagesShown++;
+  }
+
+  printf("Opened in %lu ms, laid out chapters in %lu ms, rendered %d pages in %lu ms\n", loadMs, session.layoutMs,
+         pagesShown, session.renderMs);
+  return 0;
+}
+
+void renderXtcPage(Xtc& xtc, const uint32_t page, std::vector<uint8_t>& buffer) {
+  const uint16_t width = xtc.getPageWidth();
+  const uint16_t height = xtc.getPageHeight();
+  const bool twoBit = xtc.getBitDepth() == 2;
+  const size_t planeSize = (static_cast<size_t>(width) * height + 7) / 8;
+  buffer.resize(twoBit ? planeSize * 2 : static_cast<size_t>((width + 7) / 8) * height);
+
+  renderer.clearScreen();
+  if (xtc.loadPage(page, buffer.data(), buffer.size()) == 0) {
+    Serial.printf("[%lu] [HST] Failed to load page %u\n", millis(), static_cast<unsigned>(page));
+    return;
+  }
+  for (uint16_t y = 0; y < height; y++) {
+    for (uint16_t x = 0; x < width; x++) {
+      bool black;
+      if (twoBit) {
+        // Column-major bit planes, columns right to left, see XtcReaderActivity::renderPage
+        const size_t offset = static_cast<size_t>(width - 1 - x) * ((height + 7) / 8) + y / 8;
+        const uint8_t bit = 0x80 >> (y % 8);
+        // Every non-white pixel, like the black and white pass of the device
+        black = (buffer[offset] | buffer[planeSize + offset]) & bit;
+      } else {
+        black = !(buffer[y * ((width + 7) / 8) + x / 8] & (0x80 >> (x % 8)));
+      }
+      if (black) {
+        renderer.drawPixel(x, y, true);
+      }
+    }
+  }
+}
+
+int readXtc(const Options& options) {
+  Xtc xtc(options.bookPath, CACHE_DIR);
+  if (options.clearCache) {
+    xtc.clearCache();
+  }
+  if (!xtc.load() || xtc.getPageCount() == 0) {
+    Serial.printf("[%lu] [HST] Could not load %s\n", millis(), options.bookPath.c_str());
+    return 1;
+  }
+
+  std::vector<uint8_t> buffer;
+  uint32_t page = 0;
+  unsigned long renderMs = 0;
+  int pagesShown = 0;
+  do {
+    const unsigned long start = millis();
+    renderXtcPage(xtc, page, buffer);
+    renderMs += millis() - start;
+    refreshScheduler.display(renderer, options.refreshFrequency);
+    pagesShown++;
+
+    int direction = 0;
+    while (direction == 0 && !isFinished(options, pagesShown)) {
+      direction = nextPageTurn(!options.scriptPath.empty());
+    }
+    if (direction > 0 && page + 1 >= xtc.getPageCount() && options.scriptPath.empty()) {
+      break;
+    }
+    if (direction != 0) {
+      page = std::min<uint32_t>(xtc.getPageCount() - 1, std::max<int64_t>(0, static_cast<int64_t>(page) + direction));
+    }
+  } while (!isFinished(options, pagesShown));
+
+  printf("Rendered %d pages in %lu ms\n", pagesShown, renderMs);
+  return 0;
+}
+
+// Text layout lives in TxtReaderActivity, which needs FreeRTOS; only the library side is exercised here
+int readTxt(const Options& options) {
+  Txt txt(options.bookPath, CACHE_DIR);
+  if (!txt.load()) {
+    Serial.printf("[%lu] [HST] Could not load %s\n", millis(), options.bookPath.c_str());
+    return 1;
+  }
+
+  std::vector<uint8_t> buffer(4096);
+  const unsigned long start = millis();
+  for (size_t offset = 0; offset < txt.getFileSize(); offset += buffer.size()) {
+    if (!txt.readContent(buffer.data(), offset, std::min(buffer.size(), txt.getFileSize() - offset))) {
+      Serial.printf("[%lu] [HST] Failed to read %s at %zu\n", millis(), options.bookPath.c_str(), offset);
+      return 1;
+    }
+  }
+  printf("Read \"%s\" (%zu bytes) in %lu ms\n", txt.getTitle().c_str(), txt.getFileSize(), millis() - start);
+  return 0;
+}
+}  // namespace
+
+int main(const int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  sdSetHostRoot(options.sdRoot);
+  if (!SdMan.begin()) {
+    return 1;
+  }
+  if (!options.scriptPath.empty() && !inputManager.loadScript(options.scriptPath)) {
+    return 1;
+  }
+  if (options.sdStats) {
+    sdHostEnableSiteStats();
+  }
+  if (!options.sdTracePath.empty() && !sdHostStartTrace(options.sdTracePath)) {
+    return 1;
+  }
+
+  einkDisplay.begin();
+  hostReader::setupRenderer(renderer);
+  if (!options.dumpDirectory.empty()) {
+    einkDisplay.setDumpDirectory(options.dumpDirectory, options.dumpFormat, true);
+  }
+
+  int result;
+  if (hasExtension(options.bookPath, ".epub")) {
+    result = readEpub(options);
+  } else if (hasExtension(options.bookPath, ".xtc") || hasExtension(options.bookPath, ".xtch")) {
+    result = readXtc(options);
+  } else if (hasExtension(options.bookPath, ".txt")) {
+    result = readTxt(options);
+  } else {
+    fprintf(stderr, "Unsupported book type: %s\n", options.bookPath.c_str());
+    return 2;
+  }
+
+  printf("Display refreshes: %u fast, %u half, %u full\n", einkDisplay.getRefreshCount(EInkDisplay::FAST_REFRESH),
+         einkDisplay.getRefreshCount(EInkDisplay::HALF_REFRESH),
+         einkDisplay.getRefreshCount(EInkDisplay::FULL_REFRESH));
+  sdHostStopTrace();
+  if (options.sdStats) {
+    sdHostWriteSiteStats(stdout);
+  }
+  return result;
+}
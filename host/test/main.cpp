@@ -0,0 +1,248 @@
+// Host tests of device code that doesn't need the hardware (see docs/native-build.md). Prints every failed check and
+// exits non-zero if there was one.
+
+#include <EInkDisplay.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <GfxRenderer.h>
+#include <HostReader.h>
+#include <SDCardManager.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/OtaImageStream.h"
+
+namespace {
+namespace fs = std::filesystem;
+
+// Run from the project root, like the benchmark
+constexpr char CORPUS_DIR[] = "host/bench/corpus";
+constexpr char SD_ROOT[] = "/tmp/crosspoint-host-test";
+constexpr char SECTION_BOOK[] = "novel.epub";
+// A build stopped after this many pages, in a chapter that has more
+constexpr uint16_t STOP_AFTER_PAGES = 10;
+
+EInkDisplay einkDisplay;
+GfxRenderer renderer(einkDisplay);
+int failures = 0;
+
+#define CHECK(condition)                                            \
+  do {                                                              \
+    if (!(condition)) {                                             \
+      printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                   \
+    }                                                               \
+  } while (0)
+
+// SHA-256 of "abc" (FIPS 180-2 example)
+constexpr char ABC_SHA256[] = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+std::vector<uint8_t> makeImage(const size_t size) {
+  std::vector<uint8_t> image(size);
+  for (size_t i = 0; i < size; i++) {
+    image[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+  }
+  return image;
+}
+
+std::string digestOf(const std::vector<uint8_t>& image) {
+  OtaImageStream stream(image.size(), "", [](const uint8_t*, size_t) { return true; });
+  stream.write(image.data(), image.size());
+  stream.verify();
+  return stream.getDigest();
+}
+
+void testDigest() {
+  const std::vector<uint8_t> abc = {'a', 'b', 'c'};
+  OtaImageStream stream(abc.size(), ABC_SHA256, [](const uint8_t*, size_t) { return true; });
+  CHECK(stream.write(abc.data(), abc.size()));
+  CHECK(stream.isComplete());
+  CHECK(stream.verify());
+  CHECK(stream.getDigest() == ABC_SHA256);
+}
+
+// The image arrives over several responses that break off, each continuing at getOffset(). A write the sink refuses
+// is retried and must not be hashed twice.
+void testResume() {
+  const std::vector<uint8_t> image = makeImage(10000);
+  std::vector<uint8_t> flashed;
+  bool failNextWrite = false;
+  OtaImageStream stream(image.size(), digestOf(image), [&](const uint8_t* data, const size_t length) {
+    if (failNextWrite) {
+      failNextWrite = false;
+      return false;
+    }
+    flashed.insert(flashed.end(), data, data + length);
+    return true;
+  });
+
+  // First response breaks off after 3000 bytes
+  CHECK(stream.write(image.data(), 1000));
+  CHECK(stream.write(image.data() + 1000, 2000));
+  CHECK(stream.getOffset() == 3000);
+
+  // The second one fails to reach flash on its first chunk
+  failNextWrite = true;
+  CHECK(!stream.write(image.data() + stream.getOffset(), 500));
+  CHECK(stream.getOffset() == 3000);
+
+  // The third one delivers the rest, in uneven chunks
+  while (!stream.isComplete()) {
+    const size_t length = std::min<size_t>(777, image.size() - stream.getOffset());
+    CHECK(stream.write(image.data() + stream.getOffset(), length));
+  }
+  CHECK(flashed == image);
+  CHECK(stream.verify());
+}
+
+void testTruncatedImage() {
+  const std::vector<uint8_t> image = makeImage(4096);
+  OtaImageStream stream(image.size(), digestOf(image), [](const uint8_t*, size_t) { return true; });
+  CHECK(stream.write(image.data(), image.size() - 1));
+  CHECK(!stream.isComplete());
+  CHECK(!stream.verify());
+
+  // Nothing past the declared size is taken
+  OtaImageStream overlong(image.size() - 1, "", [](const uint8_t*, size_t) { return true; });
+  CHECK(!overlong.write(image.data(), image.size()));
+  CHECK(overlong.getOffset() == 0);
+}
+
+void testChecksumMismatch() {
+  std::vector<uint8_t> image = makeImage(4096);
+  const std::string expected = digestOf(image);
+  image[2048] ^= 0x01;
+  OtaImageStream stream(image.size(), expected, [](const uint8_t*, size_t) { return true; });
+  CHECK(stream.write(image.data(), image.size()));
+  CHECK(stream.isComplete());
+  CHECK(!stream.verify());
+  CHECK(stream.getDigest() != expected);
+}
+
+void testParseSha256() {
+  std::string hex;
+  CHECK(OtaImageStream::parseSha256(std::string("sha256:") + ABC_SHA256, hex) && hex == ABC_SHA256);
+  const std::string checksumLine = "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD  firmware.bin";
+  CHECK(OtaImageStream::parseSha256(checksumLine, hex) && hex == ABC_SHA256);
+  CHECK(!OtaImageStream::parseSha256("sha256:ba7816bf", hex));
+  CHECK(!OtaImageStream::parseSha256(std::string(ABC_SHA256) + "0", hex));
+}
+std::vector<char> readHostFile(const std::string& sdPath) {
+  std::ifstream in(std::string(SD_ROOT) + sdPath, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+bool buildSection(Section& section, const std::function<bool()>& shouldStop = nullptr) {
+  using namespace hostReader;
+  const Viewport viewport = getViewport(renderer);
+  return section.createSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                                   HYPHENATION, viewport.width, viewport.height, nullptr, nullptr, shouldStop);
+}
+
+bool loadSection(Section& section) {
+  using namespace hostReader;
+  const Viewport viewport = getViewport(renderer);
+  return section.loadSectionFile(FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT, HYPHENATION,
+                                 viewport.width, viewport.height);
+}
+
+// A chapter build stopped part way has its pages readable from the checkpoint, and continuing it gives the same
+// section file as building it in one go. Once parsing the HTML, once laying out from the text cache.
+void testSectionResume(const std::shared_ptr<Epub>& epub, const int spineIndex, const bool fromTextCache) {
+  const std::string sectionsDir = epub->getCachePath() + "/sections/";
+  const std::string sectionPath = sectionsDir + std::to_string(spineIndex) + ".bin";
+  const std::string textCachePath = sectionsDir + std::to_string(spineIndex) + ".text.bin";
+
+  Section reference(epub, spineIndex, renderer);
+  reference.clearCache();
+  CHECK(buildSection(reference));
+  const std::vector<char> expected = readHostFile(sectionPath);
+  CHECK(!expected.empty());
+
+  Section stopped(epub, spineIndex, renderer);
+  stopped.clearCache();
+  if (!fromTextCache) {
+    SdMan.remove(textCachePath.c_str());
+  }
+  CHECK(buildSection(stopped, [&stopped] { return stopped.pageCount >= STOP_AFTER_PAGES; }));
+  CHECK(!stopped.isComplete());
+  CHECK(stopped.pageCount >= STOP_AFTER_PAGES && stopped.pageCount < reference.pageCount);
+
+  // What the reader sees when it opens the chapter again before the build is continued
+  Section reopened(epub, spineIndex, renderer);
+  CHECK(loadSection(reopened));
+  CHECK(!reopened.isComplete());
+  CHECK(reopened.pageCount == stopped.pageCount);
+  for (reopened.currentPage = 0; reopened.currentPage < stopped.pageCount; reopened.currentPage++) {
+    CHECK(reopened.loadPageFromSectionFile() != nullptr);
+  }
+
+  CHECK(buildSection(reopened));
+  CHECK(reopened.isComplete());
+  CHECK(reopened.pageCount == reference.pageCount);
+  CHECK(readHostFile(sectionPath) == expected);
+}
+
+void testSectionResume() {
+  std::error_code error;
+  fs::remove_all(SD_ROOT, error);
+  fs::create_directories(SD_ROOT, error);
+  if (!fs::copy_file(fs::path(CORPUS_DIR) / SECTION_BOOK, fs::path(SD_ROOT) / SECTION_BOOK, error)) {
+    printf("FAILED: %s not found in %s, run from the project root\n", SECTION_BOOK, CORPUS_DIR);
+    failures++;
+    return;
+  }
+  sdSetHostRoot(SD_ROOT);
+  CHECK(SdMan.begin());
+  einkDisplay.begin();
+  hostReader::setupRenderer(renderer);
+
+  const auto epub = std::make_shared<Epub>(std::string("/") + SECTION_BOOK, hostReader::CACHE_DIR);
+  CHECK(epub->load());
+
+  // The longest chapter
+  int spineIndex = -1;
+  uint16_t mostPages = 0;
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    Section section(epub, i, renderer);
+    if (buildSection(section) && section.pageCount > mostPages) {
+      mostPages = section.pageCount;
+      spineIndex = i;
+    }
+  }
+  CHECK(mostPages > STOP_AFTER_PAGES * 2);
+  if (spineIndex < 0) {
+    return;
+  }
+
+  testSectionResume(epub, spineIndex, false);
+  testSectionResume(epub, spineIndex, true);
+}
+}  // namespace
+
+int main() {
+  setenv("CROSSPOINT_QUIET", "1", 1);
+  testDigest();
+  testResume();
+  testTruncatedImage();
+  testChecksumMismatch();
+  testParseSha256();
+  testSectionResume();
+
+  if (failures > 0) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+  printf("All tests passed\n");
+  return 0;
+}
@@ -4,17 +4,40 @@
 #include <Serialization.h>
 #include <ZipFile.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "FsHelpers.h"
 
 namespace {
-constexpr uint8_t BOOK_CACHE_VERSION = 4;
+constexpr uint8_t BOOK_CACHE_VERSION = 5;
 constexpr char bookBinFile[] = "/book.bin";
 constexpr char tmpSpineBinFile[] = "/spine.bin.tmp";
 constexpr char tmpTocBinFile[] = "/toc.bin.tmp";
+
+// Offset of str in a page's string pool, appending it if it isn't there yet
+bool internString(std::string& pool, const std::string& str, uint16_t& offset) {
+  const size_t found = pool.find(str.c_str(), 0, str.size() + 1);
+  if (found != std::string::npos) {
+    offset = found;
+    return true;
+  }
+  if (pool.size() + str.size() + 1 > UINT16_MAX) {
+    return false;
+  }
+  offset = pool.size();
+  pool.append(str.c_str(), str.size() + 1);
+  return true;
+}
 }  // namespace
 
+BookMetadataCache::~BookMetadataCache() {
+  if (lookupStats.hits + lookupStats.pageLoads + lookupStats.sdReads > 0) {
+    Serial.printf("[%lu] [BMC] Lookups: %u hits, %u page loads, %u uncached, %u bytes cached\n", millis(),
+                  lookupStats.hits, lookupStats.pageLoads, lookupStats.sdReads, lookupStats.cachedBytes);
+  }
+}
+
 /* ============= WRITING / BUILDING FUNCTIONS ================ */
 
 bool BookMetadataCache::beginWrite() {
@@ -29,12 +52,18 @@ bool BookMetadataCache::beginContentOpfPass() {
   Serial.printf("[%lu] [BMC] Beginning content opf pass\n", millis());
 
   // Open spine file for writing
-  return SdMan.openFileForWrite("BMC", cachePath + tmpSpineBinFile, spineFile);
+  if (!SdMan.openFileForWrite("BMC", cachePath + tmpSpineBinFile, spineFile)) {
+    return false;
+  }
+  spineOut.reset(new BufferedFsWriter(spineFile));
+  return true;
 }
 
 bool BookMetadataCache::endContentOpfPass() {
+  const bool ok = !spineOut || spineOut->flush();
+  spineOut.reset();
   spineFile.close();
-  return true;
+  return ok;
 }
 
 bool BookMetadataCache::beginTocPass() {
@@ -48,13 +77,18 @@ bool BookMetadataCache::beginTocPass() {
     spineFile.close();
     return false;
   }
+  spineIn.reset(new BufferedFsReader(spineFile));
+  tocOut.reset(new BufferedFsWriter(tocFile));
   return true;
 }
 
 bool BookMetadataCache::endTocPass() {
+  const bool ok = !tocOut || tocOut->flush();
+  tocOut.reset();
+  spineIn.reset();
   tocFile.close();
   spineFile.close();
-  return true;
+  return ok;
 }
 
 bool BookMetadataCache::endWrite() {
@@ -85,38 +119,44 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     return false;
   }
 
+  // On the heap like the buffers of the passes before, the ZIP lookups below need the stack
+  std::unique_ptr<BufferedFsWriter> bookOut(new BufferedFsWriter(bookFile));
+  std::unique_ptr<BufferedFsReader> spineReader(new BufferedFsReader(spineFile));
+  std::unique_ptr<BufferedFsReader> tocReader(new BufferedFsReader(tocFile));
+
   constexpr uint32_t headerASize =
       sizeof(BOOK_CACHE_VERSION) + /* LUT Offset */ sizeof(uint32_t) + sizeof(spineCount) + sizeof(tocCount);
   const uint32_t metadataSize = metadata.title.size() + metadata.author.size() + metadata.coverItemHref.size() +
-                                metadata.textReferenceHref.size() + sizeof(uint32_t) * 4;
+                                metadata.textReferenceHref.size() + metadata.language.size() + sizeof(uint32_t) * 5;
   const uint32_t lutSize = sizeof(uint32_t) * spineCount + sizeof(uint32_t) * tocCount;
   const uint32_t lutOffset = headerASize + metadataSize;
 
   // Header A
-  serialization::writePod(bookFile, BOOK_CACHE_VERSION);
-  serialization::writePod(bookFile, lutOffset);
-  serialization::writePod(bookFile, spineCount);
-  serialization::writePod(bookFile, tocCount);
+  serialization::writePod(*bookOut, BOOK_CACHE_VERSION);
+  serialization::writePod(*bookOut, lutOffset);
+  serialization::writePod(*bookOut, spineCount);
+  serialization::writePod(*bookOut, tocCount);
   // Metadata
-  serialization::writeString(bookFile, metadata.title);
-  serialization::writeString(bookFile, metadata.author);
-  serialization::writeString(bookFile, metadata.coverItemHref);
-  serialization::writeString(bookFile, metadata.textReferenceHref);
+  serialization::writeString(*bookOut, metadata.title);
+  serialization::writeString(*bookOut, metadata.author);
+  serialization::writeString(*bookOut, metadata.coverItemHref);
+  serialization::writeString(*bookOut, metadata.textReferenceHref);
+  serialization::writeString(*bookOut, metadata.language);
 
   // Loop through spine entries, writing LUT positions
-  spineFile.seek(0);
+  spineReader->seek(0);
   for (int i = 0; i < spineCount; i++) {
-    uint32_t pos = spineFile.position();
-    auto spineEntry = readSpineEntry(spineFile);
-    serialization::writePod(bookFile, pos + lutOffset + lutSize);
+    uint32_t pos = spineReader->position();
+    auto spineEntry = readSpineEntry(*spineReader);
+    serialization::writePod(*bookOut, pos + lutOffset + lutSize);
   }
 
   // Loop through toc entries, writing LUT positions
-  tocFile.seek(0);
+  tocReader->seek(0);
   for (int i = 0; i < tocCount; i++) {
-    uint32_t pos = tocFile.position();
-    auto tocEntry = readTocEntry(tocFile);
-    serialization::writePod(bookFile, pos + lutOffset + lutSize + static_cast<uint32_t>(spineFile.position()));
+    uint32_t pos = tocReader->position();
+    auto tocEntry = readTocEntry(*tocReader);
+    serialization::writePod(*bookOut, pos + lutOffset + lutSize + spineReader->position());
   }
 
   // LUTs complete
@@ -126,6 +166,7 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   // Pre-open zip file to speed up size calculations
   if (!zip.open()) {
     Serial.printf("[%lu] [BMC] Could not open EPUB zip for size calculations\n", millis());
+    bookOut->discard();
     bookFile.close();
     spineFile.close();
     tocFile.close();
@@ -136,6 +177,7 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   //       Perhaps only a cache of spine items or a better way to speedup lookups?
   if (!zip.loadAllFileStatSlims()) {
     Serial.printf("[%lu] [BMC] Could not load zip local header offsets for size calculations\n", millis());
+    bookOut->discard();
     bookFile.close();
     spineFile.close();
     tocFile.close();
@@ -143,14 +185,14 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     return false;
   }
   uint32_t cumSize = 0;
-  spineFile.seek(0);
+  spineReader->seek(0);
   int lastSpineTocIndex = -1;
   for (int i = 0; i < spineCount; i++) {
-    auto spineEntry = readSpineEntry(spineFile);
+    auto spineEntry = readSpineEntry(*spineReader);
 
-    tocFile.seek(0);
+    tocReader->seek(0);
     for (int j = 0; j < tocCount; j++) {
-      auto tocEntry = readTocEntry(tocFile);
+      auto tocEntry = readTocEntry(*tocReader);
       if (tocEntry.spineIndex == i) {
         spineEntry.tocIndex = j;
         break;
@@ -178,22 +220,28 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     }
 
     // Write out spine data to book.bin
-    writeSpineEntry(bookFile, spineEntry);
+    writeSpineEntry(*bookOut, spineEntry);
   }
   // Close opened zip file
   zip.close();
 
   // Loop through toc entries from toc file writing to book.bin
-  tocFile.seek(0);
+  tocReader->seek(0);
   for (int i = 0; i < tocCount; i++) {
-    auto tocEntry = readTocEntry(tocFile);
-    writeTocEntry(bookFile, tocEntry);
+    auto tocEntry = readTocEntry(*tocReader);
+    writeTocEntry(*bookOut, tocEntry);
   }
 
+  const bool ok = bookOut->flush();
   bookFile.close();
   spineFile.close();
   tocFile.close();
 
+  if (!ok) {
+    Serial.printf("[%lu] [BMC] Failed to write book.bin\n", millis());
+    SdMan.remove((cachePath + bookBinFile).c_str());
+    return false;
+  }
   Serial.printf("[%lu] [BMC] Successfully built book.bin\n", millis());
   return true;
 }
@@ -208,40 +256,40 @@ bool BookMetadataCache::cleanupTmpFiles() const {
   return true;
 }
 
-uint32_t BookMetadataCache::writeSpineEntry(FsFile& file, const SpineEntry& entry) const {
-  const uint32_t pos = file.position();
-  serialization::writeString(file, entry.href);
-  serialization::writePod(file, entry.cumulativeSize);
-  serialization::writePod(file, entry.tocIndex);
+uint32_t BookMetadataCache::writeSpineEntry(BufferedFsWriter& out, const SpineEntry& entry) const {
+  const uint32_t pos = out.position();
+  serialization::writeString(out, entry.href);
+  serialization::writePod(out, entry.cumulativeSize);
+  serialization::writePod(out, entry.tocIndex);
   return pos;
 }
 
-uint32_t BookMetadataCache::writeTocEntry(FsFile& file, const TocEntry& entry) const {
-  const uint32_t pos = file.position();
-  serialization::writeString(file, entry.title);
-  serialization::writeString(file, entry.href);
-  serialization::writeString(file, entry.anchor);
-  serialization::writePod(file, entry.level);
-  serialization::writePod(file, entry.spineIndex);
+uint32_t BookMetadataCache::writeTocEntry(BufferedFsWriter& out, const TocEntry& entry) const {
+  const uint32_t pos = out.position();
+  serialization::writeString(out, entry.title);
+  serialization::writeString(out, entry.href);
+  serialization::writeString(out, entry.anchor);
+  serialization::writePod(out, entry.level);
+  serialization::writePod(out, entry.spineIndex);
   return pos;
 }
 
 // Note: for the LUT to be accurate, this **MUST** be called for all spine items before `addTocEntry` is ever called
 // this is because in this function we're marking positions of the items
 void BookMetadataCache::createSpineEntry(const std::string& href) {
-  if (!buildMode || !spineFile) {
+  if (!buildMode || !spineOut) {
     Serial.printf("[%lu] [BMC] createSpineEntry called but not in build mode\n", millis());
     return;
   }
 
   const SpineEntry entry(href, 0, -1);
-  writeSpineEntry(spineFile, entry);
+  writeSpineEntry(*spineOut, entry);
   spineCount++;
 }
 
 void BookMetadataCache::createTocEntry(const std::string& title, const std::string& href, const std::string& anchor,
                                        const uint8_t level) {
-  if (!buildMode || !tocFile || !spineFile) {
+  if (!buildMode || !tocOut || !spineIn) {
     Serial.printf("[%lu] [BMC] createTocEntry called but not in build mode\n", millis());
     return;
   }
@@ -250,9 +298,9 @@ void BookMetadataCache::createTocEntry(const std::string& title, const std::stri
   // find spine index
   // TODO: This lookup is slow as need to scan through all items each time. We can't hold it all in memory due to size.
   //       But perhaps we can load just the hrefs in a vector/list to do an index lookup?
-  spineFile.seek(0);
+  spineIn->seek(0);
   for (int i = 0; i < spineCount; i++) {
-    auto spineEntry = readSpineEntry(spineFile);
+    auto spineEntry = readSpineEntry(*spineIn);
     if (spineEntry.href == href) {
       spineIndex = i;
       break;
@@ -264,7 +312,7 @@ void BookMetadataCache::createTocEntry(const std::string& title, const std::stri
   }
 
   const TocEntry entry(title, href, anchor, level, spineIndex);
-  writeTocEntry(tocFile, entry);
+  writeTocEntry(*tocOut, entry);
   tocCount++;
 }
 
@@ -275,23 +323,28 @@ bool BookMetadataCache::load() {
     return false;
   }
 
+  // Kept for the lookups, which read the entries close to each other
+  bookIn.reset(new BufferedFsReader(bookFile));
   uint8_t version;
-  serialization::readPod(bookFile, version);
+  serialization::readPod(*bookIn, version);
   if (version != BOOK_CACHE_VERSION) {
     Serial.printf("[%lu] [BMC] Cache version mismatch: expected %d, got %d\n", millis(), BOOK_CACHE_VERSION, version);
+    bookIn.reset();
     bookFile.close();
     return false;
   }
 
-  serialization::readPod(bookFile, lutOffset);
-  serialization::readPod(bookFile, spineCount);
-  serialization::readPod(bookFile, tocCount);
+  serialization::readPod(*bookIn, lutOffset);
+  serialization::readPod(*bookIn, spineCount);
+  serialization::readPod(*bookIn, tocCount);
 
-  serialization::readString(bookFile, coreMetadata.title);
-  serialization::readString(bookFile, coreMetadata.author);
-  serialization::readString(bookFile, coreMetadata.coverItemHref);
-  serialization::readString(bookFile, coreMetadata.textReferenceHref);
+  serialization::readString(*bookIn, coreMetadata.title);
+  serialization::readString(*bookIn, coreMetadata.author);
+  serialization::readString(*bookIn, coreMetadata.coverItemHref);
+  serialization::readString(*bookIn, coreMetadata.textReferenceHref);
+  serialization::readString(*bookIn, coreMetadata.language);
 
+  clearLookupCache();
   loaded = true;
   Serial.printf("[%lu] [BMC] Loaded cache data: %d spine, %d TOC entries\n", millis(), spineCount, tocCount);
   return true;
@@ -308,12 +361,18 @@ BookMetadataCache::SpineEntry BookMetadataCache::getSpineEntry(const int index)
     return {};
   }
 
+  if (const CachedPage* page = findLookupPage(false, index)) {
+    const auto& record = page->records[index - page->first];
+    return {page->string(record.href), record.cumulativeSize, record.linkIndex};
+  }
+
   // Seek to spine LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * index);
+  lookupStats.sdReads++;
+  bookIn->seek(lutOffset + sizeof(uint32_t) * index);
   uint32_t spineEntryPos;
-  serialization::readPod(bookFile, spineEntryPos);
-  bookFile.seek(spineEntryPos);
-  return readSpineEntry(bookFile);
+  serialization::readPod(*bookIn, spineEntryPos);
+  bookIn->seek(spineEntryPos);
+  return readSpineEntry(*bookIn);
 }
 
 BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
@@ -327,28 +386,155 @@ BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
     return {};
   }
 
+  if (const CachedPage* page = findLookupPage(true, index)) {
+    const auto& record = page->records[index - page->first];
+    return {page->string(record.title), page->string(record.href), page->string(record.anchor), record.level,
+            record.linkIndex};
+  }
+
   // Seek to TOC LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * index);
+  lookupStats.sdReads++;
+  bookIn->seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * index);
   uint32_t tocEntryPos;
-  serialization::readPod(bookFile, tocEntryPos);
-  bookFile.seek(tocEntryPos);
-  return readTocEntry(bookFile);
+  serialization::readPod(*bookIn, tocEntryPos);
+  bookIn->seek(tocEntryPos);
+  return readTocEntry(*bookIn);
 }
 
-BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(FsFile& file) const {
+bool BookMetadataCache::getTocEntries(const int first, int count, std::vector<TocEntry>& entries) {
+  entries.clear();
+  if (!loaded || first < 0 || first >= static_cast<int>(tocCount)) {
+    return false;
+  }
+  count = std::min(count, static_cast<int>(tocCount) - first);
+
+  // TOC entries are stored back to back in LUT order, only the first one has to be looked up
+  bookIn->seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * first);
+  uint32_t tocEntryPos;
+  serialization::readPod(*bookIn, tocEntryPos);
+  bookIn->seek(tocEntryPos);
+  entries.reserve(count);
+  for (int i = 0; i < count; i++) {
+    entries.push_back(readTocEntry(*bookIn));
+  }
+  lookupStats.sdReads += count;
+  return true;
+}
+
+BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(BufferedFsReader& in) const {
   SpineEntry entry;
-  serialization::readString(file, entry.href);
-  serialization::readPod(file, entry.cumulativeSize);
-  serialization::readPod(file, entry.tocIndex);
+  serialization::readString(in, entry.href);
+  serialization::readPod(in, entry.cumulativeSize);
+  serialization::readPod(in, entry.tocIndex);
   return entry;
 }
 
-BookMetadataCache::TocEntry BookMetadataCache::readTocEntry(FsFile& file) const {
+BookMetadataCache::TocEntry BookMetadataCache::readTocEntry(BufferedFsReader& in) const {
   TocEntry entry;
-  serialization::readString(file, entry.title);
-  serialization::readString(file, entry.href);
-  serialization::readString(file, entry.anchor);
-  serialization::readPod(file, entry.level);
-  serialization::readPod(file, entry.spineIndex);
+  serialization::readString(in, entry.title);
+  serialization::readString(in, entry.href);
+  serialization::readString(in, entry.anchor);
+  serialization::readPod(in, entry.level);
+  serialization::readPod(in, entry.spineIndex);
   return entry;
 }
+
+/* ============= LOOKUP CACHE ================ */
+
+void BookMetadataCache::setLookupCacheLimit(const size_t bytes) {
+  lookupCacheLimit = bytes;
+  clearLookupCache();
+}
+
+void BookMetadataCache::clearLookupCache() {
+  lookupPages.clear();
+  lookupPages.shrink_to_fit();
+  uncachedLookupPages.clear();
+  uncachedLookupPages.shrink_to_fit();
+  lookupStats.cachedBytes = 0;
+}
+
+bool BookMetadataCache::loadLookupPage(const bool toc, const uint16_t first, CachedPage& page) {
+  const uint16_t count = std::min<uint16_t>(LOOKUP_PAGE_ENTRIES, (toc ? tocCount : spineCount) - first);
+  page.toc = toc;
+  page.first = first;
+  page.records.reserve(count);
+
+  // The LUT entries of a page are next to each other, read them in one go
+  uint32_t positions[LOOKUP_PAGE_ENTRIES];
+  bookIn->seek(lutOffset + sizeof(uint32_t) * ((toc ? spineCount : 0) + first));
+  if (bookIn->read(reinterpret_cast<uint8_t*>(positions), sizeof(uint32_t) * count) != sizeof(uint32_t) * count) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    bookIn->seek(positions[i]);
+    CachedRecord record = {};
+    bool ok;
+    if (toc) {
+      const auto entry = readTocEntry(*bookIn);
+      ok = internString(page.strings, entry.title, record.title) &&
+           internString(page.strings, entry.href, record.href) &&
+           internString(page.strings, entry.anchor, record.anchor);
+      record.level = entry.level;
+      record.linkIndex = entry.spineIndex;
+    } else {
+      const auto entry = readSpineEntry(*bookIn);
+      ok = internString(page.strings, entry.href, record.href);
+      record.cumulativeSize = entry.cumulativeSize;
+      record.linkIndex = entry.tocIndex;
+    }
+    if (!ok) {
+      return false;
+    }
+    page.records.push_back(record);
+  }
+  page.strings.shrink_to_fit();
+  return true;
+}
+
+const BookMetadataCache::CachedPage* BookMetadataCache::findLookupPage(const bool toc, const int index) {
+  if (lookupCacheLimit == 0) {
+    return nullptr;
+  }
+
+  const uint16_t first = index - index % LOOKUP_PAGE_ENTRIES;
+  for (auto& page : lookupPages) {
+    if (page.toc == toc && page.first == first) {
+      page.lastUse = ++lookupUseCounter;
+      lookupStats.hits++;
+      return &page;
+    }
+  }
+
+  const uint32_t key = static_cast<uint32_t>(toc) << 16 | first;
+  if (std::find(uncachedLookupPages.begin(), uncachedLookupPages.end(), key) != uncachedLookupPages.end()) {
+    return nullptr;
+  }
+
+  CachedPage page;
+  if (!loadLookupPage(toc, first, page)) {
+    // E.g. strings over the pool limit, it would fail the same way on every lookup
+    uncachedLookupPages.push_back(key);
+    return nullptr;
+  }
+  // A page that doesn't fit (very long titles) is left on the SD card, the entry is read directly
+  if (page.bytes() > lookupCacheLimit) {
+    uncachedLookupPages.push_back(key);
+    return nullptr;
+  }
+
+  // Drop the least recently used pages until the new one fits
+  while (!lookupPages.empty() && lookupStats.cachedBytes + page.bytes() > lookupCacheLimit) {
+    const auto lru = std::min_element(lookupPages.begin(), lookupPages.end(),
+                                      [](const CachedPage& a, const CachedPage& b) { return a.lastUse < b.lastUse; });
+    lookupStats.cachedBytes -= lru->bytes();
+    lookupPages.erase(lru);
+  }
+
+  page.lastUse = ++lookupUseCounter;
+  lookupStats.cachedBytes += page.bytes();
+  lookupStats.pageLoads++;
+  lookupPages.push_back(std::move(page));
+  return &lookupPages.back();
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <BufferedFsStream.h>
 #include <SDCardManager.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 class BookMetadataCache {
  public:
@@ -11,6 +14,7 @@ class BookMetadataCache {
     std::string author;
     std::string coverItemHref;
     std::string textReferenceHref;
+    std::string language;
   };
 
   struct SpineEntry {
@@ -39,9 +43,45 @@ class BookMetadataCache {
           spineIndex(spineIndex) {}
   };
 
+  // Lookups served from RAM vs. read from book.bin, see getSpineEntry
+  struct LookupStats {
+    uint32_t hits;
+    uint32_t pageLoads;
+    uint32_t sdReads;  // Lookups not cached at all (cache disabled or page over the limit)
+    uint32_t cachedBytes;
+  };
+
+  // RAM used for cached spine and TOC entries by default, 0 disables the cache
+  static constexpr size_t DEFAULT_LOOKUP_CACHE_BYTES = 8 * 1024;
+
  private:
+  // Entries are cached in pages of consecutive indexes, so walking a chapter list only loads every few entries
+  static constexpr uint16_t LOOKUP_PAGE_ENTRIES = 16;
+
+  // Fixed size record for a spine or TOC entry, strings are offsets into the page's string pool
+  struct CachedRecord {
+    uint16_t title;
+    uint16_t href;
+    uint16_t anchor;
+    int16_t linkIndex;  // tocIndex for spine entries, spineIndex for TOC entries
+    uint32_t cumulativeSize;
+    uint8_t level;
+  };
+
+  struct CachedPage {
+    bool toc;
+    uint16_t first;
+    uint32_t lastUse;
+    std::vector<CachedRecord> records;
+    // NUL terminated strings, identical ones (and suffixes) are stored once
+    std::string strings;
+
+    const char* string(const uint16_t offset) const { return strings.c_str() + offset; }
+    size_t bytes() const { return sizeof(CachedPage) + records.capacity() * sizeof(CachedRecord) + strings.capacity(); }
+  };
+
   std::string cachePath;
-  size_t lutOffset;
+  uint32_t lutOffset;
   uint16_t spineCount;
   uint16_t tocCount;
   bool loaded;
@@ -51,18 +91,34 @@ class BookMetadataCache {
   // Temp file handles during build
   FsFile spineFile;
   FsFile tocFile;
+  // Entries are a few bytes per field, these batch them into sector sized transfers. Only allocated while in use.
+  std::unique_ptr<BufferedFsReader> bookIn;
+  std::unique_ptr<BufferedFsWriter> spineOut;
+  std::unique_ptr<BufferedFsReader> spineIn;
+  std::unique_ptr<BufferedFsWriter> tocOut;
+
+  std::vector<CachedPage> lookupPages;
+  // Pages found to be over the limit or that failed to load, as toc << 16 | first. Their entries are read from
+  // book.bin without loading the page again.
+  std::vector<uint32_t> uncachedLookupPages;
+  size_t lookupCacheLimit = DEFAULT_LOOKUP_CACHE_BYTES;
+  uint32_t lookupUseCounter = 0;
+  LookupStats lookupStats = {};
 
-  uint32_t writeSpineEntry(FsFile& file, const SpineEntry& entry) const;
-  uint32_t writeTocEntry(FsFile& file, const TocEntry& entry) const;
-  SpineEntry readSpineEntry(FsFile& file) const;
-  TocEntry readTocEntry(FsFile& file) const;
+  uint32_t writeSpineEntry(BufferedFsWriter& out, const SpineEntry& entry) const;
+  uint32_t writeTocEntry(BufferedFsWriter& out, const TocEntry& entry) const;
+  SpineEntry readSpineEntry(BufferedFsReader& in) const;
+  TocEntry readTocEntry(BufferedFsReader& in) const;
+  bool loadLookupPage(bool toc, uint16_t first, CachedPage& page);
+  const CachedPage* findLookupPage(bool toc, int index);
+  void clearLookupCache();
 
  public:
   BookMetadata coreMetadata;
 
   explicit BookMetadataCache(std::string cachePath)
       : cachePath(std::move(cachePath)), lutOffset(0), spineCount(0), tocCount(0), loaded(false), buildMode(false) {}
-  ~BookMetadataCache() = default;
+  ~BookMetadataCache();
 
   // Building phase (stream to disk immediately)
   bool beginWrite();
@@ -82,7 +138,13 @@ class BookMetadataCache {
   bool load();
   SpineEntry getSpineEntry(int index);
   TocEntry getTocEntry(int index);
+  // Read count consecutive TOC entries starting at first with one seek, for lists that show many at once
+  bool getTocEntries(int first, int count, std::vector<TocEntry>& entries);
   int getSpineCount() const { return spineCount; }
   int getTocCount() const { return tocCount; }
   bool isLoaded() const { return loaded; }
+
+  // Limit the RAM used for cached entries. Books whose entries don't fit are read from the SD card as needed.
+  void setLookupCacheLimit(size_t bytes);
+  LookupStats getLookupStats() const { return lookupStats; }
 };
@@ -0,0 +1,191 @@
+#include "ChapterTextCache.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Bump when the parser changes what it produces for the same HTML
+constexpr uint8_t TEXT_CACHE_VERSION = 1;
+constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t);
+// Records: a block is BLOCK_TAG followed by its style, a word is its font style (< BLOCK_TAG), length and bytes
+constexpr uint8_t BLOCK_TAG = 0x80;
+constexpr size_t MAX_WORD_LENGTH = 255;
+}  // namespace
+
+uint32_t ChapterTextCache::wordRecordSize(const char* word) {
+  return 2 + static_cast<uint32_t>(std::min(strlen(word), MAX_WORD_LENGTH));
+}
+
+bool ChapterTextCache::isValid() {
+  FsFile in;
+  if (!SdMan.exists(filePath.c_str()) || !SdMan.openFileForRead("CTC", filePath, in)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(in, version);
+  serialization::readPod(in, recordsSize);
+  const bool valid = version == TEXT_CACHE_VERSION && recordsSize > 0 && in.size() == HEADER_SIZE + recordsSize;
+  in.close();
+  if (!valid) {
+    Serial.printf("[%lu] [CTC] Ignoring stale or incomplete text cache %s\n", millis(), filePath.c_str());
+    recordsSize = 0;
+  }
+  return valid;
+}
+
+bool ChapterTextCache::remove() const {
+  if (!SdMan.exists(filePath.c_str())) {
+    return true;
+  }
+  return SdMan.remove(filePath.c_str());
+}
+
+bool ChapterTextCache::beginWrite() {
+  if (!SdMan.openFileForWrite("CTC", filePath, file)) {
+    return false;
+  }
+  recordsSize = 0;
+  serialization::writePod(file, TEXT_CACHE_VERSION);
+  serialization::writePod(file, static_cast<uint32_t>(0));  // Records size, written by endWrite
+  return true;
+}
+
+bool ChapterTextCache::resumeWrite(const uint32_t recordsOffset) {
+  if (!SdMan.exists(filePath.c_str())) {
+    return false;
+  }
+  file = SdMan.open(filePath.c_str(), O_RDWR);
+  if (!file) {
+    return false;
+  }
+
+  uint8_t version;
+  uint32_t size;
+  serialization::readPod(file, version);
+  serialization::readPod(file, size);
+  // Only an unfinished cache from this version can be continued, and it has to hold everything before the offset
+  if (version != TEXT_CACHE_VERSION || size != 0 || file.size() < HEADER_SIZE + recordsOffset ||
+      !file.truncate(HEADER_SIZE + recordsOffset) || !file.seekEnd()) {
+    file.close();
+    return false;
+  }
+  recordsSize = 0;
+  return true;
+}
+
+bool ChapterTextCache::sync() { return file && out.flush() && file.sync(); }
+
+void ChapterTextCache::writeBlock(const uint8_t style) {
+  if (!file) {
+    return;
+  }
+  const uint8_t record[] = {BLOCK_TAG, style};
+  out.write(record, sizeof(record));
+}
+
+void ChapterTextCache::writeWord(const char* word, const EpdFontFamily::Style fontStyle) {
+  if (!file) {
+    return;
+  }
+  const size_t length = std::min(strlen(word), MAX_WORD_LENGTH);
+  const uint8_t record[] = {static_cast<uint8_t>(fontStyle), static_cast<uint8_t>(length)};
+  out.write(record, sizeof(record));
+  out.write(reinterpret_cast<const uint8_t*>(word), length);
+}
+
+bool ChapterTextCache::endWrite() {
+  if (!file) {
+    return false;
+  }
+  const uint32_t size = out.position() - HEADER_SIZE;
+  const bool flushed = out.flush();
+  file.seek(sizeof(TEXT_CACHE_VERSION));
+  serialization::writePod(file, size);
+  // A failed write on the way leaves the file shorter than the header says, so isValid rejects it
+  const bool ok = flushed && file.getWriteError() == 0;
+  file.close();
+  if (!ok) {
+    Serial.printf("[%lu] [CTC] Write error, dropping text cache %s\n", millis(), filePath.c_str());
+    remove();
+    return false;
+  }
+  recordsSize = size;
+  Serial.printf("[%lu] [CTC] Wrote text cache %s (%u bytes)\n", millis(), filePath.c_str(),
+                static_cast<unsigned>(size));
+  return true;
+}
+
+void ChapterTextCache::abortWrite() {
+  if (!file) {
+    return;
+  }
+  out.discard();
+  file.close();
+  remove();
+}
+
+void ChapterTextCache::suspendWrite() {
+  if (file) {
+    out.flush();
+    file.close();
+  }
+}
+
+bool ChapterTextCache::replay(const std::function<bool(uint8_t style)>& onBlock,
+                              const std::function<void(const char* word, EpdFontFamily::Style fontStyle)>& onWord,
+                              const std::function<void(int)>& progressFn, const uint32_t recordsOffset) {
+  if (recordsOffset > recordsSize) {
+    return false;
+  }
+  FsFile in;
+  if (!SdMan.openFileForRead("CTC", filePath, in)) {
+    return false;
+  }
+  BufferedFsReader records(in);
+  records.seek(HEADER_SIZE + recordsOffset);
+  uint32_t consumed = recordsOffset;
+  int lastProgress = -1;
+
+  char word[MAX_WORD_LENGTH + 1];
+  uint8_t record[2];
+  while (consumed < recordsSize) {
+    if (records.read(record, sizeof(record)) != sizeof(record)) {
+      break;
+    }
+    consumed += sizeof(record);
+
+    if (record[0] == BLOCK_TAG) {
+      if (!onBlock(record[1])) {
+        in.close();
+        return false;
+      }
+    } else {
+      if (records.read(reinterpret_cast<uint8_t*>(word), record[1]) != record[1]) {
+        break;
+      }
+      consumed += record[1];
+      word[record[1]] = '\0';
+      onWord(word, static_cast<EpdFontFamily::Style>(record[0]));
+    }
+
+    if (progressFn) {
+      const int progress = static_cast<int>(static_cast<uint64_t>(consumed) * 100 / recordsSize);
+      if (lastProgress / 10 != progress / 10) {
+        lastProgress = progress;
+        progressFn(progress);
+      }
+    }
+  }
+  in.close();
+
+  if (consumed != recordsSize) {
+    Serial.printf("[%lu] [CTC] Text cache %s is truncated\n", millis(), filePath.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <BufferedFsStream.h>
+#include <EpdFontFamily.h>
+#include <SdFat.h>
+
+#include <functional>
+#include <string>
+
+/**
+ * Layout independent copy of a chapter: the text blocks and styled words the HTML parser produced, stored at
+ * sections/<spine index>.text.bin next to the section file. Font, spacing, alignment and viewport changes only
+ * invalidate the section file; the pages are rebuilt from this cache without touching the ZIP or the XML parser.
+ * Format in docs/file-formats.md.
+ */
+class ChapterTextCache {
+  std::string filePath;
+  FsFile file;
+  // Records are a few bytes each, they are collected into sector sized writes
+  BufferedFsWriter out{file};
+  uint32_t recordsSize = 0;
+
+ public:
+  // Block style meaning "the paragraph alignment from the settings", resolved at layout time
+  static constexpr uint8_t PARAGRAPH_STYLE = 0x7F;
+  // Offsets into the cache (used to resume section builds) count record bytes, these are the record sizes
+  static constexpr uint32_t BLOCK_RECORD_SIZE = 2;
+  static uint32_t wordRecordSize(const char* word);
+
+  explicit ChapterTextCache(std::string filePath) : filePath(std::move(filePath)) {}
+  ~ChapterTextCache() { abortWrite(); }
+
+  // True if a complete cache written by this firmware version exists
+  bool isValid();
+  bool remove() const;
+
+  bool beginWrite();
+  // Continue an incomplete cache after its first recordsOffset bytes of records, dropping anything after them
+  bool resumeWrite(uint32_t recordsOffset);
+  // Make the records written so far durable, before a section build checkpoint refers to them
+  bool sync();
+  void writeBlock(uint8_t style);
+  void writeWord(const char* word, EpdFontFamily::Style fontStyle);
+  // Finish the file, it only becomes valid once this succeeds
+  bool endWrite();
+  // Drop a partially written file
+  void abortWrite();
+  // Close a partially written file but keep it, so resumeWrite can continue it
+  void suspendWrite();
+
+  /**
+   * Feed the stored blocks and words back in the order they were written.
+   * @param onBlock returns false to stop the replay before the block
+   * @param progressFn called with 0-100 as the file is read, may be null
+   * @param recordsOffset start at this record offset instead of the beginning
+   * @return false if the file is damaged or onBlock stopped the replay
+   */
+  bool replay(const std::function<bool(uint8_t style)>& onBlock,
+              const std::function<void(const char* word, EpdFontFamily::Style fontStyle)>& onWord,
+              const std::function<void(int)>& progressFn = nullptr, uint32_t recordsOffset = 0);
+
+  // Size of the stored records, known after isValid()
+  uint32_t getSize() const { return recordsSize; }
+};
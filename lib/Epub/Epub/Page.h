@@ -1,5 +1,5 @@
 #pragma once
-#include <SdFat.h>
+#include <BufferedFsStream.h>
 
 #include <utility>
 #include <vector>
@@ -18,7 +18,7 @@ class PageElement {
   explicit PageElement(const int16_t xPos, const int16_t yPos) : xPos(xPos), yPos(yPos) {}
   virtual ~PageElement() = default;
   virtual void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) = 0;
-  virtual bool serialize(FsFile& file) = 0;
+  virtual bool serialize(BufferedFsWriter& out) = 0;
 };
 
 // a line from a block element
@@ -29,8 +29,8 @@ class PageLine final : public PageElement {
   PageLine(std::shared_ptr<TextBlock> block, const int16_t xPos, const int16_t yPos)
       : PageElement(xPos, yPos), block(std::move(block)) {}
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) override;
-  bool serialize(FsFile& file) override;
-  static std::unique_ptr<PageLine> deserialize(FsFile& file);
+  bool serialize(BufferedFsWriter& out) override;
+  static std::unique_ptr<PageLine> deserialize(BufferedFsReader& in);
 };
 
 class Page {
@@ -38,6 +38,6 @@ class Page {
   // the list of block index and line numbers on this page
   std::vector<std::shared_ptr<PageElement>> elements;
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) const;
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<Page> deserialize(FsFile& file);
+  bool serialize(BufferedFsWriter& out) const;
+  static std::unique_ptr<Page> deserialize(BufferedFsReader& in);
 };
@@ -1,14 +1,20 @@
 #include "ParsedText.h"
 
 #include <GfxRenderer.h>
+#include <Trace.h>
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <vector>
 
+#include "hyphenation/Hyphenator.h"
+
 constexpr int MAX_COST = std::numeric_limits<int>::max();
+// Extra cost of ending a line with a hyphen, in space widths (squared like the slack it competes with)
+constexpr int HYPHEN_PENALTY_SPACES = 2;
 
 void ParsedText::addWord(std::string word, const EpdFontFamily::Style fontStyle) {
   if (word.empty()) return;
@@ -21,78 +27,155 @@ void ParsedText::addWord(std::string word, const EpdFontFamily::Style fontStyle)
 void ParsedText::layoutAndExtractLines(const GfxRenderer& renderer, const int fontId, const uint16_t viewportWidth,
                                        const std::function<void(std::shared_ptr<TextBlock>)>& processLine,
                                        const bool includeLastLine) {
+  TRACE_SPAN(LINE_BREAK);
   if (words.empty()) {
     return;
   }
 
   const int pageWidth = viewportWidth;
   const int spaceWidth = renderer.getSpaceWidth(fontId);
-  const auto wordWidths = calculateWordWidths(renderer, fontId);
-  const auto lineBreakIndices = computeLineBreaks(pageWidth, spaceWidth, wordWidths);
-  const size_t lineCount = includeLastLine ? lineBreakIndices.size() : lineBreakIndices.size() - 1;
+  const auto wordWidths = measureWords(renderer, fontId);
+  auto fragments = calculateFragments(renderer, fontId, wordWidths, {});
+  auto lineBreakIndices = computeLineBreaks(pageWidth, spaceWidth, fragments);
+
+  // Hyphenating every word made layout several times slower, as each one adds fragments to measure and line starts
+  // to the search. Only the words that overflow a line broken without hyphenation are split, and the lines are
+  // broken again with them.
+  if (hyphenator && lineBreakIndices.size() > 1) {
+    std::vector<bool> splitWords(words.size(), false);
+    // Without hyphenation every fragment is a whole word, a break index is the first word of the next line
+    for (const size_t nextLineStart : lineBreakIndices) {
+      if (nextLineStart < splitWords.size()) {
+        splitWords[nextLineStart] = true;
+      }
+    }
+    fragments = calculateFragments(renderer, fontId, wordWidths, splitWords);
+    lineBreakIndices = computeLineBreaks(pageWidth, spaceWidth, fragments);
+  }
 
-  for (size_t i = 0; i < lineCount; ++i) {
-    extractLine(i, pageWidth, spaceWidth, wordWidths, lineBreakIndices, processLine);
+  size_t lineCount = lineBreakIndices.size();
+  if (!includeLastLine) {
+    // The optimal breaks near the end of the window depend on text that hasn't been parsed yet. Only lines ending
+    // before the look-ahead are final, the rest is broken again with the next window.
+    const size_t settledWords = words.size() > LOOKAHEAD_WORDS ? words.size() - LOOKAHEAD_WORDS : 0;
+    size_t settledFragments = 0;
+    for (size_t counted = 0; counted < settledWords; settledFragments++) {
+      counted += fragments[settledFragments].endsWord ? 1 : 0;
+    }
+    lineCount--;
+    while (lineCount > 0 && lineBreakIndices[lineCount - 1] > settledFragments) {
+      lineCount--;
+    }
   }
-}
 
-std::vector<uint16_t> ParsedText::calculateWordWidths(const GfxRenderer& renderer, const int fontId) {
-  const size_t totalWordCount = words.size();
+  for (size_t i = 0; i < lineCount; ++i) {
+    extractLine(i, pageWidth, spaceWidth, fragments, lineBreakIndices, processLine);
+  }
 
-  std::vector<uint16_t> wordWidths;
-  wordWidths.reserve(totalWordCount);
+  // A line kept back for the next call may start in the middle of a hyphenated word. Drop the part already shown.
+  firstWordContinues = false;
+  if (lineCount > 0 && !words.empty()) {
+    const Fragment& lastExtracted = fragments[lineBreakIndices[lineCount - 1] - 1];
+    if (!lastExtracted.endsWord) {
+      words.front().erase(0, lastExtracted.end);
+      firstWordContinues = true;
+    }
+  }
+}
 
+std::vector<uint16_t> ParsedText::measureWords(const GfxRenderer& renderer, const int fontId) {
   // add em-space at the beginning of first word in paragraph to indent
-  if ((style == TextBlock::JUSTIFIED || style == TextBlock::LEFT_ALIGN) && !extraParagraphSpacing) {
+  if ((style == TextBlock::JUSTIFIED || style == TextBlock::LEFT_ALIGN) && !extraParagraphSpacing &&
+      !indentApplied) {
     std::string& first_word = words.front();
     first_word.insert(0, "\xe2\x80\x83");
   }
+  indentApplied = true;
+
+  std::vector<uint16_t> wordWidths;
+  wordWidths.reserve(words.size());
+  auto wordStylesIt = wordStyles.begin();
+  for (const auto& word : words) {
+    wordWidths.push_back(static_cast<uint16_t>(renderer.getTextWidth(fontId, word.c_str(), *wordStylesIt)));
+    std::advance(wordStylesIt, 1);
+  }
+  return wordWidths;
+}
+
+std::vector<ParsedText::Fragment> ParsedText::calculateFragments(const GfxRenderer& renderer, const int fontId,
+                                                                 const std::vector<uint16_t>& wordWidths,
+                                                                 const std::vector<bool>& splitWords) const {
+  std::vector<Fragment> fragments;
+  fragments.reserve(words.size());
+
+  int hyphenWidths[4] = {-1, -1, -1, -1};
+  std::vector<uint8_t> breaks;
+  char piece[256];
 
   auto wordsIt = words.begin();
   auto wordStylesIt = wordStyles.begin();
 
-  while (wordsIt != words.end()) {
-    wordWidths.push_back(renderer.getTextWidth(fontId, wordsIt->c_str(), *wordStylesIt));
+  for (size_t w = 0; w < wordWidths.size(); w++) {
+    const std::string& word = *wordsIt;
+    const auto wordEnd = static_cast<uint8_t>(std::min<size_t>(word.size(), 255));
+
+    breaks.clear();
+    if (hyphenator && w < splitWords.size() && splitWords[w] && !(firstWordContinues && w == 0)) {
+      hyphenator->hyphenate(word, breaks);
+    }
+
+    if (breaks.empty()) {
+      fragments.push_back({wordWidths[w], 0, wordEnd, 0, true});
+    } else {
+      int& hyphenWidth = hyphenWidths[*wordStylesIt & 3];
+      if (hyphenWidth < 0) {
+        hyphenWidth = renderer.getTextWidth(fontId, "-", *wordStylesIt);
+      }
+
+      uint8_t start = 0;
+      for (size_t i = 0; i <= breaks.size(); i++) {
+        const uint8_t end = i < breaks.size() ? breaks[i] : wordEnd;
+        memcpy(piece, word.data() + start, end - start);
+        piece[end - start] = '\0';
+        fragments.push_back({static_cast<uint16_t>(renderer.getTextWidth(fontId, piece, *wordStylesIt)), start, end,
+                             static_cast<uint8_t>(hyphenWidth), i == breaks.size()});
+        start = end;
+      }
+    }
 
     std::advance(wordsIt, 1);
     std::advance(wordStylesIt, 1);
   }
 
-  return wordWidths;
+  return fragments;
 }
 
 std::vector<size_t> ParsedText::computeLineBreaks(const int pageWidth, const int spaceWidth,
-                                                  const std::vector<uint16_t>& wordWidths) const {
-  const size_t totalWordCount = words.size();
+                                                  const std::vector<Fragment>& fragments) const {
+  const size_t totalFragmentCount = fragments.size();
+  const int hyphenPenalty = HYPHEN_PENALTY_SPACES * HYPHEN_PENALTY_SPACES * spaceWidth * spaceWidth;
 
-  // DP table to store the minimum badness (cost) of lines starting at index i
-  std::vector<int> dp(totalWordCount);
-  // 'ans[i]' stores the index 'j' of the *last word* in the optimal line starting at 'i'
-  std::vector<size_t> ans(totalWordCount);
+  // DP table to store the minimum badness (cost) of lines starting at fragment i
+  std::vector<int> dp(totalFragmentCount);
+  // 'ans[i]' stores the index 'j' of the *last fragment* in the optimal line starting at 'i'
+  std::vector<size_t> ans(totalFragmentCount);
 
   // Base Case
-  dp[totalWordCount - 1] = 0;
-  ans[totalWordCount - 1] = totalWordCount - 1;
+  dp[totalFragmentCount - 1] = 0;
+  ans[totalFragmentCount - 1] = totalFragmentCount - 1;
 
-  for (int i = totalWordCount - 2; i >= 0; --i) {
-    int currlen = -spaceWidth;
+  for (int i = totalFragmentCount - 2; i >= 0; --i) {
     dp[i] = MAX_COST;
 
-    for (size_t j = i; j < totalWordCount; ++j) {
-      // Current line length: previous width + space + current word width
-      currlen += wordWidths[j] + spaceWidth;
-
-      if (currlen > pageWidth) {
-        break;
-      }
-
+    const auto considerLineEnd = [&](const size_t j, const int lineLength, const bool hyphenated) {
       int cost;
-      if (j == totalWordCount - 1) {
+      if (j == totalFragmentCount - 1) {
         cost = 0;  // Last line
       } else {
-        const int remainingSpace = pageWidth - currlen;
+        const int remainingSpace = pageWidth - lineLength;
         // Use long long for the square to prevent overflow
-        const long long cost_ll = static_cast<long long>(remainingSpace) * remainingSpace + dp[j + 1];
+        const long long cost_ll = static_cast<long long>(remainingSpace) * remainingSpace +
+                                  (hyphenated ? hyphenPenalty : 0) + dp[j + 1];
 
         if (cost_ll > MAX_COST) {
           cost = MAX_COST;
@@ -103,16 +186,47 @@ std::vector<size_t> ParsedText::computeLineBreaks(const int pageWidth, const int
 
       if (cost < dp[i]) {
         dp[i] = cost;
-        ans[i] = j;  // j is the index of the last word in this optimal line
+        ans[i] = j;  // j is the index of the last fragment in this optimal line
+      }
+    };
+
+    // Add whole words while they fit. Only the word that overflows the line is tried at its hyphenation points.
+    int currlen = -spaceWidth;
+    size_t j = i;
+    while (j < totalFragmentCount) {
+      size_t wordEnd = j;
+      int wordWidth = fragments[j].width;
+      while (!fragments[wordEnd].endsWord) {
+        wordWidth += fragments[++wordEnd].width;
+      }
+
+      // Current line length: previous width + space + current word width
+      currlen += spaceWidth;
+      if (currlen + wordWidth <= pageWidth) {
+        currlen += wordWidth;
+        considerLineEnd(wordEnd, currlen, false);
+        j = wordEnd + 1;
+        continue;
       }
+
+      int partialLength = currlen;
+      for (size_t k = j; k < wordEnd; k++) {
+        partialLength += fragments[k].width;
+        const int lineLength = partialLength + fragments[k].hyphenWidth;
+        if (lineLength > pageWidth) {
+          break;
+        }
+        considerLineEnd(k, lineLength, true);
+      }
+      break;
     }
 
-    // Handle oversized word: if no valid configuration found, force single-word line
+    // Handle oversized word: if no valid configuration found, force single-fragment line
     // This prevents cascade failure where one oversized word breaks all preceding words
     if (dp[i] == MAX_COST) {
-      ans[i] = i;  // Just this word on its own line
-      // Inherit cost from next word to allow subsequent words to find valid configurations
-      if (i + 1 < static_cast<int>(totalWordCount)) {
+      ans[i] = i;  // Just this fragment on its own line
+      // Inherit cost from next fragment to allow subsequent fragments to find valid configurations
+      if (i + 1 < static_cast<int>(totalFragmentCount)) {
         dp[i] = dp[i + 1];
       } else {
         dp[i] = 0;
@@ -120,37 +234,42 @@ std::vector<size_t> ParsedText::computeLineBreaks(const int pageWidth, const int
     }
   }
 
-  // Stores the index of the word that starts the next line (last_word_index + 1)
+  // Stores the index of the fragment that starts the next line (last_fragment_index + 1)
   std::vector<size_t> lineBreakIndices;
-  size_t currentWordIndex = 0;
+  size_t currentFragmentIndex = 0;
 
-  while (currentWordIndex < totalWordCount) {
-    size_t nextBreakIndex = ans[currentWordIndex] + 1;
+  while (currentFragmentIndex < totalFragmentCount) {
+    size_t nextBreakIndex = ans[currentFragmentIndex] + 1;
 
     // Safety check: prevent infinite loop if nextBreakIndex doesn't advance
-    if (nextBreakIndex <= currentWordIndex) {
-      // Force advance by at least one word to avoid infinite loop
-      nextBreakIndex = currentWordIndex + 1;
+    if (nextBreakIndex <= currentFragmentIndex) {
+      // Force advance by at least one fragment to avoid infinite loop
+      nextBreakIndex = currentFragmentIndex + 1;
     }
 
     lineBreakIndices.push_back(nextBreakIndex);
-    currentWordIndex = nextBreakIndex;
+    currentFragmentIndex = nextBreakIndex;
   }
 
   return lineBreakIndices;
 }
 
 void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const int spaceWidth,
-                             const std::vector<uint16_t>& wordWidths, const std::vector<size_t>& lineBreakIndices,
+                             const std::vector<Fragment>& fragments, const std::vector<size_t>& lineBreakIndices,
                              const std::function<void(std::shared_ptr<TextBlock>)>& processLine) {
   const size_t lineBreak = lineBreakIndices[breakIndex];
   const size_t lastBreakAt = breakIndex > 0 ? lineBreakIndices[breakIndex - 1] : 0;
-  const size_t lineWordCount = lineBreak - lastBreakAt;
+  const bool endsMidWord = !fragments[lineBreak - 1].endsWord;
 
-  // Calculate total word width for this line
+  // Calculate total width and the number of (possibly partial) words drawn on this line
   int lineWordWidthSum = 0;
+  size_t lineWordCount = endsMidWord ? 1 : 0;
   for (size_t i = lastBreakAt; i < lineBreak; i++) {
-    lineWordWidthSum += wordWidths[i];
+    lineWordWidthSum += fragments[i].width;
+    lineWordCount += fragments[i].endsWord ? 1 : 0;
+  }
+  if (endsMidWord) {
+    lineWordWidthSum += fragments[lineBreak - 1].hyphenWidth;
   }
 
   // Calculate spacing
@@ -173,23 +292,45 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
 
   // Pre-calculate X positions for words
   std::list<uint16_t> lineXPos;
+  int currentWordWidth = 0;
   for (size_t i = lastBreakAt; i < lineBreak; i++) {
-    const uint16_t currentWordWidth = wordWidths[i];
-    lineXPos.push_back(xpos);
-    xpos += currentWordWidth + spacing;
+    currentWordWidth += fragments[i].width;
+    if (fragments[i].endsWord || i == lineBreak - 1) {
+      lineXPos.push_back(xpos);
+      xpos += currentWordWidth + spacing;
+      currentWordWidth = 0;
+    }
   }
 
-  // Iterators always start at the beginning as we are moving content with splice below
-  auto wordEndIt = words.begin();
-  auto wordStyleEndIt = wordStyles.begin();
-  std::advance(wordEndIt, lineWordCount);
-  std::advance(wordStyleEndIt, lineWordCount);
-
   // *** CRITICAL STEP: CONSUME DATA USING SPLICE ***
+  // Whole words are moved out of the paragraph, pieces of hyphenated words are copied out. The word a line
+  // breaks inside stays at the front of the list until its last piece has been extracted.
   std::list<std::string> lineWords;
-  lineWords.splice(lineWords.begin(), words, words.begin(), wordEndIt);
   std::list<EpdFontFamily::Style> lineWordStyles;
-  lineWordStyles.splice(lineWordStyles.begin(), wordStyles, wordStyles.begin(), wordStyleEndIt);
+  size_t pieceStart = lastBreakAt;
+  for (size_t i = lastBreakAt; i < lineBreak; i++) {
+    if (!fragments[i].endsWord && i != lineBreak - 1) {
+      continue;
+    }
+
+    const uint8_t start = fragments[pieceStart].start;
+    if (start == 0 && fragments[i].endsWord) {
+      lineWords.splice(lineWords.end(), words, words.begin());
+      lineWordStyles.splice(lineWordStyles.end(), wordStyles, wordStyles.begin());
+    } else {
+      std::string piece = words.front().substr(start, fragments[i].end - start);
+      if (!fragments[i].endsWord && fragments[i].hyphenWidth > 0) {
+        piece += '-';
+      }
+      lineWords.push_back(std::move(piece));
+      lineWordStyles.push_back(wordStyles.front());
+      if (fragments[i].endsWord) {
+        words.pop_front();
+        wordStyles.pop_front();
+      }
+    }
+    pieceStart = i + 1;
+  }
 
   processLine(std::make_shared<TextBlock>(std::move(lineWords), std::move(lineXPos), std::move(lineWordStyles), style));
 }
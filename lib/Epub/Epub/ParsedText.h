@@ -11,22 +11,47 @@
 #include "blocks/TextBlock.h"
 
 class GfxRenderer;
+class Hyphenator;
 
 class ParsedText {
+  // Unit of line breaking: a whole word or, when hyphenation splits it, a run of syllables
+  struct Fragment {
+    uint16_t width;
+    uint8_t start;  // byte range within the word
+    uint8_t end;
+    uint8_t hyphenWidth;  // width of the hyphen drawn if a line ends here mid-word
+    bool endsWord;
+  };
+
   std::list<std::string> words;
   std::list<EpdFontFamily::Style> wordStyles;
   TextBlock::Style style;
   bool extraParagraphSpacing;
+  const Hyphenator* hyphenator;
+  // The first word is what's left of a word hyphenated by the previous layoutAndExtractLines call
+  bool firstWordContinues = false;
+  // The paragraph indent was added to the first word, it must only be added once per paragraph
+  bool indentApplied = false;
 
-  std::vector<size_t> computeLineBreaks(int pageWidth, int spaceWidth, const std::vector<uint16_t>& wordWidths) const;
-  void extractLine(size_t breakIndex, int pageWidth, int spaceWidth, const std::vector<uint16_t>& wordWidths,
+  std::vector<size_t> computeLineBreaks(int pageWidth, int spaceWidth, const std::vector<Fragment>& fragments) const;
+  void extractLine(size_t breakIndex, int pageWidth, int spaceWidth, const std::vector<Fragment>& fragments,
                    const std::vector<size_t>& lineBreakIndices,
                    const std::function<void(std::shared_ptr<TextBlock>)>& processLine);
-  std::vector<uint16_t> calculateWordWidths(const GfxRenderer& renderer, int fontId);
+  std::vector<uint16_t> measureWords(const GfxRenderer& renderer, int fontId);
+  // Words flagged in splitWords are split at their hyphenation points, the others are whole fragments
+  std::vector<Fragment> calculateFragments(const GfxRenderer& renderer, int fontId,
+                                           const std::vector<uint16_t>& wordWidths,
+                                           const std::vector<bool>& splitWords) const;
 
  public:
-  explicit ParsedText(const TextBlock::Style style, const bool extraParagraphSpacing)
-      : style(style), extraParagraphSpacing(extraParagraphSpacing) {}
+  // Buffered words at which a paragraph that is still being parsed should be laid out (see layoutAndExtractLines)
+  static constexpr size_t LAYOUT_WINDOW_WORDS = 768;
+  // Words at the end of the window whose line breaks are not final until more of the paragraph is known
+  static constexpr size_t LOOKAHEAD_WORDS = 256;
+
+  explicit ParsedText(const TextBlock::Style style, const bool extraParagraphSpacing,
+                      const Hyphenator* hyphenator = nullptr)
+      : style(style), extraParagraphSpacing(extraParagraphSpacing), hyphenator(hyphenator) {}
   ~ParsedText() = default;
 
   void addWord(std::string word, EpdFontFamily::Style fontStyle);
@@ -34,6 +59,12 @@ class ParsedText {
   TextBlock::Style getStyle() const { return style; }
   size_t size() const { return words.size(); }
   bool isEmpty() const { return words.empty(); }
+  /**
+   * Break the buffered words into lines and hand the lines to processLine, consuming their words.
+   * With includeLastLine false the paragraph continues after the buffered words: lines ending within the last
+   * LOOKAHEAD_WORDS words are held back and broken again together with the words added next. Calling this
+   * whenever LAYOUT_WINDOW_WORDS are buffered lays out a paragraph of any length in bounded memory.
+   */
   void layoutAndExtractLines(const GfxRenderer& renderer, int fontId, uint16_t viewportWidth,
                              const std::function<void(std::shared_ptr<TextBlock>)>& processLine,
                              bool includeLastLine = true);
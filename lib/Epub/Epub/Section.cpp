@@ -2,24 +2,31 @@
 
 #include <SDCardManager.h>
 #include <Serialization.h>
+#include <Trace.h>
 
+#include "ChapterTextCache.h"
 #include "Page.h"
+#include "hyphenation/Hyphenator.h"
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-constexpr uint8_t SECTION_FILE_VERSION = 9;
+constexpr uint8_t SECTION_FILE_VERSION = 10;
+constexpr uint8_t CHECKPOINT_VERSION = 1;
+// Pages laid out between checkpoints. Each one syncs the section file, so this trades SD writes for lost work.
+constexpr uint16_t CHECKPOINT_INTERVAL_PAGES = 8;
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
-                                 sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint32_t);
+                                 sizeof(bool) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) +
+                                 sizeof(uint32_t);
 }  // namespace
 
-uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
+uint32_t Section::onPageComplete(BufferedFsWriter& out, std::unique_ptr<Page> page) {
   if (!file) {
     Serial.printf("[%lu] [SCT] File not open for writing page %d\n", millis(), pageCount);
     return 0;
   }
 
-  const uint32_t position = file.position();
-  if (!page->serialize(file)) {
+  const uint32_t position = out.position();
+  if (!page->serialize(out)) {
     Serial.printf("[%lu] [SCT] Failed to serialize page %d\n", millis(), pageCount);
     return 0;
   }
@@ -29,76 +36,120 @@ uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
   return position;
 }
 
-void Section::writeSectionFileHeader(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
-                                     const uint8_t paragraphAlignment, const uint16_t viewportWidth,
+void Section::writeSectionFileHeader(BufferedFsWriter& out, const int fontId, const float lineCompression,
+                                     const bool extraParagraphSpacing, const uint8_t paragraphAlignment,
+                                     const bool hyphenation, const uint16_t viewportWidth,
                                      const uint16_t viewportHeight) {
   if (!file) {
     Serial.printf("[%lu] [SCT] File not open for writing header\n", millis());
     return;
   }
   static_assert(HEADER_SIZE == sizeof(SECTION_FILE_VERSION) + sizeof(fontId) + sizeof(lineCompression) +
-                                   sizeof(extraParagraphSpacing) + sizeof(paragraphAlignment) + sizeof(viewportWidth) +
-                                   sizeof(viewportHeight) + sizeof(pageCount) + sizeof(uint32_t),
+                                   sizeof(extraParagraphSpacing) + sizeof(paragraphAlignment) + sizeof(hyphenation) +
+                                   sizeof(viewportWidth) + sizeof(viewportHeight) + sizeof(pageCount) +
+                                   sizeof(uint32_t),
                 "Header size mismatch");
-  serialization::writePod(file, SECTION_FILE_VERSION);
-  serialization::writePod(file, fontId);
-  serialization::writePod(file, lineCompression);
-  serialization::writePod(file, extraParagraphSpacing);
-  serialization::writePod(file, paragraphAlignment);
-  serialization::writePod(file, viewportWidth);
-  serialization::writePod(file, viewportHeight);
-  serialization::writePod(file, pageCount);  // Placeholder for page count (will be initially 0 when written)
-  serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for LUT offset
+  serialization::writePod(out, SECTION_FILE_VERSION);
+  serialization::writePod(out, fontId);
+  serialization::writePod(out, lineCompression);
+  serialization::writePod(out, extraParagraphSpacing);
+  serialization::writePod(out, paragraphAlignment);
+  serialization::writePod(out, hyphenation);
+  serialization::writePod(out, viewportWidth);
+  serialization::writePod(out, viewportHeight);
+  serialization::writePod(out, pageCount);  // Placeholder for page count (will be initially 0 when written)
+  serialization::writePod(out, static_cast<uint32_t>(0));  // Placeholder for LUT offset
+}
+
+bool Section::readSectionFileHeader(BufferedFsReader& in, const int fontId, const float lineCompression,
+                                    const bool extraParagraphSpacing, const uint8_t paragraphAlignment,
+                                    const bool hyphenation, const uint16_t viewportWidth,
+                                    const uint16_t viewportHeight) {
+  uint8_t version;
+  serialization::readPod(in, version);
+  if (version != SECTION_FILE_VERSION) {
+    Serial.printf("[%lu] [SCT] Deserialization failed: Unknown version %u\n", millis(), version);
+    return false;
+  }
+
+  int fileFontId;
+  uint16_t fileViewportWidth, fileViewportHeight;
+  float fileLineCompression;
+  bool fileExtraParagraphSpacing;
+  uint8_t fileParagraphAlignment;
+  bool fileHyphenation;
+  serialization::readPod(in, fileFontId);
+  serialization::readPod(in, fileLineCompression);
+  serialization::readPod(in, fileExtraParagraphSpacing);
+  serialization::readPod(in, fileParagraphAlignment);
+  serialization::readPod(in, fileHyphenation);
+  serialization::readPod(in, fileViewportWidth);
+  serialization::readPod(in, fileViewportHeight);
+
+  if (fontId != fileFontId || lineCompression != fileLineCompression ||
+      extraParagraphSpacing != fileExtraParagraphSpacing || paragraphAlignment != fileParagraphAlignment ||
+      hyphenation != fileHyphenation || viewportWidth != fileViewportWidth || viewportHeight != fileViewportHeight) {
+    Serial.printf("[%lu] [SCT] Deserialization failed: Parameters do not match\n", millis());
+    return false;
+  }
+  return true;
 }
 
 bool Section::loadSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
-                              const uint8_t paragraphAlignment, const uint16_t viewportWidth,
-                              const uint16_t viewportHeight) {
+                              const uint8_t paragraphAlignment, const bool hyphenation,
+                              const uint16_t viewportWidth, const uint16_t viewportHeight) {
   if (!SdMan.openFileForRead("SCT", filePath, file)) {
     return false;
   }
 
   // Match parameters
-  {
-    uint8_t version;
-    serialization::readPod(file, version);
-    if (version != SECTION_FILE_VERSION) {
-      file.close();
-      Serial.printf("[%lu] [SCT] Deserialization failed: Unknown version %u\n", millis(), version);
-      clearCache();
-      return false;
-    }
+  BufferedFsReader in(file);
+  if (!readSectionFileHeader(in, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, hyphenation,
+                             viewportWidth, viewportHeight)) {
+    file.close();
+    clearCache();
+    return false;
+  }
 
-    int fileFontId;
-    uint16_t fileViewportWidth, fileViewportHeight;
-    float fileLineCompression;
-    bool fileExtraParagraphSpacing;
-    uint8_t fileParagraphAlignment;
-    serialization::readPod(file, fileFontId);
-    serialization::readPod(file, fileLineCompression);
-    serialization::readPod(file, fileExtraParagraphSpacing);
-    serialization::readPod(file, fileParagraphAlignment);
-    serialization::readPod(file, fileViewportWidth);
-    serialization::readPod(file, fileViewportHeight);
-
-    if (fontId != fileFontId || lineCompression != fileLineCompression ||
-        extraParagraphSpacing != fileExtraParagraphSpacing || paragraphAlignment != fileParagraphAlignment ||
-        viewportWidth != fileViewportWidth || viewportHeight != fileViewportHeight) {
-      file.close();
-      Serial.printf("[%lu] [SCT] Deserialization failed: Parameters do not match\n", millis());
-      clearCache();
+  // An unfinished build for the same settings is continued by createSectionFile, the pages it already wrote can be
+  // read in the meantime
+  if (SdMan.exists(checkpointPath.c_str())) {
+    file.close();
+    uint32_t textOffset, sectionSize;
+    int16_t nextY;
+    complete = false;
+    if (!readCheckpoint(textOffset, sectionSize, nextY, partialLut, nullptr) || partialLut.empty()) {
+      Serial.printf("[%lu] [SCT] Section build is incomplete\n", millis());
+      pageCount = 0;
       return false;
     }
+    pageCount = partialLut.size();
+    Serial.printf("[%lu] [SCT] Section build is incomplete, %d pages available\n", millis(), pageCount);
+    return true;
   }
 
-  serialization::readPod(file, pageCount);
+  uint32_t lutOffset;
+  serialization::readPod(in, pageCount);
+  serialization::readPod(in, lutOffset);
   file.close();
+  // Page count and LUT offset are filled in last, a build that died before that left them at 0
+  if (lutOffset == 0) {
+    Serial.printf("[%lu] [SCT] Deserialization failed: Section file is incomplete\n", millis());
+    pageCount = 0;
+    return false;
+  }
+  complete = true;
+  partialLut.clear();
   Serial.printf("[%lu] [SCT] Deserialization succeeded: %d pages\n", millis(), pageCount);
   return true;
 }
 
 // Your updated class method (assuming you are using the 'SD' object, which is a wrapper for a specific filesystem)
 bool Section::clearCache() const {
+  if (SdMan.exists(checkpointPath.c_str())) {
+    SdMan.remove(checkpointPath.c_str());
+  }
+
   if (!SdMan.exists(filePath.c_str())) {
     Serial.printf("[%lu] [SCT] Cache does not exist, no action needed\n", millis());
     return true;
@@ -113,23 +164,11 @@ bool Section::clearCache() const {
   return true;
 }
 
-bool Section::createSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
-                                const uint8_t paragraphAlignment, const uint16_t viewportWidth,
-                                const uint16_t viewportHeight, const std::function<void()>& progressSetupFn,
-                                const std::function<void(int)>& progressFn) {
-  constexpr uint32_t MIN_SIZE_FOR_PROGRESS = 50 * 1024;  // 50KB
+bool Section::streamItemToTempFile(const std::string& tmpHtmlPath, uint32_t& fileSize) const {
   const auto localPath = epub->getSpineItem(spineIndex).href;
-  const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
-
-  // Create cache directory if it doesn't exist
-  {
-    const auto sectionsDir = epub->getCachePath() + "/sections";
-    SdMan.mkdir(sectionsDir.c_str());
-  }
 
   // Retry logic for SD card timing issues
   bool success = false;
-  uint32_t fileSize = 0;
   for (int attempt = 0; attempt < 3 && !success; attempt++) {
     if (attempt > 0) {
       Serial.printf("[%lu] [SCT] Retrying stream (attempt %d)...\n", millis(), attempt + 1);
@@ -162,35 +201,279 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   }
 
   Serial.printf("[%lu] [SCT] Streamed temp HTML to %s (%d bytes)\n", millis(), tmpHtmlPath.c_str(), fileSize);
+  return true;
+}
+
+bool Section::canReuseTempFile(const std::string& tmpHtmlPath, uint32_t& fileSize) const {
+  size_t itemSize;
+  FsFile tmpHtml;
+  if (!SdMan.exists(tmpHtmlPath.c_str()) || !epub->getItemSize(epub->getSpineItem(spineIndex).href, &itemSize) ||
+      !SdMan.openFileForRead("SCT", tmpHtmlPath, tmpHtml)) {
+    return false;
+  }
+  fileSize = tmpHtml.size();
+  tmpHtml.close();
+  // Anything else is left over from an inflate that was cut short
+  if (fileSize != itemSize) {
+    return false;
+  }
+  Serial.printf("[%lu] [SCT] Reusing temp HTML %s (%u bytes)\n", millis(), tmpHtmlPath.c_str(),
+                static_cast<unsigned>(fileSize));
+  return true;
+}
+
+// The checkpoint holds everything needed to continue a build at the start of a block: how far into the chapter text
+// it got, how much of the section file is valid, the page LUT so far and the page that was being filled.
+bool Section::writeCheckpoint(BufferedFsWriter& out, const uint32_t textOffset, const Page* currentPage,
+                              const int16_t currentPageNextY, const std::vector<uint32_t>& lut,
+                              ChapterTextCache* textCache) {
+  // The checkpoint must never point past data that could still be lost
+  if (!out.flush() || !file.sync() || (textCache && !textCache->sync())) {
+    Serial.printf("[%lu] [SCT] Failed to sync before checkpoint\n", millis());
+    return false;
+  }
+
+  FsFile checkpoint;
+  if (!SdMan.openFileForWrite("SCT", checkpointPath, checkpoint)) {
+    return false;
+  }
+  BufferedFsWriter checkpointOut(checkpoint);
+  serialization::writePod(checkpointOut, CHECKPOINT_VERSION);
+  serialization::writePod(checkpointOut, static_cast<uint32_t>(0));  // Checkpoint size, written last
+  serialization::writePod(checkpointOut, textOffset);
+  serialization::writePod(checkpointOut, static_cast<uint32_t>(file.position()));
+  serialization::writePod(checkpointOut, pageCount);
+  serialization::writePod(checkpointOut, currentPageNextY);
+  for (const uint32_t pos : lut) {
+    serialization::writePod(checkpointOut, pos);
+  }
+  const bool hasPage = currentPage != nullptr;
+  serialization::writePod(checkpointOut, hasPage);
+  bool ok = !hasPage || currentPage->serialize(checkpointOut);
+
+  // A checkpoint cut short keeps a size of 0 and is ignored
+  const uint32_t size = checkpointOut.position();
+  ok = checkpointOut.flush() && ok;
+  checkpoint.seek(sizeof(CHECKPOINT_VERSION));
+  serialization::writePod(checkpoint, size);
+  ok = ok && checkpoint.getWriteError() == 0;
+  checkpoint.close();
+  if (!ok) {
+    SdMan.remove(checkpointPath.c_str());
+    return false;
+  }
+
+  Serial.printf("[%lu] [SCT] Checkpoint at page %u, text offset %u\n", millis(), pageCount,
+                static_cast<unsigned>(textOffset));
+  return true;
+}
+
+bool Section::readCheckpoint(uint32_t& textOffset, uint32_t& sectionSize, int16_t& currentPageNextY,
+                             std::vector<uint32_t>& lut, std::unique_ptr<Page>* currentPage) const {
+  FsFile checkpoint;
+  if (!SdMan.exists(checkpointPath.c_str()) || !SdMan.openFileForRead("SCT", checkpointPath, checkpoint)) {
+    return false;
+  }
+
+  BufferedFsReader in(checkpoint);
+  uint8_t version;
+  uint32_t size;
+  uint16_t checkpointPageCount;
+  serialization::readPod(in, version);
+  serialization::readPod(in, size);
+  bool ok = version == CHECKPOINT_VERSION && size == checkpoint.size();
+  if (ok) {
+    serialization::readPod(in, textOffset);
+    serialization::readPod(in, sectionSize);
+    serialization::readPod(in, checkpointPageCount);
+    serialization::readPod(in, currentPageNextY);
+    lut.resize(checkpointPageCount);
+    for (uint32_t& pos : lut) {
+      serialization::readPod(in, pos);
+    }
+    bool hasPage;
+    serialization::readPod(in, hasPage);
+    if (hasPage && currentPage) {
+      *currentPage = Page::deserialize(in);
+      ok = *currentPage != nullptr;
+    }
+  }
+  checkpoint.close();
+  if (!ok) {
+    lut.clear();
+  }
+  return ok;
+}
+
+bool Section::resumeFromCheckpoint(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
+                                   const uint8_t paragraphAlignment, const bool hyphenation,
+                                   const uint16_t viewportWidth, const uint16_t viewportHeight,
+                                   uint32_t& textOffset, std::unique_ptr<Page>& currentPage,
+                                   int16_t& currentPageNextY, std::vector<uint32_t>& lut) {
+  if (!SdMan.exists(checkpointPath.c_str())) {
+    return false;
+  }
+
+  uint32_t sectionSize;
+  bool ok = readCheckpoint(textOffset, sectionSize, currentPageNextY, lut, &currentPage);
+
+  // The pages written before the checkpoint have to be there, laid out with the same settings
+  if (ok) {
+    file = SdMan.open(filePath.c_str(), O_RDWR);
+    BufferedFsReader in(file);
+    ok = file && readSectionFileHeader(in, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment,
+                                       hyphenation, viewportWidth, viewportHeight) &&
+         file.size() >= sectionSize && file.truncate(sectionSize) && file.seekEnd();
+  }
+
+  if (!ok) {
+    Serial.printf("[%lu] [SCT] Discarding unusable build checkpoint\n", millis());
+    if (file) {
+      file.close();
+    }
+    SdMan.remove(checkpointPath.c_str());
+    lut.clear();
+    currentPage.reset();
+    return false;
+  }
+
+  pageCount = lut.size();
+  Serial.printf("[%lu] [SCT] Resuming build at page %u\n", millis(), pageCount);
+  return true;
+}
+
+bool Section::createSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
+                                const uint8_t paragraphAlignment, const bool hyphenation,
+                                const uint16_t viewportWidth, const uint16_t viewportHeight,
+                                const std::function<void()>& progressSetupFn,
+                                const std::function<void(int)>& progressFn,
+                                const std::function<bool()>& shouldStop) {
+  TRACE_SPAN(SECTION_BUILD);
+  constexpr uint32_t MIN_SIZE_FOR_PROGRESS = 50 * 1024;  // 50KB
+  const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
+
+  // Create cache directory if it doesn't exist
+  {
+    const auto sectionsDir = epub->getCachePath() + "/sections";
+    SdMan.mkdir(sectionsDir.c_str());
+  }
+
+  // The text cache survives layout setting changes. With it the chapter is only laid out again, without inflating
+  // and parsing the HTML.
+  ChapterTextCache textCache(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".text.bin");
+  const bool haveTextCache = textCache.isValid();
+
+  std::vector<uint32_t> lut = {};
+  complete = false;
+  partialLut.clear();
+  uint32_t resumeOffset = 0;
+  std::unique_ptr<Page> resumePage;
+  int16_t resumePageNextY = 0;
+  pageCount = 0;
+  const bool resuming =
+      resumeFromCheckpoint(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, hyphenation,
+                           viewportWidth, viewportHeight, resumeOffset, resumePage, resumePageNextY, lut);
+
+  uint32_t fileSize = 0;
+  if (haveTextCache) {
+    fileSize = textCache.getSize();
+    Serial.printf("[%lu] [SCT] Laying out from text cache (%u bytes)\n", millis(), static_cast<unsigned>(fileSize));
+  } else if (!(resuming && canReuseTempFile(tmpHtmlPath, fileSize)) && !streamItemToTempFile(tmpHtmlPath, fileSize)) {
+    if (resuming) {
+      file.close();
+    }
+    return false;
+  }
 
   // Only show progress bar for larger chapters where rendering overhead is worth it
   if (progressSetupFn && fileSize >= MIN_SIZE_FOR_PROGRESS) {
     progressSetupFn();
   }
 
-  if (!SdMan.openFileForWrite("SCT", filePath, file)) {
-    return false;
+  // Pages are small and written a few bytes at a time, they reach the file in sector sized writes
+  BufferedFsWriter out(file);
+  if (!resuming) {
+    if (!SdMan.openFileForWrite("SCT", filePath, file)) {
+      return false;
+    }
+    writeSectionFileHeader(out, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, hyphenation,
+                           viewportWidth, viewportHeight);
   }
-  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-                         viewportHeight);
-  std::vector<uint32_t> lut = {};
 
+  // Pattern packs are loaded on first use and kept while chapters in the same language are built
+  const Hyphenator* hyphenator = hyphenation ? Hyphenator::forLanguage(epub->getLanguage()) : nullptr;
+
+  // Keep the parsed text for the next layout. Building the pages doesn't depend on the text cache being written.
+  // A resumed parse continues the text cache it was writing before.
+  bool writingTextCache = false;
+  if (!haveTextCache) {
+    writingTextCache = resuming ? textCache.resumeWrite(resumeOffset) : textCache.beginWrite();
+  }
+
+  uint16_t checkpointPageCount = pageCount;
   ChapterHtmlSlimParser visitor(
       tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-      viewportHeight,
-      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
-      progressFn);
-  success = visitor.parseAndBuildPages();
+      viewportHeight, hyphenator,
+      [this, &lut, &out](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(out, std::move(page))); },
+      progressFn,
+      [&](const uint32_t textOffset, const Page* currentPage, const int16_t currentPageNextY) {
+        const bool stop = shouldStop && shouldStop();
+        if (stop || pageCount >= checkpointPageCount + CHECKPOINT_INTERVAL_PAGES) {
+          writeCheckpoint(out, textOffset, currentPage, currentPageNextY, lut, writingTextCache ? &textCache : nullptr);
+          checkpointPageCount = pageCount;
+        }
+        return !stop;
+      });
+  if (resuming) {
+    visitor.resumeFrom(resumeOffset, std::move(resumePage), resumePageNextY);
+  }
+
+  buildOut = &out;
+  buildLut = &lut;
+  bool success;
+  if (haveTextCache) {
+    success = visitor.buildPagesFromTextCache(textCache);
+    if (!success && !visitor.wasStopped()) {
+      // Parse the HTML again next time
+      textCache.remove();
+    }
+  } else {
+    success = visitor.parseAndBuildPages(writingTextCache ? &textCache : nullptr);
+    // A stopped build keeps the inflated HTML for when it continues
+    if (!visitor.wasStopped()) {
+      SdMan.remove(tmpHtmlPath.c_str());
+    }
+    if (success && writingTextCache) {
+      textCache.endWrite();
+    } else if (visitor.wasStopped()) {
+      textCache.suspendWrite();
+    } else {
+      textCache.abortWrite();
+    }
+  }
+  buildOut = nullptr;
+  buildLut = nullptr;
+
+  if (visitor.wasStopped()) {
+    // The section file and checkpoint stay for the next call. Everything up to the checkpoint is synced, so the pages
+    // laid out so far can be read until then.
+    Serial.printf("[%lu] [SCT] Build stopped after %u pages\n", millis(), pageCount);
+    out.flush();
+    file.close();
+    partialLut = std::move(lut);
+    return true;
+  }
 
-  SdMan.remove(tmpHtmlPath.c_str());
   if (!success) {
     Serial.printf("[%lu] [SCT] Failed to parse XML and build pages\n", millis());
+    out.discard();
     file.close();
     SdMan.remove(filePath.c_str());
+    SdMan.remove(checkpointPath.c_str());
     return false;
   }
 
-  const uint32_t lutOffset = file.position();
+  const uint32_t lutOffset = out.position();
   bool hasFailedLutRecords = false;
   // Write LUT
   for (const uint32_t& pos : lut) {
@@ -198,38 +481,78 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
       hasFailedLutRecords = true;
       break;
     }
-    serialization::writePod(file, pos);
+    serialization::writePod(out, pos);
   }
 
   if (hasFailedLutRecords) {
     Serial.printf("[%lu] [SCT] Failed to write LUT due to invalid page positions\n", millis());
+    out.discard();
     file.close();
     SdMan.remove(filePath.c_str());
+    SdMan.remove(checkpointPath.c_str());
     return false;
   }
 
   // Go back and write LUT offset
+  out.flush();
   file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
   serialization::writePod(file, pageCount);
   serialization::writePod(file, lutOffset);
   file.close();
+  if (SdMan.exists(checkpointPath.c_str())) {
+    SdMan.remove(checkpointPath.c_str());
+  }
+  complete = true;
   return true;
 }
 
+// The build keeps writing the section file, the page is read through a second handle once it is on SD
+std::unique_ptr<Page> Section::loadPageDuringBuild() {
+  if (currentPage < 0 || currentPage >= static_cast<int>(buildLut->size()) || (*buildLut)[currentPage] == 0) {
+    return nullptr;
+  }
+  if (!buildOut->flush() || !file.sync()) {
+    Serial.printf("[%lu] [SCT] Failed to sync section file to load page %d\n", millis(), currentPage);
+    return nullptr;
+  }
+
+  FsFile pageFile;
+  if (!SdMan.openFileForRead("SCT", filePath, pageFile)) {
+    return nullptr;
+  }
+  BufferedFsReader in(pageFile);
+  in.seek((*buildLut)[currentPage]);
+  auto page = Page::deserialize(in);
+  pageFile.close();
+  return page;
+}
+
 std::unique_ptr<Page> Section::loadPageFromSectionFile() {
+  if (buildOut) {
+    return loadPageDuringBuild();
+  }
   if (!SdMan.openFileForRead("SCT", filePath, file)) {
     return nullptr;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t));
-  uint32_t lutOffset;
-  serialization::readPod(file, lutOffset);
-  file.seek(lutOffset + sizeof(uint32_t) * currentPage);
+  BufferedFsReader in(file);
   uint32_t pagePos;
-  serialization::readPod(file, pagePos);
-  file.seek(pagePos);
+  if (complete) {
+    in.seek(HEADER_SIZE - sizeof(uint32_t));
+    uint32_t lutOffset;
+    serialization::readPod(in, lutOffset);
+    in.seek(lutOffset + sizeof(uint32_t) * currentPage);
+    serialization::readPod(in, pagePos);
+  } else if (currentPage >= 0 && currentPage < static_cast<int>(partialLut.size())) {
+    // The LUT of an unfinished build is only written at the end
+    pagePos = partialLut[currentPage];
+  } else {
+    file.close();
+    return nullptr;
+  }
+  in.seek(pagePos);
 
-  auto page = Page::deserialize(file);
+  auto page = Page::deserialize(in);
   file.close();
   return page;
 }
@@ -1,22 +1,48 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "Epub.h"
 
 class Page;
 class GfxRenderer;
+class ChapterTextCache;
+class BufferedFsWriter;
+class BufferedFsReader;
 
 class Section {
   std::shared_ptr<Epub> epub;
   const int spineIndex;
   GfxRenderer& renderer;
   std::string filePath;
+  // Present while a build is unfinished, see writeCheckpoint
+  std::string checkpointPath;
   FsFile file;
+  // False while the chapter is still being laid out; the LUT is then kept here instead of at the end of the file
+  bool complete = false;
+  std::vector<uint32_t> partialLut;
+  // Set while createSectionFile lays out pages, for loading them from its callbacks
+  BufferedFsWriter* buildOut = nullptr;
+  const std::vector<uint32_t>* buildLut = nullptr;
 
-  void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
-                              uint16_t viewportWidth, uint16_t viewportHeight);
-  uint32_t onPageComplete(std::unique_ptr<Page> page);
+  void writeSectionFileHeader(BufferedFsWriter& out, int fontId, float lineCompression, bool extraParagraphSpacing,
+                              uint8_t paragraphAlignment, bool hyphenation, uint16_t viewportWidth,
+                              uint16_t viewportHeight);
+  bool readSectionFileHeader(BufferedFsReader& in, int fontId, float lineCompression, bool extraParagraphSpacing,
+                             uint8_t paragraphAlignment, bool hyphenation, uint16_t viewportWidth,
+                             uint16_t viewportHeight);
+  uint32_t onPageComplete(BufferedFsWriter& out, std::unique_ptr<Page> page);
+  bool streamItemToTempFile(const std::string& tmpHtmlPath, uint32_t& fileSize) const;
+  bool canReuseTempFile(const std::string& tmpHtmlPath, uint32_t& fileSize) const;
+  bool writeCheckpoint(BufferedFsWriter& out, uint32_t textOffset, const Page* currentPage, int16_t currentPageNextY,
+                       const std::vector<uint32_t>& lut, ChapterTextCache* textCache);
+  bool readCheckpoint(uint32_t& textOffset, uint32_t& sectionSize, int16_t& currentPageNextY,
+                      std::vector<uint32_t>& lut, std::unique_ptr<Page>* currentPage) const;
+  bool resumeFromCheckpoint(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
+                            bool hyphenation, uint16_t viewportWidth, uint16_t viewportHeight, uint32_t& textOffset,
+                            std::unique_ptr<Page>& currentPage, int16_t& currentPageNextY, std::vector<uint32_t>& lut);
+  std::unique_ptr<Page> loadPageDuringBuild();
 
  public:
   uint16_t pageCount = 0;
@@ -26,14 +52,27 @@ class Section {
       : epub(epub),
         spineIndex(spineIndex),
         renderer(renderer),
-        filePath(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".bin") {}
+        filePath(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".bin"),
+        checkpointPath(epub->getCachePath() + "/sections/" + std::to_string(spineIndex) + ".resume.bin") {}
   ~Section() = default;
+  // Also succeeds for an unfinished build that already has pages, see isComplete
   bool loadSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
-                       uint16_t viewportWidth, uint16_t viewportHeight);
+                       bool hyphenation, uint16_t viewportWidth, uint16_t viewportHeight);
   bool clearCache() const;
+  /**
+   * Lay out the chapter into the section file. The build checkpoints at block boundaries every few pages; an
+   * interrupted or stopped build continues from its last checkpoint on the next call.
+   * @param shouldStop polled at block boundaries, returning true checkpoints and stops the build. The pages laid out
+   * so far stay readable and pageCount is provisional until a later call completes the chapter. It may also load the
+   * pages laid out so far with loadPageFromSectionFile.
+   * @return false if the build failed
+   */
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
-                         uint16_t viewportWidth, uint16_t viewportHeight,
+                         bool hyphenation, uint16_t viewportWidth, uint16_t viewportHeight,
                          const std::function<void()>& progressSetupFn = nullptr,
-                         const std::function<void(int)>& progressFn = nullptr);
+                         const std::function<void(int)>& progressFn = nullptr,
+                         const std::function<bool()>& shouldStop = nullptr);
+  // False while pageCount only covers the pages laid out so far
+  bool isComplete() const { return complete; }
   std::unique_ptr<Page> loadPageFromSectionFile();
 };
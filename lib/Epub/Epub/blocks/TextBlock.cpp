@@ -24,7 +24,7 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
   }
 }
 
-bool TextBlock::serialize(FsFile& file) const {
+bool TextBlock::serialize(BufferedFsWriter& out) const {
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
     Serial.printf("[%lu] [TXB] Serialization failed: size mismatch (words=%u, xpos=%u, styles=%u)\n", millis(),
                   words.size(), wordXpos.size(), wordStyles.size());
@@ -32,18 +32,18 @@ bool TextBlock::serialize(FsFile& file) const {
   }
 
   // Word data
-  serialization::writePod(file, static_cast<uint16_t>(words.size()));
-  for (const auto& w : words) serialization::writeString(file, w);
-  for (auto x : wordXpos) serialization::writePod(file, x);
-  for (auto s : wordStyles) serialization::writePod(file, s);
+  serialization::writePod(out, static_cast<uint16_t>(words.size()));
+  for (const auto& w : words) serialization::writeString(out, w);
+  for (auto x : wordXpos) serialization::writePod(out, x);
+  for (auto s : wordStyles) serialization::writePod(out, s);
 
   // Block style
-  serialization::writePod(file, style);
+  serialization::writePod(out, style);
 
   return true;
 }
 
-std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
+std::unique_ptr<TextBlock> TextBlock::deserialize(BufferedFsReader& in) {
   uint16_t wc;
   std::list<std::string> words;
   std::list<uint16_t> wordXpos;
@@ -51,7 +51,7 @@ std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
   Style style;
 
   // Word count
-  serialization::readPod(file, wc);
+  serialization::readPod(in, wc);
 
   // Sanity check: prevent allocation of unreasonably large lists (max 10000 words per block)
   if (wc > 10000) {
@@ -63,12 +63,12 @@ std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
   words.resize(wc);
   wordXpos.resize(wc);
   wordStyles.resize(wc);
-  for (auto& w : words) serialization::readString(file, w);
-  for (auto& x : wordXpos) serialization::readPod(file, x);
-  for (auto& s : wordStyles) serialization::readPod(file, s);
+  for (auto& w : words) serialization::readString(in, w);
+  for (auto& x : wordXpos) serialization::readPod(in, x);
+  for (auto& s : wordStyles) serialization::readPod(in, s);
 
   // Block style
-  serialization::readPod(file, style);
+  serialization::readPod(in, style);
 
   return std::unique_ptr<TextBlock>(new TextBlock(std::move(words), std::move(wordXpos), std::move(wordStyles), style));
 }
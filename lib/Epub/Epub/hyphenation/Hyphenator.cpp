@@ -0,0 +1,290 @@
+#include "Hyphenator.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+
+#include <cctype>
+#include <cstring>
+#include <new>
+
+namespace {
+constexpr char PACK_MAGIC[4] = {'C', 'P', 'H', 'Y'};
+constexpr uint8_t PACK_VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t MAX_PACK_SIZE = 256 * 1024;
+constexpr uint32_t NO_CHILD = 0xFFFFFFFF;
+constexpr char PACK_DIR[] = "/.crosspoint/hyphenation/";
+
+uint16_t readU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+uint32_t readU24(const uint8_t* p) { return p[0] | (p[1] << 8) | (static_cast<uint32_t>(p[2]) << 16); }
+uint32_t readU32(const uint8_t* p) { return readU24(p) | (static_cast<uint32_t>(p[3]) << 24); }
+
+// Lowercase form of a letter the packs can contain (Latin, Greek, Cyrillic), or 0 if cp isn't one.
+// Every letter accepted here encodes to the same number of UTF-8 bytes in both cases.
+uint32_t foldLetter(const uint32_t cp) {
+  if (cp < 0x80) {
+    if (cp >= 'A' && cp <= 'Z') return cp + 0x20;
+    return (cp >= 'a' && cp <= 'z') ? cp : 0;
+  }
+  if (cp < 0xC0 || cp == 0xD7 || cp == 0xF7) return 0;
+  if (cp <= 0xDE) return cp + 0x20;
+  if (cp <= 0xFF) return cp;
+  if (cp <= 0x137 || (cp >= 0x14A && cp <= 0x177)) return cp | 1;
+  if ((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E)) return (cp & 1) ? cp + 1 : cp;
+  if (cp == 0x178) return 0xFF;
+  if (cp <= 0x24F) return cp;
+  if (cp >= 0x391 && cp <= 0x3A9 && cp != 0x3A2) return cp + 0x20;
+  if (cp >= 0x370 && cp <= 0x3FF) return cp;
+  if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+  if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+  if (cp <= 0x52F) return cp;
+  return 0;
+}
+
+// Decode one 1 or 2 byte UTF-8 sequence (all letters the packs can contain). Longer or broken sequences
+// decode to 0 and are skipped whole.
+uint32_t decodeShort(const uint8_t* p, const size_t remaining, size_t& length) {
+  if (p[0] < 0x80) {
+    length = 1;
+    return p[0];
+  }
+  length = 1;
+  while (length < remaining && (p[length] & 0xC0) == 0x80) {
+    length++;
+  }
+  if ((p[0] & 0xE0) == 0xC0 && length == 2) {
+    return ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+  }
+  return 0;
+}
+
+size_t encodeShort(const uint32_t cp, uint8_t* out) {
+  if (cp < 0x80) {
+    out[0] = static_cast<uint8_t>(cp);
+    return 1;
+  }
+  out[0] = static_cast<uint8_t>(0xC0 | (cp >> 6));
+  out[1] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+  return 2;
+}
+}  // namespace
+
+Hyphenator::~Hyphenator() { delete[] data; }
+
+const Hyphenator* Hyphenator::forLanguage(const std::string& language) {
+  static std::string loadedLanguage;
+  static std::unique_ptr<Hyphenator> loaded;
+  static bool attempted = false;
+
+  std::string tag;
+  for (const char c : language) {
+    if (!isspace(static_cast<unsigned char>(c))) {
+      tag += c == '_' ? '-' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+  }
+  if (attempted && tag == loadedLanguage) {
+    return loaded.get();
+  }
+
+  // Only one pack is kept, free the old one before reading the next
+  loaded.reset();
+  loadedLanguage = tag;
+  attempted = true;
+  if (tag.empty()) {
+    return nullptr;
+  }
+
+  const std::string candidates[] = {tag, tag.substr(0, tag.find('-'))};
+  for (const auto& candidate : candidates) {
+    const std::string path = PACK_DIR + candidate + ".bin";
+    if (!SdMan.exists(path.c_str())) {
+      continue;
+    }
+    loaded = loadFromFile(path);
+    if (loaded) {
+      Serial.printf("[%lu] [HYP] Loaded %s (%u bytes)\n", millis(), path.c_str(),
+                    static_cast<unsigned>(loaded->size));
+      return loaded.get();
+    }
+  }
+
+  Serial.printf("[%lu] [HYP] No hyphenation pack for language '%s'\n", millis(), language.c_str());
+  return nullptr;
+}
+
+std::unique_ptr<Hyphenator> Hyphenator::loadFromFile(const std::string& path) {
+  FsFile file;
+  if (!SdMan.openFileForRead("HYP", path, file)) {
+    return nullptr;
+  }
+
+  const size_t fileSize = file.size();
+  if (fileSize < HEADER_SIZE || fileSize > MAX_PACK_SIZE) {
+    Serial.printf("[%lu] [HYP] Pack %s has unexpected size %u\n", millis(), path.c_str(),
+                  static_cast<unsigned>(fileSize));
+    file.close();
+    return nullptr;
+  }
+
+  auto* buffer = new (std::nothrow) uint8_t[fileSize];
+  if (!buffer) {
+    Serial.printf("[%lu] [HYP] Not enough memory for pack %s (%u bytes)\n", millis(), path.c_str(),
+                  static_cast<unsigned>(fileSize));
+    file.close();
+    return nullptr;
+  }
+
+  const size_t bytesRead = file.read(buffer, fileSize);
+  file.close();
+  if (bytesRead != fileSize) {
+    Serial.printf("[%lu] [HYP] Short read on pack %s\n", millis(), path.c_str());
+    delete[] buffer;
+    return nullptr;
+  }
+
+  return fromBuffer(buffer, fileSize);
+}
+
+std::unique_ptr<Hyphenator> Hyphenator::fromBuffer(uint8_t* data, const size_t size) {
+  std::unique_ptr<Hyphenator> hyphenator(new Hyphenator(data, size));
+  if (!hyphenator->parseHeader()) {
+    Serial.printf("[%lu] [HYP] Invalid hyphenation pack\n", millis());
+    return nullptr;
+  }
+  return hyphenator;
+}
+
+bool Hyphenator::parseHeader() {
+  if (!data || size < HEADER_SIZE || memcmp(data, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || data[4] != PACK_VERSION) {
+    return false;
+  }
+
+  leftMin = data[5];
+  rightMin = data[6];
+  nodeCount = readU32(data + 8);
+  levelsSize = readU32(data + 12);
+  if (nodeCount == 0 || HEADER_SIZE + static_cast<uint64_t>(nodeCount) * NODE_SIZE + levelsSize != size) {
+    return false;
+  }
+
+  nodes = data + HEADER_SIZE;
+  levels = nodes + nodeCount * NODE_SIZE;
+  return true;
+}
+
+uint32_t Hyphenator::findChild(const uint32_t node, const uint8_t label) const {
+  const uint8_t* n = nodes + node * NODE_SIZE;
+  const uint32_t first = readU24(n + 4);
+  uint32_t lo = 0;
+  uint32_t hi = n[1];
+  if (first + hi > nodeCount) {
+    return NO_CHILD;
+  }
+
+  // Children are stored contiguously, sorted by label
+  while (lo < hi) {
+    const uint32_t mid = (lo + hi) / 2;
+    const uint8_t midLabel = nodes[(first + mid) * NODE_SIZE];
+    if (midLabel == label) {
+      return first + mid;
+    }
+    if (midLabel < label) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return NO_CHILD;
+}
+
+void Hyphenator::applyLevels(const uint32_t node, const size_t start, uint8_t* wordLevels,
+                             const size_t wordLevelsSize) const {
+  const uint16_t offset = readU16(nodes + node * NODE_SIZE + 2);
+  if (offset == 0 || offset > levelsSize) {
+    return;
+  }
+
+  // Entry: count, then (position, value) pairs. Position is a byte offset from the start of the pattern.
+  const uint8_t* entry = levels + offset - 1;
+  const uint8_t count = entry[0];
+  if (offset + static_cast<size_t>(count) * 2 > levelsSize) {
+    return;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    const size_t index = start + entry[1 + i * 2];
+    const uint8_t value = entry[2 + i * 2];
+    if (index < wordLevelsSize && value > wordLevels[index]) {
+      wordLevels[index] = value;
+    }
+  }
+}
+
+void Hyphenator::hyphenate(const std::string& word, std::vector<uint8_t>& breaks) const {
+  breaks.clear();
+  const auto* bytes = reinterpret_cast<const uint8_t*>(word.data());
+  const size_t wordSize = word.size();
+  if (wordSize > 255) {
+    return;
+  }
+
+  // Find the run of letters, skipping leading and trailing punctuation
+  size_t coreStart = wordSize;
+  size_t coreEnd = 0;
+  for (size_t i = 0, length = 0; i < wordSize; i += length) {
+    if (foldLetter(decodeShort(bytes + i, wordSize - i, length)) != 0) {
+      if (coreStart == wordSize) coreStart = i;
+      coreEnd = i + length;
+    }
+  }
+  if (coreStart >= coreEnd || coreEnd - coreStart > MAX_WORD_BYTES) {
+    return;
+  }
+
+  // Lowercased core between word boundary markers, with the character index of every byte
+  uint8_t folded[MAX_WORD_BYTES + 2];
+  uint8_t charIndex[MAX_WORD_BYTES + 2];
+  size_t foldedSize = 0;
+  size_t charCount = 0;
+  folded[foldedSize++] = '.';
+  for (size_t i = coreStart, length = 0; i < coreEnd; i += length) {
+    const uint32_t letter = foldLetter(decodeShort(bytes + i, coreEnd - i, length));
+    if (letter == 0) {
+      // Digits, apostrophes or hyphens inside the word
+      return;
+    }
+    const size_t encoded = encodeShort(letter, folded + foldedSize);
+    for (size_t b = 0; b < encoded; b++) {
+      charIndex[foldedSize + b] = static_cast<uint8_t>(charCount);
+    }
+    foldedSize += encoded;
+    charCount++;
+  }
+  folded[foldedSize++] = '.';
+  if (charCount < static_cast<size_t>(leftMin) + rightMin) {
+    return;
+  }
+
+  // Liang: every pattern matching at every start position raises the levels between the bytes it covers
+  uint8_t wordLevels[MAX_WORD_BYTES + 3] = {};
+  for (size_t start = 0; start < foldedSize; start++) {
+    uint32_t node = 0;
+    for (size_t i = start; i < foldedSize; i++) {
+      node = findChild(node, folded[i]);
+      if (node == NO_CHILD) {
+        break;
+      }
+      applyLevels(node, start, wordLevels, foldedSize + 1);
+    }
+  }
+
+  // Odd levels are break points. Level i sits before folded byte i, i.e. before core byte i - 1.
+  for (size_t i = 2; i < foldedSize - 1; i++) {
+    if ((wordLevels[i] & 1) == 0 || (folded[i] & 0xC0) == 0x80) {
+      continue;
+    }
+    const size_t before = charIndex[i];
+    if (before >= leftMin && charCount - before >= rightMin) {
+      breaks.push_back(static_cast<uint8_t>(coreStart + i - 1));
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Liang pattern hyphenation backed by a compact binary trie (a "language pack").
+ *
+ * Packs live on the SD card as /.crosspoint/hyphenation/<language>.bin and are built from TeX pattern files with
+ * scripts/build_hyphenation_pack.py (format in docs/file-formats.md). A pack is only read into RAM when a
+ * chapter in its language is laid out, and only one pack is held at a time.
+ */
+class Hyphenator {
+ public:
+  // Words with more letters than this are not hyphenated
+  static constexpr size_t MAX_WORD_BYTES = 64;
+
+  ~Hyphenator();
+
+  Hyphenator(const Hyphenator&) = delete;
+  Hyphenator& operator=(const Hyphenator&) = delete;
+
+  /**
+   * Hyphenator for a book language (BCP 47 tag as found in dc:language, e.g. "en-US" or "de").
+   * Tries the full tag and then the primary subtag. The pack stays loaded until another language is requested.
+   * @return nullptr if there is no pack for the language
+   */
+  static const Hyphenator* forLanguage(const std::string& language);
+
+  // Load a pack from a file. Returns nullptr if the file is missing or invalid.
+  static std::unique_ptr<Hyphenator> loadFromFile(const std::string& path);
+
+  // Use a pack that is already in memory. Takes ownership of data (allocated with new[]).
+  static std::unique_ptr<Hyphenator> fromBuffer(uint8_t* data, size_t size);
+
+  /**
+   * Find the positions a word may be hyphenated at. Leading and trailing punctuation is ignored; words containing
+   * anything other than letters in between are left alone.
+   * @param breaks receives byte offsets into word, in ascending order. The hyphen goes before the byte at the offset.
+   */
+  void hyphenate(const std::string& word, std::vector<uint8_t>& breaks) const;
+
+  size_t getPackSize() const { return size; }
+
+ private:
+  static constexpr size_t NODE_SIZE = 7;
+
+  uint8_t* data;
+  size_t size;
+  const uint8_t* nodes = nullptr;
+  const uint8_t* levels = nullptr;
+  uint32_t nodeCount = 0;
+  uint32_t levelsSize = 0;
+  uint8_t leftMin = 2;
+  uint8_t rightMin = 3;
+
+  Hyphenator(uint8_t* data, size_t size) : data(data), size(size) {}
+  bool parseHeader();
+  uint32_t findChild(uint32_t node, uint8_t label) const;
+  void applyLevels(uint32_t node, size_t start, uint8_t* wordLevels, size_t wordLevelsSize) const;
+};
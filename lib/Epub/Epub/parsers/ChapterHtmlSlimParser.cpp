@@ -3,8 +3,10 @@
 #include <GfxRenderer.h>
 #include <HardwareSerial.h>
 #include <SDCardManager.h>
+#include <Trace.h>
 #include <expat.h>
 
+#include "../ChapterTextCache.h"
 #include "../Page.h"
 
 const char* HEADER_TAGS[] = {"h1", "h2", "h3", "h4", "h5", "h6"};
@@ -40,18 +42,71 @@ bool matches(const char* tag_name, const char* possible_tags[], const int possib
   return false;
 }
 
+TextBlock::Style ChapterHtmlSlimParser::resolveStyle(const uint8_t style) const {
+  return static_cast<TextBlock::Style>(style == ChapterTextCache::PARAGRAPH_STYLE ? paragraphAlignment : style);
+}
+
+// The first block is implied and isn't stored in the text cache
+void ChapterHtmlSlimParser::startFirstTextBlock() {
+  textOffset = 0;
+  currentBlockStyle = ChapterTextCache::PARAGRAPH_STYLE;
+  currentTextBlock.reset(new ParsedText(resolveStyle(currentBlockStyle), extraParagraphSpacing, hyphenator));
+}
+
 // start a new text block if needed
-void ChapterHtmlSlimParser::startNewTextBlock(const TextBlock::Style style) {
+void ChapterHtmlSlimParser::startNewTextBlock(const uint8_t style) {
+  const uint32_t blockOffset = textOffset;
+  textOffset += ChapterTextCache::BLOCK_RECORD_SIZE;
+  currentBlockStyle = style;
+  if (blockOffset < resumeOffset || stopped) {
+    return;
+  }
+
+  if (textCache) {
+    textCache->writeBlock(style);
+  }
+
   if (currentTextBlock) {
     // already have a text block running and it is empty - just reuse it
     if (currentTextBlock->isEmpty()) {
-      currentTextBlock->setStyle(style);
+      currentTextBlock->setStyle(resolveStyle(style));
       return;
     }
 
     makePages();
+
+    // Everything before this block is on pages now, the build can stop here and resume later
+    if (blockBoundaryFn && !blockBoundaryFn(blockOffset, currentPage.get(), currentPageNextY)) {
+      stopped = true;
+      if (xmlParser) {
+        XML_StopParser(xmlParser, XML_FALSE);
+      }
+      return;
+    }
+  }
+  currentTextBlock.reset(new ParsedText(resolveStyle(style), extraParagraphSpacing, hyphenator));
+}
+
+void ChapterHtmlSlimParser::addWord(const char* word, const EpdFontFamily::Style fontStyle) {
+  const uint32_t wordOffset = textOffset;
+  textOffset += ChapterTextCache::wordRecordSize(word);
+  if (wordOffset < resumeOffset || stopped) {
+    return;
+  }
+
+  if (textCache) {
+    textCache->writeWord(word, fontStyle);
+  }
+  currentTextBlock->addWord(word, fontStyle);
+
+  // Lay out long paragraphs in windows so the buffered words stay bounded. Lines near the end of the window are
+  // held back and re-broken with the following text, so the paragraph doesn't get a seam at the window boundary.
+  // Spotted when reading Intermezzo, there are some really long text blocks in there.
+  if (currentTextBlock->size() >= ParsedText::LAYOUT_WINDOW_WORDS) {
+    currentTextBlock->layoutAndExtractLines(
+        renderer, fontId, viewportWidth,
+        [this](const std::shared_ptr<TextBlock>& textBlock) { addLineToPage(textBlock); }, false);
   }
-  currentTextBlock.reset(new ParsedText(style, extraParagraphSpacing));
 }
 
 void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char* name, const XML_Char** atts) {
@@ -68,7 +123,7 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
     // Add placeholder text
     self->startNewTextBlock(TextBlock::CENTER_ALIGN);
     if (self->currentTextBlock) {
-      self->currentTextBlock->addWord("[Table omitted]", EpdFontFamily::ITALIC);
+      self->addWord("[Table omitted]", EpdFontFamily::ITALIC);
     }
 
     // Skip table contents
@@ -125,11 +180,11 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
     self->boldUntilDepth = std::min(self->boldUntilDepth, self->depth);
   } else if (matches(name, BLOCK_TAGS, NUM_BLOCK_TAGS)) {
     if (strcmp(name, "br") == 0) {
-      self->startNewTextBlock(self->currentTextBlock->getStyle());
+      self->startNewTextBlock(self->currentBlockStyle);
     } else {
-      self->startNewTextBlock((TextBlock::Style)self->paragraphAlignment);
+      self->startNewTextBlock(ChapterTextCache::PARAGRAPH_STYLE);
       if (strcmp(name, "li") == 0) {
-        self->currentTextBlock->addWord("\xe2\x80\xa2", EpdFontFamily::REGULAR);
+        self->addWord("\xe2\x80\xa2", EpdFontFamily::REGULAR);
       }
     }
   } else if (matches(name, BOLD_TAGS, NUM_BOLD_TAGS)) {
@@ -163,7 +218,7 @@ void XMLCALL ChapterHtmlSlimParser::characterData(void* userData, const XML_Char
       // Currently looking at whitespace, if there's anything in the partWordBuffer, flush it
       if (self->partWordBufferIndex > 0) {
         self->partWordBuffer[self->partWordBufferIndex] = '\0';
-        self->currentTextBlock->addWord(self->partWordBuffer, fontStyle);
+        self->addWord(self->partWordBuffer, fontStyle);
         self->partWordBufferIndex = 0;
       }
       // Skip the whitespace char
@@ -202,23 +257,12 @@ void XMLCALL ChapterHtmlSlimParser::characterData(void* userData, const XML_Char
     // If we're about to run out of space, then cut the word off and start a new one
     if (self->partWordBufferIndex >= MAX_WORD_SIZE) {
       self->partWordBuffer[self->partWordBufferIndex] = '\0';
-      self->currentTextBlock->addWord(self->partWordBuffer, fontStyle);
+      self->addWord(self->partWordBuffer, fontStyle);
       self->partWordBufferIndex = 0;
     }
 
     self->partWordBuffer[self->partWordBufferIndex++] = s[i];
   }
-
-  // If we have > 750 words buffered up, perform the layout and consume out all but the last line
-  // There should be enough here to build out 1-2 full pages and doing this will free up a lot of
-  // memory.
-  // Spotted when reading Intermezzo, there are some really long text blocks in there.
-  if (self->currentTextBlock->size() > 750) {
-    Serial.printf("[%lu] [EHP] Text block too long, splitting into multiple pages\n", millis());
-    self->currentTextBlock->layoutAndExtractLines(
-        self->renderer, self->fontId, self->viewportWidth,
-        [self](const std::shared_ptr<TextBlock>& textBlock) { self->addLineToPage(textBlock); }, false);
-  }
 }
 
 void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* name) {
@@ -244,7 +288,7 @@ void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* n
       }
 
       self->partWordBuffer[self->partWordBufferIndex] = '\0';
-      self->currentTextBlock->addWord(self->partWordBuffer, fontStyle);
+      self->addWord(self->partWordBuffer, fontStyle);
       self->partWordBufferIndex = 0;
     }
   }
@@ -267,8 +311,10 @@ void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* n
   }
 }
 
-bool ChapterHtmlSlimParser::parseAndBuildPages() {
-  startNewTextBlock((TextBlock::Style)this->paragraphAlignment);
+bool ChapterHtmlSlimParser::parseAndBuildPages(ChapterTextCache* textCacheOut) {
+  TRACE_SPAN(XML_PARSE);
+  startFirstTextBlock();
+  textCache = textCacheOut;
 
   const XML_Parser parser = XML_ParserCreate(nullptr);
   int done;
@@ -289,6 +335,7 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   size_t bytesRead = 0;
   int lastProgress = -1;
 
+  xmlParser = parser;
   XML_SetUserData(parser, this);
   XML_SetElementHandler(parser, startElement, endElement);
   XML_SetCharacterDataHandler(parser, characterData);
@@ -330,7 +377,11 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
 
     done = file.available() == 0;
 
-    if (XML_ParseBuffer(parser, static_cast<int>(len), done) == XML_STATUS_ERROR) {
+    const auto status = XML_ParseBuffer(parser, static_cast<int>(len), done);
+    if (stopped) {
+      break;
+    }
+    if (status == XML_STATUS_ERROR) {
       Serial.printf("[%lu] [EHP] Parse error at line %lu:\n%s\n", millis(), XML_GetCurrentLineNumber(parser),
                     XML_ErrorString(XML_GetErrorCode(parser)));
       XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
@@ -346,8 +397,45 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
   XML_SetCharacterDataHandler(parser, nullptr);
   XML_ParserFree(parser);
+  xmlParser = nullptr;
   file.close();
 
+  textCache = nullptr;
+  if (stopped) {
+    return false;
+  }
+  finishPages();
+  return true;
+}
+
+bool ChapterHtmlSlimParser::buildPagesFromTextCache(ChapterTextCache& cache) {
+  startFirstTextBlock();
+  // A resumed build seeks straight to its block instead of counting up to it
+  textOffset = resumeOffset;
+
+  // Only show progress for larger chapters, same as when parsing
+  const bool showProgress = progressFn && cache.getSize() >= MIN_SIZE_FOR_PROGRESS;
+  if (!cache.replay(
+          [this](const uint8_t style) {
+            startNewTextBlock(style);
+            return !stopped;
+          },
+          [this](const char* word, const EpdFontFamily::Style fontStyle) { addWord(word, fontStyle); },
+          showProgress ? progressFn : nullptr, resumeOffset)) {
+    return false;
+  }
+
+  finishPages();
+  return true;
+}
+
+void ChapterHtmlSlimParser::resumeFrom(const uint32_t offset, std::unique_ptr<Page> page, const int16_t pageNextY) {
+  resumeOffset = offset;
+  currentPage = std::move(page);
+  currentPageNextY = pageNextY;
+}
+
+void ChapterHtmlSlimParser::finishPages() {
   // Process last page if there is still text
   if (currentTextBlock) {
     makePages();
@@ -355,8 +443,6 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
     currentPage.reset();
     currentTextBlock.reset();
   }
-
-  return true;
 }
 
 void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
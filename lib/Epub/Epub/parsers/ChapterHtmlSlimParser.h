@@ -11,6 +11,8 @@
 
 class Page;
 class GfxRenderer;
+class Hyphenator;
+class ChapterTextCache;
 
 #define MAX_WORD_SIZE 200
 
@@ -19,6 +21,8 @@ class ChapterHtmlSlimParser {
   GfxRenderer& renderer;
   std::function<void(std::unique_ptr<Page>)> completePageFn;
   std::function<void(int)> progressFn;  // Progress callback (0-100)
+  // Called at block boundaries once everything before the block is on pages; returning false stops the build there
+  std::function<bool(uint32_t textOffset, const Page* currentPage, int16_t currentPageNextY)> blockBoundaryFn;
   int depth = 0;
   int skipUntilDepth = INT_MAX;
   int boldUntilDepth = INT_MAX;
@@ -36,9 +40,24 @@ class ChapterHtmlSlimParser {
   uint8_t paragraphAlignment;
   uint16_t viewportWidth;
   uint16_t viewportHeight;
+  const Hyphenator* hyphenator;
+  // Receives the blocks and words while parsing, so later layouts can skip the HTML
+  ChapterTextCache* textCache = nullptr;
+  // Style the current block was started with, ChapterTextCache::PARAGRAPH_STYLE until resolved for layout
+  uint8_t currentBlockStyle = 0;
+  // Offset of the next record in the chapter text, counted the same way when parsing and when replaying
+  uint32_t textOffset = 0;
+  // Text before this offset was laid out by the build being resumed, it is only counted
+  uint32_t resumeOffset = 0;
+  bool stopped = false;
+  XML_Parser xmlParser = nullptr;
 
-  void startNewTextBlock(TextBlock::Style style);
+  TextBlock::Style resolveStyle(uint8_t style) const;
+  void startFirstTextBlock();
+  void startNewTextBlock(uint8_t style);
+  void addWord(const char* word, EpdFontFamily::Style fontStyle);
   void makePages();
+  void finishPages();
   // XML callbacks
   static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
@@ -48,20 +67,30 @@ class ChapterHtmlSlimParser {
   explicit ChapterHtmlSlimParser(const std::string& filepath, GfxRenderer& renderer, const int fontId,
                                  const float lineCompression, const bool extraParagraphSpacing,
                                  const uint8_t paragraphAlignment, const uint16_t viewportWidth,
-                                 const uint16_t viewportHeight,
+                                 const uint16_t viewportHeight, const Hyphenator* hyphenator,
                                  const std::function<void(std::unique_ptr<Page>)>& completePageFn,
-                                 const std::function<void(int)>& progressFn = nullptr)
+                                 const std::function<void(int)>& progressFn = nullptr,
+                                 const std::function<bool(uint32_t, const Page*, int16_t)>& blockBoundaryFn = nullptr)
       : filepath(filepath),
         renderer(renderer),
+        completePageFn(completePageFn),
+        progressFn(progressFn),
+        blockBoundaryFn(blockBoundaryFn),
         fontId(fontId),
         lineCompression(lineCompression),
         extraParagraphSpacing(extraParagraphSpacing),
         paragraphAlignment(paragraphAlignment),
         viewportWidth(viewportWidth),
         viewportHeight(viewportHeight),
-        completePageFn(completePageFn),
-        progressFn(progressFn) {}
+        hyphenator(hyphenator) {}
   ~ChapterHtmlSlimParser() = default;
-  bool parseAndBuildPages();
+  // Parse the HTML file and build pages, optionally storing the parsed text in textCacheOut as well
+  bool parseAndBuildPages(ChapterTextCache* textCacheOut = nullptr);
+  // Build pages from text stored by an earlier parse, without reading the HTML
+  bool buildPagesFromTextCache(ChapterTextCache& cache);
+  // Continue a stopped build at the block starting at textOffset, with the page that was being filled then
+  void resumeFrom(uint32_t textOffset, std::unique_ptr<Page> page, int16_t pageNextY);
+  // The build was stopped by blockBoundaryFn, pages up to the last boundary were completed
+  bool wasStopped() const { return stopped; }
   void addLineToPage(std::shared_ptr<TextBlock> line);
 };
@@ -1,6 +1,7 @@
 #include "ContainerParser.h"
 
 #include <HardwareSerial.h>
+#include <Trace.h>
 
 bool ContainerParser::setup() {
   parser = XML_ParserCreate(nullptr);
@@ -26,6 +27,7 @@ ContainerParser::~ContainerParser() {
 size_t ContainerParser::write(const uint8_t data) { return write(&data, 1); }
 
 size_t ContainerParser::write(const uint8_t* buffer, const size_t size) {
+  TRACE_SPAN(XML_PARSE);
   if (!parser) return 0;
 
   const uint8_t* currentBufferPos = buffer;
@@ -2,6 +2,7 @@
 
 #include <FsHelpers.h>
 #include <HardwareSerial.h>
+#include <Trace.h>
 
 #include "../BookMetadataCache.h"
 
@@ -31,6 +32,7 @@ TocNcxParser::~TocNcxParser() {
 size_t TocNcxParser::write(const uint8_t data) { return write(&data, 1); }
 
 size_t TocNcxParser::write(const uint8_t* buffer, const size_t size) {
+  TRACE_SPAN(XML_PARSE);
   if (!parser) return 0;
 
   const uint8_t* currentBufferPos = buffer;
@@ -1,5 +1,8 @@
 #include "GfxRenderer.h"
 
+#include <HeapProfiler.h>
+#include <PowerMonitor.h>
+#include <Trace.h>
 #include <Utf8.h>
 
 void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) { fontMap.insert({fontId, font}); }
@@ -397,7 +400,10 @@ void GfxRenderer::invertScreen() const {
 }
 
 void GfxRenderer::displayBuffer(const EInkDisplay::RefreshMode refreshMode) const {
+  TRACE_SPAN(DISPLAY_REFRESH);
+  const unsigned long start = millis();
   einkDisplay.displayBuffer(refreshMode);
+  powerMonitor::recordRefresh(static_cast<powerMonitor::Refresh>(refreshMode), millis() - start);
 }
 
 std::string GfxRenderer::truncatedText(const int fontId, const char* text, const int maxWidth,
@@ -647,7 +653,12 @@ void GfxRenderer::copyGrayscaleLsbBuffers() const { einkDisplay.copyGrayscaleLsb
 
 void GfxRenderer::copyGrayscaleMsbBuffers() const { einkDisplay.copyGrayscaleMsbBuffers(einkDisplay.getFrameBuffer()); }
 
-void GfxRenderer::displayGrayBuffer() const { einkDisplay.displayGrayBuffer(); }
+void GfxRenderer::displayGrayBuffer() const {
+  TRACE_SPAN(DISPLAY_REFRESH);
+  const unsigned long start = millis();
+  einkDisplay.displayGrayBuffer();
+  powerMonitor::recordRefresh(powerMonitor::GRAY_REFRESH, millis() - start);
+}
 
 void GfxRenderer::freeBwBufferChunks() {
   for (auto& bwBufferChunk : bwBufferChunks) {
@@ -683,6 +694,7 @@ bool GfxRenderer::storeBwBuffer() {
 
     const size_t offset = i * BW_BUFFER_CHUNK_SIZE;
     bwBufferChunks[i] = static_cast<uint8_t*>(malloc(BW_BUFFER_CHUNK_SIZE));
+    heapProfiler::recordAllocation(heapProfiler::BW_BUFFER, BW_BUFFER_CHUNK_SIZE, bwBufferChunks[i] != nullptr);
 
     if (!bwBufferChunks[i]) {
       Serial.printf("[%lu] [GFX] !! Failed to allocate BW buffer chunk %zu (%zu bytes)\n", millis(), i,
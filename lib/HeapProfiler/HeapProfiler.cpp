@@ -0,0 +1,204 @@
+#include "HeapProfiler.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#else
+#include <malloc.h>
+
+#include <mutex>
+#endif
+
+namespace {
+constexpr char LOG_DIR[] = "/.crosspoint";
+constexpr char LOG_FILE[] = "/.crosspoint/heap.log";
+constexpr char OLD_LOG_FILE[] = "/.crosspoint/heap.log.1";
+constexpr size_t LOG_MAX_SIZE = 16 * 1024;
+
+constexpr const char* SITE_NAMES[] = {"bw", "zip-read", "zip-inflate", "jpeg"};
+static_assert(sizeof(SITE_NAMES) / sizeof(SITE_NAMES[0]) == heapProfiler::ALLOC_SITE_COUNT,
+              "An allocation site is missing a name");
+
+struct SiteStats {
+  uint32_t count;
+  uint32_t failed;
+  uint32_t largestRequest;
+};
+
+// Since the current activity was entered
+SiteStats sites[heapProfiler::ALLOC_SITE_COUNT];
+uint32_t activityLowFree = UINT32_MAX;
+
+#if defined(ESP32)
+portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+#define PROFILER_LOCK() portENTER_CRITICAL(&lock)
+#define PROFILER_UNLOCK() portEXIT_CRITICAL(&lock)
+
+uint32_t freeHeap() { return esp_get_free_heap_size(); }
+uint32_t largestFreeBlock() { return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
+
+const char* resetReason() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:
+      return "power-on";
+    case ESP_RST_DEEPSLEEP:
+      return "deep-sleep";
+    case ESP_RST_SW:
+      return "restart";
+    case ESP_RST_PANIC:
+      return "panic";
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+      return "watchdog";
+    case ESP_RST_BROWNOUT:
+      return "brownout";
+    default:
+      return "other";
+  }
+}
+#else
+std::mutex lock;
+#define PROFILER_LOCK() lock.lock()
+#define PROFILER_UNLOCK() lock.unlock()
+
+uint32_t freeHeap() { return static_cast<uint32_t>(mallinfo2().fordblks); }
+// glibc has no cheap way to find the largest free block, the host has no shortage of memory anyway
+uint32_t largestFreeBlock() { return freeHeap(); }
+const char* resetReason() { return "host"; }
+#endif
+
+void updateLow(const uint32_t free) {
+  PROFILER_LOCK();
+  activityLowFree = std::min(activityLowFree, free);
+  PROFILER_UNLOCK();
+}
+
+// Append a line of the report, the newline is added here
+void appendLine(const char* line) {
+  SdMan.mkdir(LOG_DIR);
+  FsFile log = SdMan.open(LOG_FILE, O_WRONLY | O_CREAT | O_APPEND);
+  if (!log) {
+    return;
+  }
+  if (log.size() > LOG_MAX_SIZE) {
+    // Keep one older log, so the lines before a crash are not lost right after rolling over
+    SdMan.remove(OLD_LOG_FILE);
+    log.rename(OLD_LOG_FILE);
+    log.close();
+    log = SdMan.open(LOG_FILE, O_WRONLY | O_CREAT | O_APPEND);
+    if (!log) {
+      return;
+    }
+  }
+  log.write(reinterpret_cast<const uint8_t*>(line), strlen(line));
+  log.write('\n');
+  log.close();
+}
+}  // namespace
+
+heapProfiler::Snapshot heapProfiler::snapshot() {
+  Snapshot snapshot{};
+#if defined(ESP32)
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  snapshot.freeBytes = info.total_free_bytes;
+  snapshot.largestFreeBlock = info.largest_free_block;
+  snapshot.minFreeBytes = info.minimum_free_bytes;
+  snapshot.allocatedBlocks = info.allocated_blocks;
+  snapshot.freeBlocks = info.free_blocks;
+#else
+  const struct mallinfo2 info = mallinfo2();
+  snapshot.freeBytes = info.fordblks;
+  snapshot.largestFreeBlock = info.fordblks;
+  snapshot.minFreeBytes = info.fordblks;
+  snapshot.allocatedBlocks = 0;
+  snapshot.freeBlocks = info.ordblks;
+#endif
+  return snapshot;
+}
+
+void heapProfiler::recordAllocation(const AllocSite site, const size_t size, const bool succeeded) {
+  const uint32_t free = freeHeap();
+  PROFILER_LOCK();
+  SiteStats& stats = sites[site];
+  stats.count++;
+  stats.largestRequest = std::max(stats.largestRequest, static_cast<uint32_t>(size));
+  activityLowFree = std::min(activityLowFree, free);
+  if (!succeeded) {
+    stats.failed++;
+  }
+  PROFILER_UNLOCK();
+
+  if (!succeeded) {
+    // Walking the heap is only worth it when it tells why an allocation failed
+    Serial.printf("[%lu] [HEAP] %s allocation of %zu bytes failed, free: %u bytes, largest block: %u bytes\n",
+                  millis(), SITE_NAMES[site], size, static_cast<unsigned>(free),
+                  static_cast<unsigned>(largestFreeBlock()));
+  }
+}
+
+void heapProfiler::sample() { updateLow(freeHeap()); }
+
+void heapProfiler::logBoot() {
+  char line[32];
+  snprintf(line, sizeof(line), "boot reset=%s", resetReason());
+  appendLine(line);
+}
+
+void heapProfiler::logEnter(const char* activity, const std::string& book) {
+  const Snapshot heap = snapshot();
+  PROFILER_LOCK();
+  for (auto& stats : sites) {
+    stats = {};
+  }
+  activityLowFree = heap.freeBytes;
+  PROFILER_UNLOCK();
+
+  char line[256];
+  snprintf(line, sizeof(line), "[%lu] enter %s book=\"%s\" free=%u largest=%u blocks=%u/%u bootLow=%u", millis(),
+           activity, book.c_str(), static_cast<unsigned>(heap.freeBytes), static_cast<unsigned>(heap.largestFreeBlock),
+           static_cast<unsigned>(heap.allocatedBlocks), static_cast<unsigned>(heap.freeBlocks),
+           static_cast<unsigned>(heap.minFreeBytes));
+  appendLine(line);
+}
+
+void heapProfiler::logExit(const char* activity, const std::string& book) {
+  const Snapshot heap = snapshot();
+  SiteStats siteStats[ALLOC_SITE_COUNT];
+  PROFILER_LOCK();
+  for (size_t i = 0; i < ALLOC_SITE_COUNT; i++) {
+    siteStats[i] = sites[i];
+  }
+  const uint32_t low = std::min(activityLowFree, heap.freeBytes);
+  PROFILER_UNLOCK();
+
+  char line[384];
+  size_t length = snprintf(line, sizeof(line),
+                           "[%lu] exit %s book=\"%s\" free=%u largest=%u blocks=%u/%u low=%u bootLow=%u", millis(),
+                           activity, book.c_str(), static_cast<unsigned>(heap.freeBytes),
+                           static_cast<unsigned>(heap.largestFreeBlock), static_cast<unsigned>(heap.allocatedBlocks),
+                           static_cast<unsigned>(heap.freeBlocks), static_cast<unsigned>(low),
+                           static_cast<unsigned>(heap.minFreeBytes));
+  // Large allocations made while the activity ran, as count/failed/largest request
+  for (size_t i = 0; i < ALLOC_SITE_COUNT && length < sizeof(line); i++) {
+    const SiteStats& stats = siteStats[i];
+    if (stats.count > 0) {
+      length += snprintf(line + length, sizeof(line) - length, " %s=%u/%u/%u", SITE_NAMES[i],
+                         static_cast<unsigned>(stats.count), static_cast<unsigned>(stats.failed),
+                         static_cast<unsigned>(stats.largestRequest));
+    }
+  }
+  appendLine(line);
+
+  Serial.printf("[%lu] [HEAP] Left %s with %u bytes free, largest block %u bytes, low %u bytes\n", millis(), activity,
+                static_cast<unsigned>(heap.freeBytes), static_cast<unsigned>(heap.largestFreeBlock),
+                static_cast<unsigned>(low));
+}
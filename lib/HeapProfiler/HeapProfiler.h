@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Heap usage per activity, to find out which activity and book leave the heap too fragmented for the next large
+ * allocation. main.cpp reports every activity transition, the largest buffers report each allocation, and a line per
+ * transition is appended to /.crosspoint/heap.log on the SD card (the previous log is kept as heap.log.1), so the
+ * history survives the crash it is meant to explain.
+ *
+ * Only cheap counters are touched on the allocation paths, the heap is walked on transitions.
+ */
+namespace heapProfiler {
+enum AllocSite : uint8_t {
+  BW_BUFFER,     // GfxRenderer::storeBwBuffer chunks
+  ZIP_READ,      // whole files read into memory from a ZIP
+  ZIP_INFLATE,   // streaming inflate dictionary
+  JPEG_MCU_ROW,  // JPEG to BMP conversion row buffers
+  ALLOC_SITE_COUNT
+};
+
+struct Snapshot {
+  uint32_t freeBytes;
+  uint32_t largestFreeBlock;
+  // Lowest free heap since boot
+  uint32_t minFreeBytes;
+  uint32_t allocatedBlocks;
+  uint32_t freeBlocks;
+};
+
+Snapshot snapshot();
+
+// Call right after allocating a large buffer, whether or not the allocation succeeded
+void recordAllocation(AllocSite site, size_t size, bool succeeded);
+
+// Track the lowest free heap of the current activity, cheap enough to call on every loop
+void sample();
+
+// Log the reason of the last reset, so a crash shows up between the lines of the activity it happened in
+void logBoot();
+// Log the heap before an activity starts and reset the per-activity counters
+void logEnter(const char* activity, const std::string& book);
+// Log the heap after an activity was deleted, with its lowest free heap and allocations
+void logExit(const char* activity, const std::string& book);
+}  // namespace heapProfiler
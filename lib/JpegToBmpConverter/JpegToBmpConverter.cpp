@@ -1,6 +1,7 @@
 #include "JpegToBmpConverter.h"
 
 #include <HardwareSerial.h>
+#include <HeapProfiler.h>
 #include <SdFat.h>
 #include <picojpeg.h>
 
@@ -296,6 +297,7 @@ bool JpegToBmpConverter::jpegFileToBmpStreamInternal(FsFile& jpegFile, Print& bm
   }
 
   auto* mcuRowBuffer = static_cast<uint8_t*>(malloc(mcuRowPixels));
+  heapProfiler::recordAllocation(heapProfiler::JPEG_MCU_ROW, mcuRowPixels, mcuRowBuffer != nullptr);
   if (!mcuRowBuffer) {
     Serial.printf("[%lu] [JPG] Failed to allocate MCU row buffer (%d bytes)\n", millis(), mcuRowPixels);
     free(rowBuffer);
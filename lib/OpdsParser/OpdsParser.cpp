@@ -4,7 +4,9 @@
 
 #include <cstring>
 
-OpdsParser::~OpdsParser() {
+OpdsParser::~OpdsParser() { freeParser(); }
+
+void OpdsParser::freeParser() {
   if (parser) {
     XML_StopParser(parser, XML_FALSE);
     XML_SetElementHandler(parser, nullptr, nullptr);
@@ -15,6 +17,17 @@ OpdsParser::~OpdsParser() {
 }
 
 bool OpdsParser::parse(const char* xmlData, const size_t length) {
+  if (!begin()) {
+    return false;
+  }
+  if (!feed(xmlData, length)) {
+    return false;
+  }
+  return finish();
+}
+
+bool OpdsParser::begin() {
+  freeParser();
   clear();
 
   parser = XML_ParserCreate(nullptr);
@@ -26,47 +39,61 @@ bool OpdsParser::parse(const char* xmlData, const size_t length) {
   XML_SetUserData(parser, this);
   XML_SetElementHandler(parser, startElement, endElement);
   XML_SetCharacterDataHandler(parser, characterData);
+  return true;
+}
+
+bool OpdsParser::feed(const char* data, const size_t length) { return parseChunk(data, length, false); }
+
+bool OpdsParser::finish() {
+  if (!parseChunk(nullptr, 0, true)) {
+    return false;
+  }
+
+  freeParser();
+  Serial.printf("[%lu] [OPDS] Parsed %zu entries%s\n", millis(), entries.size(),
+                nextUrl.empty() ? "" : " (more pages)");
+  return true;
+}
+
+bool OpdsParser::parseChunk(const char* data, size_t length, const bool isFinal) {
+  if (!parser) {
+    return false;
+  }
 
   // Parse in chunks to avoid large buffer allocations
-  const char* currentPos = xmlData;
-  size_t remaining = length;
   constexpr size_t chunkSize = 1024;
 
-  while (remaining > 0) {
+  do {
     void* const buf = XML_GetBuffer(parser, chunkSize);
     if (!buf) {
       Serial.printf("[%lu] [OPDS] Couldn't allocate memory for buffer\n", millis());
-      XML_ParserFree(parser);
-      parser = nullptr;
+      freeParser();
       return false;
     }
 
-    const size_t toRead = remaining < chunkSize ? remaining : chunkSize;
-    memcpy(buf, currentPos, toRead);
+    const size_t toRead = length < chunkSize ? length : chunkSize;
+    if (toRead > 0) {
+      memcpy(buf, data, toRead);
+    }
 
-    const bool isFinal = (remaining == toRead);
-    if (XML_ParseBuffer(parser, static_cast<int>(toRead), isFinal) == XML_STATUS_ERROR) {
+    const bool lastChunk = isFinal && length == toRead;
+    if (XML_ParseBuffer(parser, static_cast<int>(toRead), lastChunk) == XML_STATUS_ERROR) {
       Serial.printf("[%lu] [OPDS] Parse error at line %lu: %s\n", millis(), XML_GetCurrentLineNumber(parser),
                     XML_ErrorString(XML_GetErrorCode(parser)));
-      XML_ParserFree(parser);
-      parser = nullptr;
+      freeParser();
       return false;
     }
 
-    currentPos += toRead;
-    remaining -= toRead;
-  }
-
-  // Clean up parser
-  XML_ParserFree(parser);
-  parser = nullptr;
+    data += toRead;
+    length -= toRead;
+  } while (length > 0);
 
-  Serial.printf("[%lu] [OPDS] Parsed %zu entries\n", millis(), entries.size());
   return true;
 }
 
 void OpdsParser::clear() {
   entries.clear();
+  nextUrl.clear();
   currentEntry = OpdsEntry{};
   currentText.clear();
   inEntry = false;
@@ -105,7 +132,17 @@ void XMLCALL OpdsParser::startElement(void* userData, const XML_Char* name, cons
     return;
   }
 
-  if (!self->inEntry) return;
+  if (!self->inEntry) {
+    // Feed-level link to the next page of a paginated catalog
+    if (strcmp(name, "link") == 0 || strstr(name, ":link") != nullptr) {
+      const char* rel = findAttribute(atts, "rel");
+      const char* href = findAttribute(atts, "href");
+      if (rel && href && strcmp(rel, "next") == 0) {
+        self->nextUrl = href;
+      }
+    }
+    return;
+  }
 
   // Check for title element
   if (strcmp(name, "title") == 0 || strstr(name, ":title") != nullptr) {
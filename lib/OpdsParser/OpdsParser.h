@@ -2,6 +2,7 @@
 #include <expat.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -41,6 +42,12 @@ using OpdsBook = OpdsEntry;
  *       }
  *     }
  *   }
+ *
+ * Feeds can also be parsed incrementally as they arrive from the network, so the raw XML never has to be
+ * held in memory:
+ *   parser.begin();
+ *   while (...) parser.feed(chunk, chunkLength);
+ *   parser.finish();
  */
 class OpdsParser {
  public:
@@ -59,12 +66,40 @@ class OpdsParser {
    */
   bool parse(const char* xmlData, size_t length);
 
+  /**
+   * Start an incremental parse, discarding any previous results.
+   * @return false if the XML parser couldn't be allocated
+   */
+  bool begin();
+
+  /**
+   * Parse the next chunk of the feed. Chunks may split elements or UTF-8 sequences anywhere.
+   * @return false on a parse error; the parse is over and further calls fail
+   */
+  bool feed(const char* data, size_t length);
+
+  /**
+   * Signal the end of the feed and release the XML parser.
+   * @return true if the whole feed was well formed
+   */
+  bool finish();
+
+  /**
+   * URL of the next page of a paginated feed (<link rel="next">), empty if this is the last page.
+   */
+  const std::string& getNextUrl() const { return nextUrl; }
+
   /**
    * Get the parsed entries (both navigation and book entries).
    * @return Vector of OpdsEntry entries
    */
   const std::vector<OpdsEntry>& getEntries() const { return entries; }
 
+  /**
+   * Move the parsed entries out of the parser, avoiding a copy of every entry.
+   */
+  std::vector<OpdsEntry> takeEntries() { return std::move(entries); }
+
   /**
    * Get only book entries (legacy compatibility).
    * @return Vector of book entries
@@ -85,8 +120,12 @@ class OpdsParser {
   // Helper to find attribute value
   static const char* findAttribute(const XML_Char** atts, const char* name);
 
+  bool parseChunk(const char* data, size_t length, bool isFinal);
+  void freeParser();
+
   XML_Parser parser = nullptr;
   std::vector<OpdsEntry> entries;
+  std::string nextUrl;
   OpdsEntry currentEntry;
   std::string currentText;
 
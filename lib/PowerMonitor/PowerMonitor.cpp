@@ -0,0 +1,251 @@
+#include "PowerMonitor.h"
+
+#include <Arduino.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+namespace {
+constexpr uint8_t STATS_FILE_VERSION = 2;
+constexpr char STATS_FILE[] = "/.crosspoint/power.bin";
+constexpr char OTHER_ACTIVITY[] = "Other";
+constexpr char SLEEP_ACTIVITY[] = "Sleep";
+
+// Typical currents, rough figures for the ESP32-C3, the e-paper controller and an SD card. The estimates are only as
+// good as these; compare them with the measured battery drop to tune them.
+constexpr float AWAKE_MA = 20;          // CPU awake, waiting in delay() without light sleep
+constexpr float LIGHT_SLEEP_MA = 0.35f;  // CPU light sleeping between input polls
+constexpr float BUSY_MA = 10;           // on top of AWAKE_MA while the main loop works
+constexpr float WIFI_MA = 80;           // radio on, receiving most of the time
+constexpr float SD_MA = 30;             // card reading or writing
+constexpr float DISPLAY_MA = 12;        // panel charge pump running during a refresh
+constexpr float MA_MS_PER_MAH = 3600.0f * 1000.0f;
+
+using powerMonitor::MAX_ACTIVITIES;
+using powerMonitor::Stats;
+
+Stats activities[MAX_ACTIVITIES];
+size_t activityCount = 0;
+Stats* current = nullptr;
+uint32_t lastSampleMs = 0;
+bool wifiOn = false;
+// SD time is measured in microseconds, whole milliseconds are moved to the current activity when sampling
+uint32_t pendingSdUs = 0;
+// Light sleep since the last sample, taken out of its awake time
+uint32_t pendingLightSleepMs = 0;
+// Last battery reading drops are counted from, -1 before the first one
+int16_t batteryBaseline = -1;
+
+#if defined(ESP32)
+portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+#define POWER_LOCK() portENTER_CRITICAL(&lock)
+#define POWER_UNLOCK() portEXIT_CRITICAL(&lock)
+#else
+std::mutex lock;
+#define POWER_LOCK() lock.lock()
+#define POWER_UNLOCK() lock.unlock()
+#endif
+
+// Caller holds the lock
+Stats* find(const char* activity) {
+  for (size_t i = 0; i < activityCount; i++) {
+    if (strcmp(activities[i].activity, activity) == 0) {
+      return &activities[i];
+    }
+  }
+  if (activityCount == MAX_ACTIVITIES) {
+    return &activities[MAX_ACTIVITIES - 1];
+  }
+  Stats& stats = activities[activityCount++];
+  stats = {};
+  // The last slot is kept for everything that does not fit
+  strncpy(stats.activity, activityCount == MAX_ACTIVITIES ? OTHER_ACTIVITY : activity, sizeof(stats.activity) - 1);
+  return &stats;
+}
+
+// Caller holds the lock. Charges the time since the last sample to the current activity.
+void accumulate() {
+  const uint32_t now = millis();
+  const uint32_t elapsed = now - lastSampleMs;
+  lastSampleMs = now;
+  const uint32_t slept = std::min(pendingLightSleepMs, elapsed);
+  pendingLightSleepMs = 0;
+  if (!current) {
+    return;
+  }
+  current->awakeMs += elapsed - slept;
+  current->lightSleepMs += slept;
+  if (wifiOn) {
+    current->wifiMs += elapsed;
+  }
+  current->sdMs += pendingSdUs / 1000;
+  pendingSdUs %= 1000;
+}
+
+// Caller holds the lock
+void chargeBattery(Stats& stats, const uint8_t percent) {
+  if (batteryBaseline >= 0 && percent < batteryBaseline) {
+    stats.batteryDrop += batteryBaseline - percent;
+    batteryBaseline = percent;
+  } else if (batteryBaseline < 0 || percent >= batteryBaseline + 2) {
+    // Charging; a single point up is more likely noise of the voltage reading
+    batteryBaseline = percent;
+  }
+}
+
+bool load() {
+  FsFile file;
+  if (!SdMan.openFileForRead("PWR", STATS_FILE, file)) {
+    return false;
+  }
+  uint8_t version;
+  uint8_t count;
+  serialization::readPod(file, version);
+  if (version != STATS_FILE_VERSION) {
+    Serial.printf("[%lu] [PWR] Deserialization failed: Unknown version %u\n", millis(), version);
+    file.close();
+    return false;
+  }
+  serialization::readPod(file, batteryBaseline);
+  serialization::readPod(file, count);
+  activityCount = std::min<size_t>(count, MAX_ACTIVITIES);
+  for (size_t i = 0; i < activityCount; i++) {
+    serialization::readPod(file, activities[i]);
+    activities[i].activity[sizeof(activities[i].activity) - 1] = '\0';
+  }
+  file.close();
+  return true;
+}
+}  // namespace
+
+void powerMonitor::begin(const uint8_t batteryPercent) {
+  load();
+  POWER_LOCK();
+  lastSampleMs = millis();
+  // The battery drained by deep sleep since the totals were last saved
+  chargeBattery(*find(SLEEP_ACTIVITY), batteryPercent);
+  POWER_UNLOCK();
+}
+
+void powerMonitor::enter(const char* activity) {
+  POWER_LOCK();
+  accumulate();
+  current = find(activity);
+  POWER_UNLOCK();
+}
+
+void powerMonitor::sample(const uint32_t busyMs, const bool wifi) {
+  POWER_LOCK();
+  wifiOn = wifi;
+  accumulate();
+  if (current) {
+    current->busyMs += busyMs;
+  }
+  POWER_UNLOCK();
+}
+
+void powerMonitor::recordLightSleep(const uint32_t ms) {
+  POWER_LOCK();
+  pendingLightSleepMs += ms;
+  POWER_UNLOCK();
+}
+
+void powerMonitor::recordBattery(const uint8_t percent) {
+  POWER_LOCK();
+  if (current) {
+    chargeBattery(*current, percent);
+  }
+  POWER_UNLOCK();
+}
+
+void powerMonitor::recordRefresh(const Refresh kind, const uint32_t ms) {
+  POWER_LOCK();
+  if (current) {
+    current->refreshCount[kind]++;
+    current->refreshMs[kind] += ms;
+  }
+  POWER_UNLOCK();
+}
+
+void powerMonitor::recordPage() {
+  POWER_LOCK();
+  if (current) {
+    current->pages++;
+  }
+  POWER_UNLOCK();
+}
+
+void powerMonitor::save() {
+  Stats copy[MAX_ACTIVITIES];
+  POWER_LOCK();
+  accumulate();
+  const auto count = static_cast<uint8_t>(activityCount);
+  const int16_t baseline = batteryBaseline;
+  std::copy(activities, activities + activityCount, copy);
+  POWER_UNLOCK();
+
+  FsFile file;
+  if (!SdMan.openFileForWrite("PWR", STATS_FILE, file)) {
+    return;
+  }
+  serialization::writePod(file, STATS_FILE_VERSION);
+  serialization::writePod(file, baseline);
+  serialization::writePod(file, count);
+  for (size_t i = 0; i < count; i++) {
+    serialization::writePod(file, copy[i]);
+  }
+  file.close();
+}
+
+void powerMonitor::reset(const uint8_t batteryPercent) {
+  POWER_LOCK();
+  const char* activity = current ? current->activity : nullptr;
+  char name[sizeof(Stats::activity)] = {};
+  if (activity) {
+    strncpy(name, activity, sizeof(name) - 1);
+  }
+  activityCount = 0;
+  pendingSdUs = 0;
+  pendingLightSleepMs = 0;
+  lastSampleMs = millis();
+  batteryBaseline = batteryPercent;
+  current = activity ? find(name) : nullptr;
+  POWER_UNLOCK();
+  save();
+}
+
+size_t powerMonitor::snapshot(Stats* out, const size_t capacity) {
+  POWER_LOCK();
+  accumulate();
+  const size_t count = std::min(capacity, activityCount);
+  std::copy(activities, activities + count, out);
+  POWER_UNLOCK();
+  std::sort(out, out + count, [](const Stats& a, const Stats& b) { return estimateMah(a) > estimateMah(b); });
+  return count;
+}
+
+float powerMonitor::estimateMah(const Stats& stats) {
+  float maMs = stats.awakeMs * AWAKE_MA + stats.lightSleepMs * LIGHT_SLEEP_MA + stats.busyMs * BUSY_MA +
+               stats.wifiMs * WIFI_MA + stats.sdMs * SD_MA;
+  for (size_t i = 0; i < REFRESH_KIND_COUNT; i++) {
+    maMs += stats.refreshMs[i] * DISPLAY_MA;
+  }
+  return maMs / MA_MS_PER_MAH;
+}
+
+powerMonitor::SdTransfer::SdTransfer() : start(micros()) {}
+
+powerMonitor::SdTransfer::~SdTransfer() {
+  const uint32_t elapsed = micros() - start;
+  POWER_LOCK();
+  pendingSdUs += elapsed;
+  POWER_UNLOCK();
+}
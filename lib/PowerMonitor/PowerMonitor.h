@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Where the battery goes, per activity. The time each activity keeps the device awake is split into what draws
+ * current on top of the idle CPU: main loop work, display refreshes by type, WiFi and SD transfers. Each part is
+ * weighted with a typical current to estimate the charge used, and the battery percentage is sampled to count the
+ * percent points actually lost while the activity was open (and pages read per point for the readers).
+ *
+ * main.cpp reports activity changes, main loop work and the battery; the renderer, the cache file streams and the
+ * book readers report their own work. Totals are kept in /.crosspoint/power.bin across restarts and shown in
+ * settings, see PowerStatsActivity.
+ */
+namespace powerMonitor {
+// Activities with totals of their own, later ones share the last slot
+constexpr size_t MAX_ACTIVITIES = 16;
+
+// The first three match EInkDisplay::RefreshMode
+enum Refresh : uint8_t { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH, GRAY_REFRESH, REFRESH_KIND_COUNT };
+
+struct Stats {
+  char activity[24];
+  uint32_t awakeMs;
+  // Light sleep between input polls, not part of awakeMs
+  uint32_t lightSleepMs;
+  // Main loop work, the rest of the awake time was spent waiting for input or the display
+  uint32_t busyMs;
+  uint32_t wifiMs;
+  uint32_t sdMs;
+  uint32_t refreshCount[REFRESH_KIND_COUNT];
+  uint32_t refreshMs[REFRESH_KIND_COUNT];
+  uint32_t pages;
+  // Battery percent points lost while the activity was open
+  uint32_t batteryDrop;
+};
+
+// Load the totals and count the battery lost during deep sleep against "Sleep"
+void begin(uint8_t batteryPercent);
+// Charge the time from now on to activity
+void enter(const char* activity);
+// Call on every main loop, with the time it spent working and whether WiFi is on
+void sample(uint32_t busyMs, bool wifiOn);
+// The main loop light slept for ms
+void recordLightSleep(uint32_t ms);
+// Call now and then, a drop since the last reading is charged to the current activity
+void recordBattery(uint8_t percent);
+void recordRefresh(Refresh kind, uint32_t ms);
+// A reader page was shown
+void recordPage();
+// Write the totals to the SD card
+void save();
+// Forget all totals, the battery is counted again from percent
+void reset(uint8_t batteryPercent);
+
+// Copies of the totals, sorted by estimated charge, returns how many were written. Pass MAX_ACTIVITIES to get all.
+size_t snapshot(Stats* out, size_t capacity);
+// Estimated charge the parts of stats used, in mAh
+float estimateMah(const Stats& stats);
+
+// Times an SD transfer on the stack, the caller's activity is charged for it
+class SdTransfer {
+  uint32_t start;
+
+ public:
+  SdTransfer();
+  ~SdTransfer();
+  SdTransfer(const SdTransfer&) = delete;
+  SdTransfer& operator=(const SdTransfer&) = delete;
+};
+
+// Run transfer timed as above: const size_t read = powerMonitor::sdTransfer([&] { return file.read(data, size); });
+template <typename Transfer>
+auto sdTransfer(Transfer&& transfer) -> decltype(transfer()) {
+  const SdTransfer timer;
+  return transfer();
+}
+}  // namespace powerMonitor
@@ -0,0 +1,90 @@
+#include "BufferedFsStream.h"
+
+#include <PowerMonitor.h>
+
+#include <algorithm>
+#include <cstring>
+
+size_t BufferedFsWriter::write(const uint8_t* data, const size_t size) {
+  size_t written = 0;
+  while (written < size) {
+    // Nothing to gain from copying a whole buffer's worth
+    if (used == 0 && size - written >= BUFFER_SIZE) {
+      const size_t direct = powerMonitor::sdTransfer([&] { return file.write(data + written, size - written); });
+      return direct == size - written ? size : 0;
+    }
+    const size_t chunk = std::min(BUFFER_SIZE - used, size - written);
+    memcpy(buffer + used, data + written, chunk);
+    used += chunk;
+    written += chunk;
+    if (used == BUFFER_SIZE && !flush()) {
+      return 0;
+    }
+  }
+  return size;
+}
+
+bool BufferedFsWriter::flush() {
+  if (used == 0) {
+    return true;
+  }
+  const bool ok = powerMonitor::sdTransfer([&] { return file.write(buffer, used); }) == used;
+  used = 0;
+  return ok;
+}
+
+size_t BufferedFsReader::read(uint8_t* data, const size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    if (used == length) {
+      // The file is positioned right after the buffered bytes
+      bufferStart += length;
+      length = 0;
+      used = 0;
+      const size_t remaining = size - done;
+      if (remaining >= BUFFER_SIZE) {
+        const int count = powerMonitor::sdTransfer([&] { return file.read(data + done, remaining); });
+        if (count > 0) {
+          bufferStart += count;
+          done += count;
+        }
+        break;
+      }
+      const int count = powerMonitor::sdTransfer([&] { return file.read(buffer, BUFFER_SIZE); });
+      if (count <= 0) {
+        break;
+      }
+      length = count;
+    }
+    const size_t chunk = std::min(size - done, length - used);
+    memcpy(data + done, buffer + used, chunk);
+    used += chunk;
+    done += chunk;
+  }
+  return done;
+}
+
+bool BufferedFsReader::seek(const uint32_t position) {
+  if (position >= bufferStart && position <= bufferStart + length) {
+    used = position - bufferStart;
+    return true;
+  }
+
+  // Refill from the start of the sector, so the reads that follow stay sector aligned
+  const uint32_t start = position - position % BUFFER_SIZE;
+  length = 0;
+  used = 0;
+  if (!file.seek(start)) {
+    bufferStart = static_cast<uint32_t>(file.position());
+    return false;
+  }
+  bufferStart = start;
+  const int count = powerMonitor::sdTransfer([&] { return file.read(buffer, BUFFER_SIZE); });
+  length = count > 0 ? count : 0;
+  if (position - start > length) {
+    // Past the end of the file
+    return false;
+  }
+  used = position - start;
+  return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <SdFat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Buffered access to cache files that are written and read a few bytes at a time (serialization::writePod and
+ * friends). Each FsFile call is a trip through SdFat, so the small reads and writes are collected into transfers of
+ * BUFFER_SIZE (one SD sector) and only larger ones go straight to the file.
+ *
+ * Both wrap a file without owning it and keep the buffer inline. The file must not be used directly while a writer
+ * has unflushed bytes, or in between reads through a reader.
+ */
+class BufferedFsWriter {
+ public:
+  static constexpr size_t BUFFER_SIZE = 512;
+
+  explicit BufferedFsWriter(FsFile& file) : file(file) {}
+  ~BufferedFsWriter() { flush(); }
+  BufferedFsWriter(const BufferedFsWriter&) = delete;
+  BufferedFsWriter& operator=(const BufferedFsWriter&) = delete;
+
+  size_t write(const uint8_t* data, size_t size);
+  size_t write(const uint8_t c) { return write(&c, 1); }
+  // Hand the buffered bytes to the file, false if it did not take all of them
+  bool flush();
+  // Forget the buffered bytes, for a file that is about to be closed and removed
+  void discard() { used = 0; }
+  // Where the next write lands in the file
+  uint32_t position() const { return static_cast<uint32_t>(file.position()) + used; }
+
+ private:
+  FsFile& file;
+  size_t used = 0;
+  uint8_t buffer[BUFFER_SIZE];
+};
+
+class BufferedFsReader {
+ public:
+  static constexpr size_t BUFFER_SIZE = 512;
+
+  // Reads from the current position of file
+  explicit BufferedFsReader(FsFile& file) : file(file), bufferStart(static_cast<uint32_t>(file.position())) {}
+  BufferedFsReader(const BufferedFsReader&) = delete;
+  BufferedFsReader& operator=(const BufferedFsReader&) = delete;
+
+  // Returns the number of bytes read, less than size at the end of the file or on an error
+  size_t read(uint8_t* data, size_t size);
+  // Seeks inside the buffered bytes cost nothing, others refill the buffer right away
+  bool seek(uint32_t position);
+  uint32_t position() const { return bufferStart + used; }
+
+ private:
+  FsFile& file;
+  // File offset of buffer[0]
+  uint32_t bufferStart;
+  size_t length = 0;
+  size_t used = 0;
+  uint8_t buffer[BUFFER_SIZE];
+};
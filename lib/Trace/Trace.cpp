@@ -0,0 +1,163 @@
+#include "Trace.h"
+
+#ifdef CROSSPOINT_TRACE
+
+#include <Arduino.h>
+#include <Print.h>
+
+#include <cstring>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <malloc.h>
+
+#include <mutex>
+#include <thread>
+#endif
+
+#ifndef CROSSPOINT_TRACE_CAPACITY
+#define CROSSPOINT_TRACE_CAPACITY 1024
+#endif
+
+namespace {
+constexpr const char* SPAN_NAMES[] = {
+    "epub_load",      "section_build",    "zip_inflate", "xml_parse",       "line_break",
+    "page_serialize", "page_deserialize", "page_render", "display_refresh",
+};
+static_assert(sizeof(SPAN_NAMES) / sizeof(SPAN_NAMES[0]) == trace::SPAN_ID_COUNT, "A span id is missing a name");
+
+// Tasks seen so far, a span refers to its task by index
+constexpr size_t MAX_TASKS = 8;
+constexpr size_t TASK_NAME_SIZE = 16;
+
+struct Record {
+  uint32_t start;  // micros()
+  uint32_t duration;
+  int32_t heapDelta;
+  uint8_t id;
+  uint8_t task;
+  uint16_t reserved;
+};
+static_assert(sizeof(Record) == 16, "Trace records should stay small");
+
+Record records[CROSSPOINT_TRACE_CAPACITY];
+size_t nextRecord = 0;
+// All spans recorded since the last clear, including overwritten ones
+uint32_t recorded = 0;
+
+char taskNames[MAX_TASKS][TASK_NAME_SIZE];
+size_t taskCount = 0;
+
+#if defined(ESP32)
+TaskHandle_t taskHandles[MAX_TASKS];
+portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK() portENTER_CRITICAL(&lock)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&lock)
+
+// Heap in use, so a span's delta is positive when it left memory allocated
+int32_t heapInUse() { return -static_cast<int32_t>(ESP.getFreeHeap()); }
+
+uint8_t currentTask() {
+  const TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+  for (size_t i = 0; i < taskCount; i++) {
+    if (taskHandles[i] == handle) {
+      return i;
+    }
+  }
+  if (taskCount == MAX_TASKS) {
+    // Out of slots, later tasks share the last one
+    return MAX_TASKS - 1;
+  }
+  taskHandles[taskCount] = handle;
+  strncpy(taskNames[taskCount], pcTaskGetName(handle), TASK_NAME_SIZE - 1);
+  return taskCount++;
+}
+#else
+std::mutex lock;
+std::thread::id threadIds[MAX_TASKS];
+#define TRACE_LOCK() lock.lock()
+#define TRACE_UNLOCK() lock.unlock()
+
+int32_t heapInUse() { return static_cast<int32_t>(mallinfo2().uordblks); }
+
+uint8_t currentTask() {
+  const std::thread::id id = std::this_thread::get_id();
+  for (size_t i = 0; i < taskCount; i++) {
+    if (threadIds[i] == id) {
+      return i;
+    }
+  }
+  if (taskCount == MAX_TASKS) {
+    return MAX_TASKS - 1;
+  }
+  threadIds[taskCount] = id;
+  snprintf(taskNames[taskCount], TASK_NAME_SIZE, taskCount == 0 ? "main" : "thread %u",
+           static_cast<unsigned>(taskCount));
+  return taskCount++;
+}
+#endif
+}  // namespace
+
+trace::Span::Span(const SpanId id) : start(micros()), heapBefore(heapInUse()), id(id) {}
+
+trace::Span::~Span() {
+  const uint32_t duration = micros() - start;
+  const int32_t heapDelta = heapInUse() - heapBefore;
+
+  TRACE_LOCK();
+  Record& record = records[nextRecord];
+  record.start = start;
+  record.duration = duration;
+  record.heapDelta = heapDelta;
+  record.id = id;
+  record.task = currentTask();
+  nextRecord = (nextRecord + 1) % CROSSPOINT_TRACE_CAPACITY;
+  recorded++;
+  TRACE_UNLOCK();
+}
+
+void trace::clear() {
+  TRACE_LOCK();
+  nextRecord = 0;
+  recorded = 0;
+  TRACE_UNLOCK();
+}
+
+size_t trace::size() {
+  TRACE_LOCK();
+  const size_t count = recorded < CROSSPOINT_TRACE_CAPACITY ? recorded : CROSSPOINT_TRACE_CAPACITY;
+  TRACE_UNLOCK();
+  return count;
+}
+
+void trace::writeChromeJson(Print& out) {
+  // Printing takes far too long to hold the lock, spans that end meanwhile may overwrite the oldest records
+  TRACE_LOCK();
+  const size_t count = recorded < CROSSPOINT_TRACE_CAPACITY ? recorded : CROSSPOINT_TRACE_CAPACITY;
+  const size_t first = (nextRecord + CROSSPOINT_TRACE_CAPACITY - count) % CROSSPOINT_TRACE_CAPACITY;
+  const uint32_t dropped = recorded - count;
+  const size_t tasks = taskCount;
+  TRACE_UNLOCK();
+
+  out.printf("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%u},\"traceEvents\":[",
+             static_cast<unsigned>(dropped));
+  const char* separator = "\n";
+  for (size_t i = 0; i < tasks; i++) {
+    out.printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", separator,
+               static_cast<unsigned>(i), taskNames[i]);
+    separator = ",\n";
+  }
+  for (size_t i = 0; i < count; i++) {
+    const Record& record = records[(first + i) % CROSSPOINT_TRACE_CAPACITY];
+    out.printf("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lu,\"dur\":%lu,\"args\":{\"heap\":%ld}}",
+               separator, record.id < trace::SPAN_ID_COUNT ? SPAN_NAMES[record.id] : "unknown", record.task,
+               static_cast<unsigned long>(record.start), static_cast<unsigned long>(record.duration),
+               static_cast<long>(record.heapDelta));
+    separator = ",\n";
+  }
+  out.printf("\n]}\n");
+}
+
+#endif
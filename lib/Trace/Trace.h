@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class Print;
+
+/**
+ * Scoped timing spans, recorded into a ring buffer in RAM and dumped as Chrome trace JSON (open the dump in
+ * chrome://tracing or ui.perfetto.dev). A span records when it started, how long it took, and how much the heap in
+ * use grew while it was open, on the task it ran on.
+ *
+ * Tracing is only compiled in with -DCROSSPOINT_TRACE=1 (see the trace environment in platformio.ini). Without it
+ * TRACE_SPAN expands to nothing and none of this costs code, RAM or time. The buffer keeps the last
+ * CROSSPOINT_TRACE_CAPACITY spans (16 bytes each), older ones are overwritten.
+ *
+ * Usage: TRACE_SPAN(XML_PARSE); at the top of the scope to measure.
+ */
+namespace trace {
+enum SpanId : uint8_t {
+  EPUB_LOAD,
+  SECTION_BUILD,
+  ZIP_INFLATE,
+  XML_PARSE,
+  LINE_BREAK,
+  PAGE_SERIALIZE,
+  PAGE_DESERIALIZE,
+  PAGE_RENDER,
+  DISPLAY_REFRESH,
+  SPAN_ID_COUNT
+};
+
+#ifdef CROSSPOINT_TRACE
+class Span {
+  uint32_t start;
+  int32_t heapBefore;
+  SpanId id;
+
+ public:
+  explicit Span(SpanId id);
+  ~Span();
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+};
+
+// Write the buffered spans, oldest first, as a Chrome trace JSON object
+void writeChromeJson(Print& out);
+void clear();
+// Spans currently in the buffer
+size_t size();
+#endif
+}  // namespace trace
+
+#ifdef CROSSPOINT_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(id) const trace::Span TRACE_CONCAT(traceSpan, __LINE__)(trace::id)
+#else
+#define TRACE_SPAN(id) \
+  do {                 \
+  } while (0)
+#endif
@@ -9,6 +9,7 @@
 
 #include <FsHelpers.h>
 #include <HardwareSerial.h>
+#include <PowerMonitor.h>
 #include <SDCardManager.h>
 
 #include <cstring>
@@ -353,7 +354,7 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
   }
 
   // Read bitmap data
-  size_t bytesRead = m_file.read(buffer, bitmapSize);
+  size_t bytesRead = powerMonitor::sdTransfer([&] { return m_file.read(buffer, bitmapSize); });
   if (bytesRead != bitmapSize) {
     Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, bytesRead);
     m_lastError = XtcError::READ_ERROR;
@@ -406,7 +407,7 @@ XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
 
   while (totalRead < bitmapSize) {
     size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
-    size_t bytesRead = m_file.read(chunk.data(), toRead);
+    size_t bytesRead = powerMonitor::sdTransfer([&] { return m_file.read(chunk.data(), toRead); });
 
     if (bytesRead == 0) {
       return XtcError::READ_ERROR;
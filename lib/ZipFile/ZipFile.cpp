@@ -1,10 +1,14 @@
 #include "ZipFile.h"
 
 #include <HardwareSerial.h>
+#include <HeapProfiler.h>
+#include <PowerMonitor.h>
 #include <SDCardManager.h>
+#include <Trace.h>
 #include <miniz.h>
 
 bool inflateOneShot(const uint8_t* inputBuf, const size_t deflatedSize, uint8_t* outputBuf, const size_t inflatedSize) {
+  TRACE_SPAN(ZIP_INFLATE);
   // Setup inflator
   const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
   if (!inflator) {
@@ -294,6 +298,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
   const auto inflatedDataSize = fileStat.uncompressedSize;
   const auto dataSize = trailingNullByte ? inflatedDataSize + 1 : inflatedDataSize;
   const auto data = static_cast<uint8_t*>(malloc(dataSize));
+  heapProfiler::recordAllocation(heapProfiler::ZIP_READ, dataSize, data != nullptr);
   if (data == nullptr) {
     Serial.printf("[%lu] [ZIP] Failed to allocate memory for output buffer (%zu bytes)\n", millis(), dataSize);
     if (!wasOpen) {
@@ -304,7 +309,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
 
   if (fileStat.method == MZ_NO_COMPRESSION) {
     // no deflation, just read content
-    const size_t dataRead = file.read(data, inflatedDataSize);
+    const size_t dataRead = powerMonitor::sdTransfer([&] { return file.read(data, inflatedDataSize); });
     if (!wasOpen) {
       close();
     }
@@ -319,6 +324,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
   } else if (fileStat.method == MZ_DEFLATED) {
     // Read out deflated content from file
     const auto deflatedData = static_cast<uint8_t*>(malloc(deflatedDataSize));
+    heapProfiler::recordAllocation(heapProfiler::ZIP_READ, deflatedDataSize, deflatedData != nullptr);
     if (deflatedData == nullptr) {
       Serial.printf("[%lu] [ZIP] Failed to allocate memory for decompression buffer\n", millis());
       if (!wasOpen) {
@@ -327,7 +333,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
       return nullptr;
     }
 
-    const size_t dataRead = file.read(deflatedData, deflatedDataSize);
+    const size_t dataRead = powerMonitor::sdTransfer([&] { return file.read(deflatedData, deflatedDataSize); });
     if (!wasOpen) {
       close();
     }
@@ -395,7 +401,8 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
 
     size_t remaining = inflatedDataSize;
     while (remaining > 0) {
-      const size_t dataRead = file.read(buffer, remaining < chunkSize ? remaining : chunkSize);
+      const size_t dataRead =
+          powerMonitor::sdTransfer([&] { return file.read(buffer, remaining < chunkSize ? remaining : chunkSize); });
       if (dataRead == 0) {
         Serial.printf("[%lu] [ZIP] Could not read more bytes\n", millis());
         free(buffer);
@@ -417,6 +424,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
   }
 
   if (fileStat.method == MZ_DEFLATED) {
+    TRACE_SPAN(ZIP_INFLATE);
     // Setup inflator
     const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
     if (!inflator) {
@@ -441,6 +449,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
     }
 
     const auto outputBuffer = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
+    heapProfiler::recordAllocation(heapProfiler::ZIP_INFLATE, TINFL_LZ_DICT_SIZE, outputBuffer != nullptr);
     if (!outputBuffer) {
       Serial.printf("[%lu] [ZIP] Failed to allocate memory for dictionary\n", millis());
       free(inflator);
@@ -466,8 +475,8 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
           break;  // EOF
         }
 
-        fileReadBufferFilledBytes =
-            file.read(fileReadBuffer, fileRemainingBytes < chunkSize ? fileRemainingBytes : chunkSize);
+        fileReadBufferFilledBytes = powerMonitor::sdTransfer(
+            [&] { return file.read(fileReadBuffer, fileRemainingBytes < chunkSize ? fileRemainingBytes : chunkSize); });
         fileRemainingBytes -= fileReadBufferFilledBytes;
         fileReadBufferCursor = 0;
 
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+"""
+Build a hyphenation language pack for the reader from TeX (Liang) hyphenation patterns.
+
+Input is a pattern file as published by the hyph-utf8 project (hyph-<lang>.pat.txt, one pattern per line), or a
+.tex file with \\patterns{...} and optionally \\hyphenation{...} exceptions. Exceptions are compiled into
+patterns, so the device only has to walk one trie.
+
+The pack goes to /.crosspoint/hyphenation/<language>.bin on the SD card, named after the book language tag
+(e.g. en-us.bin or en.bin; the full tag is tried before the primary subtag). See docs/file-formats.md.
+
+Usage:
+  python3 scripts/build_hyphenation_pack.py hyph-en-us.pat.txt en.bin --left 2 --right 3
+  python3 scripts/build_hyphenation_pack.py hyph-de-1996.pat.txt de.bin --exceptions hyph-de-1996.hyp.txt
+  python3 scripts/build_hyphenation_pack.py --check en.bin hyphenation Silbentrennung
+"""
+
+import argparse
+import re
+import struct
+import sys
+from collections import deque
+
+MAGIC = b"CPHY"
+VERSION = 1
+NODE_SIZE = 7
+MAX_PACK_SIZE = 256 * 1024  # Hyphenator::MAX_PACK_SIZE
+
+
+def strip_tex(text):
+    """Return (patterns, exceptions) from a .pat.txt or .tex file."""
+    text = "\n".join(line.split("%", 1)[0] for line in text.splitlines())
+    exceptions = []
+    m = re.search(r"\\hyphenation\s*\{([^}]*)\}", text)
+    if m:
+        exceptions = m.group(1).split()
+        text = text[: m.start()] + text[m.end():]
+    m = re.search(r"\\patterns\s*\{([^}]*)\}", text)
+    if m:
+        text = m.group(1)
+    return text.split(), exceptions
+
+
+def parse_pattern(pattern):
+    """'.hy3ph' -> (b'.hyph', {3: 3}); positions are UTF-8 byte offsets into the letters."""
+    letters = bytearray()
+    levels = {}
+    for ch in pattern:
+        if ch.isdigit():
+            levels[len(letters)] = int(ch)
+        else:
+            letters += ch.lower().encode("utf-8")
+    return bytes(letters), {pos: value for pos, value in levels.items() if value}
+
+
+def exception_to_pattern(word):
+    """'as-so-ciate' -> '.a8s9s8o9c8i8a8t8e.': forces breaks at the hyphens and nowhere else."""
+    out = ["."]
+    chars = word.lower()
+    for i, ch in enumerate(chars):
+        if ch == "-":
+            continue
+        out.append(ch)
+        if i + 1 < len(chars):
+            out.append("9" if chars[i + 1] == "-" else "8")
+    out.append(".")
+    return "".join(out)
+
+
+def build(patterns, left, right):
+    root = {"children": {}, "levels": None}
+    for letters, levels in patterns:
+        node = root
+        for b in letters:
+            node = node["children"].setdefault(b, {"children": {}, "levels": None})
+        if levels:
+            merged = dict(node["levels"] or {})
+            for pos, value in levels.items():
+                merged[pos] = max(merged.get(pos, 0), value)
+            node["levels"] = merged
+
+    # Level entries are shared between nodes with identical levels
+    level_blob = bytearray()
+    level_offsets = {}
+
+    def level_offset(levels):
+        if not levels:
+            return 0
+        key = tuple(sorted(levels.items()))
+        if key not in level_offsets:
+            level_offsets[key] = len(level_blob) + 1
+            level_blob.append(len(key))
+            for pos, value in key:
+                if pos > 255:
+                    raise SystemExit(f"pattern too long: level position {pos}")
+                level_blob.extend((pos, value))
+        return level_offsets[key]
+
+    # Breadth-first layout keeps the children of each node contiguous and sorted by label
+    order = [(0, root)]
+    queue = deque([root])
+    first_child = {}
+    while queue:
+        node = queue.popleft()
+        first_child[id(node)] = len(order)
+        for label in sorted(node["children"]):
+            child = node["children"][label]
+            order.append((label, child))
+            queue.append(child)
+
+    node_blob = bytearray()
+    for label, node in order:
+        count = len(node["children"])
+        if count > 255:
+            raise SystemExit("more than 255 children on one trie node")
+        offset = level_offset(node["levels"])
+        first = first_child[id(node)] if count else 0
+        node_blob += struct.pack("<BBH", label, count, offset) + first.to_bytes(3, "little")
+
+    if len(level_blob) >= 0xFFFF:
+        raise SystemExit("level table too large for 16-bit offsets")
+
+    header = MAGIC + struct.pack("<BBBBII", VERSION, left, right, 0, len(order), len(level_blob))
+    return header + bytes(node_blob) + bytes(level_blob)
+
+
+class Pack:
+    """Reference implementation of Hyphenator::hyphenate, for checking packs on the host."""
+
+    def __init__(self, data):
+        if data[:4] != MAGIC or data[4] != VERSION:
+            raise SystemExit("not a hyphenation pack")
+        self.left, self.right = data[5], data[6]
+        self.node_count, levels_size = struct.unpack_from("<II", data, 8)
+        self.nodes = data[16:16 + self.node_count * NODE_SIZE]
+        self.levels = data[16 + self.node_count * NODE_SIZE:]
+
+    def node(self, index):
+        label, count, offset = struct.unpack_from("<BBH", self.nodes, index * NODE_SIZE)
+        first = int.from_bytes(self.nodes[index * NODE_SIZE + 4:index * NODE_SIZE + 7], "little")
+        return label, count, offset, first
+
+    def child(self, index, label):
+        _, count, _, first = self.node(index)
+        for c in range(first, first + count):
+            if self.node(c)[0] == label:
+                return c
+        return None
+
+    def hyphenate(self, word):
+        core = word.lower().encode("utf-8")
+        folded = b"." + core + b"."
+        levels = [0] * (len(folded) + 1)
+        for start in range(len(folded)):
+            node = 0
+            for i in range(start, len(folded)):
+                node = self.child(node, folded[i])
+                if node is None:
+                    break
+                offset = self.node(node)[2]
+                if offset:
+                    entry = self.levels[offset - 1:]
+                    for k in range(entry[0]):
+                        pos, value = entry[1 + 2 * k], entry[2 + 2 * k]
+                        levels[start + pos] = max(levels[start + pos], value)
+        chars = word.lower()
+        pieces, current, byte = [], "", 1
+        for index, ch in enumerate(chars):
+            if current and levels[byte] % 2 and index >= self.left and len(chars) - index >= self.right:
+                pieces.append(current)
+                current = ""
+            current += ch
+            byte += len(ch.encode("utf-8"))
+        pieces.append(current)
+        return "-".join(pieces)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a hyphenation pack from TeX patterns")
+    parser.add_argument("input", help="pattern file, or the pack to check with --check")
+    parser.add_argument("output", nargs="?", help="pack to write")
+    parser.add_argument("words", nargs="*", help="words to hyphenate with --check")
+    parser.add_argument("--exceptions", help="extra file with one hyphenated exception word per line")
+    parser.add_argument("--left", type=int, default=2, help="minimum letters before a hyphen")
+    parser.add_argument("--right", type=int, default=3, help="minimum letters after a hyphen")
+    parser.add_argument("--check", action="store_true", help="hyphenate words with an existing pack")
+    args = parser.parse_args()
+
+    if args.check:
+        with open(args.input, "rb") as f:
+            pack = Pack(f.read())
+        for word in ([args.output] if args.output else []) + args.words:
+            print(pack.hyphenate(word))
+        return
+
+    if not args.output:
+        parser.error("output pack path required")
+
+    with open(args.input, encoding="utf-8") as f:
+        raw_patterns, exceptions = strip_tex(f.read())
+    if args.exceptions:
+        with open(args.exceptions, encoding="utf-8") as f:
+            exceptions += strip_tex(f.read())[0]
+
+    patterns = [parse_pattern(p) for p in raw_patterns]
+    patterns += [parse_pattern(exception_to_pattern(w)) for w in exceptions]
+    data = build(patterns, args.left, args.right)
+    if len(data) > MAX_PACK_SIZE:
+        print(f"warning: {len(data)} bytes is over the {MAX_PACK_SIZE} byte limit the reader loads", file=sys.stderr)
+
+    with open(args.output, "wb") as f:
+        f.write(data)
+    node_count = struct.unpack_from("<I", data, 8)[0]
+    print(f"{args.output}: {len(raw_patterns)} patterns, {len(exceptions)} exceptions, {node_count} nodes, "
+          f"{len(data)} bytes")
+
+
+if __name__ == "__main__":
+    main()
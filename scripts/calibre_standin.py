@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Minimal stand-in for Calibre's wireless device server, used to measure CrossPoint's receive throughput.
+
+Answers the device's UDP discovery broadcast, accepts its TCP connection and speaks just enough of the
+smart device protocol (length-prefixed JSON, see calibre/devices/smart_device_app/driver.py) to push one
+or more books. The device must be on the same network segment so its broadcast reaches this host.
+
+Usage:
+  python3 scripts/calibre_standin.py book.epub
+  python3 scripts/calibre_standin.py --size-mb 8 --repeat 3 --metadata-kb 64   # synthetic book, big metadata
+"""
+
+import argparse
+import json
+import os
+import socket
+import threading
+import time
+
+DISCOVERY_PORT = 54982
+OK = 0
+SEND_BOOK = 8
+GET_INITIALIZATION_INFO = 9
+NOOP = 12
+
+
+def send_message(sock, opcode, payload):
+    body = json.dumps([opcode, payload]).encode()
+    sock.sendall(str(len(body)).encode() + body)
+
+
+def recv_message(sock):
+    prefix = b""
+    while True:
+        c = sock.recv(1)
+        if not c:
+            raise ConnectionError("device closed the connection")
+        if c == b"[":
+            break
+        prefix += c
+    remaining = int(prefix) - 1
+    body = b"["
+    while remaining > 0:
+        chunk = sock.recv(remaining)
+        if not chunk:
+            raise ConnectionError("device closed the connection")
+        body += chunk
+        remaining -= len(chunk)
+    return json.loads(body)
+
+
+def answer_discovery(tcp_port, stop):
+    udp = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    udp.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    udp.bind(("", DISCOVERY_PORT))
+    udp.settimeout(0.5)
+    while not stop.is_set():
+        try:
+            data, addr = udp.recvfrom(64)
+        except socket.timeout:
+            continue
+        if data.startswith(b"hello"):
+            udp.sendto(f"calibre wireless device client (on standin);{tcp_port},0".encode(), addr)
+    udp.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Calibre wireless stand-in for throughput testing")
+    parser.add_argument("book", nargs="?", help="file to send (default: synthetic data)")
+    parser.add_argument("--size-mb", type=float, default=4, help="synthetic book size")
+    parser.add_argument("--metadata-kb", type=int, default=16, help="padding in SEND_BOOK metadata, like covers")
+    parser.add_argument("--repeat", type=int, default=1)
+    parser.add_argument("--port", type=int, default=9090)
+    args = parser.parse_args()
+
+    if args.book:
+        with open(args.book, "rb") as f:
+            data = f.read()
+        name = os.path.basename(args.book)
+    else:
+        data = os.urandom(int(args.size_mb * 1024 * 1024))
+        name = "standin.epub"
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(("", args.port))
+    server.listen(1)
+
+    stop = threading.Event()
+    threading.Thread(target=answer_discovery, args=(args.port, stop), daemon=True).start()
+    print(f"waiting for device (discovery on udp/{DISCOVERY_PORT}, tcp/{args.port})")
+
+    conn, addr = server.accept()
+    stop.set()
+    conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    print(f"device connected from {addr[0]}")
+
+    send_message(conn, GET_INITIALIZATION_INFO, {"serverProtocolVersion": 1, "validExtensions": ["epub"]})
+    info = recv_message(conn)[1]
+    print(f"device: {info.get('deviceName')} ccVersion {info.get('ccVersionNumber')}")
+
+    results = []
+    for i in range(args.repeat):
+        lpath = f"Stand-in/{i}-{name}" if args.repeat > 1 else f"Stand-in/{name}"
+        # A nested "length" and a large blob mimic real metadata (cover thumbnails)
+        metadata = {"title": name, "lpath": lpath, "length": 1, "thumbnail": ["x" * (args.metadata_kb * 1024)]}
+        send_message(conn, SEND_BOOK, {"lpath": lpath, "length": len(data), "metadata": metadata, "thisBook": i,
+                                       "totalBooks": args.repeat, "willStreamBooks": True})
+        reply = recv_message(conn)
+        if reply[0] != OK:
+            raise SystemExit(f"device refused book: {reply}")
+
+        start = time.time()
+        conn.sendall(data)
+        recv_message(conn)
+        elapsed = time.time() - start
+        mbps = len(data) / 1024 / 1024 / max(elapsed, 1e-6)
+        results.append(mbps)
+        print(f"{lpath}: {len(data)} bytes in {elapsed:.2f}s ({mbps:.2f} MB/s)")
+
+    send_message(conn, NOOP, {"ejecting": True})
+    conn.close()
+    server.close()
+    if len(results) > 1:
+        print(f"mean {sum(results) / len(results):.2f} MB/s, best {max(results):.2f} MB/s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Compare two reports of the native benchmark (host/bench, see docs/native-build.md), e.g. from before and after a change.
+
+Wall time is noisy, so the fastest run is compared and it only counts as a regression when both the relative and the
+absolute change are over the thresholds. Allocations, heap and SD traffic are deterministic for the same corpus, any
+growth over the relative threshold is reported.
+
+Usage:
+  python3 scripts/compare_bench.py base.json head.json [--threshold 10] [--min-ms 2]
+
+Exits with 1 if anything regressed, so it can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+METRICS = [
+    # key, column title, unit divisor, deterministic
+    ("wall_us_min", "time ms", 1000.0, False),
+    ("allocations", "allocs", 1, True),
+    ("peak_heap_bytes", "heap B", 1, True),
+    ("sd_read_bytes", "read B", 1, True),
+    ("sd_write_bytes", "written B", 1, True),
+    ("sd_reads", "read calls", 1, True),
+]
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        report = json.load(f)
+    return report, {(r["book"], r["stage"]): r for r in report["results"]}
+
+
+def change(base, head):
+    if base == 0:
+        return 0.0 if head == 0 else float("inf")
+    return (head - base) * 100.0 / base
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark reports")
+    parser.add_argument("base", help="report of the baseline")
+    parser.add_argument("head", help="report to check against the baseline")
+    parser.add_argument("--threshold", type=float, default=10.0, help="relative change in percent to report")
+    parser.add_argument("--min-ms", type=float, default=2.0, help="ignore wall time changes smaller than this")
+    args = parser.parse_args()
+
+    base_report, base = load(args.base)
+    head_report, head = load(args.head)
+    print(f"base {base_report.get('version', '?')} ({args.base}), head {head_report.get('version', '?')} ({args.head})")
+
+    header = f"{'book':<22} {'stage':<14}" + "".join(f" {title:>22}" for _, title, _, _ in METRICS)
+    print(header)
+    print("-" * len(header))
+
+    regressions = []
+    for key in sorted(set(base) | set(head)):
+        book, stage = key
+        if key not in base or key not in head:
+            print(f"{book:<22} {stage:<14} only in {'head' if key in head else 'base'}")
+            continue
+
+        columns = []
+        for metric, title, divisor, deterministic in METRICS:
+            if metric not in base[key] or metric not in head[key]:
+                # Reports from before the metric was added
+                columns.append(f" {'-':>12} {'':>9}")
+                continue
+            old = base[key][metric]
+            new = head[key][metric]
+            percent = change(old, new)
+            mark = " "
+            if percent > args.threshold and (deterministic or (new - old) / 1000.0 >= args.min_ms):
+                mark = "!"
+                regressions.append(f"{book} {stage} {title}: {old / divisor:.10g} -> {new / divisor:.10g}")
+            elif percent < -args.threshold:
+                mark = "+"
+            value = f"{new / divisor:.3f}" if divisor != 1 else str(new)
+            columns.append(f" {value:>12} {percent:>+7.1f}%{mark}")
+        print(f"{book:<22} {stage:<14}" + "".join(columns))
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold:g}%:")
+        for line in regressions:
+            print(f"  {line}")
+        sys.exit(1)
+    print("\nNo regressions")
+
+
+if __name__ == "__main__":
+    main()
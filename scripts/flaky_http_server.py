@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+Static file server with HTTP Range support that deliberately drops connections, for testing resumable
+downloads (HttpDownloader::downloadToFile) on the device.
+
+Each response sends ETag and Last-Modified, honours Range and If-Range, and closes the connection after a
+random number of bytes so the client has to reconnect and resume. Every request is logged with its range,
+so resumes are visible.
+
+Usage:
+  python3 scripts/flaky_http_server.py --dir ~/books --drop-min-kb 64 --drop-max-kb 512
+  python3 scripts/flaky_http_server.py --dir ~/books --drop-chance 0      # well-behaved server
+"""
+
+import argparse
+import email.utils
+import hashlib
+import http.server
+import os
+import random
+import re
+import time
+import urllib.parse
+
+
+class FlakyHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    root = "."
+    drop_chance = 0.5
+    drop_min = 64 * 1024
+    drop_max = 512 * 1024
+    throttle_kbps = 0
+
+    def do_GET(self):
+        path = os.path.join(self.root, urllib.parse.unquote(urllib.parse.urlparse(self.path).path).lstrip("/"))
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+
+        st = os.stat(path)
+        size = st.st_size
+        etag = '"' + hashlib.md5(f"{path}:{st.st_mtime_ns}:{size}".encode()).hexdigest()[:16] + '"'
+        last_modified = email.utils.formatdate(st.st_mtime, usegmt=True)
+
+        start, end = 0, size - 1
+        partial = False
+        range_header = self.headers.get("Range")
+        if_range = self.headers.get("If-Range")
+        if range_header and (not if_range or if_range in (etag, last_modified)):
+            m = re.match(r"bytes=(\d+)-(\d*)$", range_header.strip())
+            if m:
+                start = int(m.group(1))
+                if m.group(2):
+                    end = min(int(m.group(2)), size - 1)
+                if start >= size:
+                    self.send_response(416)
+                    self.send_header("Content-Range", f"bytes */{size}")
+                    self.send_header("Content-Length", "0")
+                    self.end_headers()
+                    return
+                partial = True
+
+        length = end - start + 1
+        self.send_response(206 if partial else 200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(length))
+        self.send_header("Accept-Ranges", "bytes")
+        self.send_header("ETag", etag)
+        self.send_header("Last-Modified", last_modified)
+        if partial:
+            self.send_header("Content-Range", f"bytes {start}-{end}/{size}")
+        self.end_headers()
+
+        drop_after = length
+        if random.random() < self.drop_chance:
+            drop_after = min(length, random.randint(self.drop_min, self.drop_max))
+        self.log_message("%s bytes %d-%d/%d%s", os.path.basename(path), start, end, size,
+                         f", dropping after {drop_after}" if drop_after < length else "")
+
+        sent = 0
+        with open(path, "rb") as f:
+            f.seek(start)
+            while sent < drop_after:
+                chunk = f.read(min(16384, drop_after - sent))
+                if not chunk:
+                    break
+                try:
+                    self.wfile.write(chunk)
+                except (BrokenPipeError, ConnectionResetError):
+                    return
+                sent += len(chunk)
+                if self.throttle_kbps:
+                    time.sleep(len(chunk) / (self.throttle_kbps * 1024))
+
+        if sent < length:
+            # Simulate the WiFi link going away mid-transfer
+            self.close_connection = True
+            self.connection.shutdown(2)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="HTTP server with Range support that injects disconnects")
+    parser.add_argument("--dir", default=".")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--drop-chance", type=float, default=0.5, help="probability a response is cut short")
+    parser.add_argument("--drop-min-kb", type=int, default=64)
+    parser.add_argument("--drop-max-kb", type=int, default=512)
+    parser.add_argument("--throttle-kbps", type=int, default=0, help="limit the send rate (0 = unlimited)")
+    args = parser.parse_args()
+
+    FlakyHandler.root = args.dir
+    FlakyHandler.drop_chance = args.drop_chance
+    FlakyHandler.drop_min = args.drop_min_kb * 1024
+    FlakyHandler.drop_max = max(args.drop_max_kb, args.drop_min_kb) * 1024
+    FlakyHandler.throttle_kbps = args.throttle_kbps
+
+    with http.server.ThreadingHTTPServer(("", args.port), FlakyHandler) as server:
+        print(f"serving {os.path.abspath(args.dir)} on port {args.port}, drop chance {args.drop_chance}")
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
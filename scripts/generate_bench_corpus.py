@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+"""
+Generate the synthetic book corpus used by the native benchmark (host/bench, see docs/native-build.md).
+
+All text is made up from a fixed pseudo-random sequence, so the corpus contains no copyrighted material and the same
+books come out on every run (only the compressed bytes of the EPUBs may differ between zlib versions). Regenerate it
+only when the benchmark needs new kinds of input, since changing the corpus makes reports from older commits
+incomparable.
+
+Books written:
+  novel.epub            EPUB 2 with an NCX, 12 chapters of ordinary paragraphs, headings and inline styles
+  long-paragraphs.epub  a few chapters that are each one very long paragraph, for streaming layout
+  many-chapters.epub    EPUB 3 with a nav document, 240 short chapters in a nested TOC
+  novel.txt             plain text version of the novel's chapters
+  pages.xtc             1-bit pre-rendered pages
+  pages.xtch            2-bit pre-rendered pages
+  hyphenation/en.bin    hyphenation pack for the made-up words (breaks between syllables)
+
+Usage:
+  python3 scripts/generate_bench_corpus.py [output dir, default host/bench/corpus]
+"""
+
+import os
+import struct
+import sys
+import zipfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from build_hyphenation_pack import build as build_hyphenation_pack  # noqa: E402
+from build_hyphenation_pack import parse_pattern  # noqa: E402
+
+CONSONANTS = "bcdfghklmnprstvz"
+VOWELS = "aeiou"
+FUNCTION_WORDS = ["the", "and", "of", "to", "a", "in", "was", "she", "he", "it", "that", "with", "on", "for", "as",
+                  "had", "at", "by", "not", "but", "from", "they", "her", "his", "all", "were", "we", "there"]
+# Fixed timestamp so the archives are byte for byte reproducible
+ZIP_DATE = (2024, 1, 1, 0, 0, 0)
+
+
+class Random:
+    """xorshift32, so the sequence does not depend on the Python version"""
+
+    def __init__(self, seed):
+        self.state = seed or 1
+
+    def next(self):
+        x = self.state
+        x ^= (x << 13) & 0xFFFFFFFF
+        x ^= x >> 17
+        x ^= (x << 5) & 0xFFFFFFFF
+        self.state = x
+        return x
+
+    def below(self, n):
+        return self.next() % n
+
+    def between(self, low, high):
+        return low + self.below(high - low + 1)
+
+    def pick(self, items):
+        return items[self.below(len(items))]
+
+
+class TextGenerator:
+    def __init__(self, seed):
+        self.rng = Random(seed)
+
+    def word(self):
+        if self.rng.below(100) < 45:
+            return self.rng.pick(FUNCTION_WORDS)
+        syllables = self.rng.between(1, 5)
+        word = "".join(self.rng.pick(CONSONANTS) + self.rng.pick(VOWELS) for _ in range(syllables))
+        if self.rng.below(200) == 0:
+            word = word.replace("e", "é", 1)
+        return word
+
+    def sentence(self, min_words=6, max_words=24):
+        words = [self.word() for _ in range(self.rng.between(min_words, max_words))]
+        words[0] = words[0].capitalize()
+        for i in range(1, len(words) - 1):
+            if self.rng.below(10) == 0:
+                words[i] += ","
+        if self.rng.below(30) == 0:
+            words[0] = "“" + words[0]
+            words[-1] += "”"
+        return " ".join(words) + self.rng.pick(".....?!")
+
+    def paragraph(self, min_sentences=2, max_sentences=8):
+        return " ".join(self.sentence() for _ in range(self.rng.between(min_sentences, max_sentences)))
+
+    def title(self):
+        return " ".join(self.word() for _ in range(self.rng.between(1, 4))).title()
+
+
+def xml_escape(text):
+    return text.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;")
+
+
+def styled_paragraph(gen, text):
+    """Wrap a few words in inline styles, like a typical novel"""
+    words = xml_escape(text).split(" ")
+    for i in range(len(words)):
+        roll = gen.rng.below(60)
+        if roll == 0:
+            words[i] = "<em>" + words[i] + "</em>"
+        elif roll == 1:
+            words[i] = "<strong>" + words[i] + "</strong>"
+    return "<p>" + " ".join(words) + "</p>"
+
+
+def xhtml_document(title, body):
+    return ('<?xml version="1.0" encoding="utf-8"?>\n'
+            '<!DOCTYPE html>\n'
+            '<html xmlns="http://www.w3.org/1999/xhtml" xmlns:epub="http://www.idpf.org/2007/ops" lang="en">\n'
+            f'<head><title>{xml_escape(title)}</title></head>\n'
+            f'<body>\n{body}\n</body>\n</html>\n')
+
+
+def write_epub(path, title, chapters, nested_toc=False, epub3=False):
+    """chapters: list of (title, body xhtml, toc level)"""
+    container = ('<?xml version="1.0"?>\n'
+                 '<container version="1.0" xmlns="urn:oasis:names:tc:opendocument:xmlns:container">'
+                 '<rootfiles><rootfile full-path="OEBPS/content.opf" media-type="application/oebps-package+xml"/>'
+                 '</rootfiles></container>\n')
+
+    manifest = ['<item id="ncx" href="toc.ncx" media-type="application/x-dtbncx+xml"/>']
+    if epub3:
+        manifest.append('<item id="nav" href="nav.xhtml" media-type="application/xhtml+xml" properties="nav"/>')
+    spine = []
+    for i in range(len(chapters)):
+        manifest.append(f'<item id="c{i}" href="text/c{i}.xhtml" media-type="application/xhtml+xml"/>')
+        spine.append(f'<itemref idref="c{i}"/>')
+    opf = ('<?xml version="1.0" encoding="utf-8"?>\n'
+           f'<package xmlns="http://www.idpf.org/2007/opf" version="{"3.0" if epub3 else "2.0"}" '
+           'unique-identifier="bookid">\n'
+           '<metadata xmlns:dc="http://purl.org/dc/elements/1.1/">'
+           f'<dc:title>{xml_escape(title)}</dc:title><dc:creator>CrossPoint Benchmark</dc:creator>'
+           f'<dc:identifier id="bookid">crosspoint-bench-{os.path.basename(path)}</dc:identifier>'
+           '<dc:language>en</dc:language></metadata>\n'
+           f'<manifest>{"".join(manifest)}</manifest>\n'
+           f'<spine toc="ncx">{"".join(spine)}</spine>\n'
+           '</package>\n')
+
+    # Nest the (level, title, href) entries into a tree of (entry, children)
+    toc = []
+    parents = [(0, toc)]
+    for i, (chapter_title, _, level) in enumerate(chapters):
+        level = level if nested_toc else 1
+        while parents[-1][0] >= level:
+            parents.pop()
+        children = []
+        parents[-1][1].append(((chapter_title, f"text/c{i}.xhtml"), children))
+        parents.append((level, children))
+
+    play_order = iter(range(1, len(chapters) + 1))
+
+    def nav_points(nodes):
+        return "".join(f'<navPoint id="n{n}" playOrder="{n}"><navLabel><text>{xml_escape(t)}</text></navLabel>'
+                       f'<content src="{h}"/>{nav_points(children)}</navPoint>'
+                       for ((t, h), children) in nodes for n in [next(play_order)])
+
+    def nav_list(nodes):
+        items = "".join(f'<li><a href="{h}">{xml_escape(t)}</a>{nav_list(children) if children else ""}</li>'
+                        for ((t, h), children) in nodes)
+        return f"<ol>{items}</ol>"
+
+    ncx = ('<?xml version="1.0" encoding="utf-8"?>\n'
+           '<ncx xmlns="http://www.daisy.org/z3986/2005/ncx/" version="2005-1">'
+           f'<head/><docTitle><text>{xml_escape(title)}</text></docTitle><navMap>{nav_points(toc)}</navMap></ncx>\n')
+
+    with zipfile.ZipFile(path, "w") as z:
+        def add(name, data, compress=zipfile.ZIP_DEFLATED):
+            info = zipfile.ZipInfo(name, ZIP_DATE)
+            info.compress_type = compress
+            info.external_attr = 0o644 << 16
+            z.writestr(info, data)
+
+        add("mimetype", "application/epub+zip", zipfile.ZIP_STORED)
+        add("META-INF/container.xml", container)
+        add("OEBPS/content.opf", opf)
+        add("OEBPS/toc.ncx", ncx)
+        if epub3:
+            add("OEBPS/nav.xhtml", xhtml_document(title, f'<nav epub:type="toc">{nav_list(toc)}</nav>'))
+        for i, (chapter_title, body, _) in enumerate(chapters):
+            add(f"OEBPS/text/c{i}.xhtml", xhtml_document(chapter_title, body))
+
+
+def novel_chapters(seed, count):
+    gen = TextGenerator(seed)
+    chapters = []
+    for i in range(count):
+        chapter_title = f"Chapter {i + 1}: {gen.title()}"
+        paragraphs = []
+        for p in range(gen.rng.between(20, 40)):
+            if p > 0 and gen.rng.below(25) == 0:
+                paragraphs.append(("h2", gen.title()))
+            paragraphs.append(("p", gen.paragraph()))
+        chapters.append((chapter_title, paragraphs))
+    return chapters
+
+
+def write_novel(out_dir):
+    gen = TextGenerator(7)
+    chapters = novel_chapters(1, 12)
+    epub_chapters = []
+    for chapter_title, paragraphs in chapters:
+        body = [f"<h1>{xml_escape(chapter_title)}</h1>"]
+        for kind, text in paragraphs:
+            body.append(f"<h2>{xml_escape(text)}</h2>" if kind == "h2" else styled_paragraph(gen, text))
+        epub_chapters.append((chapter_title, "\n".join(body), 1))
+    write_epub(os.path.join(out_dir, "novel.epub"), "Benchmark Novel", epub_chapters)
+
+    lines = ["Benchmark Novel", ""]
+    for chapter_title, paragraphs in chapters:
+        lines += [chapter_title, ""]
+        for _, text in paragraphs:
+            lines += [text, ""]
+    with open(os.path.join(out_dir, "novel.txt"), "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines))
+
+
+def write_long_paragraphs(out_dir):
+    gen = TextGenerator(2)
+    chapters = []
+    for i, words in enumerate([4000, 12000, 30000]):
+        sentences = []
+        count = 0
+        while count < words:
+            sentence = gen.sentence()
+            sentences.append(sentence)
+            count += sentence.count(" ") + 1
+        chapter_title = f"Part {i + 1}"
+        chapters.append((chapter_title, f"<h1>{chapter_title}</h1>\n<p>{xml_escape(' '.join(sentences))}</p>", 1))
+    write_epub(os.path.join(out_dir, "long-paragraphs.epub"), "Benchmark Long Paragraphs", chapters)
+
+
+def write_many_chapters(out_dir):
+    gen = TextGenerator(3)
+    chapters = []
+    for i in range(240):
+        # Parts of 20 chapters with sections of 4
+        level = 1 if i % 20 == 0 else (2 if i % 4 == 0 else 3)
+        chapter_title = f"{i + 1}. {gen.title()}"
+        body = [f"<h2>{xml_escape(chapter_title)}</h2>"]
+        body += [styled_paragraph(gen, gen.paragraph(1, 4)) for _ in range(gen.rng.between(2, 6))]
+        chapters.append((chapter_title, "\n".join(body), level))
+    write_epub(os.path.join(out_dir, "many-chapters.epub"), "Benchmark Many Chapters", chapters, nested_toc=True,
+               epub3=True)
+
+
+def text_page(gen, width, height):
+    """Rows of 'words' as black blocks, roughly like a page of text. Returns a list of rows of 0/1 (1 = ink)."""
+    page = [[0] * width for _ in range(height)]
+    margin = 24
+    y = margin
+    while y + 20 < height - margin:
+        x = margin
+        while True:
+            length = gen.rng.between(12, 70)
+            if x + length > width - margin:
+                break
+            for row in range(y + 4, y + 18):
+                for col in range(x, x + length):
+                    page[row][col] = 1
+            x += length + 9
+        y += 28
+    return page
+
+
+def write_xtc(path, two_bit, page_count):
+    width, height = 480, 800
+    gen = TextGenerator(5)
+    pages = []
+    for _ in range(page_count):
+        ink = text_page(gen, width, height)
+        if two_bit:
+            # Column-major bit planes, columns right to left, 8 vertical pixels per byte (see XtcTypes.h).
+            # Ink is black (3), the rest white (0).
+            plane_size = (width * height + 7) // 8
+            plane = bytearray(plane_size)
+            for x in range(width):
+                column = (width - 1 - x) * ((height + 7) // 8)
+                for y in range(height):
+                    if ink[y][x]:
+                        plane[column + y // 8] |= 0x80 >> (y % 8)
+            data = bytes(plane) + bytes(plane)
+            magic = 0x00485458
+        else:
+            # Row-major, 8 pixels per byte, 1 = white
+            row_bytes = (width + 7) // 8
+            bitmap = bytearray(b"\xff" * row_bytes * height)
+            for y in range(height):
+                for x in range(width):
+                    if ink[y][x]:
+                        bitmap[y * row_bytes + x // 8] &= ~(0x80 >> (x % 8)) & 0xFF
+            data = bytes(bitmap)
+            magic = 0x00475458
+        pages.append(struct.pack("<IHHBBIQ", magic, width, height, 0, 0, len(data), 0) + data)
+
+    title = b"Benchmark Pages\0"
+    header_size = 56
+    page_table_offset = header_size + len(title)
+    data_offset = page_table_offset + 16 * page_count
+    header = struct.pack("<IBBHIIIIQQQII", 0x48435458 if two_bit else 0x00435458, 1, 0, page_count, 0, header_size, 0,
+                         0, page_table_offset, data_offset, 0, header_size, 0)
+    table = bytearray()
+    offset = data_offset
+    for page in pages:
+        table += struct.pack("<QIHH", offset, len(page) - 22, width, height)
+        offset += len(page)
+    with open(path, "wb") as f:
+        f.write(header + title + bytes(table) + b"".join(pages))
+
+
+def write_hyphenation_pack(out_dir):
+    # Break between a vowel and the next syllable's consonant, which is where the made-up words split
+    patterns = [parse_pattern(f"{v}1{c}") for v in VOWELS for c in CONSONANTS]
+    os.makedirs(os.path.join(out_dir, "hyphenation"), exist_ok=True)
+    with open(os.path.join(out_dir, "hyphenation", "en.bin"), "wb") as f:
+        f.write(build_hyphenation_pack(patterns, 2, 3))
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join("host", "bench", "corpus")
+    os.makedirs(out_dir, exist_ok=True)
+    write_novel(out_dir)
+    write_long_paragraphs(out_dir)
+    write_many_chapters(out_dir)
+    write_xtc(os.path.join(out_dir, "pages.xtc"), False, 4)
+    write_xtc(os.path.join(out_dir, "pages.xtch"), True, 2)
+    write_hyphenation_pack(out_dir)
+    for name in sorted(os.listdir(out_dir)):
+        path = os.path.join(out_dir, name)
+        if os.path.isfile(path):
+            print(f"{path}: {os.path.getsize(path)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Serve a synthetic, paginated OPDS catalog for testing the OPDS browser against a local static HTTP server.
+
+Generates /opds (root navigation feed), a paginated "All books" feed linked with rel="next" and one small
+EPUB per book, then serves the directory with Python's static file server. That server sends
+Last-Modified and answers If-Modified-Since with 304, so feed cache revalidation can be observed in the
+device log. Touch a page file (or use --regenerate) to make it change.
+
+Usage:
+  python3 scripts/opds_test_server.py --books 300 --page-size 50
+  # then set the OPDS server URL on the device to http://<this-host>:8080
+"""
+
+import argparse
+import functools
+import http.server
+import os
+import tempfile
+import zipfile
+from xml.sax.saxutils import escape
+
+ATOM_HEADER = '<?xml version="1.0" encoding="UTF-8"?>\n<feed xmlns="http://www.w3.org/2005/Atom">\n'
+NAV_TYPE = "application/atom+xml;profile=opds-catalog;kind=navigation"
+ACQ_TYPE = "application/atom+xml;profile=opds-catalog;kind=acquisition"
+
+
+def write_epub(path, title):
+    with zipfile.ZipFile(path, "w") as z:
+        z.writestr("mimetype", "application/epub+zip", compress_type=zipfile.ZIP_STORED)
+        z.writestr(
+            "META-INF/container.xml",
+            '<?xml version="1.0"?><container version="1.0" xmlns="urn:oasis:names:tc:opendocument:xmlns:container">'
+            '<rootfiles><rootfile full-path="content.opf" media-type="application/oebps-package+xml"/></rootfiles>'
+            "</container>",
+        )
+        z.writestr(
+            "content.opf",
+            '<?xml version="1.0"?><package xmlns="http://www.idpf.org/2007/opf" version="2.0" unique-identifier="id">'
+            f'<metadata xmlns:dc="http://purl.org/dc/elements/1.1/"><dc:title>{escape(title)}</dc:title>'
+            '<dc:identifier id="id">test</dc:identifier></metadata>'
+            '<manifest><item id="c1" href="c1.xhtml" media-type="application/xhtml+xml"/></manifest>'
+            '<spine><itemref idref="c1"/></spine></package>',
+        )
+        z.writestr(
+            "c1.xhtml",
+            f'<html xmlns="http://www.w3.org/1999/xhtml"><body><h1>{escape(title)}</h1>'
+            + "<p>Lorem ipsum dolor sit amet.</p>" * 50
+            + "</body></html>",
+        )
+
+
+def write_feed(path, title, entries, next_href=None):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(ATOM_HEADER)
+        f.write(f"<title>{escape(title)}</title>\n")
+        if next_href:
+            f.write(f'<link rel="next" href="{next_href}" type="{ACQ_TYPE}"/>\n')
+        f.write("".join(entries))
+        f.write("</feed>\n")
+
+
+def generate(root, books, page_size):
+    os.makedirs(os.path.join(root, "books"), exist_ok=True)
+
+    pages = max(1, (books + page_size - 1) // page_size)
+    write_feed(
+        os.path.join(root, "opds"),
+        "Test Catalog",
+        [
+            f'<entry><title>All books ({books})</title><id>all</id>'
+            f'<link rel="subsection" type="{ACQ_TYPE}" href="/all-1.xml"/></entry>\n',
+            f'<entry><title>Empty shelf</title><id>empty</id>'
+            f'<link rel="subsection" type="{NAV_TYPE}" href="/empty.xml"/></entry>\n',
+        ],
+    )
+    write_feed(os.path.join(root, "empty.xml"), "Empty shelf", [])
+
+    for page in range(1, pages + 1):
+        entries = []
+        for i in range((page - 1) * page_size, min(page * page_size, books)):
+            title = f"Test Book {i + 1:04d}"
+            write_epub(os.path.join(root, "books", f"{i + 1}.epub"), title)
+            entries.append(
+                f"<entry><title>{title}</title><author><name>Author {i % 17}</name></author><id>book-{i}</id>"
+                f'<link rel="http://opds-spec.org/acquisition" type="application/epub+zip" href="/books/{i + 1}.epub"/>'
+                "</entry>\n"
+            )
+        next_href = f"/all-{page + 1}.xml" if page < pages else None
+        write_feed(os.path.join(root, f"all-{page}.xml"), f"All books, page {page}", entries, next_href)
+
+    print(f"generated {books} books in {pages} pages of {page_size} under {root}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static OPDS test server")
+    parser.add_argument("--books", type=int, default=120)
+    parser.add_argument("--page-size", type=int, default=25)
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--dir", help="catalog directory (default: a temporary directory)")
+    parser.add_argument("--regenerate", action="store_true", help="rewrite an existing --dir")
+    args = parser.parse_args()
+
+    root = args.dir or tempfile.mkdtemp(prefix="opds-")
+    if args.regenerate or not os.path.exists(os.path.join(root, "opds")):
+        generate(root, args.books, args.page_size)
+
+    handler = functools.partial(http.server.SimpleHTTPRequestHandler, directory=root)
+    with http.server.ThreadingHTTPServer(("", args.port), handler) as server:
+        print(f"serving {root} on port {args.port}")
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for the GitHub release API and asset download used by OTA updates.
+
+Serves /releases/latest in the GitHub format (tag_name, assets with size, digest and download URL) plus the
+firmware image itself with Range support. Responses can be cut short to exercise resuming, and the published
+digest can be deliberately wrong to check that a mismatching image is never made bootable.
+
+Point a build at it with:
+  build_flags = ... -DCROSSPOINT_OTA_RELEASE_URL=\\"http://<host>:8090/releases/latest\\"
+
+Usage:
+  python3 scripts/ota_standin.py .pio/build/default/firmware.bin --version 9.9.9
+  python3 scripts/ota_standin.py firmware.bin --drop-chance 0.7        # flaky link
+  python3 scripts/ota_standin.py firmware.bin --bad-digest             # must be refused
+  python3 scripts/ota_standin.py firmware.bin --client                 # resume/verify against itself
+"""
+
+import argparse
+import hashlib
+import http.client
+import http.server
+import json
+import os
+import random
+import re
+import threading
+
+
+def make_handler(image, version, digest, args):
+    class Handler(http.server.BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def send_body(self, code, body, content_type):
+            self.send_response(code)
+            self.send_header("Content-Type", content_type)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            host = self.headers.get("Host", f"localhost:{args.port}")
+            if self.path == "/releases/latest":
+                assets = [
+                    {
+                        "name": "firmware.bin",
+                        "size": len(image),
+                        "browser_download_url": f"http://{host}/download/firmware.bin",
+                    }
+                ]
+                if args.digest_mode in ("asset", "both"):
+                    assets[0]["digest"] = f"sha256:{digest}"
+                if args.digest_mode in ("file", "both"):
+                    assets.append(
+                        {
+                            "name": "firmware.bin.sha256",
+                            "size": 80,
+                            "browser_download_url": f"http://{host}/download/firmware.bin.sha256",
+                        }
+                    )
+                self.send_body(200, json.dumps({"tag_name": version, "assets": assets}).encode(), "application/json")
+            elif self.path == "/download/firmware.bin.sha256":
+                self.send_body(200, f"{digest}  firmware.bin\n".encode(), "text/plain")
+            elif self.path == "/download/firmware.bin":
+                self.send_image()
+            else:
+                self.send_body(404, b"not found", "text/plain")
+
+        def send_image(self):
+            start = 0
+            m = re.match(r"bytes=(\d+)-$", self.headers.get("Range", ""))
+            if m and not args.no_range:
+                start = int(m.group(1))
+                if start >= len(image):
+                    self.send_body(416, b"", "text/plain")
+                    return
+            length = len(image) - start
+            self.send_response(206 if start else 200)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(length))
+            if start:
+                self.send_header("Content-Range", f"bytes {start}-{len(image) - 1}/{len(image)}")
+            self.end_headers()
+
+            drop_after = length
+            if random.random() < args.drop_chance:
+                drop_after = random.randint(1, max(1, min(length - 1, args.drop_max_kb * 1024)))
+            self.log_message("image from %d, %s", start,
+                             f"dropping after {drop_after}" if drop_after < length else "complete")
+            try:
+                self.wfile.write(image[start:start + drop_after])
+            except (BrokenPipeError, ConnectionResetError):
+                return
+            if drop_after < length:
+                self.close_connection = True
+                self.connection.shutdown(2)
+
+    return Handler
+
+
+def run_client(port, max_retries=20):
+    """Mirror the device's algorithm: resume with Range, hash incrementally, compare with the published digest."""
+    conn = http.client.HTTPConnection("localhost", port, timeout=10)
+    conn.request("GET", "/releases/latest")
+    release = json.loads(conn.getresponse().read())
+    asset = next(a for a in release["assets"] if a["name"] == "firmware.bin")
+    expected = asset.get("digest", "").removeprefix("sha256:")
+    path = "/" + asset["browser_download_url"].split("/", 3)[3]
+
+    sha = hashlib.sha256()
+    offset = 0
+    retries = 0
+    while offset < asset["size"] and retries <= max_retries:
+        conn = http.client.HTTPConnection("localhost", port, timeout=10)
+        conn.request("GET", path, headers={"Range": f"bytes={offset}-"} if offset else {})
+        resp = conn.getresponse()
+        if resp.status != (206 if offset else 200):
+            raise SystemExit(f"unexpected status {resp.status} at offset {offset}")
+        try:
+            while chunk := resp.read(4096):
+                sha.update(chunk)
+                offset += len(chunk)
+        except (http.client.IncompleteRead, ConnectionError) as e:
+            if isinstance(e, http.client.IncompleteRead):
+                sha.update(e.partial)
+                offset += len(e.partial)
+        if offset < asset["size"]:
+            retries += 1
+    ok = offset == asset["size"] and (not expected or sha.hexdigest() == expected)
+    print(f"client: {offset}/{asset['size']} bytes, {retries} retries, digest {'ok' if ok else 'MISMATCH'}")
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="OTA release stand-in")
+    parser.add_argument("firmware", help="firmware image to serve")
+    parser.add_argument("--version", default="99.0.0", help="tag_name to advertise (must be newer)")
+    parser.add_argument("--port", type=int, default=8090)
+    parser.add_argument("--digest-mode", choices=["asset", "file", "both", "none"], default="asset",
+                        help="publish the SHA-256 as an asset digest, a .sha256 asset, both or not at all")
+    parser.add_argument("--bad-digest", action="store_true", help="publish a wrong SHA-256")
+    parser.add_argument("--drop-chance", type=float, default=0.0)
+    parser.add_argument("--drop-max-kb", type=int, default=512)
+    parser.add_argument("--no-range", action="store_true", help="ignore Range requests")
+    parser.add_argument("--client", action="store_true", help="run the reference client against the server")
+    args = parser.parse_args()
+
+    with open(args.firmware, "rb") as f:
+        image = f.read()
+    digest = hashlib.sha256(image).hexdigest()
+    if args.bad_digest:
+        digest = ("0" if digest[0] != "0" else "1") + digest[1:]
+    print(f"serving {os.path.basename(args.firmware)} ({len(image)} bytes) as {args.version}, sha256 {digest}")
+
+    server = http.server.ThreadingHTTPServer(("", args.port), make_handler(image, args.version, digest, args))
+    if args.client:
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        ok = run_client(args.port)
+        server.shutdown()
+        raise SystemExit(0 if ok != args.bad_digest else 1)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
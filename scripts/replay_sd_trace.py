@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+"""
+Replay an SD access trace of the native build (--sd-trace, see docs/native-build.md) against models of caching, to
+see how many card transactions each strategy would need before writing any firmware code.
+
+A transaction is one command to the card, reading or writing one or more consecutive 512 byte sectors. Files start on
+a cluster boundary, so file offsets are aligned the same way as sectors.
+
+Strategies:
+  none           every read and write is its own transaction
+  sdfat          SdFat's single shared sector cache: small reads inside the cached sector are free, writes are
+                 buffered until another sector is needed (what the firmware does today)
+  lru:N          N sector LRU cache shared by all files for reads, writes as with sdfat
+  readahead:N    an N byte buffer per open file that reads N bytes at a time, writes as with sdfat
+
+Usage:
+  python3 scripts/replay_sd_trace.py trace.txt [--strategy sdfat --strategy lru:8 ...] [--by-site sdfat] [--top 15]
+"""
+
+import argparse
+from collections import OrderedDict, defaultdict
+
+SECTOR = 512
+DEFAULT_STRATEGIES = ["none", "sdfat", "lru:4", "lru:16", "readahead:512", "readahead:4096"]
+
+
+def load(path):
+    sites = {}
+    files = {}
+    ops = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            if line.startswith("#") or not line.strip():
+                continue
+            kind, rest = line[0], line[2:].rstrip("\n")
+            if kind == "S":
+                site, name = rest.split(" ", 1)
+                sites[int(site)] = name
+            elif kind == "o":
+                file, mode, site, name = rest.split(" ", 3)
+                files[int(file)] = name
+                ops.append(("o", int(file), mode == "w", 0, 0, int(site)))
+            elif kind == "c":
+                ops.append(("c", int(rest), False, 0, 0, -1))
+            elif kind == "s":
+                file, offset, site = rest.split(" ")
+                ops.append(("s", int(file), False, int(offset), 0, int(site)))
+            elif kind in "rw":
+                file, offset, length, site = rest.split(" ")
+                ops.append((kind, int(file), False, int(offset), int(length), int(site)))
+    return sites, files, ops
+
+
+def sectors(offset, length):
+    return range(offset // SECTOR, (offset + length + SECTOR - 1) // SECTOR) if length else range(0)
+
+
+class Model:
+    """Counts transactions and sectors, per call site too"""
+
+    def __init__(self, name):
+        self.name = name
+        self.reads = 0
+        self.read_sectors = 0
+        self.writes = 0
+        self.write_sectors = 0
+        self.ram = 0
+        self.by_site = defaultdict(int)
+
+    def card_read(self, count, site):
+        if count:
+            self.reads += 1
+            self.read_sectors += count
+            self.by_site[site] += 1
+
+    def card_write(self, count, site):
+        if count:
+            self.writes += 1
+            self.write_sectors += count
+            self.by_site[site] += 1
+
+    def open(self, path, write):
+        pass
+
+    def close(self, path):
+        pass
+
+
+class NoCache(Model):
+    def read(self, path, offset, length, site):
+        self.card_read(len(sectors(offset, length)), site)
+
+    def write(self, path, offset, length, site):
+        self.card_write(len(sectors(offset, length)), site)
+
+
+class SdFatCache(Model):
+    def __init__(self, name):
+        super().__init__(name)
+        self.ram = SECTOR
+        self.cached = None
+        self.dirty_site = None
+        # Bytes written to files opened for writing, anything past it need not be read before a partial write
+        self.sizes = {}
+
+    def flush(self):
+        if self.dirty_site is not None:
+            self.card_write(1, self.dirty_site)
+            self.dirty_site = None
+
+    def load(self, key, site, fill):
+        if self.cached != key:
+            self.flush()
+            self.cached = key
+            if fill:
+                self.card_read(1, site)
+
+    def read(self, path, offset, length, site):
+        end = offset + length
+        direct = 0
+        for sector in sectors(offset, length):
+            start = sector * SECTOR
+            if offset <= start and start + SECTOR <= end and self.cached != (path, sector):
+                # Whole sectors go straight into the caller's buffer, consecutive ones in one transaction
+                direct += 1
+                continue
+            self.card_read(direct, site)
+            direct = 0
+            self.load((path, sector), site, True)
+        self.card_read(direct, site)
+
+    def write(self, path, offset, length, site):
+        end = offset + length
+        direct = 0
+        for sector in sectors(offset, length):
+            start = sector * SECTOR
+            if offset <= start and start + SECTOR <= end:
+                direct += 1
+                if self.cached == (path, sector):
+                    self.cached = None
+                    self.dirty_site = None
+                continue
+            self.card_write(direct, site)
+            direct = 0
+            self.load((path, sector), site, start < self.sizes.get(path, float("inf")))
+            self.dirty_site = site
+        self.card_write(direct, site)
+        if path in self.sizes:
+            self.sizes[path] = max(self.sizes[path], end)
+
+    def open(self, path, write):
+        # Files are mostly opened for writing with O_TRUNC, treat them as empty
+        if write:
+            self.sizes[path] = 0
+
+    def close(self, path):
+        self.flush()
+
+
+class LruCache(SdFatCache):
+    def __init__(self, name, size):
+        super().__init__(name)
+        self.size = size
+        self.ram += size * SECTOR
+        self.cache = OrderedDict()
+
+    def read(self, path, offset, length, site):
+        missing = 0
+        for sector in sectors(offset, length):
+            key = (path, sector)
+            if key in self.cache:
+                self.cache.move_to_end(key)
+                self.card_read(missing, site)
+                missing = 0
+                continue
+            missing += 1
+            self.cache[key] = True
+            if len(self.cache) > self.size:
+                self.cache.popitem(last=False)
+        self.card_read(missing, site)
+
+    def write(self, path, offset, length, site):
+        for sector in sectors(offset, length):
+            self.cache.pop((path, sector), None)
+        super().write(path, offset, length, site)
+
+    def open(self, path, write):
+        super().open(path, write)
+        if write:
+            for key in [k for k in self.cache if k[0] == path]:
+                del self.cache[key]
+
+
+class ReadAhead(SdFatCache):
+    def __init__(self, name, size):
+        super().__init__(name)
+        self.size = size
+        self.windows = {}
+        self.open_files = 0
+        # Most files open at once, each needs a buffer
+        self.buffers = 0
+
+    def read(self, path, offset, length, site):
+        window = self.windows.get(path)
+        if window and window[0] <= offset and offset + length <= window[1]:
+            return
+        if length >= self.size:
+            self.card_read(len(sectors(offset, length)), site)
+            return
+        start = offset - offset % SECTOR
+        end = max(start + self.size, offset + length)
+        self.windows[path] = (start, end)
+        self.card_read(len(sectors(start, end - start)), site)
+
+    def write(self, path, offset, length, site):
+        self.windows.pop(path, None)
+        super().write(path, offset, length, site)
+
+    def open(self, path, write):
+        super().open(path, write)
+        self.open_files += 1
+        self.buffers = max(self.buffers, self.open_files)
+        self.ram = SECTOR + self.buffers * self.size
+
+    def close(self, path):
+        super().close(path)
+        self.open_files -= 1
+        self.windows.pop(path, None)
+
+
+def make_model(spec):
+    kind, _, size = spec.partition(":")
+    if kind == "none":
+        return NoCache(spec)
+    if kind == "sdfat":
+        return SdFatCache(spec)
+    if kind == "lru":
+        return LruCache(spec, int(size))
+    if kind == "readahead":
+        return ReadAhead(spec, int(size))
+    raise SystemExit(f"Unknown strategy {spec}")
+
+
+def replay(model, files, ops):
+    for kind, file, write, offset, length, site in ops:
+        path = files.get(file, str(file))
+        if kind == "o":
+            model.open(path, write)
+        elif kind == "c":
+            model.close(path)
+        elif kind == "r":
+            model.read(path, offset, length, site)
+        elif kind == "w":
+            model.write(path, offset, length, site)
+    if isinstance(model, SdFatCache):
+        model.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay an SD access trace against caching strategies")
+    parser.add_argument("trace", help="trace written by the native build with --sd-trace")
+    parser.add_argument("--strategy", action="append", help=f"strategy to replay (default: {' '.join(DEFAULT_STRATEGIES)})")
+    parser.add_argument("--by-site", metavar="STRATEGY", help="also list the call sites with the most transactions")
+    parser.add_argument("--top", type=int, default=15, help="number of call sites to list")
+    args = parser.parse_args()
+
+    sites, files, ops = load(args.trace)
+    calls = sum(1 for op in ops if op[0] in "rw")
+    seeks = sum(1 for op in ops if op[0] == "s")
+    opens = sum(1 for op in ops if op[0] == "o")
+    print(f"{args.trace}: {opens} opens, {seeks} seeks, {calls} reads and writes")
+    print()
+
+    strategies = args.strategy or DEFAULT_STRATEGIES
+    if args.by_site and args.by_site not in strategies:
+        strategies.append(args.by_site)
+    print(f"{'strategy':<16} {'cache RAM':>10} {'reads':>9} {'sectors':>9} {'writes':>9} {'sectors':>9}")
+    models = {}
+    for spec in strategies:
+        model = make_model(spec)
+        replay(model, files, ops)
+        models[spec] = model
+        print(f"{spec:<16} {model.ram:>10} {model.reads:>9} {model.read_sectors:>9} {model.writes:>9} "
+              f"{model.write_sectors:>9}")
+
+    if args.by_site:
+        model = models[args.by_site]
+        print(f"\nTransactions per call site with {args.by_site}:")
+        for site, count in sorted(model.by_site.items(), key=lambda item: -item[1])[: args.top]:
+            print(f"{count:>9}  {sites.get(site, site)}")
+
+
+if __name__ == "__main__":
+    main()
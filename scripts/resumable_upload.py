@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Upload a file to a CrossPoint Reader using the resumable HTTP upload protocol.
+
+The file is sent as a series of multipart POSTs to /upload, each carrying one chunk together with its
+offset, the total size and a CRC32. Before sending, the client asks /api/upload for the committed offset,
+so re-running the script after an interrupted transfer continues where the device left off.
+
+Usage:
+  python3 scripts/resumable_upload.py book.epub --host crosspoint.local --path /Books
+  python3 scripts/resumable_upload.py big.xtc --host 192.168.1.102 --drop-after 3   # simulate a drop
+"""
+
+import argparse
+import http.client
+import json
+import os
+import sys
+import time
+import urllib.parse
+import uuid
+import zlib
+
+
+def query_offset(host, port, path, name, size):
+    params = urllib.parse.urlencode({"path": path, "name": name, "size": size})
+    conn = http.client.HTTPConnection(host, port, timeout=30)
+    conn.request("GET", f"/api/upload?{params}")
+    resp = conn.getresponse()
+    body = resp.read()
+    conn.close()
+    if resp.status != 200:
+        raise RuntimeError(f"offset query failed: {resp.status} {body!r}")
+    return json.loads(body)
+
+
+def send_chunk(host, port, path, name, size, offset, data):
+    boundary = uuid.uuid4().hex
+    head = (
+        f"--{boundary}\r\n"
+        f'Content-Disposition: form-data; name="file"; filename="{name}"\r\n'
+        "Content-Type: application/octet-stream\r\n\r\n"
+    ).encode()
+    tail = f"\r\n--{boundary}--\r\n".encode()
+    body = head + data + tail
+
+    params = urllib.parse.urlencode(
+        {"path": path, "size": size, "offset": offset, "crc": f"{zlib.crc32(data) & 0xFFFFFFFF:08x}"}
+    )
+    conn = http.client.HTTPConnection(host, port, timeout=60)
+    conn.request(
+        "POST",
+        f"/upload?{params}",
+        body=body,
+        headers={"Content-Type": f"multipart/form-data; boundary={boundary}"},
+    )
+    resp = conn.getresponse()
+    reply = json.loads(resp.read() or b"{}")
+    conn.close()
+    return resp.status, reply
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Resumable upload to CrossPoint Reader")
+    parser.add_argument("file")
+    parser.add_argument("--host", default="crosspoint.local")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", default="/", help="destination folder on the SD card")
+    parser.add_argument("--chunk-size", type=int, default=256 * 1024)
+    parser.add_argument("--retries", type=int, default=10)
+    parser.add_argument("--drop-after", type=int, default=0, help="exit after N chunks to test resuming")
+    args = parser.parse_args()
+
+    name = os.path.basename(args.file)
+    size = os.path.getsize(args.file)
+
+    status = query_offset(args.host, args.port, args.path, name, size)
+    offset = status["offset"]
+    print(f"session {status['id']}: {offset}/{size} bytes already on device")
+
+    start = time.time()
+    sent = 0
+    chunks = 0
+    retries = 0
+    with open(args.file, "rb") as f:
+        while offset < size:
+            f.seek(offset)
+            data = f.read(args.chunk_size)
+            try:
+                code, reply = send_chunk(args.host, args.port, args.path, name, size, offset, data)
+            except (OSError, http.client.HTTPException) as e:
+                retries += 1
+                if retries > args.retries:
+                    sys.exit(f"giving up after {retries - 1} retries: {e}")
+                print(f"connection error ({e}), re-querying offset")
+                time.sleep(min(retries, 5))
+                offset = query_offset(args.host, args.port, args.path, name, size)["offset"]
+                continue
+
+            if code != 200:
+                # Offset mismatch or CRC failure: the reply carries the committed offset to resume from
+                retries += 1
+                if retries > args.retries:
+                    sys.exit(f"giving up: {reply.get('error')}")
+                print(f"chunk at {offset} rejected ({reply.get('error')}), resuming at {reply['offset']}")
+                offset = reply["offset"]
+                continue
+
+            sent += len(data)
+            offset = reply["offset"]
+            chunks += 1
+            print(f"\r{offset}/{size} bytes ({100 * offset // max(size, 1)}%)", end="", flush=True)
+            if reply.get("done"):
+                break
+            if args.drop_after and chunks >= args.drop_after:
+                print("\nsimulated drop, re-run to resume")
+                return
+
+    elapsed = time.time() - start
+    print(f"\ndone: {sent} bytes sent in {elapsed:.1f}s ({sent / 1024 / max(elapsed, 1e-3):.1f} KB/s), {retries} retries")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,341 @@
+#include "BookCacheManager.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "CrossPointSettings.h"
+
+namespace {
+constexpr uint8_t INDEX_FILE_VERSION = 1;
+constexpr char CACHE_ROOT[] = "/.crosspoint";
+constexpr char INDEX_FILE[] = "/.crosspoint/cache_index.bin";
+constexpr uint16_t MAX_ENTRIES = 4096;
+// Deleting a file is a few FAT updates, this keeps a step well under a page render
+constexpr size_t EVICT_FILES_PER_STEP = 8;
+// Each check is a directory lookup on the card, a batch of them takes about as long as a few deletions
+constexpr size_t ORPHAN_CHECKS_PER_STEP = 8;
+// trimLevel values: sections and page indexes go first, then covers and thumbnails
+constexpr uint8_t TRIM_NONE = 0;
+constexpr uint8_t TRIM_SECTIONS = 1;
+constexpr uint8_t TRIM_IMAGES = 2;
+
+bool isBookCacheDir(const char* name) {
+  return strncmp(name, "epub_", 5) == 0 || strncmp(name, "txt_", 4) == 0 || strncmp(name, "xtc_", 4) == 0;
+}
+
+// Needed to show the book in the library and to continue reading it
+bool isKeptFile(const char* name) {
+  return strcmp(name, "progress.bin") == 0 || strcmp(name, "progress.log") == 0 || strcmp(name, "book.bin") == 0;
+}
+
+uint32_t directorySize(const std::string& path, const int depth) {
+  FsFile dir = SdMan.open(path.c_str());
+  if (!dir || !dir.isDirectory()) {
+    if (dir) {
+      dir.close();
+    }
+    return 0;
+  }
+
+  uint32_t total = 0;
+  char name[64];
+  for (FsFile file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    if (!file.isDirectory()) {
+      total += file.size();
+    } else if (depth > 0) {
+      file.getName(name, sizeof(name));
+      total += directorySize(path + "/" + name, depth - 1);
+    }
+    file.close();
+  }
+  dir.close();
+  return total;
+}
+
+// Deletes up to EVICT_FILES_PER_STEP files in dir accepted by filter, returns how many were deleted
+size_t removeFiles(const std::string& dir, bool (*filter)(const char* name), uint32_t& removedBytes) {
+  FsFile root = SdMan.open(dir.c_str());
+  if (!root || !root.isDirectory()) {
+    if (root) {
+      root.close();
+    }
+    return 0;
+  }
+
+  // Collect first, deleting entries while iterating the directory isn't safe
+  std::vector<std::string> names;
+  char name[64];
+  for (FsFile file = root.openNextFile(); file && names.size() < EVICT_FILES_PER_STEP; file = root.openNextFile()) {
+    file.getName(name, sizeof(name));
+    if (!file.isDirectory() && filter(name)) {
+      names.emplace_back(name);
+      removedBytes += file.size();
+    }
+    file.close();
+  }
+  root.close();
+
+  for (const auto& fileName : names) {
+    SdMan.remove((dir + "/" + fileName).c_str());
+  }
+  return names.size();
+}
+}  // namespace
+
+BookCacheManager BookCacheManager::instance;
+
+BookCacheManager::Entry* BookCacheManager::findEntry(const std::string& name) {
+  const auto it = std::find_if(entries.begin(), entries.end(), [&name](const Entry& e) { return e.name == name; });
+  return it == entries.end() ? nullptr : &*it;
+}
+
+uint64_t BookCacheManager::usedBytes() const {
+  uint64_t total = 0;
+  for (const auto& entry : entries) {
+    if (entry.sized) {
+      total += entry.sizeBytes;
+    }
+  }
+  return total;
+}
+
+bool BookCacheManager::saveToFile() const {
+  FsFile outputFile;
+  if (!SdMan.openFileForWrite("BCM", INDEX_FILE, outputFile)) {
+    return false;
+  }
+
+  serialization::writePod(outputFile, INDEX_FILE_VERSION);
+  serialization::writePod(outputFile, accessCounter);
+  serialization::writePod(outputFile, static_cast<uint16_t>(entries.size()));
+  for (const auto& entry : entries) {
+    serialization::writeString(outputFile, entry.name);
+    serialization::writeString(outputFile, entry.bookPath);
+    serialization::writePod(outputFile, entry.lastAccess);
+    serialization::writePod(outputFile, entry.sizeBytes);
+    serialization::writePod(outputFile, entry.sized);
+    serialization::writePod(outputFile, entry.trimLevel);
+  }
+  outputFile.close();
+  return true;
+}
+
+bool BookCacheManager::loadFromFile() {
+  FsFile inputFile;
+  if (!SdMan.openFileForRead("BCM", INDEX_FILE, inputFile)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(inputFile, version);
+  if (version != INDEX_FILE_VERSION) {
+    Serial.printf("[%lu] [BCM] Deserialization failed: Unknown version %u\n", millis(), version);
+    inputFile.close();
+    return false;
+  }
+
+  uint16_t count;
+  serialization::readPod(inputFile, accessCounter);
+  serialization::readPod(inputFile, count);
+  if (count > MAX_ENTRIES) {
+    Serial.printf("[%lu] [BCM] Deserialization failed: %u entries\n", millis(), count);
+    inputFile.close();
+    return false;
+  }
+
+  entries.clear();
+  entries.reserve(count);
+  for (uint16_t i = 0; i < count; i++) {
+    Entry entry;
+    serialization::readString(inputFile, entry.name);
+    serialization::readString(inputFile, entry.bookPath);
+    serialization::readPod(inputFile, entry.lastAccess);
+    serialization::readPod(inputFile, entry.sizeBytes);
+    serialization::readPod(inputFile, entry.sized);
+    serialization::readPod(inputFile, entry.trimLevel);
+    entries.push_back(std::move(entry));
+  }
+  inputFile.close();
+  Serial.printf("[%lu] [BCM] Loaded cache index: %u books, %llu bytes\n", millis(), count, usedBytes());
+  return true;
+}
+
+void BookCacheManager::touch(const std::string& cachePath, const std::string& bookPath) {
+  const std::string name = cachePath.substr(cachePath.find_last_of('/') + 1);
+  Entry* entry = findEntry(name);
+  if (!entry) {
+    entries.push_back({name, "", 0, 0, false, TRIM_NONE});
+    entry = &entries.back();
+  }
+  entry->bookPath = bookPath;
+  entry->lastAccess = ++accessCounter;
+  // Reading the book regenerates what was trimmed, its size is measured again on the next pass
+  entry->sized = false;
+  entry->trimLevel = TRIM_NONE;
+  // Saved by the next maintenance step rather than on every open
+  dirty = true;
+}
+
+void BookCacheManager::scanCacheRoot() {
+  FsFile root = SdMan.open(CACHE_ROOT);
+  if (!root || !root.isDirectory()) {
+    if (root) {
+      root.close();
+    }
+    return;
+  }
+
+  std::vector<bool> seen(entries.size(), false);
+  char name[64];
+  for (FsFile file = root.openNextFile(); file; file = root.openNextFile()) {
+    file.getName(name, sizeof(name));
+    if (file.isDirectory() && isBookCacheDir(name)) {
+      const auto it =
+          std::find_if(entries.begin(), entries.end(), [&name](const Entry& e) { return e.name == name; });
+      if (it == entries.end()) {
+        // Not opened since tracking started, so it counts as the least recently used
+        entries.push_back({name, "", 0, 0, false, TRIM_NONE});
+        dirty = true;
+      } else if (it - entries.begin() < static_cast<long>(seen.size())) {
+        seen[it - entries.begin()] = true;
+      }
+    }
+    file.close();
+  }
+  root.close();
+
+  // Directories deleted by hand
+  for (size_t i = seen.size(); i-- > 0;) {
+    if (!seen[i]) {
+      entries.erase(entries.begin() + i);
+      dirty = true;
+    }
+  }
+  Serial.printf("[%lu] [BCM] Tracking %u book cache directories\n", millis(), static_cast<unsigned>(entries.size()));
+}
+
+// A moved or deleted book gets a new cache directory if it comes back, so the old one is never read again. Checks the
+// next ORPHAN_CHECKS_PER_STEP entries and removes at most one directory, returns true until every entry was checked.
+bool BookCacheManager::removeOrphan() {
+  const size_t end = std::min(entries.size(), orphanCursor + ORPHAN_CHECKS_PER_STEP);
+  for (; orphanCursor < end; orphanCursor++) {
+    const Entry& entry = entries[orphanCursor];
+    if (entry.bookPath.empty() || SdMan.exists(entry.bookPath.c_str())) {
+      continue;
+    }
+
+    const std::string dir = std::string(CACHE_ROOT) + "/" + entry.name;
+    Serial.printf("[%lu] [BCM] %s is gone, removing %s\n", millis(), entry.bookPath.c_str(), dir.c_str());
+    SdMan.removeDir(dir.c_str());
+    evictedBytes += entry.sizeBytes;
+    // The next entry moves into the cursor's place
+    entries.erase(entries.begin() + orphanCursor);
+    dirty = true;
+    return true;
+  }
+  return orphanCursor < entries.size();
+}
+
+bool BookCacheManager::evictStep(const uint64_t budget) {
+  // The book being read (or just closed) is always the most recent one
+  uint32_t newest = 0;
+  for (const auto& entry : entries) {
+    newest = std::max(newest, entry.lastAccess);
+  }
+
+  // Lowest trim level first, so the sections of every book are gone before any cover is
+  Entry* victim = nullptr;
+  for (auto& entry : entries) {
+    if ((newest != 0 && entry.lastAccess == newest) || entry.trimLevel >= TRIM_IMAGES) {
+      continue;
+    }
+    if (!victim || entry.trimLevel < victim->trimLevel ||
+        (entry.trimLevel == victim->trimLevel && entry.lastAccess < victim->lastAccess)) {
+      victim = &entry;
+    }
+  }
+  if (!victim) {
+    Serial.printf("[%lu] [BCM] Over budget (%llu of %llu bytes) with nothing left to evict\n", millis(), usedBytes(),
+                  budget);
+    return false;
+  }
+
+  const std::string dir = std::string(CACHE_ROOT) + "/" + victim->name;
+  uint32_t removedBytes = 0;
+  size_t removed;
+  if (victim->trimLevel == TRIM_NONE) {
+    removed = removeFiles(dir + "/sections", [](const char*) { return true; }, removedBytes);
+    if (removed == 0) {
+      removed = removeFiles(dir, [](const char* name) { return strcmp(name, "index.bin") == 0; }, removedBytes);
+      victim->trimLevel = TRIM_SECTIONS;
+    }
+  } else {
+    removed = removeFiles(dir, [](const char* name) { return !isKeptFile(name); }, removedBytes);
+    if (removed == 0) {
+      victim->trimLevel = TRIM_IMAGES;
+    }
+  }
+
+  if (removed > 0) {
+    Serial.printf("[%lu] [BCM] Evicted %u files (%u bytes) from %s\n", millis(), static_cast<unsigned>(removed),
+                  static_cast<unsigned>(removedBytes), victim->name.c_str());
+  }
+  victim->sizeBytes -= std::min(victim->sizeBytes, removedBytes);
+  evictedFiles += removed;
+  evictedBytes += removedBytes;
+  dirty = true;
+  return true;
+}
+
+bool BookCacheManager::step() {
+  if (!scanned) {
+    scanCacheRoot();
+    scanned = true;
+    return true;
+  }
+
+  // Sizes are only measured for directories that changed, one per step
+  for (auto& entry : entries) {
+    if (!entry.sized) {
+      entry.sizeBytes = directorySize(std::string(CACHE_ROOT) + "/" + entry.name, 1);
+      entry.sized = true;
+      dirty = true;
+      return true;
+    }
+  }
+
+  if (!orphansChecked) {
+    if (removeOrphan()) {
+      return true;
+    }
+    orphansChecked = true;
+  }
+
+  const uint64_t budget = SETTINGS.getCacheBudgetBytes();
+  if (budget != 0 && usedBytes() > budget && evictStep(budget)) {
+    return true;
+  }
+
+  if (dirty) {
+    saveToFile();
+    dirty = false;
+    Serial.printf("[%lu] [BCM] Cache maintenance done: %u books, %llu bytes\n", millis(),
+                  static_cast<unsigned>(entries.size()), usedBytes());
+  }
+  return false;
+}
+
+BookCacheManager::Stats BookCacheManager::getStats() const {
+  Stats stats{};
+  stats.budgetBytes = SETTINGS.getCacheBudgetBytes();
+  stats.usedBytes = usedBytes();
+  stats.books = entries.size();
+  stats.unsizedBooks = std::count_if(entries.begin(), entries.end(), [](const Entry& e) { return !e.sized; });
+  stats.evictedFiles = evictedFiles;
+  stats.evictedBytes = evictedBytes;
+  return stats;
+}
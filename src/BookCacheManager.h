@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Keeps the per-book cache directories in /.crosspoint (epub_*, txt_*, xtc_*) within the budget from the settings.
+ *
+ * The size and last use of every directory is tracked in /.crosspoint/cache_index.bin. While the total is over
+ * budget, files that can be regenerated are deleted from the least recently opened books first: laid out sections
+ * and page indexes of every book before any covers and thumbnails. progress.bin, progress.log and book.bin are kept,
+ * and the most recently opened book is never touched. Directories of books that were deleted or moved are removed
+ * entirely.
+ *
+ * The work is split into small steps (one directory scan, a few deletions or book lookups) that idle activities run
+ * from their display task, so it never holds up a page turn. The index is saved by the last step of a run, touch()
+ * only marks it changed. SdFat is not thread safe: step() must only be called by the task that currently owns the SD
+ * card.
+ */
+class BookCacheManager {
+ public:
+  struct Stats {
+    uint64_t budgetBytes;  // 0 = unlimited
+    uint64_t usedBytes;    // Of the directories whose size is known
+    uint16_t books;
+    uint16_t unsizedBooks;
+    uint32_t evictedFiles;  // Since boot
+    uint64_t evictedBytes;
+  };
+
+ private:
+  struct Entry {
+    std::string name;      // Directory name in /.crosspoint
+    std::string bookPath;  // Empty for directories found on the card but not opened since tracking started
+    uint32_t lastAccess;   // Value of accessCounter when last opened, 0 = never seen opened
+    uint32_t sizeBytes;
+    bool sized;
+    // How far the directory has been trimmed, see evictStep
+    uint8_t trimLevel;
+  };
+
+  static BookCacheManager instance;
+
+  std::vector<Entry> entries;
+  uint32_t accessCounter = 0;
+  bool scanned = false;
+  // Entries are checked for a missing book once per boot, a batch per step from orphanCursor
+  bool orphansChecked = false;
+  size_t orphanCursor = 0;
+  bool dirty = false;
+  uint32_t evictedFiles = 0;
+  uint64_t evictedBytes = 0;
+
+  Entry* findEntry(const std::string& name);
+  uint64_t usedBytes() const;
+  void scanCacheRoot();
+  bool removeOrphan();
+  bool evictStep(uint64_t budget);
+  bool saveToFile() const;
+
+ public:
+  ~BookCacheManager() = default;
+
+  // Get singleton instance
+  static BookCacheManager& getInstance() { return instance; }
+
+  bool loadFromFile();
+
+  // Record that a book was opened, making it the most recently used
+  void touch(const std::string& cachePath, const std::string& bookPath);
+
+  // Do one bounded piece of maintenance. Returns true while there is more to do.
+  bool step();
+
+  Stats getStats() const;
+};
+
+// Helper macro to access the cache manager
+#define BOOK_CACHE BookCacheManager::getInstance()
@@ -58,6 +58,9 @@ class CrossPointSettings {
   // Hide battery percentage
   enum HIDE_BATTERY_PERCENTAGE { HIDE_NEVER = 0, HIDE_READER = 1, HIDE_ALWAYS = 2 };
 
+  // Size budget for the book caches in /.crosspoint
+  enum CACHE_BUDGET { CACHE_100MB = 0, CACHE_250MB = 1, CACHE_500MB = 2, CACHE_1GB = 3, CACHE_UNLIMITED = 4 };
+
   // Sleep screen settings
   uint8_t sleepScreen = DARK;
   // Sleep screen cover mode settings
@@ -92,6 +95,10 @@ class CrossPointSettings {
   uint8_t hideBatteryPercentage = HIDE_NEVER;
   // Long-press chapter skip on side buttons
   uint8_t longPressChapterSkip = 1;
+  // Hyphenate words when a pattern pack for the book language is installed
+  uint8_t hyphenation = 1;
+  // Book cache budget (default 500 MB)
+  uint8_t cacheBudget = CACHE_500MB;
 
   ~CrossPointSettings() = default;
 
@@ -109,6 +116,8 @@ class CrossPointSettings {
   float getReaderLineCompression() const;
   unsigned long getSleepTimeoutMs() const;
   int getRefreshFrequency() const;
+  // 0 if unlimited
+  uint64_t getCacheBudgetBytes() const;
 };
 
 // Helper macro to access settings
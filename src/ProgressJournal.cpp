@@ -0,0 +1,157 @@
+#include "ProgressJournal.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <miniz.h>
+
+#include <cstring>
+
+namespace {
+// Record: tag, position, CRC-32 of tag and position (little-endian)
+constexpr uint8_t RECORD_TAG = 0x50;
+constexpr uint32_t RECORD_SIZE = 1 + ProgressJournal::DATA_SIZE + 4;
+
+uint32_t recordCrc(const uint8_t* record) {
+  return static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, record, 1 + ProgressJournal::DATA_SIZE));
+}
+}  // namespace
+
+bool ProgressJournal::readLog(uint8_t data[DATA_SIZE]) {
+  logSize = 0;
+  FsFile file;
+  if (!SdMan.exists(logPath.c_str()) || !SdMan.openFileForRead("PRJ", logPath, file)) {
+    return false;
+  }
+
+  // Records are only ever appended, the last intact one is the newest. Anything after a damaged record is ignored.
+  bool found = false;
+  uint8_t record[RECORD_SIZE];
+  while (file.read(record, RECORD_SIZE) == RECORD_SIZE) {
+    uint32_t crc;
+    memcpy(&crc, record + 1 + DATA_SIZE, sizeof(crc));
+    if (record[0] != RECORD_TAG || crc != recordCrc(record)) {
+      Serial.printf("[%lu] [PRJ] Ignoring damaged record at %u in %s\n", millis(), static_cast<unsigned>(logSize),
+                    logPath.c_str());
+      break;
+    }
+    memcpy(data, record + 1, DATA_SIZE);
+    logSize += RECORD_SIZE;
+    found = true;
+  }
+  file.close();
+  return found;
+}
+
+bool ProgressJournal::begin(const std::string& cachePath, uint8_t data[DATA_SIZE]) {
+  snapshotPath = cachePath + "/progress.bin";
+  logPath = cachePath + "/progress.log";
+  pending = false;
+  pendingUpdates = 0;
+
+  bool found = readLog(data);
+  if (!found) {
+    FsFile file;
+    if (SdMan.openFileForRead("PRJ", snapshotPath, file)) {
+      found = file.read(data, DATA_SIZE) == DATA_SIZE;
+      file.close();
+    }
+  }
+
+  if (found) {
+    memcpy(current, data, DATA_SIZE);
+  } else {
+    memset(current, 0, DATA_SIZE);
+  }
+  memcpy(saved, current, DATA_SIZE);
+  return found;
+}
+
+void ProgressJournal::update(const uint8_t data[DATA_SIZE]) {
+  if (memcmp(current, data, DATA_SIZE) == 0) {
+    return;
+  }
+  memcpy(current, data, DATA_SIZE);
+  pendingUpdates++;
+  if (!pending) {
+    pending = true;
+    pendingSince = millis();
+  }
+}
+
+bool ProgressJournal::isFlushDue() const { return pending && millis() - pendingSince >= FLUSH_INTERVAL_MS; }
+
+uint32_t ProgressJournal::msUntilFlushDue() const {
+  if (!pending) {
+    return UINT32_MAX;
+  }
+  const uint32_t waited = millis() - pendingSince;
+  return waited >= FLUSH_INTERVAL_MS ? 0 : FLUSH_INTERVAL_MS - waited;
+}
+
+bool ProgressJournal::flush() {
+  if (!pending || logPath.empty()) {
+    return true;
+  }
+  if (memcmp(current, saved, DATA_SIZE) == 0) {
+    // Paged back to where it was saved
+    pending = false;
+    pendingUpdates = 0;
+    return true;
+  }
+
+  uint8_t record[RECORD_SIZE];
+  record[0] = RECORD_TAG;
+  memcpy(record + 1, current, DATA_SIZE);
+  const uint32_t crc = recordCrc(record);
+  memcpy(record + 1 + DATA_SIZE, &crc, sizeof(crc));
+
+  FsFile file = SdMan.open(logPath.c_str(), O_RDWR | O_CREAT);
+  if (!file) {
+    Serial.printf("[%lu] [PRJ] Failed to open %s\n", millis(), logPath.c_str());
+    // Try again on the next interval
+    pendingSince = millis();
+    return false;
+  }
+  // Drop a record that was cut short, so the new one lines up with the intact ones
+  if (file.size() != logSize) {
+    file.truncate(logSize);
+  }
+  file.seek(logSize);
+  const bool ok = file.write(record, RECORD_SIZE) == RECORD_SIZE;
+  file.close();
+  if (!ok) {
+    Serial.printf("[%lu] [PRJ] Failed to append to %s\n", millis(), logPath.c_str());
+    pendingSince = millis();
+    return false;
+  }
+
+  pending = false;
+  logSize += RECORD_SIZE;
+  memcpy(saved, current, DATA_SIZE);
+  Serial.printf("[%lu] [PRJ] Saved progress (%u updates since last save)\n", millis(),
+                static_cast<unsigned>(pendingUpdates));
+  pendingUpdates = 0;
+
+  if (logSize >= COMPACT_AFTER_RECORDS * RECORD_SIZE) {
+    compact();
+  }
+  return true;
+}
+
+// The log stays until the snapshot is completely written, so a power loss in between still leaves a valid position
+bool ProgressJournal::compact() {
+  FsFile file;
+  if (!SdMan.openFileForWrite("PRJ", snapshotPath, file)) {
+    return false;
+  }
+  const bool ok = file.write(saved, DATA_SIZE) == DATA_SIZE;
+  file.close();
+  if (!ok) {
+    return false;
+  }
+
+  SdMan.remove(logPath.c_str());
+  logSize = 0;
+  Serial.printf("[%lu] [PRJ] Compacted %s\n", millis(), logPath.c_str());
+  return true;
+}
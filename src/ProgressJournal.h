@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * Reading position of a book, a 4 byte record whose meaning is up to the reader (the format of progress.bin).
+ *
+ * Page turns only update the position in RAM. It is appended to <cache>/progress.log as a CRC protected record once
+ * FLUSH_INTERVAL_MS have passed since the first unsaved turn, and when the reader exits (which includes going to
+ * sleep). A write cut short by power loss only damages the record being appended, and loading picks the newest intact
+ * one. Once the log holds COMPACT_AFTER_RECORDS records the position is written to progress.bin and the log removed.
+ *
+ * Not thread safe, use it from the task that owns the SD card (the reader's display task or, on exit, the main task
+ * after the display task is gone).
+ */
+class ProgressJournal {
+ public:
+  static constexpr size_t DATA_SIZE = 4;
+
+  // Point the journal at a book's cache directory and read the last saved position into data
+  bool begin(const std::string& cachePath, uint8_t data[DATA_SIZE]);
+
+  // Record the current position, saved by the next flush
+  void update(const uint8_t data[DATA_SIZE]);
+
+  // True once an unsaved position has waited FLUSH_INTERVAL_MS
+  bool isFlushDue() const;
+  // Time until then, 0 if due, UINT32_MAX if nothing is unsaved
+  uint32_t msUntilFlushDue() const;
+
+  // Save an unsaved position now
+  bool flush();
+
+ private:
+  static constexpr unsigned long FLUSH_INTERVAL_MS = 30 * 1000;
+  static constexpr uint32_t COMPACT_AFTER_RECORDS = 64;
+
+  std::string snapshotPath;
+  std::string logPath;
+  uint8_t current[DATA_SIZE] = {};
+  uint8_t saved[DATA_SIZE] = {};
+  bool pending = false;
+  unsigned long pendingSince = 0;
+  uint32_t pendingUpdates = 0;
+  // Bytes of intact records at the start of the log, appends go after them
+  uint32_t logSize = 0;
+
+  bool readLog(uint8_t data[DATA_SIZE]);
+  bool compact();
+};
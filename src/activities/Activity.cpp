@@ -0,0 +1,220 @@
+#include "Activity.h"
+
+#include <Arduino.h>
+
+#include <algorithm>
+
+Activity* Activity::displayTasks = nullptr;
+
+namespace {
+// The size the EPUB reader's own display task had. The lowest stack space left is logged whenever an activity stops
+// using the worker, to trim this with.
+constexpr uint32_t DISPLAY_WORKER_STACK = 8192;
+
+// Created with the first activity that uses it and kept, so entering and leaving activities does not allocate stacks
+TaskHandle_t displayWorker = nullptr;
+// Guards the display worker state and the step state of the activities, which other tasks change
+portMUX_TYPE displayTaskLock = portMUX_INITIALIZER_UNLOCKED;
+// Activity whose step is running, and the task waiting for it to be over to stop the activity
+Activity* runningStep = nullptr;
+TaskHandle_t stopWaiter = nullptr;
+// Last activity stepped, the next step is looked for after it so no activity is starved
+Activity* lastStepped = nullptr;
+bool displayWorkerIdle = true;
+
+// micros() of the last button change, until the activity loop that handles it is over
+uint32_t inputAtUs = 0;
+bool inputPending = false;
+}  // namespace
+
+void Activity::startDisplayTask() {
+  if (!displayWorker) {
+    xTaskCreate(&Activity::displayWorkerLoop, "DisplayWorker", DISPLAY_WORKER_STACK, nullptr, 1, &displayWorker);
+  }
+
+  portENTER_CRITICAL(&displayTaskLock);
+  nextDisplayTask = displayTasks;
+  displayTasks = this;
+  hasDisplayTask = true;
+  // The first step draws the activity
+  stepDue = true;
+  wakeAtMs = 0;
+  portEXIT_CRITICAL(&displayTaskLock);
+  xTaskNotifyGive(displayWorker);
+}
+
+void Activity::stopDisplayTask() {
+  if (!hasDisplayTask) {
+    return;
+  }
+
+  const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  portENTER_CRITICAL(&displayTaskLock);
+  for (Activity** link = &displayTasks; *link; link = &(*link)->nextDisplayTask) {
+    if (*link == this) {
+      *link = nextDisplayTask;
+      break;
+    }
+  }
+  nextDisplayTask = nullptr;
+  hasDisplayTask = false;
+  stepDue = false;
+  wakeAtMs = 0;
+  if (lastStepped == this) {
+    lastStepped = nullptr;
+  }
+  const bool stepRunning = runningStep == this && self != displayWorker;
+  if (stepRunning) {
+    stopWaiter = self;
+  }
+  portEXIT_CRITICAL(&displayTaskLock);
+
+  if (stepRunning) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+
+  if (inputWakeups > 0) {
+    Serial.printf("[%lu] [EVT] %s: %u inputs, drawn after %u us on average, %u us at most\n", millis(), name.c_str(),
+                  static_cast<unsigned>(inputWakeups), static_cast<unsigned>(inputLatencyTotalUs / inputWakeups),
+                  static_cast<unsigned>(inputLatencyMaxUs));
+  }
+  Serial.printf("[%lu] [EVT] Display worker stack: %u of %u bytes never used\n", millis(),
+                static_cast<unsigned>(uxTaskGetStackHighWaterMark(displayWorker)),
+                static_cast<unsigned>(DISPLAY_WORKER_STACK));
+}
+
+void Activity::requestUpdate() {
+  updateRequired = true;
+
+  portENTER_CRITICAL(&displayTaskLock);
+  const bool queued = hasDisplayTask;
+  if (queued) {
+    stepDue = true;
+    wakeAtMs = 0;
+    if (inputPending) {
+      inputPending = false;
+      pendingInputUs = inputAtUs;
+    }
+  }
+  portEXIT_CRITICAL(&displayTaskLock);
+  if (queued) {
+    xTaskNotifyGive(displayWorker);
+  }
+}
+
+bool Activity::displayStepWaiting() const {
+  bool waiting = false;
+  portENTER_CRITICAL(&displayTaskLock);
+  for (const Activity* activity = displayTasks; activity; activity = activity->nextDisplayTask) {
+    if (activity != this && activity->stepDue) {
+      waiting = true;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&displayTaskLock);
+  return waiting;
+}
+
+void Activity::displayWorkerLoop(void*) {
+  while (true) {
+    portENTER_CRITICAL(&displayTaskLock);
+    Activity* activity = nullptr;
+    if (displayTasks) {
+      Activity* const first = lastStepped && lastStepped->nextDisplayTask ? lastStepped->nextDisplayTask : displayTasks;
+      Activity* candidate = first;
+      do {
+        if (candidate->stepDue) {
+          activity = candidate;
+          break;
+        }
+        candidate = candidate->nextDisplayTask ? candidate->nextDisplayTask : displayTasks;
+      } while (candidate != first);
+    }
+    uint32_t inputUs = 0;
+    if (activity) {
+      activity->stepDue = false;
+      activity->wakeAtMs = 0;
+      inputUs = activity->pendingInputUs;
+      activity->pendingInputUs = 0;
+      runningStep = activity;
+      lastStepped = activity;
+    }
+    displayWorkerIdle = !activity;
+    portEXIT_CRITICAL(&displayTaskLock);
+
+    if (!activity) {
+      // Until requestUpdate(), startDisplayTask() or the main loop for a timeout that passed. The timeouts are not
+      // passed to FreeRTOS, its tick does not count while the CPU light sleeps.
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+
+    if (inputUs != 0) {
+      const uint32_t latencyUs = micros() - inputUs;
+      activity->inputWakeups++;
+      activity->inputLatencyTotalUs += latencyUs;
+      activity->inputLatencyMaxUs = std::max(activity->inputLatencyMaxUs, latencyUs);
+    }
+
+    const uint32_t nextStepMs = activity->displayStep();
+
+    portENTER_CRITICAL(&displayTaskLock);
+    runningStep = nullptr;
+    // Not touched any more once stopped, it is deleted right after
+    if (activity->hasDisplayTask && !activity->stepDue) {
+      if (nextStepMs == 0) {
+        activity->stepDue = true;
+      } else if (nextStepMs != WAIT_FOREVER) {
+        // 0 is kept for no timeout
+        activity->wakeAtMs = (millis() + nextStepMs) | 1;
+      }
+    }
+    const TaskHandle_t waiter = stopWaiter;
+    stopWaiter = nullptr;
+    portEXIT_CRITICAL(&displayTaskLock);
+
+    if (waiter) {
+      xTaskNotifyGive(waiter);
+    }
+    if (nextStepMs == 0) {
+      // More background work to do, give the other tasks a turn
+      ulTaskNotifyTake(pdTRUE, 1);
+    }
+  }
+}
+
+void Activity::noteInput() {
+  portENTER_CRITICAL(&displayTaskLock);
+  inputAtUs = micros() | 1;
+  inputPending = true;
+  portEXIT_CRITICAL(&displayTaskLock);
+}
+
+bool Activity::serviceDisplayTasks() {
+  const uint32_t now = millis();
+  bool wake = false;
+  bool idle = true;
+
+  portENTER_CRITICAL(&displayTaskLock);
+  // The activity loop that would have handled the input is over, it did not need the display
+  inputPending = false;
+  for (Activity* activity = displayTasks; activity; activity = activity->nextDisplayTask) {
+    if (activity->wakeAtMs != 0 && static_cast<int32_t>(now - activity->wakeAtMs) >= 0) {
+      activity->wakeAtMs = 0;
+      activity->stepDue = true;
+      wake = true;
+    }
+    if (activity->stepDue) {
+      idle = false;
+    }
+  }
+  if (!displayWorkerIdle) {
+    idle = false;
+  }
+  portEXIT_CRITICAL(&displayTaskLock);
+
+  if (wake) {
+    xTaskNotifyGive(displayWorker);
+  }
+  return idle;
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <HardwareSerial.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
+#include <cstdint>
 #include <string>
 #include <utility>
 
@@ -10,17 +13,63 @@ class GfxRenderer;
 
 class Activity {
  protected:
+  static constexpr uint32_t WAIT_FOREVER = UINT32_MAX;
+
   std::string name;
   GfxRenderer& renderer;
   MappedInputManager& mappedInput;
 
+  bool updateRequired = false;
+
+  /**
+   * Activities render and do their background work on one long-lived display worker task shared by all of them,
+   * instead of a task of their own. After startDisplayTask() the worker calls displayStep() whenever requestUpdate()
+   * is called (from any task), and otherwise as soon as the last step asked for: right away (0) to continue
+   * background work, after a time in ms for work due later (like saving the reading position), or never
+   * (WAIT_FOREVER). The main loop keeps track of the timeouts, so the CPU can light sleep while nothing is due.
+   */
+  void startDisplayTask();
+  // Waits for a step of this activity in progress, call it without holding a mutex displayStep() takes
+  void stopDisplayTask();
+  void requestUpdate();
+  // Display worker only. Returns the time until the next step is due if requestUpdate() is not called first.
+  virtual uint32_t displayStep() { return WAIT_FOREVER; }
+  // Another activity has a display step due. Steps doing long background work stop when it does and continue in
+  // a later step, so the worker gets to the other activity in between.
+  bool displayStepWaiting() const;
+
  public:
   explicit Activity(std::string name, GfxRenderer& renderer, MappedInputManager& mappedInput)
       : name(std::move(name)), renderer(renderer), mappedInput(mappedInput) {}
   virtual ~Activity() = default;
+  const std::string& getName() const { return name; }
   virtual void onEnter() { Serial.printf("[%lu] [ACT] Entering activity: %s\n", millis(), name.c_str()); }
   virtual void onExit() { Serial.printf("[%lu] [ACT] Exiting activity: %s\n", millis(), name.c_str()); }
   virtual void loop() {}
   virtual bool skipLoopDelay() { return false; }
   virtual bool preventAutoSleep() { return false; }
+
+  // Main loop: a button changed state, for the input to render latency of the display step it leads to
+  static void noteInput();
+  // Main loop: queue the display steps whose timeout has passed. True if the display worker has nothing to do, so
+  // the CPU can light sleep until the next input poll.
+  static bool serviceDisplayTasks();
+
+ private:
+  [[noreturn]] static void displayWorkerLoop(void* param);
+
+  // Activities served by the display worker, linked through nextDisplayTask
+  static Activity* displayTasks;
+  Activity* nextDisplayTask = nullptr;
+  bool hasDisplayTask = false;
+  // A step is wanted as soon as the worker gets to it, or at wakeAtMs (0 for no timeout)
+  bool stepDue = false;
+  uint32_t wakeAtMs = 0;
+
+  // Time from noteInput() to the display step it led to starting, in microseconds. pendingInputUs is the micros()
+  // of the input that the last requestUpdate() was made for.
+  uint32_t pendingInputUs = 0;
+  uint32_t inputWakeups = 0;
+  uint32_t inputLatencyTotalUs = 0;
+  uint32_t inputLatencyMaxUs = 0;
 };
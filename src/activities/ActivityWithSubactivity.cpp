@@ -1,14 +1,19 @@
 #include "ActivityWithSubactivity.h"
 
+#include <PowerMonitor.h>
+
 void ActivityWithSubactivity::exitActivity() {
   if (subActivity) {
     subActivity->onExit();
     subActivity.reset();
+    // Back to charging this activity for the power report
+    powerMonitor::enter(getName().c_str());
   }
 }
 
 void ActivityWithSubactivity::enterNewActivity(Activity* activity) {
   subActivity.reset(activity);
+  powerMonitor::enter(activity->getName().c_str());
   subActivity->onEnter();
 }
 
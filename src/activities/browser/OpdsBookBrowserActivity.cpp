@@ -4,6 +4,9 @@
 #include <HardwareSerial.h>
 #include <WiFi.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include "CrossPointSettings.h"
 #include "MappedInputManager.h"
 #include "ScreenComponents.h"
@@ -19,11 +22,6 @@ constexpr int SKIP_PAGE_MS = 700;
 constexpr char OPDS_ROOT_PATH[] = "opds";  // No leading slash - relative to server URL
 }  // namespace
 
-void OpdsBookBrowserActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<OpdsBookBrowserActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void OpdsBookBrowserActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -32,17 +30,13 @@ void OpdsBookBrowserActivity::onEnter() {
   entries.clear();
   navigationHistory.clear();
   currentPath = OPDS_ROOT_PATH;
+  nextPagePath.clear();
   selectorIndex = 0;
   errorMessage.clear();
   statusMessage = "Checking WiFi...";
-  updateRequired = true;
+  requestUpdate();
 
-  xTaskCreate(&OpdsBookBrowserActivity::taskTrampoline, "OpdsBookBrowserTask",
-              4096,               // Stack size (larger for HTTP operations)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  startDisplayTask();
 
   // Check WiFi and connect if needed, then fetch feed
   checkAndConnectWifi();
@@ -54,11 +48,8 @@ void OpdsBookBrowserActivity::onExit() {
   // Turn off WiFi when exiting
   WiFi.mode(WIFI_OFF);
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  nextPageCancelled = true;
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
   entries.clear();
@@ -81,7 +72,7 @@ void OpdsBookBrowserActivity::loop() {
         Serial.printf("[%lu] [OPDS] Retry: WiFi connected, retrying fetch\n", millis());
         state = BrowserState::LOADING;
         statusMessage = "Loading...";
-        updateRequired = true;
+        requestUpdate();
         fetchFeed(currentPath);
       } else {
         // WiFi not connected - launch WiFi selection
@@ -105,7 +96,12 @@ void OpdsBookBrowserActivity::loop() {
   // Handle loading state - only Back works
   if (state == BrowserState::LOADING) {
     if (mappedInput.wasReleased(MappedInputManager::Button::Back)) {
-      navigateBack();
+      if (nextPageLoading) {
+        // Stay on the entries loaded so far
+        nextPageCancelled = true;
+      } else {
+        navigateBack();
+      }
     }
     return;
   }
@@ -140,28 +136,37 @@ void OpdsBookBrowserActivity::loop() {
       } else {
         selectorIndex = (selectorIndex + entries.size() - 1) % entries.size();
       }
-      updateRequired = true;
+      requestUpdate();
     } else if (nextReleased && !entries.empty()) {
-      if (skipPage) {
+      // Fetch the next page of a paginated feed on the display worker once the selection would run off the loaded
+      // entries
+      const size_t target = skipPage ? (selectorIndex / PAGE_ITEMS + 1) * PAGE_ITEMS : selectorIndex + 1;
+      if (target >= entries.size() && !nextPagePath.empty()) {
+        state = BrowserState::LOADING;
+        statusMessage = "Loading more...";
+        nextPageTarget = target;
+        nextPageCancelled = false;
+        nextPageLoading = true;
+      } else if (skipPage) {
         selectorIndex = ((selectorIndex / PAGE_ITEMS + 1) * PAGE_ITEMS) % entries.size();
       } else {
         selectorIndex = (selectorIndex + 1) % entries.size();
       }
-      updateRequired = true;
+      requestUpdate();
     }
   }
 }
 
-void OpdsBookBrowserActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t OpdsBookBrowserActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
+  } else if (nextPageLoading) {
+    loadNextPage();
   }
+  return nextPageLoading ? 0 : WAIT_FOREVER;
 }
 
 void OpdsBookBrowserActivity::render() const {
@@ -206,6 +211,12 @@ void OpdsBookBrowserActivity::render() const {
       constexpr int barX = 50;
       const int barY = pageHeight / 2 + 20;
       ScreenComponents::drawProgressBar(renderer, barX, barY, barWidth, barHeight, downloadProgress, downloadTotal);
+
+      std::string rate = std::to_string(downloadStats.bytesPerSecond / 1024) + " KB/s";
+      if (downloadStats.retries > 0) {
+        rate += " (retry " + std::to_string(downloadStats.retries) + ")";
+      }
+      renderer.drawCenteredText(UI_10_FONT_ID, barY + barHeight + 30, rate.c_str());
     }
     renderer.displayBuffer();
     return;
@@ -257,41 +268,99 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   if (strlen(serverUrl) == 0) {
     state = BrowserState::ERROR;
     errorMessage = "No server URL configured";
-    updateRequired = true;
-    return;
-  }
-
-  std::string url = UrlUtils::buildUrl(serverUrl, path);
-  Serial.printf("[%lu] [OPDS] Fetching: %s\n", millis(), url.c_str());
-
-  std::string content;
-  if (!HttpDownloader::fetchUrl(url, content)) {
-    state = BrowserState::ERROR;
-    errorMessage = "Failed to fetch feed";
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
-  OpdsParser parser;
-  if (!parser.parse(content.c_str(), content.size())) {
+  if (!loadFeedPage(path, entries, nextPagePath)) {
     state = BrowserState::ERROR;
-    errorMessage = "Failed to parse feed";
-    updateRequired = true;
+    errorMessage = "Failed to load feed";
+    requestUpdate();
     return;
   }
 
-  entries = parser.getEntries();
   selectorIndex = 0;
 
   if (entries.empty()) {
     state = BrowserState::ERROR;
     errorMessage = "No entries found";
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
   state = BrowserState::BROWSING;
-  updateRequired = true;
+  requestUpdate();
+}
+
+bool OpdsBookBrowserActivity::loadFeedPage(const std::string& path, std::vector<OpdsEntry>& pageEntries,
+                                           std::string& nextPath) {
+  const std::string url = UrlUtils::buildUrl(SETTINGS.opdsServerUrl, path);
+  Serial.printf("[%lu] [OPDS] Fetching: %s\n", millis(), url.c_str());
+
+  // Revalidate a cached copy instead of downloading it again
+  HttpDownloader::CacheValidators validators;
+  const bool cached = feedCache.loadValidators(url, validators);
+
+  // Parse the feed as it streams in so the XML is never held in memory
+  OpdsParser parser;
+  if (!parser.begin()) {
+    return false;
+  }
+  const auto result = HttpDownloader::streamUrl(
+      url,
+      [this, &parser](const char* data, const size_t length) {
+        return !nextPageCancelled && parser.feed(data, length);
+      },
+      &validators);
+  if (nextPageCancelled) {
+    Serial.printf("[%lu] [OPDS] Fetch cancelled\n", millis());
+    return false;
+  }
+
+  if (result == HttpDownloader::OK && parser.finish()) {
+    pageEntries = parser.takeEntries();
+    nextPath = parser.getNextUrl();
+    feedCache.store(url, validators, pageEntries, nextPath);
+  } else if (cached && feedCache.loadEntries(url, pageEntries, nextPath)) {
+    // Not modified, or the server is unreachable: fall back to the cached copy
+    if (result != HttpDownloader::NOT_MODIFIED) {
+      Serial.printf("[%lu] [OPDS] Fetch failed (%d), showing cached feed\n", millis(), result);
+    }
+  } else {
+    return false;
+  }
+
+  // The next link is relative to this page, not to the server URL
+  if (!nextPath.empty()) {
+    nextPath = UrlUtils::resolveUrl(url, nextPath);
+  }
+  return true;
+}
+
+// Display worker: appends the next page of the feed and moves the selection onto it. loop() leaves nextPagePath and
+// the feed cache alone while nextPageLoading is set, so the fetch runs without the rendering mutex and only appending
+// the entries takes it.
+void OpdsBookBrowserActivity::loadNextPage() {
+  std::vector<OpdsEntry> pageEntries;
+  std::string nextPath;
+  const bool loaded = loadFeedPage(nextPagePath, pageEntries, nextPath);
+
+  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  if (loaded && !pageEntries.empty()) {
+    entries.reserve(entries.size() + pageEntries.size());
+    std::move(pageEntries.begin(), pageEntries.end(), std::back_inserter(entries));
+    nextPagePath = nextPath;
+    selectorIndex = std::min(nextPageTarget, entries.size() - 1);
+  } else if (!nextPageCancelled) {
+    Serial.printf("[%lu] [OPDS] Failed to load next page, will retry\n", millis());
+    // Wrap around as if this was the last page
+    selectorIndex = nextPageTarget % entries.size();
+  }
+
+  state = BrowserState::BROWSING;
+  nextPageLoading = false;
+  xSemaphoreGive(renderingMutex);
+  requestUpdate();
 }
 
 void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
@@ -303,7 +372,7 @@ void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
   statusMessage = "Loading...";
   entries.clear();
   selectorIndex = 0;
-  updateRequired = true;
+  requestUpdate();
 
   fetchFeed(currentPath);
 }
@@ -321,7 +390,7 @@ void OpdsBookBrowserActivity::navigateBack() {
     statusMessage = "Loading...";
     entries.clear();
     selectorIndex = 0;
-    updateRequired = true;
+    requestUpdate();
 
     fetchFeed(currentPath);
   }
@@ -332,7 +401,8 @@ void OpdsBookBrowserActivity::downloadBook(const OpdsEntry& book) {
   statusMessage = book.title;
   downloadProgress = 0;
   downloadTotal = 0;
-  updateRequired = true;
+  downloadStats = {};
+  requestUpdate();
 
   // Build full download URL
   std::string downloadUrl = UrlUtils::buildUrl(SETTINGS.opdsServerUrl, book.href);
@@ -346,21 +416,23 @@ void OpdsBookBrowserActivity::downloadBook(const OpdsEntry& book) {
 
   Serial.printf("[%lu] [OPDS] Downloading: %s -> %s\n", millis(), downloadUrl.c_str(), filename.c_str());
 
-  const auto result =
-      HttpDownloader::downloadToFile(downloadUrl, filename, [this](const size_t downloaded, const size_t total) {
+  const auto result = HttpDownloader::downloadToFile(
+      downloadUrl, filename,
+      [this](const size_t downloaded, const size_t total, const HttpDownloader::DownloadStats& stats) {
         downloadProgress = downloaded;
         downloadTotal = total;
-        updateRequired = true;
+        downloadStats = stats;
+        requestUpdate();
       });
 
   if (result == HttpDownloader::OK) {
     Serial.printf("[%lu] [OPDS] Download complete: %s\n", millis(), filename.c_str());
     state = BrowserState::BROWSING;
-    updateRequired = true;
+    requestUpdate();
   } else {
     state = BrowserState::ERROR;
     errorMessage = "Download failed";
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
@@ -369,7 +441,7 @@ void OpdsBookBrowserActivity::checkAndConnectWifi() {
   if (WiFi.status() == WL_CONNECTED && WiFi.localIP() != IPAddress(0, 0, 0, 0)) {
     state = BrowserState::LOADING;
     statusMessage = "Loading...";
-    updateRequired = true;
+    requestUpdate();
     fetchFeed(currentPath);
     return;
   }
@@ -380,7 +452,7 @@ void OpdsBookBrowserActivity::checkAndConnectWifi() {
 
 void OpdsBookBrowserActivity::launchWifiSelection() {
   state = BrowserState::WIFI_SELECTION;
-  updateRequired = true;
+  requestUpdate();
 
   enterNewActivity(new WifiSelectionActivity(renderer, mappedInput,
                                              [this](const bool connected) { onWifiSelectionComplete(connected); }));
@@ -393,7 +465,7 @@ void OpdsBookBrowserActivity::onWifiSelectionComplete(const bool connected) {
     Serial.printf("[%lu] [OPDS] WiFi connected via selection, fetching feed\n", millis());
     state = BrowserState::LOADING;
     statusMessage = "Loading...";
-    updateRequired = true;
+    requestUpdate();
     fetchFeed(currentPath);
   } else {
     Serial.printf("[%lu] [OPDS] WiFi selection cancelled/failed\n", millis());
@@ -403,6 +475,6 @@ void OpdsBookBrowserActivity::onWifiSelectionComplete(const bool connected) {
     WiFi.mode(WIFI_OFF);
     state = BrowserState::ERROR;
     errorMessage = "WiFi connection failed";
-    updateRequired = true;
+    requestUpdate();
   }
 }
@@ -4,11 +4,14 @@
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <vector>
 
 #include "../ActivityWithSubactivity.h"
+#include "network/HttpDownloader.h"
+#include "network/OpdsFeedCache.h"
 
 /**
  * Activity for browsing and downloading books from an OPDS server.
@@ -35,30 +38,37 @@ class OpdsBookBrowserActivity final : public ActivityWithSubactivity {
   void loop() override;
 
  private:
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
 
   BrowserState state = BrowserState::LOADING;
   std::vector<OpdsEntry> entries;
   std::vector<std::string> navigationHistory;  // Stack of previous feed paths for back navigation
   std::string currentPath;                     // Current feed path being displayed
+  std::string nextPagePath;                    // rel="next" URL of the last loaded page, empty on the last page
+  OpdsFeedCache feedCache{"/.crosspoint/opds"};
   int selectorIndex = 0;
   std::string errorMessage;
   std::string statusMessage;
   size_t downloadProgress = 0;
   size_t downloadTotal = 0;
+  HttpDownloader::DownloadStats downloadStats;
+  // The next page of a paginated feed is fetched by the display worker behind the loading screen, Back cancels it.
+  // The selection moves to nextPageTarget once it arrived.
+  std::atomic<bool> nextPageLoading{false};
+  std::atomic<bool> nextPageCancelled{false};
+  size_t nextPageTarget = 0;
 
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void render() const;
 
   void checkAndConnectWifi();
   void launchWifiSelection();
   void onWifiSelectionComplete(bool connected);
   void fetchFeed(const std::string& path);
+  bool loadFeedPage(const std::string& path, std::vector<OpdsEntry>& pageEntries, std::string& nextPath);
+  void loadNextPage();
   void navigateToEntry(const OpdsEntry& entry);
   void navigateBack();
   void downloadBook(const OpdsEntry& book);
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "Battery.h"
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
@@ -17,11 +18,6 @@
 #include "fontIds.h"
 #include "util/StringUtils.h"
 
-void HomeActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<HomeActivity*>(param);
-  self->displayTaskLoop();
-}
-
 int HomeActivity::getMenuItemCount() const {
   int count = 3;  // Browse files, File transfer, Settings
   if (hasContinueReading) count++;
@@ -89,25 +85,16 @@ void HomeActivity::onEnter() {
   selectorIndex = 0;
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&HomeActivity::taskTrampoline, "HomeActivityTask",
-              4096,               // Stack size (increased for cover image rendering)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+  cacheMaintenancePending = true;
+
+  startDisplayTask();
 }
 
 void HomeActivity::onExit() {
   Activity::onExit();
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
 
@@ -187,23 +174,25 @@ void HomeActivity::loop() {
     }
   } else if (prevPressed) {
     selectorIndex = (selectorIndex + menuCount - 1) % menuCount;
-    updateRequired = true;
+    requestUpdate();
   } else if (nextPressed) {
     selectorIndex = (selectorIndex + 1) % menuCount;
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
-void HomeActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t HomeActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
+  } else if (cacheMaintenancePending) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    cacheMaintenancePending = BOOK_CACHE.step();
+    xSemaphoreGive(renderingMutex);
   }
+  return cacheMaintenancePending ? 0 : WAIT_FOREVER;
 }
 
 void HomeActivity::render() {
@@ -8,10 +8,10 @@
 #include "../Activity.h"
 
 class HomeActivity final : public Activity {
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   int selectorIndex = 0;
-  bool updateRequired = false;
+  // Book cache maintenance runs in the display task while the menu is idle
+  bool cacheMaintenancePending = false;
   bool hasContinueReading = false;
   bool hasOpdsUrl = false;
   bool hasCoverImage = false;
@@ -27,8 +27,7 @@ class HomeActivity final : public Activity {
   const std::function<void()> onFileTransferOpen;
   const std::function<void()> onOpdsBrowserOpen;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void render();
   int getMenuItemCount() const;
   bool storeCoverBuffer();    // Store frame buffer for cover image
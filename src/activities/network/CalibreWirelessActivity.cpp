@@ -5,6 +5,8 @@
 #include <SDCardManager.h>
 #include <WiFi.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 
 #include "MappedInputManager.h"
@@ -17,11 +19,6 @@ constexpr uint16_t UDP_PORTS[] = {54982, 48123, 39001, 44044, 59678};
 constexpr uint16_t LOCAL_UDP_PORT = 8134;  // Port to receive responses
 }  // namespace
 
-void CalibreWirelessActivity::displayTaskTrampoline(void* param) {
-  auto* self = static_cast<CalibreWirelessActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void CalibreWirelessActivity::networkTaskTrampoline(void* param) {
   auto* self = static_cast<CalibreWirelessActivity*>(param);
   self->networkTaskLoop();
@@ -44,15 +41,25 @@ void CalibreWirelessActivity::onEnter() {
   currentFileSize = 0;
   bytesReceived = 0;
   inBinaryMode = false;
-  recvBuffer.clear();
+  rxStart = 0;
+  rxEnd = 0;
+  scanner.reset();
 
-  updateRequired = true;
+  rxCapacity = RX_BUFFER_SIZE;
+  rxBuffer = static_cast<uint8_t*>(malloc(rxCapacity));
+  if (!rxBuffer) {
+    rxCapacity = RX_BUFFER_MIN_SIZE;
+    rxBuffer = static_cast<uint8_t*>(malloc(rxCapacity));
+  }
+  Serial.printf("[%lu] [CAL] Receive buffer: %zu bytes\n", millis(), rxBuffer ? rxCapacity : 0);
+
+  requestUpdate();
 
   // Start UDP listener for Calibre responses
   udp.begin(LOCAL_UDP_PORT);
 
-  // Create display task
-  xTaskCreate(&CalibreWirelessActivity::displayTaskTrampoline, "CalDisplayTask", 2048, this, 1, &displayTaskHandle);
+  // Render from the display worker
+  startDisplayTask();
 
   // Create network task with larger stack for JSON parsing
   xTaskCreate(&CalibreWirelessActivity::networkTaskTrampoline, "CalNetworkTask", 12288, this, 2, &networkTaskHandle);
@@ -85,17 +92,16 @@ void CalibreWirelessActivity::onExit() {
   }
   xSemaphoreGive(stateMutex);
 
-  // Acquire renderingMutex before deleting display task
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
 
   vSemaphoreDelete(stateMutex);
   stateMutex = nullptr;
+
+  free(rxBuffer);
+  rxBuffer = nullptr;
+  rxCapacity = 0;
 }
 
 void CalibreWirelessActivity::loop() {
@@ -105,16 +111,14 @@ void CalibreWirelessActivity::loop() {
   }
 }
 
-void CalibreWirelessActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(50 / portTICK_PERIOD_MS);
+uint32_t CalibreWirelessActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
   }
+  return WAIT_FOREVER;
 }
 
 void CalibreWirelessActivity::networkTaskLoop() {
@@ -123,6 +127,11 @@ void CalibreWirelessActivity::networkTaskLoop() {
     const auto currentState = state;
     xSemaphoreGive(stateMutex);
 
+    if (!rxBuffer && currentState != WirelessState::ERROR) {
+      setError("Out of memory");
+      continue;
+    }
+
     switch (currentState) {
       case WirelessState::DISCOVERING:
         listenForDiscovery();
@@ -267,129 +276,44 @@ void CalibreWirelessActivity::handleTcpClient() {
     return;
   }
 
-  std::string message;
-  if (readJsonMessage(message)) {
-    // Parse opcode from JSON array format: [opcode, {...}]
-    // Find the opcode (first number after '[')
-    size_t start = message.find('[');
-    if (start != std::string::npos) {
-      start++;
-      size_t end = message.find(',', start);
-      if (end != std::string::npos) {
-        const int opcodeInt = std::stoi(message.substr(start, end - start));
-        if (opcodeInt < 0 || opcodeInt >= OpCode::ERROR) {
-          Serial.printf("[%lu] [CAL] Invalid opcode: %d\n", millis(), opcodeInt);
-          sendJsonResponse(OpCode::OK, "{}");
-          return;
-        }
-        const auto opcode = static_cast<OpCode>(opcodeInt);
-
-        // Extract data object (everything after the comma until the last ']')
-        size_t dataStart = end + 1;
-        size_t dataEnd = message.rfind(']');
-        std::string data = "";
-        if (dataEnd != std::string::npos && dataEnd > dataStart) {
-          data = message.substr(dataStart, dataEnd - dataStart);
-        }
-
-        handleCommand(opcode, data);
-      }
-    }
-  }
-}
-
-bool CalibreWirelessActivity::readJsonMessage(std::string& message) {
-  // Read available data into buffer
-  int available = tcpClient.available();
-  if (available > 0) {
-    // Limit buffer growth to prevent memory issues
-    if (recvBuffer.size() > 100000) {
-      recvBuffer.clear();
-      return false;
-    }
-    // Read in chunks
-    char buf[1024];
-    while (available > 0) {
-      int toRead = std::min(available, static_cast<int>(sizeof(buf)));
-      int bytesRead = tcpClient.read(reinterpret_cast<uint8_t*>(buf), toRead);
-      if (bytesRead > 0) {
-        recvBuffer.append(buf, bytesRead);
-        available -= bytesRead;
-      } else {
-        break;
-      }
-    }
+  // The scanner consumes everything it is fed, so outside binary mode the buffer is always empty here
+  // unless a message followed the last book in the same read
+  if (rxStart == rxEnd) {
+    rxStart = 0;
+    rxEnd = 0;
   }
+  readIntoRxBuffer(rxCapacity - rxEnd);
 
-  if (recvBuffer.empty()) {
-    return false;
-  }
-
-  // Find '[' which marks the start of JSON
-  size_t bracketPos = recvBuffer.find('[');
-  if (bracketPos == std::string::npos) {
-    // No '[' found - if buffer is getting large, something is wrong
-    if (recvBuffer.size() > 1000) {
-      recvBuffer.clear();
-    }
-    return false;
-  }
-
-  // Try to extract length from digits before '['
-  // Calibre ALWAYS sends a length prefix, so if it's not valid digits, it's garbage
-  size_t msgLen = 0;
-  bool validPrefix = false;
-
-  if (bracketPos > 0 && bracketPos <= 12) {
-    // Check if prefix is all digits
-    bool allDigits = true;
-    for (size_t i = 0; i < bracketPos; i++) {
-      char c = recvBuffer[i];
-      if (c < '0' || c > '9') {
-        allDigits = false;
-        break;
-      }
-    }
-    if (allDigits) {
-      msgLen = std::stoul(recvBuffer.substr(0, bracketPos));
-      validPrefix = true;
+  while (rxStart < rxEnd && !inBinaryMode) {
+    rxStart += scanner.feed(rxBuffer + rxStart, rxEnd - rxStart);
+    if (!scanner.isComplete()) {
+      break;
     }
-  }
 
-  if (!validPrefix) {
-    // Not a valid length prefix - discard everything up to '[' and treat '[' as start
-    if (bracketPos > 0) {
-      recvBuffer = recvBuffer.substr(bracketPos);
+    const auto& message = scanner.getMessage();
+    if (message.opcode < 0 || message.opcode >= OpCode::ERROR) {
+      Serial.printf("[%lu] [CAL] Invalid opcode: %d\n", millis(), message.opcode);
+      sendJsonResponse(OpCode::OK, "{}");
+    } else {
+      handleCommand(static_cast<OpCode>(message.opcode), message);
     }
-    // Without length prefix, we can't reliably parse - wait for more data
-    // that hopefully starts with a proper length prefix
-    return false;
-  }
-
-  // Sanity check the message length
-  if (msgLen > 1000000) {
-    recvBuffer = recvBuffer.substr(bracketPos + 1);  // Skip past this '[' and try again
-    return false;
+    scanner.reset();
   }
+}
 
-  // Check if we have the complete message
-  size_t totalNeeded = bracketPos + msgLen;
-  if (recvBuffer.size() < totalNeeded) {
-    // Not enough data yet - wait for more
-    return false;
+size_t CalibreWirelessActivity::readIntoRxBuffer(const size_t maxBytes) {
+  const int available = tcpClient.available();
+  if (available <= 0 || maxBytes == 0) {
+    return 0;
   }
 
-  // Extract the message
-  message = recvBuffer.substr(bracketPos, msgLen);
-
-  // Keep the rest in buffer (may contain binary data or next message)
-  if (recvBuffer.size() > totalNeeded) {
-    recvBuffer = recvBuffer.substr(totalNeeded);
-  } else {
-    recvBuffer.clear();
+  const size_t toRead = std::min(static_cast<size_t>(available), maxBytes);
+  const int bytesRead = tcpClient.read(rxBuffer + rxEnd, toRead);
+  if (bytesRead <= 0) {
+    return 0;
   }
-
-  return true;
+  rxEnd += bytesRead;
+  return bytesRead;
 }
 
 void CalibreWirelessActivity::sendJsonResponse(const OpCode opcode, const std::string& data) {
@@ -402,10 +326,10 @@ void CalibreWirelessActivity::sendJsonResponse(const OpCode opcode, const std::s
   tcpClient.flush();
 }
 
-void CalibreWirelessActivity::handleCommand(const OpCode opcode, const std::string& data) {
+void CalibreWirelessActivity::handleCommand(const OpCode opcode, const CalibreMessageScanner::Message& message) {
   switch (opcode) {
     case OpCode::GET_INITIALIZATION_INFO:
-      handleGetInitializationInfo(data);
+      handleGetInitializationInfo();
       break;
     case OpCode::GET_DEVICE_INFORMATION:
       handleGetDeviceInformation();
@@ -417,16 +341,16 @@ void CalibreWirelessActivity::handleCommand(const OpCode opcode, const std::stri
       handleGetBookCount();
       break;
     case OpCode::SEND_BOOK:
-      handleSendBook(data);
+      handleSendBook(message);
       break;
     case OpCode::SEND_BOOK_METADATA:
-      handleSendBookMetadata(data);
+      handleSendBookMetadata();
       break;
     case OpCode::DISPLAY_MESSAGE:
-      handleDisplayMessage(data);
+      handleDisplayMessage(message);
       break;
     case OpCode::NOOP:
-      handleNoop(data);
+      handleNoop(message);
       break;
     case OpCode::SET_CALIBRE_DEVICE_INFO:
     case OpCode::SET_CALIBRE_DEVICE_NAME:
@@ -453,7 +377,7 @@ void CalibreWirelessActivity::handleCommand(const OpCode opcode, const std::stri
   }
 }
 
-void CalibreWirelessActivity::handleGetInitializationInfo(const std::string& data) {
+void CalibreWirelessActivity::handleGetInitializationInfo() {
   setState(WirelessState::WAITING);
   setStatus("Connected to " + calibreHostname +
             "\nWaiting for transfer...\n\nIf transfer fails, enable\n'Ignore free space' in Calibre's\nSmartDevice "
@@ -515,58 +439,11 @@ void CalibreWirelessActivity::handleGetBookCount() {
   sendJsonResponse(OpCode::OK, response);
 }
 
-void CalibreWirelessActivity::handleSendBook(const std::string& data) {
-  // Manually extract lpath and length from SEND_BOOK data
-  // Full JSON parsing crashes on large metadata, so we just extract what we need
-
-  // Extract "lpath" field - format: "lpath": "value"
-  std::string lpath;
-  size_t lpathPos = data.find("\"lpath\"");
-  if (lpathPos != std::string::npos) {
-    size_t colonPos = data.find(':', lpathPos + 7);
-    if (colonPos != std::string::npos) {
-      size_t quoteStart = data.find('"', colonPos + 1);
-      if (quoteStart != std::string::npos) {
-        size_t quoteEnd = data.find('"', quoteStart + 1);
-        if (quoteEnd != std::string::npos) {
-          lpath = data.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-        }
-      }
-    }
-  }
-
-  // Extract top-level "length" field - must track depth to skip nested objects
-  // The metadata contains nested "length" fields (e.g., cover image length)
-  size_t length = 0;
-  int depth = 0;
-  for (size_t i = 0; i < data.size(); i++) {
-    char c = data[i];
-    if (c == '{' || c == '[') {
-      depth++;
-    } else if (c == '}' || c == ']') {
-      depth--;
-    } else if (depth == 1 && c == '"') {
-      // At top level, check if this is "length"
-      if (i + 9 < data.size() && data.substr(i, 8) == "\"length\"") {
-        // Found top-level "length" - extract the number after ':'
-        size_t colonPos = data.find(':', i + 8);
-        if (colonPos != std::string::npos) {
-          size_t numStart = colonPos + 1;
-          while (numStart < data.size() && (data[numStart] == ' ' || data[numStart] == '\t')) {
-            numStart++;
-          }
-          size_t numEnd = numStart;
-          while (numEnd < data.size() && data[numEnd] >= '0' && data[numEnd] <= '9') {
-            numEnd++;
-          }
-          if (numEnd > numStart) {
-            length = std::stoul(data.substr(numStart, numEnd - numStart));
-            break;
-          }
-        }
-      }
-    }
-  }
+void CalibreWirelessActivity::handleSendBook(const CalibreMessageScanner::Message& message) {
+  // lpath and the top-level length were picked out by the scanner; the (possibly huge) metadata
+  // object was skipped without being buffered
+  const std::string& lpath = message.lpath;
+  const size_t length = message.length;
 
   if (lpath.empty() || length == 0) {
     sendJsonResponse(OpCode::ERROR, "{\"message\":\"Invalid book data\"}");
@@ -604,35 +481,36 @@ void CalibreWirelessActivity::handleSendBook(const std::string& data) {
   // Switch to binary mode
   inBinaryMode = true;
   binaryBytesRemaining = length;
+  transferStartMs = millis();
+  sdWrites = 0;
 
-  // Check if recvBuffer has leftover data (binary file data that arrived with the JSON)
-  if (!recvBuffer.empty()) {
-    size_t toWrite = std::min(recvBuffer.size(), binaryBytesRemaining);
-    size_t written = currentFile.write(reinterpret_cast<const uint8_t*>(recvBuffer.data()), toWrite);
-    bytesReceived += written;
-    binaryBytesRemaining -= written;
-    recvBuffer = recvBuffer.substr(toWrite);
-    updateRequired = true;
+  // Book data that arrived with the JSON follows the message in the receive buffer. Move it to the
+  // front so every SD write is a full buffer starting at a buffer-aligned file offset.
+  const size_t leftover = rxEnd - rxStart;
+  if (leftover > 0 && rxStart > 0) {
+    memmove(rxBuffer, rxBuffer + rxStart, leftover);
   }
+  rxStart = 0;
+  rxEnd = leftover;
 }
 
-void CalibreWirelessActivity::handleSendBookMetadata(const std::string& data) {
+void CalibreWirelessActivity::handleSendBookMetadata() {
   // We receive metadata after the book - just acknowledge
   sendJsonResponse(OpCode::OK, "{}");
 }
 
-void CalibreWirelessActivity::handleDisplayMessage(const std::string& data) {
+void CalibreWirelessActivity::handleDisplayMessage(const CalibreMessageScanner::Message& message) {
   // Calibre may send messages to display
   // Check messageKind - 1 means password error
-  if (data.find("\"messageKind\":1") != std::string::npos) {
+  if (message.messageKind == 1) {
     setError("Password required");
   }
   sendJsonResponse(OpCode::OK, "{}");
 }
 
-void CalibreWirelessActivity::handleNoop(const std::string& data) {
+void CalibreWirelessActivity::handleNoop(const CalibreMessageScanner::Message& message) {
   // Check for ejecting flag
-  if (data.find("\"ejecting\":true") != std::string::npos) {
+  if (message.ejecting) {
     setState(WirelessState::DISCONNECTED);
     setStatus("Calibre disconnected");
   }
@@ -640,40 +518,90 @@ void CalibreWirelessActivity::handleNoop(const std::string& data) {
 }
 
 void CalibreWirelessActivity::receiveBinaryData() {
-  const int available = tcpClient.available();
-  if (available == 0) {
+  // Drain the socket into the buffer, but never past the end of the book so a following message
+  // stays in the socket (or at the end of the buffer) for the JSON path
+  bool gotData = false;
+  while (rxEnd < rxCapacity && rxEnd < binaryBytesRemaining) {
+    const size_t wanted = std::min(rxCapacity - rxEnd, binaryBytesRemaining - rxEnd);
+    if (readIntoRxBuffer(wanted) == 0) {
+      break;
+    }
+    gotData = true;
+  }
+
+  if (!gotData && rxEnd < binaryBytesRemaining && rxEnd < rxCapacity) {
     // Check if connection is still alive
     if (!tcpClient.connected()) {
       currentFile.close();
       inBinaryMode = false;
+      rxStart = 0;
+      rxEnd = 0;
       setError("Transfer interrupted");
     }
     return;
   }
 
-  uint8_t buffer[1024];
-  const size_t toRead = std::min(sizeof(buffer), binaryBytesRemaining);
-  const size_t bytesRead = tcpClient.read(buffer, toRead);
+  bytesReceived = currentFileSize - binaryBytesRemaining + std::min(rxEnd, binaryBytesRemaining);
+  requestUpdate();
 
-  if (bytesRead > 0) {
-    currentFile.write(buffer, bytesRead);
-    bytesReceived += bytesRead;
-    binaryBytesRemaining -= bytesRead;
-    updateRequired = true;
+  // Only write full buffers; the tail of the book is the one partial write
+  if (rxEnd < rxCapacity && rxEnd < binaryBytesRemaining) {
+    return;
+  }
 
-    if (binaryBytesRemaining == 0) {
-      // Transfer complete
-      currentFile.flush();
-      currentFile.close();
-      inBinaryMode = false;
+  if (!flushBinaryData()) {
+    currentFile.close();
+    inBinaryMode = false;
+    rxStart = 0;
+    rxEnd = 0;
+    setError("Failed to write file");
+    sendJsonResponse(OpCode::ERROR, "{\"message\":\"Failed to write file\"}");
+    return;
+  }
 
-      setState(WirelessState::WAITING);
-      setStatus("Received: " + currentFilename + "\nWaiting for more...");
+  if (binaryBytesRemaining == 0) {
+    finishBinaryTransfer();
+  }
+}
 
-      // Send OK to acknowledge completion
-      sendJsonResponse(OpCode::OK, "{}");
-    }
+bool CalibreWirelessActivity::flushBinaryData() {
+  const size_t toWrite = std::min(rxEnd, binaryBytesRemaining);
+  if (toWrite == 0) {
+    return true;
+  }
+
+  const size_t written = currentFile.write(rxBuffer, toWrite);
+  sdWrites++;
+  if (written != toWrite) {
+    Serial.printf("[%lu] [CAL] SD write failed: %zu of %zu bytes\n", millis(), written, toWrite);
+    return false;
   }
+  binaryBytesRemaining -= toWrite;
+
+  // Anything past the end of the book is the start of the next message
+  rxStart = toWrite;
+  if (rxStart == rxEnd) {
+    rxStart = 0;
+    rxEnd = 0;
+  }
+  return true;
+}
+
+void CalibreWirelessActivity::finishBinaryTransfer() {
+  currentFile.flush();
+  currentFile.close();
+  inBinaryMode = false;
+
+  const unsigned long elapsedMs = std::max(millis() - transferStartMs, 1UL);
+  Serial.printf("[%lu] [CAL] Received %s: %zu bytes in %lu ms (%.2f MB/s, %zu SD writes of up to %zu bytes)\n",
+                millis(), currentFilename.c_str(), currentFileSize, elapsedMs,
+                static_cast<float>(currentFileSize) / 1048.576f / static_cast<float>(elapsedMs), sdWrites, rxCapacity);
+
+  setState(WirelessState::WAITING);
+  setStatus("Received: " + currentFilename + "\nWaiting for more...");
+
+  // Send OK to acknowledge completion
+  sendJsonResponse(OpCode::OK, "{}");
 }
 
 void CalibreWirelessActivity::render() const {
@@ -742,12 +670,12 @@ void CalibreWirelessActivity::setState(WirelessState newState) {
   xSemaphoreTake(stateMutex, portMAX_DELAY);
   state = newState;
   xSemaphoreGive(stateMutex);
-  updateRequired = true;
+  requestUpdate();
 }
 
 void CalibreWirelessActivity::setStatus(const std::string& message) {
   statusMessage = message;
-  updateRequired = true;
+  requestUpdate();
 }
 
 void CalibreWirelessActivity::setError(const std::string& message) {
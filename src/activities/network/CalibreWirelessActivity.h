@@ -10,6 +10,7 @@
 #include <string>
 
 #include "activities/Activity.h"
+#include "network/CalibreMessageScanner.h"
 
 /**
  * CalibreWirelessActivity implements Calibre's "wireless device" protocol.
@@ -61,11 +62,9 @@ class CalibreWirelessActivity final : public Activity {
     ERROR = 20,
   };
 
-  TaskHandle_t displayTaskHandle = nullptr;
   TaskHandle_t networkTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   SemaphoreHandle_t stateMutex = nullptr;
-  bool updateRequired = false;
 
   WirelessState state = WirelessState::DISCOVERING;
   const std::function<void()> onComplete;
@@ -91,31 +90,43 @@ class CalibreWirelessActivity final : public Activity {
   bool inBinaryMode = false;
   size_t binaryBytesRemaining = 0;
   FsFile currentFile;
-  std::string recvBuffer;  // Buffer for incoming data (like KOReader)
+  unsigned long transferStartMs = 0;
+  size_t sdWrites = 0;
+
+  // Fixed receive buffer: JSON is scanned in place from [rxStart, rxEnd), book data is coalesced here
+  // into full-buffer SD writes. Allocated on enter so it doesn't live on the network task stack.
+  static constexpr size_t RX_BUFFER_SIZE = 32768;
+  static constexpr size_t RX_BUFFER_MIN_SIZE = 8192;
+  uint8_t* rxBuffer = nullptr;
+  size_t rxCapacity = 0;
+  size_t rxStart = 0;
+  size_t rxEnd = 0;
+  CalibreMessageScanner scanner;
 
-  static void displayTaskTrampoline(void* param);
   static void networkTaskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   [[noreturn]] void networkTaskLoop();
   void render() const;
 
   // Network operations
   void listenForDiscovery();
   void handleTcpClient();
-  bool readJsonMessage(std::string& message);
+  size_t readIntoRxBuffer(size_t maxBytes);
   void sendJsonResponse(OpCode opcode, const std::string& data);
-  void handleCommand(OpCode opcode, const std::string& data);
+  void handleCommand(OpCode opcode, const CalibreMessageScanner::Message& message);
   void receiveBinaryData();
+  bool flushBinaryData();
+  void finishBinaryTransfer();
 
   // Protocol handlers
-  void handleGetInitializationInfo(const std::string& data);
+  void handleGetInitializationInfo();
   void handleGetDeviceInformation();
   void handleFreeSpace();
   void handleGetBookCount();
-  void handleSendBook(const std::string& data);
-  void handleSendBookMetadata(const std::string& data);
-  void handleDisplayMessage(const std::string& data);
-  void handleNoop(const std::string& data);
+  void handleSendBook(const CalibreMessageScanner::Message& message);
+  void handleSendBookMetadata();
+  void handleDisplayMessage(const CalibreMessageScanner::Message& message);
+  void handleNoop(const CalibreMessageScanner::Message& message);
 
   // Utility
   std::string getDeviceUuid() const;
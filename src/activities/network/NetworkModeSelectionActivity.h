@@ -19,15 +19,12 @@ enum class NetworkMode { JOIN_NETWORK, CREATE_HOTSPOT };
  * The onCancel callback is called if the user presses back.
  */
 class NetworkModeSelectionActivity final : public Activity {
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   int selectedIndex = 0;
-  bool updateRequired = false;
   const std::function<void(NetworkMode)> onModeSelected;
   const std::function<void()> onCancel;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void render() const;
 
  public:
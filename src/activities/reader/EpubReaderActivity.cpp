@@ -3,8 +3,10 @@
 #include <Epub/Page.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
-#include <SDCardManager.h>
 
+#include <algorithm>
+
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "EpubReaderChapterSelectionActivity.h"
@@ -19,11 +21,6 @@ constexpr unsigned long goHomeMs = 1000;
 constexpr int statusBarMargin = 19;
 }  // namespace
 
-void EpubReaderActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<EpubReaderActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void EpubReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -53,15 +50,11 @@ void EpubReaderActivity::onEnter() {
 
   epub->setupCacheDir();
 
-  FsFile f;
-  if (SdMan.openFileForRead("ERS", epub->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    if (f.read(data, 4) == 4) {
-      currentSpineIndex = data[0] + (data[1] << 8);
-      nextPageNumber = data[2] + (data[3] << 8);
-      Serial.printf("[%lu] [ERS] Loaded cache: %d, %d\n", millis(), currentSpineIndex, nextPageNumber);
-    }
-    f.close();
+  uint8_t data[ProgressJournal::DATA_SIZE];
+  if (progress.begin(epub->getCachePath(), data)) {
+    currentSpineIndex = data[0] + (data[1] << 8);
+    nextPageNumber = data[2] + (data[3] << 8);
+    Serial.printf("[%lu] [ERS] Loaded cache: %d, %d\n", millis(), currentSpineIndex, nextPageNumber);
   }
   // We may want a better condition to detect if we are opening for the first time.
   // This will trigger if the book is re-opened at Chapter 0.
@@ -79,30 +72,35 @@ void EpubReaderActivity::onEnter() {
   APP_STATE.saveToFile();
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&EpubReaderActivity::taskTrampoline, "EpubReaderActivityTask",
-              8192,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+  cacheMaintenancePending = true;
+
+  startDisplayTask();
 }
 
 void EpubReaderActivity::onExit() {
+  // Closes an open chapter selection, see displayStep
+  lockRendering();
   ActivityWithSubactivity::onExit();
+  xSemaphoreGive(renderingMutex);
 
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  // Wait for the display worker to finish a step of this activity. A section build in progress stops at its next
+  // block boundary and continues from there when the chapter is opened again.
+  stopIndexing = true;
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
+  refreshScheduler.logSummary();
+  if (firstPageCount > 0) {
+    Serial.printf("[%lu] [ERS] Time to first page: %u chapters, %ums on average, %ums at most\n", millis(),
+                  static_cast<unsigned>(firstPageCount), static_cast<unsigned>(firstPageTotalMs / firstPageCount),
+                  static_cast<unsigned>(firstPageMaxMs));
+  }
+  // Also runs before going to sleep
+  progress.flush();
   section.reset();
   epub.reset();
 }
@@ -117,22 +115,27 @@ void EpubReaderActivity::loop() {
   // Enter chapter selection activity
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
     // Don't start activity transition while rendering
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    lockRendering();
     exitActivity();
     enterNewActivity(new EpubReaderChapterSelectionActivity(
         this->renderer, this->mappedInput, epub, currentSpineIndex,
         [this] {
+          lockRendering();
           exitActivity();
-          updateRequired = true;
+          xSemaphoreGive(renderingMutex);
+          requestUpdate();
         },
         [this](const int newSpineIndex) {
+          lockRendering();
           if (currentSpineIndex != newSpineIndex) {
             currentSpineIndex = newSpineIndex;
             nextPageNumber = 0;
             section.reset();
+            pendingPageTurns = 0;
           }
           exitActivity();
-          updateRequired = true;
+          xSemaphoreGive(renderingMutex);
+          requestUpdate();
         }));
     xSemaphoreGive(renderingMutex);
   }
@@ -164,7 +167,7 @@ void EpubReaderActivity::loop() {
   if (currentSpineIndex > 0 && currentSpineIndex >= epub->getSpineItemsCount()) {
     currentSpineIndex = epub->getSpineItemsCount() - 1;
     nextPageNumber = UINT16_MAX;
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -172,58 +175,158 @@ void EpubReaderActivity::loop() {
 
   if (skipChapter) {
     // We don't want to delete the section mid-render, so grab the semaphore
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    lockRendering();
     nextPageNumber = 0;
     currentSpineIndex = nextReleased ? currentSpineIndex + 1 : currentSpineIndex - 1;
     section.reset();
+    pendingPageTurns = 0;
     xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
-  // No current section, attempt to rerender the book
-  if (!section) {
-    updateRequired = true;
-    return;
+  // The display worker makes the turn when it shows the page, a chapter that is still being laid out keeps going
+  pendingPageTurns += nextReleased ? 1 : -1;
+  requestUpdate();
+}
+
+void EpubReaderActivity::lockRendering() {
+  yieldIndexing = true;
+  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  yieldIndexing = false;
+}
+
+uint32_t EpubReaderActivity::displayStep() {
+  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  // The chapter selection reads the book from the main task, and SdFat must not be used by two tasks at once. It is
+  // entered and left holding the rendering mutex, so the background work waits here for the step that redraws the
+  // page once it is closed.
+  if (subActivity) {
+    xSemaphoreGive(renderingMutex);
+    return WAIT_FOREVER;
+  }
+  if (updateRequired) {
+    updateRequired = false;
+    applyPageTurns(true);
+    renderScreen();
+  } else if (indexingPending) {
+    continueIndexing();
+  } else if (progress.isFlushDue()) {
+    progress.flush();
+  } else if (cacheMaintenancePending) {
+    cacheMaintenancePending = BOOK_CACHE.step();
   }
+  xSemaphoreGive(renderingMutex);
+  return indexingPending || cacheMaintenancePending ? 0 : progress.msUntilFlushDue();
+}
 
-  if (prevReleased) {
-    if (section->currentPage > 0) {
-      section->currentPage--;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      nextPageNumber = UINT16_MAX;
-      currentSpineIndex--;
-      section.reset();
-      xSemaphoreGive(renderingMutex);
-    }
-    updateRequired = true;
-  } else {
-    if (section->currentPage < section->pageCount - 1) {
-      section->currentPage++;
+void EpubReaderActivity::getContentMargins(int* top, int* right, int* bottom, int* left) const {
+  // Apply screen viewable areas and additional padding
+  renderer.getOrientedViewableTRBL(top, right, bottom, left);
+  *top += SETTINGS.screenMargin;
+  *left += SETTINGS.screenMargin;
+  *right += SETTINGS.screenMargin;
+  *bottom += statusBarMargin;
+}
+
+bool EpubReaderActivity::buildSection(const std::function<bool()>& shouldStop,
+                                      const std::function<void()>& progressSetupFn,
+                                      const std::function<void(int)>& progressFn) {
+  int marginTop, marginRight, marginBottom, marginLeft;
+  getContentMargins(&marginTop, &marginRight, &marginBottom, &marginLeft);
+  const uint16_t viewportWidth = renderer.getScreenWidth() - marginLeft - marginRight;
+  const uint16_t viewportHeight = renderer.getScreenHeight() - marginTop - marginBottom;
+
+  return section->createSectionFile(
+      SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(), SETTINGS.extraParagraphSpacing,
+      SETTINGS.paragraphAlignment, SETTINGS.hyphenation, viewportWidth, viewportHeight, progressSetupFn, progressFn,
+      [this, &shouldStop] { return stopIndexing.load() || yieldIndexing.load() || shouldStop(); });
+}
+
+// Makes the page turns queued by loop(). Without leaveChapter a turn onto another chapter stays queued and false is
+// returned.
+bool EpubReaderActivity::applyPageTurns(const bool leaveChapter) {
+  int turns = pendingPageTurns.exchange(0);
+  // No current section, the book is rendered again without turning
+  while (turns != 0 && section) {
+    const bool forward = turns > 0;
+    // While the chapter is still being laid out, the page after the ones counted so far can be turned to
+    const bool inChapter = forward ? section->currentPage < section->pageCount - (section->isComplete() ? 1 : 0)
+                                   : section->currentPage > 0;
+    if (inChapter) {
+      section->currentPage += forward ? 1 : -1;
+      turns += forward ? -1 : 1;
+    } else if (forward && !section->isComplete()) {
+      // Waiting for the next page to be laid out. Outside of a build renderScreen lays it out and drops the others.
+      if (!leaveChapter) {
+        pendingPageTurns += turns;
+      }
+      break;
+    } else if (!leaveChapter) {
+      pendingPageTurns += turns;
+      return false;
     } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      nextPageNumber = 0;
-      currentSpineIndex++;
+      // Further turns are dropped, the other chapter is opened first
+      nextPageNumber = forward ? 0 : UINT16_MAX;
+      currentSpineIndex += forward ? 1 : -1;
       section.reset();
-      xSemaphoreGive(renderingMutex);
+      break;
     }
+  }
+  return true;
+}
+
+// Polled by the background build: shows the page turned to once it is laid out. False to stop the build, to leave
+// the chapter or when the page could not be loaded (renderScreen handles that once the build stopped).
+bool EpubReaderActivity::showTurnedPage() {
+  if (!updateRequired) {
+    return true;
+  }
+  if (!applyPageTurns(false)) {
+    return false;
+  }
+  if (section->currentPage >= section->pageCount) {
+    return true;
+  }
+  updateRequired = false;
+  if (!renderPage()) {
     updateRequired = true;
+    return false;
   }
+  return true;
 }
 
-void EpubReaderActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+// Lays out the rest of the shown chapter while the reader is on a page. Page turns are shown from within the build:
+// each time a stopped build continues it parses the chapter from its start, so it only stops to leave the chapter,
+// on exit, when loop() waits for the rendering mutex, or to let another activity have the display worker.
+void EpubReaderActivity::continueIndexing() {
+  indexingPending = false;
+  if (!section || section->isComplete() || stopIndexing) {
+    return;
+  }
+
+  const auto start = millis();
+  bool handedOver = false;
+  if (!buildSection([this, &handedOver] {
+        handedOver = displayStepWaiting();
+        return handedOver || !showTurnedPage();
+      })) {
+    Serial.printf("[%lu] [ERS] Failed to finish laying out chapter\n", millis());
+    // The build removed the partial section file, the chapter is built again when it is next shown. loop() only
+    // touches the section while holding the rendering mutex, which this step has.
+    nextPageNumber = section->currentPage;
+    section.reset();
+    return;
+  }
+
+  if (section->isComplete()) {
+    Serial.printf("[%lu] [ERS] Finished laying out chapter in the background: %d pages, %lums\n", millis(),
+                  section->pageCount, millis() - start);
+  } else if (handedOver) {
+    // Continued in the next step, after the other activity's
+    indexingPending = true;
   }
+  // Otherwise it stopped for one of the other reasons above, and renderScreen queues it again
 }
 
 // TODO: Failure handling
@@ -249,90 +352,97 @@ void EpubReaderActivity::renderScreen() {
     return;
   }
 
-  // Apply screen viewable areas and additional padding
   int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
-  renderer.getOrientedViewableTRBL(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom,
-                                   &orientedMarginLeft);
-  orientedMarginTop += SETTINGS.screenMargin;
-  orientedMarginLeft += SETTINGS.screenMargin;
-  orientedMarginRight += SETTINGS.screenMargin;
-  orientedMarginBottom += statusBarMargin;
+  getContentMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
 
   if (!section) {
     const auto filepath = epub->getSpineItem(currentSpineIndex).href;
     Serial.printf("[%lu] [ERS] Loading file: %s, index: %d\n", millis(), filepath.c_str(), currentSpineIndex);
+    sectionOpenedAt = millis();
     section = std::unique_ptr<Section>(new Section(epub, currentSpineIndex, renderer));
 
     const uint16_t viewportWidth = renderer.getScreenWidth() - orientedMarginLeft - orientedMarginRight;
     const uint16_t viewportHeight = renderer.getScreenHeight() - orientedMarginTop - orientedMarginBottom;
 
     if (!section->loadSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                  SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                  viewportHeight)) {
+                                  SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, SETTINGS.hyphenation,
+                                  viewportWidth, viewportHeight)) {
       Serial.printf("[%lu] [ERS] Cache not found, building...\n", millis());
-
-      // Progress bar dimensions
-      constexpr int barWidth = 200;
-      constexpr int barHeight = 10;
-      constexpr int boxMargin = 20;
-      const int textWidth = renderer.getTextWidth(UI_12_FONT_ID, "Indexing...");
-      const int boxWidthWithBar = (barWidth > textWidth ? barWidth : textWidth) + boxMargin * 2;
-      const int boxWidthNoBar = textWidth + boxMargin * 2;
-      const int boxHeightWithBar = renderer.getLineHeight(UI_12_FONT_ID) + barHeight + boxMargin * 3;
-      const int boxHeightNoBar = renderer.getLineHeight(UI_12_FONT_ID) + boxMargin * 2;
-      const int boxXWithBar = (renderer.getScreenWidth() - boxWidthWithBar) / 2;
-      const int boxXNoBar = (renderer.getScreenWidth() - boxWidthNoBar) / 2;
-      constexpr int boxY = 50;
-      const int barX = boxXWithBar + (boxWidthWithBar - barWidth) / 2;
-      const int barY = boxY + renderer.getLineHeight(UI_12_FONT_ID) + boxMargin * 2;
-
-      // Always show "Indexing..." text first
-      {
-        renderer.fillRect(boxXNoBar, boxY, boxWidthNoBar, boxHeightNoBar, false);
-        renderer.drawText(UI_12_FONT_ID, boxXNoBar + boxMargin, boxY + boxMargin, "Indexing...");
-        renderer.drawRect(boxXNoBar + 5, boxY + 5, boxWidthNoBar - 10, boxHeightNoBar - 10);
-        renderer.displayBuffer();
-        pagesUntilFullRefresh = 0;
-      }
-
-      // Setup callback - only called for chapters >= 50KB, redraws with progress bar
-      auto progressSetup = [this, boxXWithBar, boxWidthWithBar, boxHeightWithBar, barX, barY] {
-        renderer.fillRect(boxXWithBar, boxY, boxWidthWithBar, boxHeightWithBar, false);
-        renderer.drawText(UI_12_FONT_ID, boxXWithBar + boxMargin, boxY + boxMargin, "Indexing...");
-        renderer.drawRect(boxXWithBar + 5, boxY + 5, boxWidthWithBar - 10, boxHeightWithBar - 10);
-        renderer.drawRect(barX, barY, barWidth, barHeight);
-        renderer.displayBuffer();
-      };
-
-      // Progress callback to update progress bar
-      auto progressCallback = [this, barX, barY, barWidth, barHeight](int progress) {
-        const int fillWidth = (barWidth - 2) * progress / 100;
-        renderer.fillRect(barX + 1, barY + 1, fillWidth, barHeight - 2, true);
-        renderer.displayBuffer(EInkDisplay::FAST_REFRESH);
-      };
-
-      if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                      SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                      viewportHeight, progressSetup, progressCallback)) {
-        Serial.printf("[%lu] [ERS] Failed to persist page data to SD\n", millis());
-        section.reset();
-        return;
-      }
     } else {
       Serial.printf("[%lu] [ERS] Cache found, skipping build...\n", millis());
     }
+    // UINT16_MAX (last page) is resolved once the whole chapter is laid out
+    section->currentPage = nextPageNumber;
+  }
 
-    if (nextPageNumber == UINT16_MAX) {
-      section->currentPage = section->pageCount - 1;
-    } else {
-      section->currentPage = nextPageNumber;
+  // Lay out the chapter only as far as the page to show, the rest follows in the background (continueIndexing)
+  if (!section->isComplete() && section->currentPage >= section->pageCount) {
+    // Progress bar dimensions
+    constexpr int barWidth = 200;
+    constexpr int barHeight = 10;
+    constexpr int boxMargin = 20;
+    const int textWidth = renderer.getTextWidth(UI_12_FONT_ID, "Indexing...");
+    const int boxWidthWithBar = (barWidth > textWidth ? barWidth : textWidth) + boxMargin * 2;
+    const int boxWidthNoBar = textWidth + boxMargin * 2;
+    const int boxHeightWithBar = renderer.getLineHeight(UI_12_FONT_ID) + barHeight + boxMargin * 3;
+    const int boxHeightNoBar = renderer.getLineHeight(UI_12_FONT_ID) + boxMargin * 2;
+    const int boxXWithBar = (renderer.getScreenWidth() - boxWidthWithBar) / 2;
+    const int boxXNoBar = (renderer.getScreenWidth() - boxWidthNoBar) / 2;
+    constexpr int boxY = 50;
+    const int barX = boxXWithBar + (boxWidthWithBar - barWidth) / 2;
+    const int barY = boxY + renderer.getLineHeight(UI_12_FONT_ID) + boxMargin * 2;
+
+    // Always show "Indexing..." text first
+    {
+      renderer.fillRect(boxXNoBar, boxY, boxWidthNoBar, boxHeightNoBar, false);
+      renderer.drawText(UI_12_FONT_ID, boxXNoBar + boxMargin, boxY + boxMargin, "Indexing...");
+      renderer.drawRect(boxXNoBar + 5, boxY + 5, boxWidthNoBar - 10, boxHeightNoBar - 10);
+      renderer.displayBuffer();
+      refreshScheduler.requestRefresh();
+    }
+
+    // Setup callback - only called for chapters >= 50KB, redraws with progress bar
+    auto progressSetup = [this, boxXWithBar, boxWidthWithBar, boxHeightWithBar, barX, barY] {
+      renderer.fillRect(boxXWithBar, boxY, boxWidthWithBar, boxHeightWithBar, false);
+      renderer.drawText(UI_12_FONT_ID, boxXWithBar + boxMargin, boxY + boxMargin, "Indexing...");
+      renderer.drawRect(boxXWithBar + 5, boxY + 5, boxWidthWithBar - 10, boxHeightWithBar - 10);
+      renderer.drawRect(barX, barY, barWidth, barHeight);
+      renderer.displayBuffer();
+    };
+
+    // Progress callback to update progress bar
+    auto progressCallback = [this, barX, barY, barWidth, barHeight](int progress) {
+      const int fillWidth = (barWidth - 2) * progress / 100;
+      renderer.fillRect(barX + 1, barY + 1, fillWidth, barHeight - 2, true);
+      renderer.displayBuffer(EInkDisplay::FAST_REFRESH);
+    };
+
+    const int targetPage = section->currentPage;
+    if (!buildSection([this, targetPage] { return section->pageCount > targetPage; }, progressSetup,
+                      progressCallback)) {
+      Serial.printf("[%lu] [ERS] Failed to persist page data to SD\n", millis());
+      section.reset();
+      return;
+    }
+    // Exiting, or loop() is waiting to change the section
+    if (stopIndexing || yieldIndexing) {
+      return;
     }
   }
 
-  renderer.clearScreen();
+  if (section->currentPage == UINT16_MAX) {
+    section->currentPage = section->pageCount - 1;
+  } else if (section->isComplete() && section->pageCount > 0 && section->currentPage == section->pageCount) {
+    // Turned past the provisional last page and the chapter did end there
+    nextPageNumber = 0;
+    currentSpineIndex++;
+    section.reset();
+    return renderScreen();
+  }
 
   if (section->pageCount == 0) {
     Serial.printf("[%lu] [ERS] No pages to render\n", millis());
+    renderer.clearScreen();
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Empty chapter", true, EpdFontFamily::BOLD);
     renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
     renderer.displayBuffer();
@@ -341,35 +451,52 @@ void EpubReaderActivity::renderScreen() {
 
   if (section->currentPage < 0 || section->currentPage >= section->pageCount) {
     Serial.printf("[%lu] [ERS] Page out of bounds: %d (max %d)\n", millis(), section->currentPage, section->pageCount);
+    renderer.clearScreen();
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Out of bounds", true, EpdFontFamily::BOLD);
     renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
     renderer.displayBuffer();
     return;
   }
 
-  {
-    auto p = section->loadPageFromSectionFile();
-    if (!p) {
-      Serial.printf("[%lu] [ERS] Failed to load page from SD - clearing section cache\n", millis());
-      section->clearCache();
-      section.reset();
-      return renderScreen();
-    }
-    const auto start = millis();
-    renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-    Serial.printf("[%lu] [ERS] Rendered page in %dms\n", millis(), millis() - start);
+  if (!renderPage()) {
+    Serial.printf("[%lu] [ERS] Failed to load page from SD - clearing section cache\n", millis());
+    section->clearCache();
+    section.reset();
+    return renderScreen();
   }
+  indexingPending = !section->isComplete();
+}
 
-  FsFile f;
-  if (SdMan.openFileForWrite("ERS", epub->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    data[0] = currentSpineIndex & 0xFF;
-    data[1] = (currentSpineIndex >> 8) & 0xFF;
-    data[2] = section->currentPage & 0xFF;
-    data[3] = (section->currentPage >> 8) & 0xFF;
-    f.write(data, 4);
-    f.close();
+// Shows section->currentPage, which has to be laid out already. False if it could not be loaded.
+bool EpubReaderActivity::renderPage() {
+  auto p = section->loadPageFromSectionFile();
+  if (!p) {
+    return false;
   }
+
+  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
+  getContentMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
+  const auto start = millis();
+  renderer.clearScreen();
+  renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+  Serial.printf("[%lu] [ERS] Rendered page in %lums\n", millis(), millis() - start);
+  if (sectionOpenedAt != 0) {
+    const uint32_t firstPageMs = millis() - sectionOpenedAt;
+    Serial.printf("[%lu] [ERS] Time to first page: %ums (%d pages laid out%s)\n", millis(),
+                  static_cast<unsigned>(firstPageMs), section->pageCount, section->isComplete() ? "" : " so far");
+    firstPageCount++;
+    firstPageTotalMs += firstPageMs;
+    firstPageMaxMs = std::max(firstPageMaxMs, firstPageMs);
+    sectionOpenedAt = 0;
+  }
+
+  uint8_t data[ProgressJournal::DATA_SIZE];
+  data[0] = currentSpineIndex & 0xFF;
+  data[1] = (currentSpineIndex >> 8) & 0xFF;
+  data[2] = section->currentPage & 0xFF;
+  data[3] = (section->currentPage >> 8) & 0xFF;
+  progress.update(data);
+  return true;
 }
 
 void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int orientedMarginTop,
@@ -377,13 +504,7 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
                                         const int orientedMarginLeft) {
   page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
   renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-  if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(EInkDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-  } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
-  }
+  refreshScheduler.display(renderer, SETTINGS.getRefreshFrequency());
 
   // Save bw buffer to reset buffer state after grayscale data sync
   renderer.storeBwBuffer();
@@ -433,8 +554,9 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
     const uint8_t bookProgress = epub->calculateProgress(currentSpineIndex, sectionChapterProg);
 
     // Right aligned text for progress counter
+    // The page count is provisional while the chapter is still being laid out
     const std::string progress = std::to_string(section->currentPage + 1) + "/" + std::to_string(section->pageCount) +
-                                 "  " + std::to_string(bookProgress) + "%";
+                                 (section->isComplete() ? "" : "+") + "  " + std::to_string(bookProgress) + "%";
     progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progress.c_str());
     renderer.drawText(SMALL_FONT_ID, renderer.getScreenWidth() - orientedMarginRight - progressTextWidth, textY,
                       progress.c_str());
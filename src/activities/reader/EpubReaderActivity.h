@@ -5,23 +5,49 @@
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
+#include <atomic>
+
+#include "ProgressJournal.h"
+#include "RefreshScheduler.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class EpubReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Epub> epub;
   std::unique_ptr<Section> section = nullptr;
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   int currentSpineIndex = 0;
   int nextPageNumber = 0;
-  int pagesUntilFullRefresh = 0;
-  bool updateRequired = false;
+  RefreshScheduler refreshScheduler;
+  ProgressJournal progress;
+  // Set on exit so a chapter that is still being indexed checkpoints and stops instead of holding up the exit
+  std::atomic<bool> stopIndexing{false};
+  // Set while loop() waits for the rendering mutex, a section build pauses at its next block boundary to release it
+  std::atomic<bool> yieldIndexing{false};
+  // The shown chapter is only partly laid out, the display task continues it while idle
+  bool indexingPending = false;
+  // Book cache maintenance, run after the chapter is laid out
+  bool cacheMaintenancePending = false;
+  // Page turns from loop(), made by the display worker. Only it touches section outside of lockRendering().
+  std::atomic<int> pendingPageTurns{0};
+  // When the current section was opened, until its first page is on screen
+  unsigned long sectionOpenedAt = 0;
+  // Time to first page of the chapters opened, logged on exit
+  uint32_t firstPageCount = 0;
+  uint32_t firstPageTotalMs = 0;
+  uint32_t firstPageMaxMs = 0;
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
+  void lockRendering();
+  void getContentMargins(int* top, int* right, int* bottom, int* left) const;
+  bool buildSection(const std::function<bool()>& shouldStop, const std::function<void()>& progressSetupFn = nullptr,
+                    const std::function<void(int)>& progressFn = nullptr);
+  bool applyPageTurns(bool leaveChapter);
+  bool showTurnedPage();
+  void continueIndexing();
   void renderScreen();
+  bool renderPage();
   void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
                       int orientedMarginBottom, int orientedMarginLeft);
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
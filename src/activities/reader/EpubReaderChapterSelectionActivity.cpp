@@ -8,6 +8,9 @@
 namespace {
 // Time threshold for treating a long press as a page-up/page-down
 constexpr int SKIP_PAGE_MS = 700;
+// Holding even longer jumps to the next/previous 10% of the list
+constexpr int SKIP_PERCENT_MS = 1500;
+constexpr int SKIP_PERCENT_STEP = 10;
 }  // namespace
 
 int EpubReaderChapterSelectionActivity::getPageItems() const {
@@ -28,11 +31,6 @@ int EpubReaderChapterSelectionActivity::getPageItems() const {
   return items;
 }
 
-void EpubReaderChapterSelectionActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<EpubReaderChapterSelectionActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void EpubReaderChapterSelectionActivity::onEnter() {
   Activity::onEnter();
 
@@ -41,32 +39,34 @@ void EpubReaderChapterSelectionActivity::onEnter() {
   }
 
   renderingMutex = xSemaphoreCreateMutex();
+  toc.reset(new TocWindow(epub->getTocItemsCount(),
+                          [this](const int first, const int count, std::vector<TocWindow::Item>& items) {
+                            std::vector<BookMetadataCache::TocEntry> entries;
+                            epub->getTocItems(first, count, entries);
+                            items.clear();
+                            items.reserve(entries.size());
+                            for (auto& entry : entries) {
+                              items.push_back({std::move(entry.title), entry.level});
+                            }
+                          }));
+  toc->setPageItems(getPageItems());
   selectorIndex = epub->getTocIndexForSpineIndex(currentSpineIndex);
   if (selectorIndex == -1) {
     selectorIndex = 0;
   }
 
   // Trigger first update
-  updateRequired = true;
-  xTaskCreate(&EpubReaderChapterSelectionActivity::taskTrampoline, "EpubReaderChapterSelectionActivityTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+  startDisplayTask();
 }
 
 void EpubReaderChapterSelectionActivity::onExit() {
   Activity::onExit();
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
+  toc.reset();
 }
 
 void EpubReaderChapterSelectionActivity::loop() {
@@ -76,45 +76,76 @@ void EpubReaderChapterSelectionActivity::loop() {
                             mappedInput.wasReleased(MappedInputManager::Button::Right);
 
   const bool skipPage = mappedInput.getHeldTime() > SKIP_PAGE_MS;
+  const bool skipPercent = mappedInput.getHeldTime() > SKIP_PERCENT_MS;
   const int pageItems = getPageItems();
+  const int totalItems = epub->getTocItemsCount();
 
+  // selectorIndex is also moved by the display task, see displayStep
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
+    // The display task may be reading ahead in the book
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
     const auto newSpineIndex = epub->getSpineIndexForTocIndex(selectorIndex);
+    xSemaphoreGive(renderingMutex);
     if (newSpineIndex == -1) {
       onGoBack();
     } else {
       onSelectSpineIndex(newSpineIndex);
     }
   } else if (mappedInput.wasReleased(MappedInputManager::Button::Back)) {
+    if (skipPage) {
+      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      jumpToNextInitial = true;
+      xSemaphoreGive(renderingMutex);
+      requestUpdate();
+      return;
+    }
     onGoBack();
   } else if (prevReleased) {
-    if (skipPage) {
-      selectorIndex =
-          ((selectorIndex / pageItems - 1) * pageItems + epub->getTocItemsCount()) % epub->getTocItemsCount();
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (skipPercent) {
+      selectorIndex = toc->jumpPercent(selectorIndex, -SKIP_PERCENT_STEP);
+    } else if (skipPage) {
+      selectorIndex = ((selectorIndex / pageItems - 1) * pageItems + totalItems) % totalItems;
     } else {
-      selectorIndex = (selectorIndex + epub->getTocItemsCount() - 1) % epub->getTocItemsCount();
+      selectorIndex = (selectorIndex + totalItems - 1) % totalItems;
     }
-    updateRequired = true;
+    xSemaphoreGive(renderingMutex);
+    requestUpdate();
   } else if (nextReleased) {
-    if (skipPage) {
-      selectorIndex = ((selectorIndex / pageItems + 1) * pageItems) % epub->getTocItemsCount();
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (skipPercent) {
+      selectorIndex = toc->jumpPercent(selectorIndex, SKIP_PERCENT_STEP);
+    } else if (skipPage) {
+      selectorIndex = ((selectorIndex / pageItems + 1) * pageItems) % totalItems;
     } else {
-      selectorIndex = (selectorIndex + 1) % epub->getTocItemsCount();
+      selectorIndex = (selectorIndex + 1) % totalItems;
     }
-    updateRequired = true;
+    xSemaphoreGive(renderingMutex);
+    requestUpdate();
   }
 }
 
-void EpubReaderChapterSelectionActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
+uint32_t EpubReaderChapterSelectionActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (jumpToNextInitial) {
+      jumpToNextInitial = false;
+      selectorIndex = toc->nextInitial(selectorIndex);
     }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    renderScreen();
+    // The neighbours of a page are loaded once, when the selection moves onto it
+    const int shownPage = selectorIndex / getPageItems();
+    prefetchPending = prefetchPending || shownPage != prefetchedPage;
+    prefetchedPage = shownPage;
+    xSemaphoreGive(renderingMutex);
+  } else if (prefetchPending) {
+    // Load the pages around the selection while nothing else is happening
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    prefetchPending = toc->prefetch(selectorIndex);
+    xSemaphoreGive(renderingMutex);
   }
+  return prefetchPending ? 0 : WAIT_FOREVER;
 }
 
 void EpubReaderChapterSelectionActivity::renderScreen() {
@@ -127,11 +158,12 @@ void EpubReaderChapterSelectionActivity::renderScreen() {
       renderer.truncatedText(UI_12_FONT_ID, epub->getTitle().c_str(), pageWidth - 40, EpdFontFamily::BOLD);
   renderer.drawCenteredText(UI_12_FONT_ID, 15, title.c_str(), true, EpdFontFamily::BOLD);
 
+  toc->setPageItems(pageItems);
   const auto pageStartIndex = selectorIndex / pageItems * pageItems;
   renderer.fillRect(0, 60 + (selectorIndex % pageItems) * 30 - 2, pageWidth - 1, 30);
-  for (int tocIndex = pageStartIndex; tocIndex < epub->getTocItemsCount() && tocIndex < pageStartIndex + pageItems;
+  for (int tocIndex = pageStartIndex; tocIndex < toc->getItemCount() && tocIndex < pageStartIndex + pageItems;
        tocIndex++) {
-    auto item = epub->getTocItem(tocIndex);
+    const auto& item = toc->get(tocIndex);
     renderer.drawText(UI_10_FONT_ID, 20 + (item.level - 1) * 15, 60 + (tocIndex % pageItems) * 30, item.title.c_str(),
                       tocIndex != selectorIndex);
   }
@@ -7,14 +7,20 @@
 #include <memory>
 
 #include "../Activity.h"
+#include "TocWindow.h"
 
 class EpubReaderChapterSelectionActivity final : public Activity {
   std::shared_ptr<Epub> epub;
-  TaskHandle_t displayTaskHandle = nullptr;
+  std::unique_ptr<TocWindow> toc;
   SemaphoreHandle_t renderingMutex = nullptr;
   int currentSpineIndex = 0;
   int selectorIndex = 0;
-  bool updateRequired = false;
+  // Set by a long Back press, the search reads the book so it runs in the display task. It and selectorIndex are
+  // only changed holding renderingMutex.
+  bool jumpToNextInitial = false;
+  // Page of the list the neighbours were last loaded for, and whether that is still going on
+  int prefetchedPage = -1;
+  bool prefetchPending = false;
   const std::function<void()> onGoBack;
   const std::function<void(int newSpineIndex)> onSelectSpineIndex;
 
@@ -22,8 +28,7 @@ class EpubReaderChapterSelectionActivity final : public Activity {
   // This adapts automatically when switching between portrait and landscape.
   int getPageItems() const;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void renderScreen();
 
  public:
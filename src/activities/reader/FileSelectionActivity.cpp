@@ -23,11 +23,6 @@ void sortFileList(std::vector<std::string>& strs) {
   });
 }
 
-void FileSelectionActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<FileSelectionActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void FileSelectionActivity::loadFiles() {
   files.clear();
 
@@ -72,25 +67,15 @@ void FileSelectionActivity::onEnter() {
   selectorIndex = 0;
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&FileSelectionActivity::taskTrampoline, "FileSelectionActivityTask",
-              2048,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+
+  startDisplayTask();
 }
 
 void FileSelectionActivity::onExit() {
   Activity::onExit();
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
   files.clear();
@@ -102,7 +87,7 @@ void FileSelectionActivity::loop() {
     if (basepath != "/") {
       basepath = "/";
       loadFiles();
-      updateRequired = true;
+      requestUpdate();
     }
     return;
   }
@@ -124,7 +109,7 @@ void FileSelectionActivity::loop() {
       basepath += files[selectorIndex].substr(0, files[selectorIndex].length() - 1);
       loadFiles();
       selectorIndex = 0;
-      updateRequired = true;
+      requestUpdate();
     } else {
       onSelect(basepath + files[selectorIndex]);
     }
@@ -142,7 +127,7 @@ void FileSelectionActivity::loop() {
         const std::string dirName = oldPath.substr(pos + 1) + "/";
         selectorIndex = findEntry(dirName);
 
-        updateRequired = true;
+        requestUpdate();
       } else {
         onGoHome();
       }
@@ -153,27 +138,25 @@ void FileSelectionActivity::loop() {
     } else {
       selectorIndex = (selectorIndex + files.size() - 1) % files.size();
     }
-    updateRequired = true;
+    requestUpdate();
   } else if (nextReleased) {
     if (skipPage) {
       selectorIndex = ((selectorIndex / PAGE_ITEMS + 1) * PAGE_ITEMS) % files.size();
     } else {
       selectorIndex = (selectorIndex + 1) % files.size();
     }
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
-void FileSelectionActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t FileSelectionActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
   }
+  return WAIT_FOREVER;
 }
 
 void FileSelectionActivity::render() const {
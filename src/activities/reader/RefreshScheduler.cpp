@@ -0,0 +1,100 @@
+#include "RefreshScheduler.h"
+
+#include <GfxRenderer.h>
+#include <HardwareSerial.h>
+#include <PowerMonitor.h>
+
+namespace {
+constexpr const char* MODE_NAMES[] = {"full", "half", "fast"};
+// Cells changed plus cells cleared by an ordinary text page turn (about 9000 and 4500 of the 24000 with the default
+// font), the unit of the ghosting score
+constexpr float TYPICAL_PAGE_TURN_CELLS = 13500;
+// A page turn that clears half the screen (a large image going away) gets a full refresh, a half one leaves it visible
+constexpr uint32_t FULL_REFRESH_CLEARED_CELLS = 12000;
+// However little the pages change, they never go more than this many times the setting without a half refresh
+constexpr int MAX_STRETCH = 2;
+}  // namespace
+
+void RefreshScheduler::updateInkMap(const uint8_t* frame, uint32_t& changed, uint32_t& cleared) {
+  constexpr int rowBytes = EInkDisplay::DISPLAY_WIDTH_BYTES;
+  changed = 0;
+  cleared = 0;
+  uint8_t* cells = inkMap;
+  for (int y = 0; y < EInkDisplay::DISPLAY_HEIGHT; y += CELL_SIZE) {
+    const uint8_t* row = frame + y * rowBytes;
+    // Four frame bytes are eight cells, one byte of the map
+    for (int x = 0; x < rowBytes; x += 4) {
+      uint8_t ink = 0;
+      for (int i = 0; i < 4; i++) {
+        // Bits are set for white pixels, a cell has ink unless its nibble is white in all of its rows
+        const uint8_t* column = row + x + i;
+        const uint8_t white = column[0] & column[rowBytes] & column[2 * rowBytes] & column[3 * rowBytes];
+        if ((white & 0xF0) != 0xF0) {
+          ink |= 0x80 >> (i * 2);
+        }
+        if ((white & 0x0F) != 0x0F) {
+          ink |= 0x40 >> (i * 2);
+        }
+      }
+      changed += __builtin_popcount(*cells ^ ink);
+      cleared += __builtin_popcount(*cells & ~ink & 0xFF);
+      *cells++ = ink;
+    }
+  }
+}
+
+EInkDisplay::RefreshMode RefreshScheduler::choose(const uint32_t changed, const uint32_t cleared,
+                                                  const int pagesPerRefresh) {
+  pagesSinceRefresh++;
+  // Ink turning white is what fast refreshes leave behind the most, so it counts twice
+  score += (changed + cleared) / TYPICAL_PAGE_TURN_CELLS;
+
+  if (cleared >= FULL_REFRESH_CLEARED_CELLS) {
+    return EInkDisplay::FULL_REFRESH;
+  }
+  // A setting of one page means every page, however little it changed
+  if (refreshRequested || pagesPerRefresh <= 1 || score >= pagesPerRefresh ||
+      pagesSinceRefresh >= pagesPerRefresh * MAX_STRETCH) {
+    return EInkDisplay::HALF_REFRESH;
+  }
+  return EInkDisplay::FAST_REFRESH;
+}
+
+void RefreshScheduler::display(GfxRenderer& renderer, const int pagesPerRefresh) {
+  uint32_t changed;
+  uint32_t cleared;
+  updateInkMap(renderer.getFrameBuffer(), changed, cleared);
+  const EInkDisplay::RefreshMode mode = choose(changed, cleared, pagesPerRefresh);
+
+  const unsigned long start = millis();
+  renderer.displayBuffer(mode);
+  const unsigned long elapsed = millis() - start;
+  stats[mode].count++;
+  stats[mode].totalMs += elapsed;
+  powerMonitor::recordPage();
+
+  if (mode != EInkDisplay::FAST_REFRESH) {
+    Serial.printf("[%lu] [RFS] %s refresh after %u pages, ghosting %.1f, %lu ms\n", millis(), MODE_NAMES[mode],
+                  static_cast<unsigned>(pagesSinceRefresh), score, elapsed);
+    refreshRequested = false;
+    score = 0;
+    pagesSinceRefresh = 0;
+  }
+}
+
+void RefreshScheduler::logSummary() const {
+  uint32_t pages = 0;
+  for (const auto& mode : stats) {
+    pages += mode.count;
+  }
+  if (pages == 0) {
+    return;
+  }
+  const auto& fast = stats[EInkDisplay::FAST_REFRESH];
+  const auto& half = stats[EInkDisplay::HALF_REFRESH];
+  const auto& full = stats[EInkDisplay::FULL_REFRESH];
+  Serial.printf("[%lu] [RFS] %u pages: %u fast (%u ms), %u half (%u ms), %u full (%u ms)\n", millis(),
+                static_cast<unsigned>(pages), static_cast<unsigned>(fast.count), static_cast<unsigned>(fast.totalMs),
+                static_cast<unsigned>(half.count), static_cast<unsigned>(half.totalMs),
+                static_cast<unsigned>(full.count), static_cast<unsigned>(full.totalMs));
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <EInkDisplay.h>
+
+#include <cstdint>
+
+class GfxRenderer;
+
+/**
+ * Picks the refresh mode of each reader page from how much the screen changed, instead of a fixed page count.
+ *
+ * Fast refreshes leave a trace of what was there before, mostly where black turns white. Every page is reduced to a
+ * map of 4x4 pixel cells holding ink and compared with the previous one: the cells that changed, and those that
+ * went from ink to white, add to a ghosting score. A typical text page turn adds about 1, so the refresh frequency
+ * setting stays the number of ordinary pages between half refreshes, while pages that barely change (or change
+ * a lot, like images) stretch or shorten it.
+ *
+ * Not thread safe, use it from the reader's display task.
+ */
+class RefreshScheduler {
+ public:
+  RefreshScheduler() = default;
+  RefreshScheduler(const RefreshScheduler&) = delete;
+  RefreshScheduler& operator=(const RefreshScheduler&) = delete;
+
+  // Show the frame in the renderer's buffer with the refresh it needs. pagesPerRefresh is the setting.
+  void display(GfxRenderer& renderer, int pagesPerRefresh);
+  // The next page gets a half refresh, for when something else was drawn over the page in between
+  void requestRefresh() { refreshRequested = true; }
+  // Log the refreshes shown so far by mode, with the time they took
+  void logSummary() const;
+
+ private:
+  static constexpr int CELL_SIZE = 4;
+  static constexpr int MAP_WIDTH = EInkDisplay::DISPLAY_WIDTH / CELL_SIZE;
+  static constexpr int MAP_HEIGHT = EInkDisplay::DISPLAY_HEIGHT / CELL_SIZE;
+  static constexpr int MAP_BYTES = MAP_WIDTH * MAP_HEIGHT / 8;
+
+  struct ModeStats {
+    uint32_t count;
+    uint32_t totalMs;
+  };
+
+  // One bit per cell, set if any pixel in it is black
+  uint8_t inkMap[MAP_BYTES] = {};
+  bool refreshRequested = true;
+  float score = 0;
+  uint16_t pagesSinceRefresh = 0;
+  ModeStats stats[3] = {};
+
+  // Replace the ink map with the frame's, counting the cells that changed and those that went from ink to white
+  void updateInkMap(const uint8_t* frame, uint32_t& changed, uint32_t& cleared);
+  EInkDisplay::RefreshMode choose(uint32_t changed, uint32_t cleared, int pagesPerRefresh);
+};
@@ -0,0 +1,150 @@
+#include "TocWindow.h"
+
+#include <Utf8.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+// First letter of a title, ignoring leading punctuation and case. All digits count as one letter.
+uint32_t titleInitial(const std::string& title) {
+  auto* text = reinterpret_cast<const unsigned char*>(title.c_str());
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(&text))) {
+    if (cp >= '0' && cp <= '9') {
+      return '0';
+    }
+    if (cp >= 'a' && cp <= 'z') {
+      return cp - 'a' + 'A';
+    }
+    if (cp >= 0x80 || (cp >= 'A' && cp <= 'Z')) {
+      return cp;
+    }
+  }
+  return 0;
+}
+}  // namespace
+
+void TocWindow::setPageItems(const int items) {
+  if (items == pageItems) {
+    return;
+  }
+  pageItems = std::max(items, 1);
+  for (auto& page : pages) {
+    page.first = -1;
+    page.items.clear();
+  }
+}
+
+TocWindow::Page* TocWindow::findPage(const int first) {
+  for (auto& page : pages) {
+    if (page.first == first) {
+      return &page;
+    }
+  }
+  return nullptr;
+}
+
+void TocWindow::fillPage(Page& page, const int first) {
+  page.first = first;
+  loader(first, std::min(pageItems, itemCount - first), page.items);
+}
+
+// Replaces the page furthest from first (scrolling wraps around), which is the least likely to be shown next
+TocWindow::Page& TocWindow::loadPage(const int first) {
+  if (Page* page = findPage(first)) {
+    return *page;
+  }
+
+  const auto distance = [this, first](const Page& page) {
+    if (page.first < 0) {
+      return itemCount;
+    }
+    const int d = std::abs(page.first - first);
+    return std::min(d, itemCount - d);
+  };
+  Page& page = *std::max_element(std::begin(pages), std::end(pages),
+                                 [&distance](const Page& a, const Page& b) { return distance(a) < distance(b); });
+  fillPage(page, first);
+  return page;
+}
+
+const TocWindow::Item& TocWindow::get(const int index) {
+  static const Item missing{"", 1};
+  if (index < 0 || index >= itemCount) {
+    return missing;
+  }
+
+  const Page& page = loadPage(index / pageItems * pageItems);
+  const size_t offset = index - page.first;
+  // The loader returns fewer entries if the book couldn't be read
+  return offset < page.items.size() ? page.items[offset] : missing;
+}
+
+bool TocWindow::prefetch(const int index) {
+  if (itemCount == 0) {
+    return false;
+  }
+
+  const int first = index / pageItems * pageItems;
+  const int lastFirst = (itemCount - 1) / pageItems * pageItems;
+  // Scrolling wraps around, so the neighbours of the first and last pages are each other
+  const int next = first + pageItems > lastFirst ? 0 : first + pageItems;
+  const int prev = first == 0 ? lastFirst : first - pageItems;
+  for (const int neighbour : {next, prev}) {
+    if (findPage(neighbour)) {
+      continue;
+    }
+    // There is always a page that is neither shown nor a neighbour, the window holds three
+    for (auto& page : pages) {
+      if (page.first != first && page.first != next && page.first != prev) {
+        fillPage(page, neighbour);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+int TocWindow::jumpPercent(const int index, const int step) const {
+  if (itemCount == 0 || step == 0) {
+    return 0;
+  }
+
+  // Short lists have several marks on the same entry, skip to the first one that moves
+  const int marks = 100 / std::abs(step);
+  const auto markIndex = [this, marks](const int mark) {
+    return static_cast<int>(static_cast<int64_t>(mark) * itemCount / marks);
+  };
+  if (step > 0) {
+    for (int mark = 1; mark < marks; mark++) {
+      if (markIndex(mark) > index) {
+        return markIndex(mark);
+      }
+    }
+    return 0;
+  }
+  for (int mark = marks - 1; mark >= 0; mark--) {
+    if (markIndex(mark) < index) {
+      return markIndex(mark);
+    }
+  }
+  return markIndex(marks - 1);
+}
+
+int TocWindow::nextInitial(const int index) {
+  if (itemCount == 0) {
+    return 0;
+  }
+
+  const uint32_t initial = titleInitial(get(index).title);
+  const int scan = std::min(itemCount - 1, MAX_INITIAL_SCAN_PAGES * pageItems);
+  for (int i = 1; i <= scan; i++) {
+    const int candidate = (index + i) % itemCount;
+    if (titleInitial(get(candidate).title) != initial) {
+      return candidate;
+    }
+  }
+  // Either every title starts with the same letter, or the search gave up and the next press continues from here
+  return scan == itemCount - 1 ? index : (index + scan) % itemCount;
+}
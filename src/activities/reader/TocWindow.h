@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Entries of a chapter list loaded a screen page at a time.
+ *
+ * Only the page being shown and its neighbours are held in RAM, each loaded with a single call to the loader (one
+ * sequential read for EPUB tables of contents). prefetch() loads the neighbours of the selection while the list is
+ * idle, so scrolling onto the next page doesn't wait for the SD card.
+ *
+ * Not thread safe, the loader reads the book: use it only from the list's display task.
+ */
+class TocWindow {
+ public:
+  struct Item {
+    std::string title;
+    uint8_t level;
+  };
+
+  // Fill items with count entries starting at first
+  using Loader = std::function<void(int first, int count, std::vector<Item>& items)>;
+
+  TocWindow(const int itemCount, Loader loader) : itemCount(itemCount), loader(std::move(loader)) {}
+
+  // Entries per page, normally the number of rows on screen. Drops the loaded pages if it changed.
+  void setPageItems(int items);
+  int getItemCount() const { return itemCount; }
+
+  const Item& get(int index);
+
+  // Load one missing neighbour page of index. Returns true if it loaded something, so it can be called until false.
+  bool prefetch(int index);
+
+  // Index of the next (step > 0) or previous multiple of step percent of the list, wrapping around
+  int jumpPercent(int index, int step) const;
+
+  // Index of the next entry whose title starts with a different letter than index, wrapping around. Looks at most
+  // MAX_INITIAL_SCAN_PAGES pages ahead and stops at the last entry looked at if they all start with the same letter.
+  int nextInitial(int index);
+
+ private:
+  struct Page {
+    int first = -1;
+    std::vector<Item> items;
+  };
+
+  // The shown page, the one before and the one after
+  static constexpr int WINDOW_PAGES = 3;
+  // Every page nextInitial looks at is a read of the book
+  static constexpr int MAX_INITIAL_SCAN_PAGES = 8;
+
+  int itemCount;
+  Loader loader;
+  int pageItems = 1;
+  Page pages[WINDOW_PAGES];
+
+  Page* findPage(int first);
+  void fillPage(Page& page, int first);
+  Page& loadPage(int first);
+};
@@ -21,11 +21,6 @@ constexpr uint32_t CACHE_MAGIC = 0x54585449;  // "TXTI"
 constexpr uint8_t CACHE_VERSION = 2;          // Increment when cache format changes
 }  // namespace
 
-void TxtReaderActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<TxtReaderActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void TxtReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -60,14 +55,9 @@ void TxtReaderActivity::onEnter() {
   APP_STATE.saveToFile();
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&TxtReaderActivity::taskTrampoline, "TxtReaderActivityTask",
-              6144,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+
+  startDisplayTask();
 }
 
 void TxtReaderActivity::onExit() {
@@ -76,14 +66,12 @@ void TxtReaderActivity::onExit() {
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
-  // Wait until not rendering to delete task
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
+  refreshScheduler.logSummary();
+  // Also runs before going to sleep
+  progress.flush();
   pageOffsets.clear();
   currentPageLines.clear();
   txt.reset();
@@ -120,23 +108,25 @@ void TxtReaderActivity::loop() {
 
   if (prevReleased && currentPage > 0) {
     currentPage--;
-    updateRequired = true;
+    requestUpdate();
   } else if (nextReleased && currentPage < totalPages - 1) {
     currentPage++;
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
-void TxtReaderActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-  }
+uint32_t TxtReaderActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    renderScreen();
+    xSemaphoreGive(renderingMutex);
+  } else if (progress.isFlushDue()) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    progress.flush();
+    xSemaphoreGive(renderingMutex);
+  }
+  return progress.msUntilFlushDue();
 }
 
 void TxtReaderActivity::initializeReader() {
@@ -464,13 +454,7 @@ void TxtReaderActivity::renderPage() {
   renderLines();
   renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
 
-  if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(EInkDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-  } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
-  }
+  refreshScheduler.display(renderer, SETTINGS.getRefreshFrequency());
 
   // Grayscale rendering pass (for anti-aliased fonts)
   if (SETTINGS.textAntiAliasing) {
@@ -536,34 +520,26 @@ void TxtReaderActivity::renderStatusBar(const int orientedMarginRight, const int
   }
 }
 
-void TxtReaderActivity::saveProgress() const {
-  FsFile f;
-  if (SdMan.openFileForWrite("TRS", txt->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    data[0] = currentPage & 0xFF;
-    data[1] = (currentPage >> 8) & 0xFF;
-    data[2] = 0;
-    data[3] = 0;
-    f.write(data, 4);
-    f.close();
-  }
+void TxtReaderActivity::saveProgress() {
+  uint8_t data[ProgressJournal::DATA_SIZE];
+  data[0] = currentPage & 0xFF;
+  data[1] = (currentPage >> 8) & 0xFF;
+  data[2] = 0;
+  data[3] = 0;
+  progress.update(data);
 }
 
 void TxtReaderActivity::loadProgress() {
-  FsFile f;
-  if (SdMan.openFileForRead("TRS", txt->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    if (f.read(data, 4) == 4) {
-      currentPage = data[0] + (data[1] << 8);
-      if (currentPage >= totalPages) {
-        currentPage = totalPages - 1;
-      }
-      if (currentPage < 0) {
-        currentPage = 0;
-      }
-      Serial.printf("[%lu] [TRS] Loaded progress: page %d/%d\n", millis(), currentPage, totalPages);
+  uint8_t data[ProgressJournal::DATA_SIZE];
+  if (progress.begin(txt->getCachePath(), data)) {
+    currentPage = data[0] + (data[1] << 8);
+    if (currentPage >= totalPages) {
+      currentPage = totalPages - 1;
     }
-    f.close();
+    if (currentPage < 0) {
+      currentPage = 0;
+    }
+    Serial.printf("[%lu] [TRS] Loaded progress: page %d/%d\n", millis(), currentPage, totalPages);
   }
 }
 
@@ -8,16 +8,17 @@
 #include <vector>
 
 #include "CrossPointSettings.h"
+#include "ProgressJournal.h"
+#include "RefreshScheduler.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class TxtReaderActivity final : public ActivityWithSubactivity {
   std::unique_ptr<Txt> txt;
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   int currentPage = 0;
   int totalPages = 1;
-  int pagesUntilFullRefresh = 0;
-  bool updateRequired = false;
+  RefreshScheduler refreshScheduler;
+  ProgressJournal progress;
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
@@ -33,8 +34,7 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   int cachedScreenMargin = 0;
   uint8_t cachedParagraphAlignment = CrossPointSettings::LEFT_ALIGN;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void renderScreen();
   void renderPage();
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
@@ -44,7 +44,7 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   void buildPageIndex();
   bool loadPageIndexCache();
   void savePageIndexCache() const;
-  void saveProgress() const;
+  void saveProgress();
   void loadProgress();
 
  public:
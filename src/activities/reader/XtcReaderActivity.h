@@ -12,23 +12,23 @@
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
+#include "ProgressJournal.h"
+#include "RefreshScheduler.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class XtcReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Xtc> xtc;
-  TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   uint32_t currentPage = 0;
-  int pagesUntilFullRefresh = 0;
-  bool updateRequired = false;
+  RefreshScheduler refreshScheduler;
+  ProgressJournal progress;
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void renderScreen();
   void renderPage();
-  void saveProgress() const;
+  void saveProgress();
   void loadProgress();
 
  public:
@@ -7,6 +7,8 @@
 
 namespace {
 constexpr int SKIP_PAGE_MS = 700;
+constexpr int SKIP_PERCENT_MS = 1500;
+constexpr int SKIP_PERCENT_STEP = 10;
 }  // namespace
 
 int XtcReaderChapterSelectionActivity::getPageItems() const {
@@ -38,11 +40,6 @@ int XtcReaderChapterSelectionActivity::findChapterIndexForPage(uint32_t page) co
   return 0;
 }
 
-void XtcReaderChapterSelectionActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<XtcReaderChapterSelectionActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void XtcReaderChapterSelectionActivity::onEnter() {
   Activity::onEnter();
 
@@ -51,27 +48,29 @@ void XtcReaderChapterSelectionActivity::onEnter() {
   }
 
   renderingMutex = xSemaphoreCreateMutex();
+  // The parser already holds all chapters in RAM, the window only shares the list navigation
+  toc.reset(new TocWindow(static_cast<int>(xtc->getChapters().size()),
+                          [this](const int first, const int count, std::vector<TocWindow::Item>& items) {
+                            const auto& chapters = xtc->getChapters();
+                            items.clear();
+                            for (int i = first; i < first + count; i++) {
+                              items.push_back({chapters[i].name.empty() ? "Unnamed" : chapters[i].name, 1});
+                            }
+                          }));
+  toc->setPageItems(getPageItems());
   selectorIndex = findChapterIndexForPage(currentPage);
 
-  updateRequired = true;
-  xTaskCreate(&XtcReaderChapterSelectionActivity::taskTrampoline, "XtcReaderChapterSelectionActivityTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+  startDisplayTask();
 }
 
 void XtcReaderChapterSelectionActivity::onExit() {
   Activity::onExit();
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
+  toc.reset();
 }
 
 void XtcReaderChapterSelectionActivity::loop() {
@@ -81,50 +80,72 @@ void XtcReaderChapterSelectionActivity::loop() {
                             mappedInput.wasReleased(MappedInputManager::Button::Right);
 
   const bool skipPage = mappedInput.getHeldTime() > SKIP_PAGE_MS;
+  const bool skipPercent = mappedInput.getHeldTime() > SKIP_PERCENT_MS;
   const int pageItems = getPageItems();
 
+  // selectorIndex is also moved by the display task, see displayStep
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
     const auto& chapters = xtc->getChapters();
-    if (!chapters.empty() && selectorIndex >= 0 && selectorIndex < static_cast<int>(chapters.size())) {
-      onSelectPage(chapters[selectorIndex].startPage);
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    const int index = selectorIndex;
+    xSemaphoreGive(renderingMutex);
+    if (!chapters.empty() && index >= 0 && index < static_cast<int>(chapters.size())) {
+      onSelectPage(chapters[index].startPage);
     }
   } else if (mappedInput.wasReleased(MappedInputManager::Button::Back)) {
+    if (skipPage) {
+      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      jumpToNextInitial = true;
+      xSemaphoreGive(renderingMutex);
+      requestUpdate();
+      return;
+    }
     onGoBack();
   } else if (prevReleased) {
     const int total = static_cast<int>(xtc->getChapters().size());
     if (total == 0) {
       return;
     }
-    if (skipPage) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (skipPercent) {
+      selectorIndex = toc->jumpPercent(selectorIndex, -SKIP_PERCENT_STEP);
+    } else if (skipPage) {
       selectorIndex = ((selectorIndex / pageItems - 1) * pageItems + total) % total;
     } else {
       selectorIndex = (selectorIndex + total - 1) % total;
     }
-    updateRequired = true;
+    xSemaphoreGive(renderingMutex);
+    requestUpdate();
   } else if (nextReleased) {
     const int total = static_cast<int>(xtc->getChapters().size());
     if (total == 0) {
       return;
     }
-    if (skipPage) {
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (skipPercent) {
+      selectorIndex = toc->jumpPercent(selectorIndex, SKIP_PERCENT_STEP);
+    } else if (skipPage) {
       selectorIndex = ((selectorIndex / pageItems + 1) * pageItems) % total;
     } else {
       selectorIndex = (selectorIndex + 1) % total;
     }
-    updateRequired = true;
+    xSemaphoreGive(renderingMutex);
+    requestUpdate();
   }
 }
 
-void XtcReaderChapterSelectionActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
+uint32_t XtcReaderChapterSelectionActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    if (jumpToNextInitial) {
+      jumpToNextInitial = false;
+      selectorIndex = toc->nextInitial(selectorIndex);
     }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    renderScreen();
+    xSemaphoreGive(renderingMutex);
   }
+  return WAIT_FOREVER;
 }
 
 void XtcReaderChapterSelectionActivity::renderScreen() {
@@ -134,19 +155,17 @@ void XtcReaderChapterSelectionActivity::renderScreen() {
   const int pageItems = getPageItems();
   renderer.drawCenteredText(UI_12_FONT_ID, 15, "Select Chapter", true, EpdFontFamily::BOLD);
 
-  const auto& chapters = xtc->getChapters();
-  if (chapters.empty()) {
+  if (toc->getItemCount() == 0) {
     renderer.drawCenteredText(UI_10_FONT_ID, 120, "No chapters");
     renderer.displayBuffer();
     return;
   }
 
+  toc->setPageItems(pageItems);
   const auto pageStartIndex = selectorIndex / pageItems * pageItems;
   renderer.fillRect(0, 60 + (selectorIndex % pageItems) * 30 - 2, pageWidth - 1, 30);
-  for (int i = pageStartIndex; i < static_cast<int>(chapters.size()) && i < pageStartIndex + pageItems; i++) {
-    const auto& chapter = chapters[i];
-    const char* title = chapter.name.empty() ? "Unnamed" : chapter.name.c_str();
-    renderer.drawText(UI_10_FONT_ID, 20, 60 + (i % pageItems) * 30, title, i != selectorIndex);
+  for (int i = pageStartIndex; i < toc->getItemCount() && i < pageStartIndex + pageItems; i++) {
+    renderer.drawText(UI_10_FONT_ID, 20, 60 + (i % pageItems) * 30, toc->get(i).title.c_str(), i != selectorIndex);
   }
 
   const auto labels = mappedInput.mapLabels("« Back", "Select", "Up", "Down");
@@ -7,22 +7,24 @@
 #include <memory>
 
 #include "../Activity.h"
+#include "TocWindow.h"
 
 class XtcReaderChapterSelectionActivity final : public Activity {
   std::shared_ptr<Xtc> xtc;
-  TaskHandle_t displayTaskHandle = nullptr;
+  std::unique_ptr<TocWindow> toc;
   SemaphoreHandle_t renderingMutex = nullptr;
   uint32_t currentPage = 0;
   int selectorIndex = 0;
-  bool updateRequired = false;
+  // Set by a long Back press, the search runs in the display task. It and selectorIndex are only changed holding
+  // renderingMutex.
+  bool jumpToNextInitial = false;
   const std::function<void()> onGoBack;
   const std::function<void(uint32_t newPage)> onSelectPage;
 
   int getPageItems() const;
   int findChapterIndexForPage(uint32_t page) const;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
+  uint32_t displayStep() override;
   void renderScreen();
 
  public:
@@ -17,34 +17,20 @@ constexpr int MENU_ITEMS = 2;
 const char* menuNames[MENU_ITEMS] = {"Calibre Web URL", "Connect as Wireless Device"};
 }  // namespace
 
-void CalibreSettingsActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<CalibreSettingsActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void CalibreSettingsActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
   renderingMutex = xSemaphoreCreateMutex();
   selectedIndex = 0;
-  updateRequired = true;
-
-  xTaskCreate(&CalibreSettingsActivity::taskTrampoline, "CalibreSettingsTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+
+  startDisplayTask();
 }
 
 void CalibreSettingsActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
 }
@@ -68,11 +54,11 @@ void CalibreSettingsActivity::loop() {
   if (mappedInput.wasPressed(MappedInputManager::Button::Up) ||
       mappedInput.wasPressed(MappedInputManager::Button::Left)) {
     selectedIndex = (selectedIndex + MENU_ITEMS - 1) % MENU_ITEMS;
-    updateRequired = true;
+    requestUpdate();
   } else if (mappedInput.wasPressed(MappedInputManager::Button::Down) ||
              mappedInput.wasPressed(MappedInputManager::Button::Right)) {
     selectedIndex = (selectedIndex + 1) % MENU_ITEMS;
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
@@ -91,11 +77,11 @@ void CalibreSettingsActivity::handleSelection() {
           SETTINGS.opdsServerUrl[sizeof(SETTINGS.opdsServerUrl) - 1] = '\0';
           SETTINGS.saveToFile();
           exitActivity();
-          updateRequired = true;
+          requestUpdate();
         },
         [this]() {
           exitActivity();
-          updateRequired = true;
+          requestUpdate();
         }));
   } else if (selectedIndex == 1) {
     // Wireless Device - launch the activity (handles WiFi connection internally)
@@ -106,16 +92,16 @@ void CalibreSettingsActivity::handleSelection() {
         if (connected) {
           enterNewActivity(new CalibreWirelessActivity(renderer, mappedInput, [this] {
             exitActivity();
-            updateRequired = true;
+            requestUpdate();
           }));
         } else {
-          updateRequired = true;
+          requestUpdate();
         }
       }));
     } else {
       enterNewActivity(new CalibreWirelessActivity(renderer, mappedInput, [this] {
         exitActivity();
-        updateRequired = true;
+        requestUpdate();
       }));
     }
   }
@@ -123,16 +109,15 @@ void CalibreSettingsActivity::handleSelection() {
   xSemaphoreGive(renderingMutex);
 }
 
-void CalibreSettingsActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired && !subActivity) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t CalibreSettingsActivity::displayStep() {
+  if (updateRequired && !subActivity) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
   }
+  // Updates requested while a subactivity is open are retried until it is gone
+  return updateRequired ? 10 : WAIT_FOREVER;
 }
 
 void CalibreSettingsActivity::render() {
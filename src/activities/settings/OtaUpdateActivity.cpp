@@ -8,11 +8,6 @@
 #include "fontIds.h"
 #include "network/OtaUpdater.h"
 
-void OtaUpdateActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<OtaUpdateActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
   exitActivity();
 
@@ -27,7 +22,7 @@ void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   state = CHECKING_FOR_UPDATE;
   xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  requestUpdate();
   vTaskDelay(10 / portTICK_PERIOD_MS);
   const auto res = updater.checkForUpdate();
   if (res != OtaUpdater::OK) {
@@ -35,7 +30,7 @@ void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
     xSemaphoreTake(renderingMutex, portMAX_DELAY);
     state = FAILED;
     xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -44,14 +39,14 @@ void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
     xSemaphoreTake(renderingMutex, portMAX_DELAY);
     state = NO_UPDATE;
     xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   state = WAITING_CONFIRMATION;
   xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  requestUpdate();
 }
 
 void OtaUpdateActivity::onEnter() {
@@ -59,12 +54,7 @@ void OtaUpdateActivity::onEnter() {
 
   renderingMutex = xSemaphoreCreateMutex();
 
-  xTaskCreate(&OtaUpdateActivity::taskTrampoline, "OtaUpdateActivityTask",
-              2048,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  startDisplayTask();
 
   // Turn on WiFi immediately
   Serial.printf("[%lu] [OTA] Turning on WiFi...\n", millis());
@@ -85,26 +75,19 @@ void OtaUpdateActivity::onExit() {
   WiFi.mode(WIFI_OFF);
   delay(100);  // Allow WiFi hardware to fully power down
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
 }
 
-void OtaUpdateActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t OtaUpdateActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
   }
+  return WAIT_FOREVER;
 }
 
 void OtaUpdateActivity::render() {
@@ -167,6 +150,9 @@ void OtaUpdateActivity::render() {
 
   if (state == FAILED) {
     renderer.drawCenteredText(UI_10_FONT_ID, 300, "Update failed", true, EpdFontFamily::BOLD);
+    if (failure == OtaUpdater::HASH_MISMATCH_ERROR) {
+      renderer.drawCenteredText(UI_10_FONT_ID, 350, "Checksum mismatch, firmware not installed");
+    }
     renderer.displayBuffer();
     return;
   }
@@ -192,23 +178,24 @@ void OtaUpdateActivity::loop() {
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       state = UPDATE_IN_PROGRESS;
       xSemaphoreGive(renderingMutex);
-      updateRequired = true;
+      requestUpdate();
       vTaskDelay(10 / portTICK_PERIOD_MS);
-      const auto res = updater.installUpdate([this](const size_t, const size_t) { updateRequired = true; });
+      const auto res = updater.installUpdate([this](const size_t, const size_t) { requestUpdate(); });
 
       if (res != OtaUpdater::OK) {
         Serial.printf("[%lu] [OTA] Update failed: %d\n", millis(), res);
         xSemaphoreTake(renderingMutex, portMAX_DELAY);
+        failure = res;
         state = FAILED;
         xSemaphoreGive(renderingMutex);
-        updateRequired = true;
+        requestUpdate();
         return;
       }
 
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       state = FINISHED;
       xSemaphoreGive(renderingMutex);
-      updateRequired = true;
+      requestUpdate();
     }
 
     if (mappedInput.wasPressed(MappedInputManager::Button::Back)) {
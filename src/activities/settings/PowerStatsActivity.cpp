@@ -0,0 +1,104 @@
+#include "PowerStatsActivity.h"
+
+#include <GfxRenderer.h>
+#include <PowerMonitor.h>
+
+#include <cstdio>
+
+#include "Battery.h"
+#include "MappedInputManager.h"
+#include "fontIds.h"
+
+namespace {
+void formatDuration(char* out, const size_t size, const uint32_t ms) {
+  const uint32_t seconds = ms / 1000;
+  if (seconds >= 3600) {
+    snprintf(out, size, "%uh %02um", static_cast<unsigned>(seconds / 3600), static_cast<unsigned>(seconds / 60 % 60));
+  } else if (seconds >= 60) {
+    snprintf(out, size, "%um %02us", static_cast<unsigned>(seconds / 60), static_cast<unsigned>(seconds % 60));
+  } else {
+    snprintf(out, size, "%us", static_cast<unsigned>(seconds));
+  }
+}
+}  // namespace
+
+void PowerStatsActivity::onEnter() {
+  Activity::onEnter();
+  render();
+}
+
+void PowerStatsActivity::loop() {
+  if (mappedInput.wasPressed(MappedInputManager::Button::Back)) {
+    onBack();
+    return;
+  }
+
+  if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
+    powerMonitor::reset(battery.readPercentage());
+    render();
+  }
+}
+
+void PowerStatsActivity::render() const {
+  renderer.clearScreen();
+
+  const auto pageWidth = renderer.getScreenWidth();
+  const auto pageHeight = renderer.getScreenHeight();
+  renderer.drawCenteredText(UI_12_FONT_ID, 15, "Power Usage", true, EpdFontFamily::BOLD);
+
+  powerMonitor::Stats stats[powerMonitor::MAX_ACTIVITIES];
+  const size_t count = powerMonitor::snapshot(stats, powerMonitor::MAX_ACTIVITIES);
+  if (count == 0) {
+    renderer.drawCenteredText(UI_10_FONT_ID, pageHeight / 2, "Nothing measured yet");
+  }
+
+  const int titleHeight = renderer.getLineHeight(UI_10_FONT_ID);
+  const int detailHeight = renderer.getLineHeight(SMALL_FONT_ID);
+  int y = 60;
+  for (size_t i = 0; i < count && y + titleHeight + 3 * detailHeight <= pageHeight - 60; i++) {
+    const auto& activity = stats[i];
+    char line[96];
+
+    renderer.drawText(UI_10_FONT_ID, 20, y, activity.activity, true, EpdFontFamily::BOLD);
+    snprintf(line, sizeof(line), "%.1f mAh est.", powerMonitor::estimateMah(activity));
+    renderer.drawText(UI_10_FONT_ID, pageWidth - 20 - renderer.getTextWidth(UI_10_FONT_ID, line), y, line);
+    y += titleHeight;
+
+    char awake[16];
+    char asleep[16];
+    char wifi[16];
+    formatDuration(awake, sizeof(awake), activity.awakeMs);
+    formatDuration(asleep, sizeof(asleep), activity.lightSleepMs);
+    formatDuration(wifi, sizeof(wifi), activity.wifiMs);
+    snprintf(line, sizeof(line), "Awake %s, light sleep %s, WiFi %s, SD %us", awake, asleep, wifi,
+             static_cast<unsigned>(activity.sdMs / 1000));
+    renderer.drawText(SMALL_FONT_ID, 20, y, line);
+    y += detailHeight;
+
+    snprintf(line, sizeof(line), "Refreshes: %u fast, %u half, %u full, %u gray",
+             static_cast<unsigned>(activity.refreshCount[powerMonitor::FAST_REFRESH]),
+             static_cast<unsigned>(activity.refreshCount[powerMonitor::HALF_REFRESH]),
+             static_cast<unsigned>(activity.refreshCount[powerMonitor::FULL_REFRESH]),
+             static_cast<unsigned>(activity.refreshCount[powerMonitor::GRAY_REFRESH]));
+    renderer.drawText(SMALL_FONT_ID, 20, y, line);
+    y += detailHeight;
+
+    if (activity.batteryDrop > 0 || activity.pages > 0) {
+      if (activity.batteryDrop > 0 && activity.pages > 0) {
+        snprintf(line, sizeof(line), "Battery -%u%%, %u pages, %.1f pages per %%",
+                 static_cast<unsigned>(activity.batteryDrop), static_cast<unsigned>(activity.pages),
+                 static_cast<float>(activity.pages) / activity.batteryDrop);
+      } else {
+        snprintf(line, sizeof(line), "Battery -%u%%, %u pages", static_cast<unsigned>(activity.batteryDrop),
+                 static_cast<unsigned>(activity.pages));
+      }
+      renderer.drawText(SMALL_FONT_ID, 20, y, line);
+      y += detailHeight;
+    }
+    y += 8;
+  }
+
+  const auto labels = mappedInput.mapLabels("« Back", "Reset", "", "");
+  renderer.drawButtonHints(UI_10_FONT_ID, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
+  renderer.displayBuffer();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+
+#include "activities/Activity.h"
+
+/**
+ * Battery use per activity from powerMonitor, the activities that used the most first. Confirm clears the totals,
+ * e.g. after tuning something, to measure it from a full charge.
+ */
+class PowerStatsActivity final : public Activity {
+  const std::function<void()> onBack;
+
+  void render() const;
+
+ public:
+  explicit PowerStatsActivity(GfxRenderer& renderer, MappedInputManager& mappedInput,
+                              const std::function<void()>& onBack)
+      : Activity("PowerStats", renderer, mappedInput), onBack(onBack) {}
+  void onEnter() override;
+  void loop() override;
+};
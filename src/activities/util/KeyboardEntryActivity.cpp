@@ -13,21 +13,14 @@ const char* const KeyboardEntryActivity::keyboard[NUM_ROWS] = {
 const char* const KeyboardEntryActivity::keyboardShift[NUM_ROWS] = {"~!@#$%^&*()_+", "QWERTYUIOP{}|", "ASDFGHJKL:\"",
                                                                     "ZXCVBNM<>?", "SPECIAL ROW"};
 
-void KeyboardEntryActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<KeyboardEntryActivity*>(param);
-  self->displayTaskLoop();
-}
-
-void KeyboardEntryActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+uint32_t KeyboardEntryActivity::displayStep() {
+  if (updateRequired) {
+    updateRequired = false;
+    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    render();
+    xSemaphoreGive(renderingMutex);
   }
+  return WAIT_FOREVER;
 }
 
 void KeyboardEntryActivity::onEnter() {
@@ -36,25 +29,15 @@ void KeyboardEntryActivity::onEnter() {
   renderingMutex = xSemaphoreCreateMutex();
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&KeyboardEntryActivity::taskTrampoline, "KeyboardEntryActivity",
-              2048,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
+
+  startDisplayTask();
 }
 
 void KeyboardEntryActivity::onExit() {
   Activity::onExit();
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
+  stopDisplayTask();
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
 }
@@ -146,7 +129,7 @@ void KeyboardEntryActivity::loop() {
       const int maxCol = getRowLength(selectedRow) - 1;
       if (selectedCol > maxCol) selectedCol = maxCol;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Down)) {
@@ -155,7 +138,7 @@ void KeyboardEntryActivity::loop() {
       const int maxCol = getRowLength(selectedRow) - 1;
       if (selectedCol > maxCol) selectedCol = maxCol;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Left)) {
@@ -174,7 +157,7 @@ void KeyboardEntryActivity::loop() {
         // At done button, move to backspace
         selectedCol = BACKSPACE_COL;
       }
-      updateRequired = true;
+      requestUpdate();
       return;
     }
 
@@ -185,7 +168,7 @@ void KeyboardEntryActivity::loop() {
       selectedRow--;
       selectedCol = getRowLength(selectedRow) - 1;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Right)) {
@@ -206,7 +189,7 @@ void KeyboardEntryActivity::loop() {
       } else if (selectedCol >= DONE_COL) {
         // At done button, do nothing
       }
-      updateRequired = true;
+      requestUpdate();
       return;
     }
 
@@ -217,13 +200,13 @@ void KeyboardEntryActivity::loop() {
       selectedRow++;
       selectedCol = 0;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   // Selection
   if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
     handleKeyPress();
-    updateRequired = true;
+    requestUpdate();
   }
 
   // Cancel
@@ -231,7 +214,7 @@ void KeyboardEntryActivity::loop() {
     if (onCancel) {
       onCancel();
     }
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
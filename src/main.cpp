@@ -2,14 +2,21 @@
 #include <EInkDisplay.h>
 #include <Epub.h>
 #include <GfxRenderer.h>
+#include <HeapProfiler.h>
 #include <InputManager.h>
+#include <PowerMonitor.h>
 #include <SDCardManager.h>
 #include <SPI.h>
+#include <Trace.h>
+#include <WiFi.h>
 #include <builtinFonts/all.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
 
 #include <cstring>
 
 #include "Battery.h"
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
@@ -36,6 +43,12 @@
 
 #define SD_SPI_MISO 7
 
+// Main loop input poll interval
+#define LOOP_DELAY_MS 10
+// Idle input polls before the CPU light sleeps between polls, so a burst of button presses (e.g. paging through a
+// list) is not slowed by waking up from light sleep before each one
+#define LIGHT_SLEEP_AFTER_IDLE_POLLS 100
+
 EInkDisplay einkDisplay(EPD_SCLK, EPD_MOSI, EPD_CS, EPD_DC, EPD_RST, EPD_BUSY);
 InputManager inputManager;
 MappedInputManager mappedInputManager(inputManager);
@@ -137,13 +150,22 @@ unsigned long t2 = 0;
 
 void exitActivity() {
   if (currentActivity) {
+    const std::string name = currentActivity->getName();
     currentActivity->onExit();
     delete currentActivity;
     currentActivity = nullptr;
+    // After the delete, so the report shows what the activity left behind
+    heapProfiler::logExit(name.c_str(), APP_STATE.openEpubPath);
+    // Also runs before going to sleep
+    powerMonitor::save();
   }
 }
 
-void enterNewActivity(Activity* activity) {
+// book is the book the activity is about to open, for the heap report
+void enterNewActivity(Activity* activity, const std::string& book = APP_STATE.openEpubPath) {
+  // Before onEnter, so an activity that runs out of memory while starting still has its line in the report
+  heapProfiler::logEnter(activity->getName().c_str(), book);
+  powerMonitor::enter(activity->getName().c_str());
   currentActivity = activity;
   currentActivity->onEnter();
 }
@@ -186,6 +208,21 @@ void verifyWakeupLongPress() {
   }
 }
 
+// Sleep the CPU with RAM kept until ms passed or the power button is pressed. The other buttons are read through the
+// ADC and can't wake it, so they are still polled every LOOP_DELAY_MS.
+void lightSleep(const uint32_t ms) {
+  const unsigned long start = millis();
+  esp_sleep_enable_timer_wakeup(ms * 1000ULL);
+  gpio_wakeup_enable(static_cast<gpio_num_t>(InputManager::POWER_BUTTON_PIN), GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_light_sleep_start();
+  // Deep sleep arms its own wakeup, the timer must not wake it
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+  gpio_wakeup_disable(static_cast<gpio_num_t>(InputManager::POWER_BUTTON_PIN));
+  powerMonitor::recordLightSleep(millis() - start);
+}
+
 void waitForPowerRelease() {
   inputManager.update();
   while (inputManager.isPressed(InputManager::BTN_POWER)) {
@@ -212,7 +249,7 @@ void enterDeepSleep() {
 void onGoHome();
 void onGoToReader(const std::string& initialEpubPath) {
   exitActivity();
-  enterNewActivity(new ReaderActivity(renderer, mappedInputManager, initialEpubPath, onGoHome));
+  enterNewActivity(new ReaderActivity(renderer, mappedInputManager, initialEpubPath, onGoHome), initialEpubPath);
 }
 void onGoToReaderHome() { onGoToReader(std::string()); }
 void onContinueReading() { onGoToReader(APP_STATE.openEpubPath); }
@@ -238,6 +275,33 @@ void onGoHome() {
                                     onGoToFileTransfer, onGoToBrowser));
 }
 
+#ifdef CROSSPOINT_TRACE
+// Serial commands of trace builds: "trace" prints the recorded spans as Chrome trace JSON, "trace clear" drops them
+void handleTraceCommand() {
+  static char line[16];
+  static size_t length = 0;
+  while (Serial.available() > 0) {
+    const char c = static_cast<char>(Serial.read());
+    if (c != '\n' && c != '\r') {
+      if (length < sizeof(line) - 1) {
+        line[length++] = c;
+      }
+      continue;
+    }
+    line[length] = '\0';
+    length = 0;
+    if (strcmp(line, "trace") == 0) {
+      Serial.printf("[%lu] [TRC] %u spans, Chrome trace JSON follows\n", millis(),
+                    static_cast<unsigned>(trace::size()));
+      trace::writeChromeJson(Serial);
+    } else if (strcmp(line, "trace clear") == 0) {
+      trace::clear();
+      Serial.printf("[%lu] [TRC] Cleared\n", millis());
+    }
+  }
+}
+#endif
+
 void setupDisplayAndFonts() {
   einkDisplay.begin();
   Serial.printf("[%lu] [   ] Display initialized\n", millis());
@@ -295,6 +359,8 @@ void setup() {
 
   // First serial output only here to avoid timing inconsistencies for power button press duration verification
   Serial.printf("[%lu] [   ] Starting CrossPoint version " CROSSPOINT_VERSION "\n", millis());
+  heapProfiler::logBoot();
+  powerMonitor::begin(battery.readPercentage());
 
   setupDisplayAndFonts();
 
@@ -302,6 +368,7 @@ void setup() {
   enterNewActivity(new BootActivity(renderer, mappedInputManager));
 
   APP_STATE.loadFromFile();
+  BOOK_CACHE.loadFromFile();
   if (APP_STATE.openEpubPath.empty()) {
     onGoHome();
   } else {
@@ -321,8 +388,14 @@ void loop() {
   static unsigned long maxLoopDuration = 0;
   const unsigned long loopStartTime = millis();
   static unsigned long lastMemPrint = 0;
+  static unsigned long lastBatteryRead = 0;
 
   inputManager.update();
+  heapProfiler::sample();
+
+#ifdef CROSSPOINT_TRACE
+  handleTraceCommand();
+#endif
 
   if (Serial && millis() - lastMemPrint >= 10000) {
     Serial.printf("[%lu] [MEM] Free: %d bytes, Total: %d bytes, Min Free: %d bytes\n", millis(), ESP.getFreeHeap(),
@@ -330,10 +403,18 @@ void loop() {
     lastMemPrint = millis();
   }
 
+  if (millis() - lastBatteryRead >= 60000) {
+    powerMonitor::recordBattery(battery.readPercentage());
+    lastBatteryRead = millis();
+  }
+
   // Check for any user activity (button press or release) or active background work
   static unsigned long lastActivityTime = millis();
-  if (inputManager.wasAnyPressed() || inputManager.wasAnyReleased() ||
-      (currentActivity && currentActivity->preventAutoSleep())) {
+  const bool inputChanged = inputManager.wasAnyPressed() || inputManager.wasAnyReleased();
+  if (inputChanged) {
+    Activity::noteInput();
+  }
+  if (inputChanged || (currentActivity && currentActivity->preventAutoSleep())) {
     lastActivityTime = millis();  // Reset inactivity timer
   }
 
@@ -357,6 +438,7 @@ void loop() {
     currentActivity->loop();
   }
   const unsigned long activityDuration = millis() - activityStartTime;
+  const bool displayTasksIdle = Activity::serviceDisplayTasks();
 
   const unsigned long loopDuration = millis() - loopStartTime;
   if (loopDuration > maxLoopDuration) {
@@ -366,13 +448,20 @@ void loop() {
                     activityDuration);
     }
   }
+  powerMonitor::sample(loopDuration, WiFi.getMode() != WIFI_OFF);
 
   // Add delay at the end of the loop to prevent tight spinning
   // When an activity requests skip loop delay (e.g., webserver running), use yield() for faster response
   // Otherwise, use longer delay to save power
+  static uint32_t idlePolls = 0;
+  const bool idle = displayTasksIdle && !inputChanged && !Serial && WiFi.getMode() == WIFI_OFF &&
+                    !(currentActivity && currentActivity->preventAutoSleep());
+  idlePolls = idle ? idlePolls + 1 : 0;
   if (currentActivity && currentActivity->skipLoopDelay()) {
     yield();  // Give FreeRTOS a chance to run tasks, but return immediately
+  } else if (idlePolls >= LIGHT_SLEEP_AFTER_IDLE_POLLS) {
+    lightSleep(LOOP_DELAY_MS);  // Nothing to do until the next input poll
   } else {
-    delay(10);  // Normal delay when no activity requires fast response
+    delay(LOOP_DELAY_MS);  // Normal delay when no activity requires fast response
   }
 }
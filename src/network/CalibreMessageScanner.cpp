@@ -0,0 +1,156 @@
+#include "CalibreMessageScanner.h"
+
+#include <cstdlib>
+
+void CalibreMessageScanner::reset() {
+  state = State::LENGTH;
+  prefixDigits = 0;
+  bodyRemaining = 0;
+  message = Message{};
+  depth = 0;
+  inString = false;
+  escape = false;
+  expectingValue = false;
+  key.clear();
+  token.clear();
+}
+
+size_t CalibreMessageScanner::feed(const uint8_t* data, const size_t len) {
+  size_t pos = 0;
+
+  while (pos < len && state != State::COMPLETE) {
+    const char c = static_cast<char>(data[pos]);
+
+    if (state == State::LENGTH) {
+      pos++;
+      if (c >= '0' && c <= '9') {
+        // bodyRemaining doubles as the prefix accumulator until '[' is seen
+        bodyRemaining = bodyRemaining * 10 + (c - '0');
+        if (++prefixDigits > MAX_PREFIX_DIGITS) {
+          prefixDigits = 0;
+          bodyRemaining = 0;
+        }
+      } else if (c == '[' && prefixDigits > 0 && bodyRemaining > 0 && bodyRemaining <= MAX_MESSAGE_LEN) {
+        // The length covers the JSON starting at '['
+        state = State::BODY;
+        bodyRemaining--;
+        scanByte(c);
+        if (bodyRemaining == 0) {
+          state = State::COMPLETE;
+        }
+      } else {
+        // Calibre always sends a length prefix - anything else is garbage, resync on the next digits
+        prefixDigits = 0;
+        bodyRemaining = 0;
+      }
+      continue;
+    }
+
+    // BODY: scan everything the prefix covers, but never past the end of this message
+    const size_t chunk = bodyRemaining < len - pos ? bodyRemaining : len - pos;
+    for (size_t i = 0; i < chunk; i++) {
+      scanByte(static_cast<char>(data[pos + i]));
+    }
+    pos += chunk;
+    bodyRemaining -= chunk;
+    if (bodyRemaining == 0) {
+      state = State::COMPLETE;
+    }
+  }
+
+  return pos;
+}
+
+void CalibreMessageScanner::finishScalar() {
+  if (token.empty()) {
+    return;
+  }
+
+  if (depth == 1 && message.opcode < 0) {
+    // First element of the outer array
+    message.opcode = atoi(token.c_str());
+  } else if (depth == 2 && expectingValue) {
+    if (key == "length") {
+      message.length = strtoul(token.c_str(), nullptr, 10);
+    } else if (key == "messageKind") {
+      message.messageKind = atoi(token.c_str());
+    } else if (key == "ejecting") {
+      message.ejecting = token == "true";
+    }
+  }
+  token.clear();
+}
+
+void CalibreMessageScanner::scanByte(const char c) {
+  if (inString) {
+    if (escape) {
+      escape = false;
+    } else if (c == '\\') {
+      escape = true;
+      return;
+    } else if (c == '"') {
+      inString = false;
+      if (depth == 2) {
+        if (!expectingValue) {
+          key = token;
+        } else if (key == "lpath") {
+          message.lpath = token;
+        }
+      }
+      token.clear();
+      return;
+    }
+
+    // Only keys and the lpath value of the data object are kept
+    if (depth == 2) {
+      const size_t limit = expectingValue ? (key == "lpath" ? MAX_LPATH_LEN : 0) : MAX_KEY_LEN;
+      if (token.size() < limit) {
+        token += c;
+      }
+    }
+    return;
+  }
+
+  switch (c) {
+    case '"':
+      inString = true;
+      token.clear();
+      break;
+    case '{':
+    case '[':
+      finishScalar();
+      depth++;
+      break;
+    case '}':
+    case ']':
+      finishScalar();
+      if (depth == 2) {
+        expectingValue = false;
+      }
+      depth--;
+      break;
+    case ':':
+      if (depth == 2) {
+        expectingValue = true;
+        token.clear();
+      }
+      break;
+    case ',':
+      finishScalar();
+      if (depth == 2) {
+        expectingValue = false;
+      }
+      break;
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      break;
+    default:
+      // Numbers, true/false/null
+      if ((depth == 1 || (depth == 2 && expectingValue)) && token.size() < MAX_SCALAR_LEN) {
+        token += c;
+      }
+      break;
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Incremental parser for Calibre's length-prefixed JSON messages ("<len>[<opcode>, {...}]").
+ *
+ * Bytes are fed straight from the receive buffer and scanned in place; the message itself is never
+ * copied. Only the handful of top-level fields the device acts on are captured (opcode, lpath, length,
+ * messageKind, ejecting), so SEND_BOOK messages carrying large metadata/cover blobs are handled in
+ * constant memory.
+ */
+class CalibreMessageScanner {
+ public:
+  struct Message {
+    int opcode = -1;
+    std::string lpath;
+    size_t length = 0;  // Top-level "length" (book size for SEND_BOOK)
+    int messageKind = -1;
+    bool ejecting = false;
+  };
+
+  // Consume bytes until a message completes or the input is exhausted. Returns the number of bytes
+  // consumed; anything after a completed message is left for the caller (e.g. book binary data).
+  size_t feed(const uint8_t* data, size_t len);
+
+  bool isComplete() const { return state == State::COMPLETE; }
+  const Message& getMessage() const { return message; }
+  // Prepare for the next message
+  void reset();
+
+ private:
+  static constexpr size_t MAX_PREFIX_DIGITS = 12;
+  static constexpr size_t MAX_MESSAGE_LEN = 1000000;
+  static constexpr size_t MAX_KEY_LEN = 16;
+  static constexpr size_t MAX_SCALAR_LEN = 24;
+  static constexpr size_t MAX_LPATH_LEN = 512;
+
+  enum class State { LENGTH, BODY, COMPLETE };
+
+  State state = State::LENGTH;
+  size_t prefixDigits = 0;
+  size_t bodyRemaining = 0;
+  Message message;
+
+  // JSON tokenizer state
+  int depth = 0;
+  bool inString = false;
+  bool escape = false;
+  bool expectingValue = false;  // Inside the data object, after "key":
+  std::string key;
+  std::string token;  // Current key, captured string value or scalar
+
+  void scanByte(char c);
+  void finishScalar();
+};
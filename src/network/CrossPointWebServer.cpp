@@ -3,11 +3,14 @@
 #include <ArduinoJson.h>
 #include <FsHelpers.h>
 #include <SDCardManager.h>
+#include <Trace.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
 
 #include <algorithm>
 
+#include "BookCacheManager.h"
+#include "UploadSession.h"
 #include "html/FilesPageHtml.generated.h"
 #include "html/HomePageHtml.generated.h"
 
@@ -21,13 +24,51 @@ constexpr size_t HIDDEN_ITEMS_COUNT = sizeof(HIDDEN_ITEMS) / sizeof(HIDDEN_ITEMS
 CrossPointWebServer* wsInstance = nullptr;
 
 // WebSocket upload state
-FsFile wsUploadFile;
 String wsUploadFileName;
 String wsUploadPath;
 size_t wsUploadSize = 0;
 size_t wsUploadReceived = 0;
 unsigned long wsUploadStartTime = 0;
+size_t wsLastProgressSent = 0;
 bool wsUploadInProgress = false;
+uint8_t wsUploadClient = 0;
+
+// Resumable WebSocket upload state (SESSION command)
+constexpr size_t WS_CHUNK_HEADER_SIZE = 8;  // <offset:u32 LE><crc32:u32 LE>
+bool wsUploadResumable = false;
+std::string wsUploadSessionId;
+std::string wsUploadPartPath;
+
+#ifdef CROSSPOINT_TRACE
+// Sends everything printed to it as chunks of a response started with CONTENT_LENGTH_UNKNOWN
+class ChunkedResponsePrint final : public Print {
+  WebServer& server;
+  char buffer[512];
+  size_t used = 0;
+
+ public:
+  explicit ChunkedResponsePrint(WebServer& server) : server(server) {}
+
+  size_t write(const uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t* data, const size_t size) override {
+    for (size_t i = 0; i < size; i++) {
+      if (used == sizeof(buffer)) {
+        sendBuffer();
+      }
+      buffer[used++] = static_cast<char>(data[i]);
+    }
+    return size;
+  }
+
+  void sendBuffer() {
+    if (used > 0) {
+      server.sendContent(buffer, used);
+      used = 0;
+    }
+  }
+};
+#endif
 }  // namespace
 
 // File listing page template - now using generated headers:
@@ -84,11 +125,17 @@ void CrossPointWebServer::begin() {
   server->on("/files", HTTP_GET, [this] { handleFileList(); });
 
   server->on("/api/status", HTTP_GET, [this] { handleStatus(); });
+#ifdef CROSSPOINT_TRACE
+  server->on("/api/trace", HTTP_GET, [this] { handleTrace(); });
+#endif
   server->on("/api/files", HTTP_GET, [this] { handleFileListData(); });
 
   // Upload endpoint with special handling for multipart form data
   server->on("/upload", HTTP_POST, [this] { handleUploadPost(); }, [this] { handleUpload(); });
 
+  // Resumable upload offset query
+  server->on("/api/upload", HTTP_GET, [this] { handleUploadStatus(); });
+
   // Create folder endpoint
   server->on("/mkdir", HTTP_POST, [this] { handleCreateFolder(); });
 
@@ -100,6 +147,12 @@ void CrossPointWebServer::begin() {
 
   server->begin();
 
+  // Start the SD writer task used by both upload paths
+  uploadWriter.reset(new UploadWriter());
+  if (!uploadWriter->init()) {
+    Serial.printf("[%lu] [WEB] Failed to start upload writer\n", millis());
+  }
+
   // Start WebSocket server for fast binary uploads
   Serial.printf("[%lu] [WEB] Starting WebSocket server on port %d...\n", millis(), wsPort);
   wsServer.reset(new WebSocketsServer(wsPort));
@@ -130,10 +183,14 @@ void CrossPointWebServer::stop() {
 
   Serial.printf("[%lu] [WEB] [MEM] Free heap before stop: %d bytes\n", millis(), ESP.getFreeHeap());
 
-  // Close any in-progress WebSocket upload
-  if (wsUploadInProgress && wsUploadFile) {
-    wsUploadFile.close();
-    wsUploadInProgress = false;
+  // Abort any in-progress upload and stop the writer task
+  wsUploadInProgress = false;
+  if (uploadWriter) {
+    if (!uploadWriter->deinit()) {
+      // Still used by its writer task, which is stuck in an SD write
+      uploadWriter.release();
+    }
+    uploadWriter.reset();
   }
 
   // Stop WebSocket server
@@ -214,11 +271,50 @@ void CrossPointWebServer::handleStatus() const {
   doc["freeHeap"] = ESP.getFreeHeap();
   doc["uptime"] = millis() / 1000;
 
+  if (uploadWriter) {
+    const UploadWriter::Stats stats = uploadWriter->getStats();
+    JsonObject upload = doc["upload"].to<JsonObject>();
+    upload["active"] = uploadWriter->isActive();
+    upload["bytes"] = stats.bytesWritten;
+    upload["kbps"] = uploadWriter->getKbps();
+    upload["sdWrites"] = stats.sdWrites;
+    upload["sdWriteMs"] = stats.sdWriteMs;
+    upload["stallMs"] = stats.stallMs;
+    upload["bufferSize"] = uploadWriter->getCapacity();
+    upload["bufferFill"] = uploadWriter->getFill();
+    upload["bufferPeak"] = stats.peakFill;
+  }
+
+  const BookCacheManager::Stats cacheStats = BOOK_CACHE.getStats();
+  JsonObject cache = doc["cache"].to<JsonObject>();
+  cache["budget"] = cacheStats.budgetBytes;
+  cache["used"] = cacheStats.usedBytes;
+  cache["books"] = cacheStats.books;
+  cache["unsizedBooks"] = cacheStats.unsizedBooks;
+  cache["evictedFiles"] = cacheStats.evictedFiles;
+  cache["evictedBytes"] = cacheStats.evictedBytes;
+
   String json;
   serializeJson(doc, json);
   server->send(200, "application/json", json);
 }
 
+#ifdef CROSSPOINT_TRACE
+void CrossPointWebServer::handleTrace() const {
+  // The buffer holds up to CROSSPOINT_TRACE_CAPACITY spans, far too much JSON to build in one String
+  server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server->send(200, "application/json", "");
+  ChunkedResponsePrint out(*server);
+  trace::writeChromeJson(out);
+  out.sendBuffer();
+  server->sendContent("");
+
+  if (server->hasArg("clear")) {
+    trace::clear();
+  }
+}
+#endif
+
 void CrossPointWebServer::scanFiles(const char* path, const std::function<void(FileInfo)>& callback) const {
   FsFile root = SdMan.open(path);
   if (!root) {
@@ -283,9 +379,22 @@ bool CrossPointWebServer::isEpubFile(const String& filename) const {
   return lower.endsWith(".epub");
 }
 
+// SdFat is not thread safe, so other SD operations are refused while the writer task owns the card
+bool CrossPointWebServer::rejectIfUploadActive() const {
+  if (uploadWriter && uploadWriter->isActive()) {
+    server->send(503, "text/plain", "Upload in progress, try again shortly");
+    return true;
+  }
+  return false;
+}
+
 void CrossPointWebServer::handleFileList() const { server->send(200, "text/html", FilesPageHtml); }
 
 void CrossPointWebServer::handleFileListData() const {
+  if (rejectIfUploadActive()) {
+    return;
+  }
+
   // Get current path from query string (default to root)
   String currentPath = "/";
   if (server->hasArg("path")) {
@@ -336,44 +445,26 @@ void CrossPointWebServer::handleFileListData() const {
 }
 
 // Static variables for upload handling
-static FsFile uploadFile;
 static String uploadFileName;
 static String uploadPath = "/";
 static size_t uploadSize = 0;
 static bool uploadSuccess = false;
 static String uploadError = "";
-
-// Upload write buffer - batches small writes into larger SD card operations
-// 4KB is a good balance: large enough to reduce syscall overhead, small enough
-// to keep individual write times short and avoid watchdog issues
-constexpr size_t UPLOAD_BUFFER_SIZE = 4096;  // 4KB buffer
-static uint8_t uploadBuffer[UPLOAD_BUFFER_SIZE];
-static size_t uploadBufferPos = 0;
-
-// Diagnostic counters for upload performance analysis
+static bool uploadStarted = false;
 static unsigned long uploadStartTime = 0;
-static unsigned long totalWriteTime = 0;
-static size_t writeCount = 0;
-
-static bool flushUploadBuffer() {
-  if (uploadBufferPos > 0 && uploadFile) {
-    esp_task_wdt_reset();  // Reset watchdog before potentially slow SD write
-    const unsigned long writeStart = millis();
-    const size_t written = uploadFile.write(uploadBuffer, uploadBufferPos);
-    totalWriteTime += millis() - writeStart;
-    writeCount++;
-    esp_task_wdt_reset();  // Reset watchdog after SD write
-
-    if (written != uploadBufferPos) {
-      Serial.printf("[%lu] [WEB] [UPLOAD] Buffer flush failed: expected %d, wrote %d\n", millis(), uploadBufferPos,
-                    written);
-      uploadBufferPos = 0;
-      return false;
-    }
-    uploadBufferPos = 0;
-  }
-  return true;
-}
+
+// Resumable upload state, used when the client passes `size` and `offset` query parameters.
+// Each POST then carries one chunk of the file starting at `offset`, optionally verified by `crc`.
+static bool uploadResumable = false;
+static size_t uploadTotalSize = 0;
+static size_t uploadChunkOffset = 0;
+static size_t uploadCommitted = 0;
+static bool uploadHasCrc = false;
+static uint32_t uploadExpectedCrc = 0;
+static uint32_t uploadCrc = 0;
+static bool uploadComplete = false;
+static std::string uploadSessionId;
+static std::string uploadPartPath;
 
 void CrossPointWebServer::handleUpload() const {
   static size_t lastLoggedSize = 0;
@@ -397,11 +488,12 @@ void CrossPointWebServer::handleUpload() const {
     uploadSize = 0;
     uploadSuccess = false;
     uploadError = "";
+    uploadStarted = false;
     uploadStartTime = millis();
     lastLoggedSize = 0;
-    uploadBufferPos = 0;
-    totalWriteTime = 0;
-    writeCount = 0;
+    uploadResumable = server->hasArg("size") && server->hasArg("offset");
+    uploadCrc = 0;
+    uploadComplete = false;
 
     // Get upload path from query parameter (defaults to root if not specified)
     // Note: We use query parameter instead of form data because multipart form
@@ -428,89 +520,150 @@ void CrossPointWebServer::handleUpload() const {
     if (!filePath.endsWith("/")) filePath += "/";
     filePath += uploadFileName;
 
-    // Check if file already exists - SD operations can be slow
-    esp_task_wdt_reset();
-    if (SdMan.exists(filePath.c_str())) {
-      Serial.printf("[%lu] [WEB] [UPLOAD] Overwriting existing file: %s\n", millis(), filePath.c_str());
+    if (!uploadWriter || uploadWriter->isActive()) {
+      uploadError = "Another upload is in progress";
+      Serial.printf("[%lu] [WEB] [UPLOAD] Rejected, writer busy: %s\n", millis(), filePath.c_str());
+      return;
+    }
+
+    if (uploadResumable) {
+      uploadTotalSize = strtoul(server->arg("size").c_str(), nullptr, 10);
+      uploadChunkOffset = strtoul(server->arg("offset").c_str(), nullptr, 10);
+      uploadHasCrc = server->hasArg("crc");
+      uploadExpectedCrc = uploadHasCrc ? strtoul(server->arg("crc").c_str(), nullptr, 16) : 0;
+      uploadSessionId = UploadSession::makeId(filePath.c_str(), uploadTotalSize);
+      uploadPartPath = UploadSession::partPath(uploadPath.c_str(), uploadSessionId);
+
+      // Chunks must continue exactly where the committed data ends
+      esp_task_wdt_reset();
+      uploadCommitted = UploadSession::committedSize(uploadPartPath);
+      if (uploadCommitted > uploadTotalSize) {
+        // Stale part file from an unrelated upload - start over
+        SdMan.remove(uploadPartPath.c_str());
+        uploadCommitted = 0;
+      }
+      if (uploadChunkOffset != uploadCommitted) {
+        uploadError = "Offset mismatch";
+        Serial.printf("[%lu] [WEB] [UPLOAD] Session %s: chunk at %zu, committed %zu\n", millis(),
+                      uploadSessionId.c_str(), uploadChunkOffset, uploadCommitted);
+        return;
+      }
+
       esp_task_wdt_reset();
-      SdMan.remove(filePath.c_str());
+      if (!uploadWriter->begin("WEB", uploadPartPath.c_str(), true)) {
+        uploadError = "Failed to open partial file on SD card";
+        return;
+      }
+      uploadStarted = true;
+      Serial.printf("[%lu] [WEB] [UPLOAD] Session %s: resuming at %zu of %zu\n", millis(), uploadSessionId.c_str(),
+                    uploadChunkOffset, uploadTotalSize);
+      return;
     }
 
-    // Open file for writing - this can be slow due to FAT cluster allocation
+    // Create (overwriting any existing file) - this can be slow due to FAT cluster allocation
     esp_task_wdt_reset();
-    if (!SdMan.openFileForWrite("WEB", filePath, uploadFile)) {
+    if (!uploadWriter->begin("WEB", filePath.c_str())) {
       uploadError = "Failed to create file on SD card";
       Serial.printf("[%lu] [WEB] [UPLOAD] FAILED to create file: %s\n", millis(), filePath.c_str());
       return;
     }
+    uploadStarted = true;
     esp_task_wdt_reset();
 
     Serial.printf("[%lu] [WEB] [UPLOAD] File created successfully: %s\n", millis(), filePath.c_str());
   } else if (upload.status == UPLOAD_FILE_WRITE) {
-    if (uploadFile && uploadError.isEmpty()) {
-      // Buffer incoming data and flush when buffer is full
-      // This reduces SD card write operations and improves throughput
-      const uint8_t* data = upload.buf;
-      size_t remaining = upload.currentSize;
-
-      while (remaining > 0) {
-        const size_t space = UPLOAD_BUFFER_SIZE - uploadBufferPos;
-        const size_t toCopy = (remaining < space) ? remaining : space;
-
-        memcpy(uploadBuffer + uploadBufferPos, data, toCopy);
-        uploadBufferPos += toCopy;
-        data += toCopy;
-        remaining -= toCopy;
-
-        // Flush buffer when full
-        if (uploadBufferPos >= UPLOAD_BUFFER_SIZE) {
-          if (!flushUploadBuffer()) {
-            uploadError = "Failed to write to SD card - disk may be full";
-            uploadFile.close();
-            return;
-          }
+    if (uploadStarted && uploadError.isEmpty()) {
+      if (uploadResumable) {
+        if (uploadChunkOffset + uploadSize + upload.currentSize > uploadTotalSize) {
+          uploadError = "Chunk exceeds declared size";
+          return;
         }
+        uploadCrc = UploadSession::crc32(uploadCrc, upload.buf, upload.currentSize);
+      }
+
+      // Hand the data to the write-behind buffer; this only blocks when the ring is full
+      if (!uploadWriter->write(upload.buf, upload.currentSize)) {
+        uploadError = "Failed to write to SD card - disk may be full";
+        // Resumable chunks are rolled back to their start offset once the request ends
+        if (!uploadResumable) {
+          uploadWriter->abort();
+          uploadStarted = false;
+        }
+        return;
       }
 
       uploadSize += upload.currentSize;
 
       // Log progress every 100KB
       if (uploadSize - lastLoggedSize >= 102400) {
-        const unsigned long elapsed = millis() - uploadStartTime;
-        const float kbps = (elapsed > 0) ? (uploadSize / 1024.0) / (elapsed / 1000.0) : 0;
+        const UploadWriter::Stats stats = uploadWriter->getStats();
         Serial.printf("[%lu] [WEB] [UPLOAD] %d bytes (%.1f KB), %.1f KB/s, %d writes\n", millis(), uploadSize,
-                      uploadSize / 1024.0, kbps, writeCount);
+                      uploadSize / 1024.0, uploadWriter->getKbps(), stats.sdWrites);
         lastLoggedSize = uploadSize;
       }
     }
   } else if (upload.status == UPLOAD_FILE_END) {
-    if (uploadFile) {
-      // Flush any remaining buffered data
-      if (!flushUploadBuffer()) {
+    if (uploadStarted) {
+      // Drain any remaining buffered data and close the file
+      if (!uploadWriter->finish()) {
         uploadError = "Failed to write final data to SD card";
       }
-      uploadFile.close();
+      uploadStarted = false;
+
+      if (uploadResumable) {
+        if (uploadError.isEmpty() && uploadHasCrc && uploadCrc != uploadExpectedCrc) {
+          uploadError = "CRC mismatch";
+          Serial.printf("[%lu] [WEB] [UPLOAD] Session %s: CRC %08lx, expected %08lx\n", millis(),
+                        uploadSessionId.c_str(), static_cast<unsigned long>(uploadCrc),
+                        static_cast<unsigned long>(uploadExpectedCrc));
+        }
+        if (!uploadError.isEmpty()) {
+          // Drop the unverified chunk so the client can resend it from the last committed offset
+          UploadSession::truncate(uploadPartPath, uploadChunkOffset);
+          uploadCommitted = uploadChunkOffset;
+          return;
+        }
+
+        uploadCommitted = uploadChunkOffset + uploadSize;
+        if (uploadCommitted >= uploadTotalSize) {
+          String filePath = uploadPath;
+          if (!filePath.endsWith("/")) filePath += "/";
+          filePath += uploadFileName;
+          if (!UploadSession::commit(uploadPartPath, filePath.c_str())) {
+            uploadError = "Failed to finalize file on SD card";
+            return;
+          }
+          uploadComplete = true;
+          Serial.printf("[%lu] [WEB] [UPLOAD] Session %s complete: %s\n", millis(), uploadSessionId.c_str(),
+                        filePath.c_str());
+        }
+        uploadSuccess = true;
+        return;
+      }
 
       if (uploadError.isEmpty()) {
         uploadSuccess = true;
+        const UploadWriter::Stats stats = uploadWriter->getStats();
         const unsigned long elapsed = millis() - uploadStartTime;
         const float avgKbps = (elapsed > 0) ? (uploadSize / 1024.0) / (elapsed / 1000.0) : 0;
-        const float writePercent = (elapsed > 0) ? (totalWriteTime * 100.0 / elapsed) : 0;
+        const float writePercent = (elapsed > 0) ? (stats.sdWriteMs * 100.0 / elapsed) : 0;
         Serial.printf("[%lu] [WEB] [UPLOAD] Complete: %s (%d bytes in %lu ms, avg %.1f KB/s)\n", millis(),
                       uploadFileName.c_str(), uploadSize, elapsed, avgKbps);
-        Serial.printf("[%lu] [WEB] [UPLOAD] Diagnostics: %d writes, total write time: %lu ms (%.1f%%)\n", millis(),
-                      writeCount, totalWriteTime, writePercent);
+        Serial.printf("[%lu] [WEB] [UPLOAD] Diagnostics: %d writes, %lu ms writing (%.1f%%), %lu ms stalled\n",
+                      millis(), stats.sdWrites, stats.sdWriteMs, writePercent, stats.stallMs);
       }
     }
   } else if (upload.status == UPLOAD_FILE_ABORTED) {
-    uploadBufferPos = 0;  // Discard buffered data
-    if (uploadFile) {
-      uploadFile.close();
-      // Try to delete the incomplete file
-      String filePath = uploadPath;
-      if (!filePath.endsWith("/")) filePath += "/";
-      filePath += uploadFileName;
-      SdMan.remove(filePath.c_str());
+    if (uploadStarted && uploadResumable) {
+      // The chunk never got verified, drop it so the client resends it from the last committed offset
+      uploadWriter->finish();
+      UploadSession::truncate(uploadPartPath, uploadChunkOffset);
+      uploadCommitted = uploadChunkOffset;
+      uploadStarted = false;
+    } else if (uploadStarted) {
+      // Discard buffered data and delete the incomplete file
+      uploadWriter->abort();
+      uploadStarted = false;
     }
     uploadError = "Upload aborted";
     Serial.printf("[%lu] [WEB] Upload aborted\n", millis());
@@ -518,6 +671,22 @@ void CrossPointWebServer::handleUpload() const {
 }
 
 void CrossPointWebServer::handleUploadPost() const {
+  if (uploadResumable) {
+    JsonDocument doc;
+    doc["id"] = uploadSessionId;
+    doc["offset"] = uploadCommitted;
+    doc["size"] = uploadTotalSize;
+    doc["done"] = uploadComplete;
+    if (!uploadSuccess) {
+      doc["error"] = uploadError.isEmpty() ? "Unknown error during upload" : uploadError.c_str();
+    }
+
+    String json;
+    serializeJson(doc, json);
+    server->send(uploadSuccess ? 200 : 409, "application/json", json);
+    return;
+  }
+
   if (uploadSuccess) {
     server->send(200, "text/plain", "File uploaded successfully: " + uploadFileName);
   } else {
@@ -526,7 +695,47 @@ void CrossPointWebServer::handleUploadPost() const {
   }
 }
 
+void CrossPointWebServer::handleUploadStatus() const {
+  if (rejectIfUploadActive()) {
+    return;
+  }
+
+  if (!server->hasArg("name") || !server->hasArg("size")) {
+    server->send(400, "text/plain", "Missing name or size");
+    return;
+  }
+
+  String dirPath = server->hasArg("path") ? server->arg("path") : "/";
+  if (!dirPath.startsWith("/")) {
+    dirPath = "/" + dirPath;
+  }
+  if (dirPath.length() > 1 && dirPath.endsWith("/")) {
+    dirPath = dirPath.substring(0, dirPath.length() - 1);
+  }
+  String filePath = dirPath;
+  if (!filePath.endsWith("/")) filePath += "/";
+  filePath += server->arg("name");
+
+  const size_t totalSize = strtoul(server->arg("size").c_str(), nullptr, 10);
+  const std::string id = UploadSession::makeId(filePath.c_str(), totalSize);
+
+  JsonDocument doc;
+  doc["id"] = id;
+  const size_t committed = UploadSession::committedSize(UploadSession::partPath(dirPath.c_str(), id));
+  // A stale part file larger than the upload is removed when the upload starts
+  doc["offset"] = committed > totalSize ? 0 : committed;
+  doc["size"] = totalSize;
+
+  String json;
+  serializeJson(doc, json);
+  server->send(200, "application/json", json);
+}
+
 void CrossPointWebServer::handleCreateFolder() const {
+  if (rejectIfUploadActive()) {
+    return;
+  }
+
   // Get folder name from form data
   if (!server->hasArg("name")) {
     server->send(400, "text/plain", "Missing folder name");
@@ -577,6 +786,10 @@ void CrossPointWebServer::handleCreateFolder() const {
 }
 
 void CrossPointWebServer::handleDelete() const {
+  if (rejectIfUploadActive()) {
+    return;
+  }
+
   // Get path from form data
   if (!server->hasArg("path")) {
     server->send(400, "text/plain", "Missing path");
@@ -671,19 +884,32 @@ void CrossPointWebServer::wsEventCallback(uint8_t num, WStype_t type, uint8_t* p
 //   2. Client sends BINARY messages with file data chunks
 //   3. Server sends TEXT "PROGRESS:<received>:<total>" after each chunk
 //   4. Server sends TEXT "DONE" or "ERROR:<message>" when complete
+//
+// Resumable variant:
+//   1. Client sends TEXT "SESSION:<filename>:<size>:<path>", server replies "SESSION:<id>:<offset>" with the
+//      committed offset to continue from (0 for a new upload)
+//   2. Each BINARY message starts with an 8 byte header: <offset:u32 LE><crc32:u32 LE>, followed by the data.
+//      A chunk at the wrong offset or with a bad CRC is dropped and answered with "OFFSET:<id>:<committed>",
+//      and the client continues from that offset
+//   3. PROGRESS/DONE/ERROR as above. If the connection drops, buffered data is flushed and kept, and the
+//      client reconnects and sends SESSION again to resume
+//   "QUERY:<filename>:<size>:<path>" returns "OFFSET:<id>:<committed>" without starting an upload.
 void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
   switch (type) {
     case WStype_DISCONNECTED:
       Serial.printf("[%lu] [WS] Client %u disconnected\n", millis(), num);
-      // Clean up any in-progress upload
-      if (wsUploadInProgress && wsUploadFile) {
-        wsUploadFile.close();
-        // Delete incomplete file
-        String filePath = wsUploadPath;
-        if (!filePath.endsWith("/")) filePath += "/";
-        filePath += wsUploadFileName;
-        SdMan.remove(filePath.c_str());
-        Serial.printf("[%lu] [WS] Deleted incomplete upload: %s\n", millis(), filePath.c_str());
+      if (!wsUploadInProgress || num != wsUploadClient || !uploadWriter) {
+        break;
+      }
+      if (wsUploadResumable) {
+        // Keep verified data so the client can resume this session
+        uploadWriter->finish();
+        Serial.printf("[%lu] [WS] Suspended upload %s at %d bytes\n", millis(), wsUploadSessionId.c_str(),
+                      wsUploadReceived);
+      } else {
+        // Clean up any in-progress upload (discards buffered data and deletes the incomplete file)
+        uploadWriter->abort();
+        Serial.printf("[%lu] [WS] Deleted incomplete upload: %s\n", millis(), wsUploadFileName.c_str());
       }
       wsUploadInProgress = false;
       break;
@@ -698,97 +924,181 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
       String msg = String((char*)payload);
       Serial.printf("[%lu] [WS] Text from client %u: %s\n", millis(), num, msg.c_str());
 
-      if (msg.startsWith("START:")) {
-        // Parse: START:<filename>:<size>:<path>
-        int firstColon = msg.indexOf(':', 6);
-        int secondColon = msg.indexOf(':', firstColon + 1);
+      const bool isStart = msg.startsWith("START:");
+      const bool isSession = msg.startsWith("SESSION:");
+      const bool isQuery = msg.startsWith("QUERY:");
+      if (!isStart && !isSession && !isQuery) {
+        break;
+      }
 
-        if (firstColon > 0 && secondColon > 0) {
-          wsUploadFileName = msg.substring(6, firstColon);
-          wsUploadSize = msg.substring(firstColon + 1, secondColon).toInt();
-          wsUploadPath = msg.substring(secondColon + 1);
-          wsUploadReceived = 0;
-          wsUploadStartTime = millis();
+      // Parse: <command>:<filename>:<size>:<path>
+      const int commandEnd = msg.indexOf(':');
+      int firstColon = msg.indexOf(':', commandEnd + 1);
+      int secondColon = msg.indexOf(':', firstColon + 1);
+      if (firstColon <= 0 || secondColon <= 0) {
+        wsServer->sendTXT(num, "ERROR:Invalid " + msg.substring(0, commandEnd) + " format");
+        break;
+      }
 
-          // Ensure path is valid
-          if (!wsUploadPath.startsWith("/")) wsUploadPath = "/" + wsUploadPath;
-          if (wsUploadPath.length() > 1 && wsUploadPath.endsWith("/")) {
-            wsUploadPath = wsUploadPath.substring(0, wsUploadPath.length() - 1);
-          }
+      const String fileName = msg.substring(commandEnd + 1, firstColon);
+      const size_t totalSize = msg.substring(firstColon + 1, secondColon).toInt();
+      String dirPath = msg.substring(secondColon + 1);
 
-          // Build file path
-          String filePath = wsUploadPath;
-          if (!filePath.endsWith("/")) filePath += "/";
-          filePath += wsUploadFileName;
+      // Ensure path is valid
+      if (!dirPath.startsWith("/")) dirPath = "/" + dirPath;
+      if (dirPath.length() > 1 && dirPath.endsWith("/")) {
+        dirPath = dirPath.substring(0, dirPath.length() - 1);
+      }
 
-          Serial.printf("[%lu] [WS] Starting upload: %s (%d bytes) to %s\n", millis(), wsUploadFileName.c_str(),
-                        wsUploadSize, filePath.c_str());
+      // Build file path
+      String filePath = dirPath;
+      if (!filePath.endsWith("/")) filePath += "/";
+      filePath += fileName;
+
+      if (isQuery) {
+        const std::string id = UploadSession::makeId(filePath.c_str(), totalSize);
+        size_t committed = 0;
+        if (wsUploadInProgress && wsUploadResumable && id == wsUploadSessionId) {
+          committed = wsUploadReceived;
+        } else if (uploadWriter && uploadWriter->isActive()) {
+          wsServer->sendTXT(num, "ERROR:Another upload is in progress");
+          break;
+        } else {
+          committed = UploadSession::committedSize(UploadSession::partPath(dirPath.c_str(), id));
+        }
+        String reply = "OFFSET:" + String(id.c_str()) + ":" + String(committed);
+        wsServer->sendTXT(num, reply);
+        break;
+      }
 
-          // Check if file exists and remove it
-          esp_task_wdt_reset();
-          if (SdMan.exists(filePath.c_str())) {
-            SdMan.remove(filePath.c_str());
-          }
+      // A new START/SESSION replaces any unfinished upload on this server. A resumable one is only
+      // suspended, so a client reconnecting before its old connection timed out can pick it back up.
+      if (wsUploadInProgress && uploadWriter) {
+        if (wsUploadResumable) {
+          uploadWriter->finish();
+        } else {
+          uploadWriter->abort();
+        }
+      }
+      wsUploadInProgress = false;
 
-          // Open file for writing
-          esp_task_wdt_reset();
-          if (!SdMan.openFileForWrite("WS", filePath, wsUploadFile)) {
-            wsServer->sendTXT(num, "ERROR:Failed to create file");
-            wsUploadInProgress = false;
-            return;
-          }
-          esp_task_wdt_reset();
+      if (!uploadWriter || uploadWriter->isActive()) {
+        wsServer->sendTXT(num, "ERROR:Another upload is in progress");
+        return;
+      }
 
-          wsUploadInProgress = true;
-          wsServer->sendTXT(num, "READY");
-        } else {
-          wsServer->sendTXT(num, "ERROR:Invalid START format");
+      wsUploadFileName = fileName;
+      wsUploadSize = totalSize;
+      wsUploadPath = dirPath;
+      wsUploadReceived = 0;
+      // Also after a suspended or dropped upload, so progress is counted from where this one starts
+      wsLastProgressSent = 0;
+      wsUploadStartTime = millis();
+      wsUploadClient = num;
+      wsUploadResumable = isSession;
+
+      Serial.printf("[%lu] [WS] Starting upload: %s (%d bytes) to %s\n", millis(), wsUploadFileName.c_str(),
+                    wsUploadSize, filePath.c_str());
+
+      if (isSession) {
+        wsUploadSessionId = UploadSession::makeId(filePath.c_str(), wsUploadSize);
+        wsUploadPartPath = UploadSession::partPath(wsUploadPath.c_str(), wsUploadSessionId);
+
+        esp_task_wdt_reset();
+        wsUploadReceived = UploadSession::committedSize(wsUploadPartPath);
+        if (wsUploadReceived > wsUploadSize) {
+          // Stale part file from an unrelated upload - start over
+          SdMan.remove(wsUploadPartPath.c_str());
+          wsUploadReceived = 0;
+        }
+        wsLastProgressSent = wsUploadReceived;
+
+        esp_task_wdt_reset();
+        if (!uploadWriter->begin("WS", wsUploadPartPath.c_str(), true)) {
+          wsServer->sendTXT(num, "ERROR:Failed to create file");
+          return;
+        }
+        esp_task_wdt_reset();
+
+        wsUploadInProgress = true;
+        String reply = "SESSION:" + String(wsUploadSessionId.c_str()) + ":" + String(wsUploadReceived);
+        wsServer->sendTXT(num, reply);
+        Serial.printf("[%lu] [WS] Session %s at offset %d\n", millis(), wsUploadSessionId.c_str(), wsUploadReceived);
+
+        // Everything already arrived before the previous connection dropped
+        if (wsUploadReceived >= wsUploadSize) {
+          completeWebSocketUpload(num);
         }
+        return;
       }
+
+      // Create (overwriting any existing file) and start buffering
+      esp_task_wdt_reset();
+      if (!uploadWriter->begin("WS", filePath.c_str())) {
+        wsServer->sendTXT(num, "ERROR:Failed to create file");
+        return;
+      }
+      esp_task_wdt_reset();
+
+      wsUploadInProgress = true;
+      wsServer->sendTXT(num, "READY");
       break;
     }
 
     case WStype_BIN: {
-      if (!wsUploadInProgress || !wsUploadFile) {
+      if (!wsUploadInProgress || num != wsUploadClient || !uploadWriter || !uploadWriter->isActive()) {
         wsServer->sendTXT(num, "ERROR:No upload in progress");
         return;
       }
 
-      // Write binary data directly to file
-      esp_task_wdt_reset();
-      size_t written = wsUploadFile.write(payload, length);
-      esp_task_wdt_reset();
+      const uint8_t* data = payload;
+      size_t dataLength = length;
 
-      if (written != length) {
-        wsUploadFile.close();
+      if (wsUploadResumable) {
+        if (length < WS_CHUNK_HEADER_SIZE) {
+          wsServer->sendTXT(num, "ERROR:Chunk header missing");
+          return;
+        }
+
+        uint32_t chunkOffset;
+        uint32_t chunkCrc;
+        memcpy(&chunkOffset, payload, sizeof(chunkOffset));
+        memcpy(&chunkCrc, payload + sizeof(chunkOffset), sizeof(chunkCrc));
+        data = payload + WS_CHUNK_HEADER_SIZE;
+        dataLength = length - WS_CHUNK_HEADER_SIZE;
+
+        // Out of order or corrupted chunk: drop it and tell the client where to continue from
+        if (chunkOffset != wsUploadReceived || wsUploadReceived + dataLength > wsUploadSize ||
+            UploadSession::crc32(0, data, dataLength) != chunkCrc) {
+          Serial.printf("[%lu] [WS] Rejected chunk at %lu (%d bytes), committed %d\n", millis(),
+                        static_cast<unsigned long>(chunkOffset), dataLength, wsUploadReceived);
+          String reply = "OFFSET:" + String(wsUploadSessionId.c_str()) + ":" + String(wsUploadReceived);
+          wsServer->sendTXT(num, reply);
+          return;
+        }
+      }
+
+      // Queue the frame for the writer task; only blocks (stalling the socket) when the ring is full
+      esp_task_wdt_reset();
+      if (!uploadWriter->write(data, dataLength)) {
+        uploadWriter->abort();
         wsUploadInProgress = false;
         wsServer->sendTXT(num, "ERROR:Write failed - disk full?");
         return;
       }
 
-      wsUploadReceived += written;
+      wsUploadReceived += dataLength;
 
       // Send progress update (every 64KB or at end)
-      static size_t lastProgressSent = 0;
-      if (wsUploadReceived - lastProgressSent >= 65536 || wsUploadReceived >= wsUploadSize) {
+      if (wsUploadReceived - wsLastProgressSent >= 65536 || wsUploadReceived >= wsUploadSize) {
         String progress = "PROGRESS:" + String(wsUploadReceived) + ":" + String(wsUploadSize);
         wsServer->sendTXT(num, progress);
-        lastProgressSent = wsUploadReceived;
+        wsLastProgressSent = wsUploadReceived;
       }
 
       // Check if upload complete
       if (wsUploadReceived >= wsUploadSize) {
-        wsUploadFile.close();
-        wsUploadInProgress = false;
-
-        unsigned long elapsed = millis() - wsUploadStartTime;
-        float kbps = (elapsed > 0) ? (wsUploadSize / 1024.0) / (elapsed / 1000.0) : 0;
-
-        Serial.printf("[%lu] [WS] Upload complete: %s (%d bytes in %lu ms, %.1f KB/s)\n", millis(),
-                      wsUploadFileName.c_str(), wsUploadSize, elapsed, kbps);
-
-        wsServer->sendTXT(num, "DONE");
-        lastProgressSent = 0;
+        completeWebSocketUpload(num);
       }
       break;
     }
@@ -797,3 +1107,31 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
       break;
   }
 }
+
+void CrossPointWebServer::completeWebSocketUpload(const uint8_t num) {
+  const bool flushed = uploadWriter->finish();
+  wsUploadInProgress = false;
+  wsLastProgressSent = 0;
+  if (!flushed) {
+    wsServer->sendTXT(num, "ERROR:Write failed - disk full?");
+    return;
+  }
+
+  if (wsUploadResumable) {
+    String filePath = wsUploadPath;
+    if (!filePath.endsWith("/")) filePath += "/";
+    filePath += wsUploadFileName;
+    if (!UploadSession::commit(wsUploadPartPath, filePath.c_str())) {
+      wsServer->sendTXT(num, "ERROR:Failed to finalize file");
+      return;
+    }
+  }
+
+  unsigned long elapsed = millis() - wsUploadStartTime;
+  float kbps = (elapsed > 0) ? (wsUploadSize / 1024.0) / (elapsed / 1000.0) : 0;
+
+  Serial.printf("[%lu] [WS] Upload complete: %s (%d bytes in %lu ms, %.1f KB/s)\n", millis(), wsUploadFileName.c_str(),
+                wsUploadSize, elapsed, kbps);
+
+  wsServer->sendTXT(num, "DONE");
+}
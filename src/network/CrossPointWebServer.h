@@ -5,6 +5,8 @@
 
 #include <vector>
 
+#include "UploadWriter.h"
+
 // Structure to hold file information
 struct FileInfo {
   String name;
@@ -41,23 +43,32 @@ class CrossPointWebServer {
   uint16_t port = 80;
   uint16_t wsPort = 81;  // WebSocket port
 
+  // Write-behind SD sink shared by the HTTP and WebSocket upload paths
+  std::unique_ptr<UploadWriter> uploadWriter = nullptr;
+
   // WebSocket upload state
   void onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
   static void wsEventCallback(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
+  void completeWebSocketUpload(uint8_t num);
 
   // File scanning
   void scanFiles(const char* path, const std::function<void(FileInfo)>& callback) const;
   String formatFileSize(size_t bytes) const;
   bool isEpubFile(const String& filename) const;
+  bool rejectIfUploadActive() const;
 
   // Request handlers
   void handleRoot() const;
   void handleNotFound() const;
   void handleStatus() const;
+#ifdef CROSSPOINT_TRACE
+  void handleTrace() const;
+#endif
   void handleFileList() const;
   void handleFileListData() const;
   void handleUpload() const;
   void handleUploadPost() const;
+  void handleUploadStatus() const;
   void handleCreateFolder() const;
   void handleDelete() const;
 };
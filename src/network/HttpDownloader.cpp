@@ -2,13 +2,312 @@
 
 #include <HTTPClient.h>
 #include <HardwareSerial.h>
+#include <Serialization.h>
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <memory>
+#include <new>
 
 #include "util/UrlUtils.h"
 
+namespace {
+// Adapts HTTPClient::writeToStream, which handles chunked transfer encoding, to a chunk callback
+class CallbackStream final : public Stream {
+ public:
+  explicit CallbackStream(const HttpDownloader::ChunkCallback& onChunk) : onChunk(onChunk) {}
+
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    if (aborted || !onChunk(reinterpret_cast<const char*>(buffer), size)) {
+      aborted = true;
+      return 0;
+    }
+    return size;
+  }
+  size_t write(const uint8_t c) override { return write(&c, 1); }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override {}
+
+  bool wasAborted() const { return aborted; }
+
+ private:
+  const HttpDownloader::ChunkCallback& onChunk;
+  bool aborted = false;
+};
+
+constexpr uint8_t PART_INFO_VERSION = 1;
+constexpr size_t WRITE_BUFFER_SIZE = 32768;  // SD writes are coalesced into cluster-sized blocks
+constexpr size_t WRITE_BUFFER_MIN_SIZE = 4096;
+constexpr unsigned long STALL_TIMEOUT_MS = 15000;
+constexpr unsigned long RETRY_DELAY_MS = 1000;
+
+// Sidecar describing a partial download, so it is only resumed against the same resource
+struct PartInfo {
+  std::string url;
+  std::string etag;
+  std::string lastModified;
+  size_t total = 0;
+};
+
+enum class AttemptResult { DONE, RETRY, HTTP_FAILED, FILE_FAILED };
+
+struct AttemptContext {
+  const std::string& url;
+  const std::string& partPath;
+  const std::string& infoPath;
+  PartInfo& info;
+  size_t& offset;  // Bytes committed to the part file
+  uint8_t* buffer;
+  size_t bufferSize;
+  HttpDownloader::DownloadStats& stats;
+  const HttpDownloader::ProgressCallback& progress;
+  const HttpDownloader::DownloadOptions& options;
+};
+
+std::string partPathFor(const std::string& destPath) {
+  const size_t slash = destPath.rfind('/');
+  const size_t nameStart = slash == std::string::npos ? 0 : slash + 1;
+  return destPath.substr(0, nameStart) + "." + destPath.substr(nameStart) + ".part";
+}
+
+bool loadPartInfo(const std::string& infoPath, PartInfo& info) {
+  FsFile file;
+  if (!SdMan.exists(infoPath.c_str()) || !SdMan.openFileForRead("HTTP", infoPath, file)) {
+    return false;
+  }
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != PART_INFO_VERSION) {
+    file.close();
+    return false;
+  }
+  uint32_t total;
+  serialization::readString(file, info.url);
+  serialization::readString(file, info.etag);
+  serialization::readString(file, info.lastModified);
+  serialization::readPod(file, total);
+  info.total = total;
+  file.close();
+  return true;
+}
+
+void savePartInfo(const std::string& infoPath, const PartInfo& info) {
+  FsFile file;
+  if (!SdMan.openFileForWrite("HTTP", infoPath, file)) {
+    return;
+  }
+  serialization::writePod(file, PART_INFO_VERSION);
+  serialization::writeString(file, info.url);
+  serialization::writeString(file, info.etag);
+  serialization::writeString(file, info.lastModified);
+  serialization::writePod(file, static_cast<uint32_t>(info.total));
+  file.close();
+}
+
+void discardPart(const std::string& partPath, const std::string& infoPath) {
+  if (SdMan.exists(partPath.c_str())) {
+    SdMan.remove(partPath.c_str());
+  }
+  if (SdMan.exists(infoPath.c_str())) {
+    SdMan.remove(infoPath.c_str());
+  }
+}
+
+// "bytes <start>-<end>/<total>", total may be "*"
+bool parseContentRange(const String& header, size_t& start, size_t& total) {
+  unsigned long first = 0;
+  unsigned long last = 0;
+  unsigned long length = 0;
+  const int fields = sscanf(header.c_str(), "bytes %lu-%lu/%lu", &first, &last, &length);
+  if (fields < 2) {
+    return false;
+  }
+  start = first;
+  total = fields == 3 ? length : 0;
+  return true;
+}
+
+AttemptResult downloadAttempt(const AttemptContext& ctx) {
+  // Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP
+  std::unique_ptr<WiFiClient> client;
+  if (UrlUtils::isHttpsUrl(ctx.url)) {
+    auto* secureClient = new WiFiClientSecure();
+    secureClient->setInsecure();
+    client.reset(secureClient);
+  } else {
+    client.reset(new WiFiClient());
+  }
+  HTTPClient http;
+
+  http.begin(*client, ctx.url.c_str());
+  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+  // The body is read straight from the socket, so rule out chunked transfer encoding
+  http.useHTTP10(true);
+  http.addHeader("User-Agent", "CrossPoint-ESP32-" CROSSPOINT_VERSION);
+  if (ctx.offset > 0) {
+    http.addHeader("Range", ("bytes=" + std::to_string(ctx.offset) + "-").c_str());
+    // If the resource changed since the partial download, the server sends the whole new file instead
+    if (!ctx.info.etag.empty()) {
+      http.addHeader("If-Range", ctx.info.etag.c_str());
+    } else if (!ctx.info.lastModified.empty()) {
+      http.addHeader("If-Range", ctx.info.lastModified.c_str());
+    }
+  }
+  const char* headerKeys[] = {"ETag", "Last-Modified", "Content-Range"};
+  http.collectHeaders(headerKeys, 3);
+
+  const int httpCode = http.GET();
+  size_t total = 0;
+  if (httpCode == HTTP_CODE_PARTIAL_CONTENT) {
+    size_t start = 0;
+    if (!parseContentRange(http.header("Content-Range"), start, total) || start != ctx.offset) {
+      Serial.printf("[%lu] [HTTP] Unexpected Content-Range: %s\n", millis(), http.header("Content-Range").c_str());
+      http.end();
+      ctx.offset = 0;
+      SdMan.remove(ctx.partPath.c_str());
+      return AttemptResult::RETRY;
+    }
+  } else if (httpCode == HTTP_CODE_OK) {
+    if (ctx.offset > 0) {
+      Serial.printf("[%lu] [HTTP] Server sent the full file, restarting download\n", millis());
+      ctx.offset = 0;
+      ctx.stats.resumedFrom = 0;
+    }
+    total = http.getSize() > 0 ? http.getSize() : 0;
+  } else if (httpCode == HTTP_CODE_RANGE_NOT_SATISFIABLE && ctx.offset > 0) {
+    http.end();
+    if (ctx.info.total == ctx.offset) {
+      // Everything was already received before the connection dropped
+      return AttemptResult::DONE;
+    }
+    ctx.offset = 0;
+    SdMan.remove(ctx.partPath.c_str());
+    return AttemptResult::RETRY;
+  } else {
+    Serial.printf("[%lu] [HTTP] Download failed: %d\n", millis(), httpCode);
+    http.end();
+    // Connection errors (negative codes) and server errors are worth another try
+    return httpCode < 0 || httpCode >= 500 ? AttemptResult::RETRY : AttemptResult::HTTP_FAILED;
+  }
+
+  const std::string etag = http.header("ETag").c_str();
+  if (!ctx.options.expectedEtag.empty() && etag != ctx.options.expectedEtag) {
+    Serial.printf("[%lu] [HTTP] ETag mismatch: got %s, expected %s\n", millis(), etag.c_str(),
+                  ctx.options.expectedEtag.c_str());
+    http.end();
+    return AttemptResult::HTTP_FAILED;
+  }
+  if (ctx.options.expectedSize > 0 && total > 0 && total != ctx.options.expectedSize) {
+    Serial.printf("[%lu] [HTTP] Size mismatch: server reports %zu, expected %zu\n", millis(), total,
+                  ctx.options.expectedSize);
+    http.end();
+    return AttemptResult::HTTP_FAILED;
+  }
+  Serial.printf("[%lu] [HTTP] Status %d, receiving from %zu of %zu\n", millis(), httpCode, ctx.offset, total);
+
+  if (ctx.offset == 0 || total != ctx.info.total || etag != ctx.info.etag) {
+    ctx.info.etag = etag;
+    ctx.info.lastModified = http.header("Last-Modified").c_str();
+    ctx.info.total = total;
+    savePartInfo(ctx.infoPath, ctx.info);
+  }
+
+  FsFile file = SdMan.open(ctx.partPath.c_str(), O_RDWR | O_CREAT);
+  if (!file || !file.truncate(ctx.offset) || !file.seekEnd()) {
+    Serial.printf("[%lu] [HTTP] Failed to open file for writing\n", millis());
+    file.close();
+    http.end();
+    return AttemptResult::FILE_FAILED;
+  }
+
+  WiFiClient* stream = http.getStreamPtr();
+  if (!stream) {
+    Serial.printf("[%lu] [HTTP] Failed to get stream\n", millis());
+    file.close();
+    http.end();
+    return AttemptResult::RETRY;
+  }
+
+  const size_t sessionStartOffset = ctx.offset;
+  const unsigned long sessionStartMs = millis();
+  unsigned long lastDataMs = sessionStartMs;
+  size_t fill = 0;
+
+  // Write whatever is buffered; the part file is flushed so the bytes survive a reboot
+  const auto flushBuffer = [&]() {
+    if (fill == 0) {
+      return true;
+    }
+    const size_t written = file.write(ctx.buffer, fill);
+    if (written != fill) {
+      Serial.printf("[%lu] [HTTP] Write failed: wrote %zu of %zu bytes\n", millis(), written, fill);
+      return false;
+    }
+    file.flush();
+    ctx.offset += fill;
+    fill = 0;
+    return true;
+  };
+
+  AttemptResult result = AttemptResult::DONE;
+  while (total == 0 || ctx.offset + fill < total) {
+    const size_t available = stream->available();
+    if (available == 0) {
+      if (!http.connected()) {
+        // Without a known size the server closing the connection marks the end of the file
+        result = total == 0 ? AttemptResult::DONE : AttemptResult::RETRY;
+        break;
+      }
+      if (millis() - lastDataMs > STALL_TIMEOUT_MS) {
+        Serial.printf("[%lu] [HTTP] Download stalled\n", millis());
+        result = AttemptResult::RETRY;
+        break;
+      }
+      delay(1);
+      continue;
+    }
+
+    size_t toRead = std::min(available, ctx.bufferSize - fill);
+    if (total > 0) {
+      toRead = std::min(toRead, total - ctx.offset - fill);
+    }
+    const size_t bytesRead = stream->readBytes(ctx.buffer + fill, toRead);
+    if (bytesRead == 0) {
+      result = AttemptResult::RETRY;
+      break;
+    }
+    fill += bytesRead;
+    lastDataMs = millis();
+
+    if (fill == ctx.bufferSize && !flushBuffer()) {
+      result = AttemptResult::FILE_FAILED;
+      break;
+    }
+
+    const unsigned long elapsedMs = millis() - sessionStartMs;
+    if (elapsedMs > 0) {
+      ctx.stats.bytesPerSecond =
+          static_cast<uint32_t>(static_cast<uint64_t>(ctx.offset + fill - sessionStartOffset) * 1000 / elapsedMs);
+    }
+    if (ctx.progress && total > 0) {
+      ctx.progress(ctx.offset + fill, total, ctx.stats);
+    }
+  }
+
+  // Keep the bytes that did arrive so the next attempt resumes after them
+  if (result != AttemptResult::FILE_FAILED && !flushBuffer()) {
+    result = AttemptResult::FILE_FAILED;
+  }
+  file.close();
+  http.end();
+  return result;
+}
+}  // namespace
+
 bool HttpDownloader::fetchUrl(const std::string& url, std::string& outContent) {
   // Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP
   std::unique_ptr<WiFiClient> client;
@@ -41,8 +340,8 @@ bool HttpDownloader::fetchUrl(const std::string& url, std::string& outContent) {
   return true;
 }
 
-HttpDownloader::DownloadError HttpDownloader::downloadToFile(const std::string& url, const std::string& destPath,
-                                                             ProgressCallback progress) {
+HttpDownloader::DownloadError HttpDownloader::streamUrl(const std::string& url, const ChunkCallback& onChunk,
+                                                        CacheValidators* validators) {
   // Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP
   std::unique_ptr<WiFiClient> client;
   if (UrlUtils::isHttpsUrl(url)) {
@@ -54,92 +353,139 @@ HttpDownloader::DownloadError HttpDownloader::downloadToFile(const std::string&
   }
   HTTPClient http;
 
-  Serial.printf("[%lu] [HTTP] Downloading: %s\n", millis(), url.c_str());
-  Serial.printf("[%lu] [HTTP] Destination: %s\n", millis(), destPath.c_str());
+  Serial.printf("[%lu] [HTTP] Streaming: %s\n", millis(), url.c_str());
 
   http.begin(*client, url.c_str());
   http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
   http.addHeader("User-Agent", "CrossPoint-ESP32-" CROSSPOINT_VERSION);
+  if (validators) {
+    if (!validators->etag.empty()) {
+      http.addHeader("If-None-Match", validators->etag.c_str());
+    }
+    if (!validators->lastModified.empty()) {
+      http.addHeader("If-Modified-Since", validators->lastModified.c_str());
+    }
+    const char* headerKeys[] = {"ETag", "Last-Modified"};
+    http.collectHeaders(headerKeys, 2);
+  }
 
   const int httpCode = http.GET();
+  if (httpCode == HTTP_CODE_NOT_MODIFIED && validators) {
+    Serial.printf("[%lu] [HTTP] Not modified\n", millis());
+    http.end();
+    return NOT_MODIFIED;
+  }
   if (httpCode != HTTP_CODE_OK) {
-    Serial.printf("[%lu] [HTTP] Download failed: %d\n", millis(), httpCode);
+    Serial.printf("[%lu] [HTTP] Stream failed: %d\n", millis(), httpCode);
     http.end();
     return HTTP_ERROR;
   }
 
-  const size_t contentLength = http.getSize();
-  Serial.printf("[%lu] [HTTP] Content-Length: %zu\n", millis(), contentLength);
-
-  // Remove existing file if present
-  if (SdMan.exists(destPath.c_str())) {
-    SdMan.remove(destPath.c_str());
+  if (validators) {
+    validators->etag = http.header("ETag").c_str();
+    validators->lastModified = http.header("Last-Modified").c_str();
   }
 
-  // Open file for writing
-  FsFile file;
-  if (!SdMan.openFileForWrite("HTTP", destPath.c_str(), file)) {
-    Serial.printf("[%lu] [HTTP] Failed to open file for writing\n", millis());
-    http.end();
-    return FILE_ERROR;
-  }
+  CallbackStream stream(onChunk);
+  const int streamed = http.writeToStream(&stream);
+  http.end();
 
-  // Get the stream for chunked reading
-  WiFiClient* stream = http.getStreamPtr();
-  if (!stream) {
-    Serial.printf("[%lu] [HTTP] Failed to get stream\n", millis());
-    file.close();
-    SdMan.remove(destPath.c_str());
-    http.end();
+  if (stream.wasAborted()) {
+    Serial.printf("[%lu] [HTTP] Stream aborted by receiver\n", millis());
+    return ABORTED;
+  }
+  if (streamed < 0) {
+    Serial.printf("[%lu] [HTTP] Stream error: %d\n", millis(), streamed);
     return HTTP_ERROR;
   }
 
-  // Download in chunks
-  uint8_t buffer[DOWNLOAD_CHUNK_SIZE];
-  size_t downloaded = 0;
-  const size_t total = contentLength > 0 ? contentLength : 0;
+  Serial.printf("[%lu] [HTTP] Streamed %d bytes\n", millis(), streamed);
+  return OK;
+}
 
-  while (http.connected() && (contentLength == 0 || downloaded < contentLength)) {
-    const size_t available = stream->available();
-    if (available == 0) {
-      delay(1);
-      continue;
-    }
+HttpDownloader::DownloadError HttpDownloader::downloadToFile(const std::string& url, const std::string& destPath,
+                                                             ProgressCallback progress,
+                                                             const DownloadOptions& options) {
+  Serial.printf("[%lu] [HTTP] Downloading: %s\n", millis(), url.c_str());
+  Serial.printf("[%lu] [HTTP] Destination: %s\n", millis(), destPath.c_str());
 
-    const size_t toRead = available < DOWNLOAD_CHUNK_SIZE ? available : DOWNLOAD_CHUNK_SIZE;
-    const size_t bytesRead = stream->readBytes(buffer, toRead);
+  const std::string partPath = partPathFor(destPath);
+  const std::string infoPath = partPath + ".info";
 
-    if (bytesRead == 0) {
-      break;
-    }
+  // Keep a partial file only if it belongs to the same URL
+  PartInfo info;
+  size_t offset = 0;
+  if (loadPartInfo(infoPath, info) && info.url == url && SdMan.exists(partPath.c_str())) {
+    FsFile part = SdMan.open(partPath.c_str());
+    offset = part ? part.size() : 0;
+    part.close();
+  } else {
+    discardPart(partPath, infoPath);
+    info = PartInfo{};
+    info.url = url;
+  }
 
-    const size_t written = file.write(buffer, bytesRead);
-    if (written != bytesRead) {
-      Serial.printf("[%lu] [HTTP] Write failed: wrote %zu of %zu bytes\n", millis(), written, bytesRead);
-      file.close();
-      SdMan.remove(destPath.c_str());
-      http.end();
+  size_t bufferSize = WRITE_BUFFER_SIZE;
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[bufferSize]);
+  if (!buffer) {
+    bufferSize = WRITE_BUFFER_MIN_SIZE;
+    buffer.reset(new (std::nothrow) uint8_t[bufferSize]);
+    if (!buffer) {
+      Serial.printf("[%lu] [HTTP] Out of memory for write buffer\n", millis());
       return FILE_ERROR;
     }
+  }
 
-    downloaded += bytesRead;
+  DownloadStats stats;
+  stats.resumedFrom = offset;
+  if (offset > 0) {
+    Serial.printf("[%lu] [HTTP] Resuming partial download at %zu bytes\n", millis(), offset);
+  }
 
-    if (progress && total > 0) {
-      progress(downloaded, total);
+  AttemptContext ctx{url, partPath, infoPath, info, offset, buffer.get(), bufferSize, stats, progress, options};
+  AttemptResult result = AttemptResult::RETRY;
+  for (uint8_t attempt = 0; attempt <= options.maxRetries; attempt++) {
+    if (attempt > 0) {
+      stats.retries++;
+      Serial.printf("[%lu] [HTTP] Retry %u at offset %zu\n", millis(), stats.retries, offset);
+      delay(RETRY_DELAY_MS * attempt);
+    }
+    result = downloadAttempt(ctx);
+    if (result != AttemptResult::RETRY) {
+      break;
     }
   }
 
-  file.close();
-  http.end();
+  if (result != AttemptResult::DONE) {
+    // A dropped download keeps its partial file for the next call; anything else starts over
+    if (result != AttemptResult::RETRY) {
+      discardPart(partPath, infoPath);
+    }
+    return result == AttemptResult::FILE_FAILED ? FILE_ERROR : HTTP_ERROR;
+  }
 
-  Serial.printf("[%lu] [HTTP] Downloaded %zu bytes\n", millis(), downloaded);
+  // Content-Length validation: the file must have exactly the size the server announced
+  FsFile part = SdMan.open(partPath.c_str(), O_RDWR);
+  const size_t finalSize = part ? part.size() : 0;
+  if (info.total > 0 && finalSize != info.total) {
+    Serial.printf("[%lu] [HTTP] Size mismatch: got %zu, expected %zu\n", millis(), finalSize, info.total);
+    part.close();
+    discardPart(partPath, infoPath);
+    return HTTP_ERROR;
+  }
 
-  // Verify download size if known
-  if (contentLength > 0 && downloaded != contentLength) {
-    Serial.printf("[%lu] [HTTP] Size mismatch: got %zu, expected %zu\n", millis(), downloaded, contentLength);
+  if (SdMan.exists(destPath.c_str())) {
     SdMan.remove(destPath.c_str());
-    return HTTP_ERROR;
+  }
+  const bool renamed = part && part.rename(destPath.c_str());
+  part.close();
+  SdMan.remove(infoPath.c_str());
+  if (!renamed) {
+    Serial.printf("[%lu] [HTTP] Failed to move download into place\n", millis());
+    return FILE_ERROR;
   }
 
+  Serial.printf("[%lu] [HTTP] Downloaded %zu bytes (%zu resumed, %u retries, %lu B/s)\n", millis(), finalSize,
+                stats.resumedFrom, stats.retries, static_cast<unsigned long>(stats.bytesPerSecond));
   return OK;
 }
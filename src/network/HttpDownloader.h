@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <string>
+#include <utility>
 
 /**
  * HTTP client utility for fetching content and downloading files.
@@ -10,13 +11,36 @@
  */
 class HttpDownloader {
  public:
-  using ProgressCallback = std::function<void(size_t downloaded, size_t total)>;
+  // Transfer statistics reported with every progress update
+  struct DownloadStats {
+    size_t resumedFrom = 0;       // Bytes of a previous partial download that were kept
+    uint32_t bytesPerSecond = 0;  // Average rate of the bytes received in this call
+    uint8_t retries = 0;          // Reconnects after dropped connections
+  };
+
+  // Optional checks applied to the server's response
+  struct DownloadOptions {
+    size_t expectedSize = 0;   // Fail if the server reports a different size (0 = don't check)
+    std::string expectedEtag;  // Fail if the server's ETag differs (empty = don't check)
+    uint8_t maxRetries = 5;
+  };
+
+  using ProgressCallback = std::function<void(size_t downloaded, size_t total, const DownloadStats& stats)>;
+  // Receives the response body piece by piece; return false to abort the transfer
+  using ChunkCallback = std::function<bool(const char* data, size_t length)>;
 
   enum DownloadError {
     OK = 0,
     HTTP_ERROR,
     FILE_ERROR,
     ABORTED,
+    NOT_MODIFIED,
+  };
+
+  // HTTP cache validators for conditional requests
+  struct CacheValidators {
+    std::string etag;
+    std::string lastModified;
   };
 
   /**
@@ -27,16 +51,32 @@ class HttpDownloader {
    */
   static bool fetchUrl(const std::string& url, std::string& outContent);
 
+  /**
+   * Stream a URL's body through a callback without buffering it (chunked encoding is decoded).
+   * @param url The URL to fetch
+   * @param onChunk Called for each piece of the body
+   * @param validators Optional: sent as If-None-Match/If-Modified-Since when set, and updated from the
+   *                   response's ETag/Last-Modified headers
+   * @return OK, NOT_MODIFIED (304, no body delivered), HTTP_ERROR or ABORTED
+   */
+  static DownloadError streamUrl(const std::string& url, const ChunkCallback& onChunk,
+                                 CacheValidators* validators = nullptr);
+
   /**
    * Download a file to the SD card.
+   * Data goes to a hidden ".<name>.part" file next to destPath, which is renamed into place once complete.
+   * Dropped connections are retried with an HTTP Range request, and a partial file left by an earlier
+   * call for the same URL is resumed (guarded by If-Range with the server's ETag/Last-Modified).
    * @param url The URL to download
    * @param destPath The destination path on SD card
    * @param progress Optional progress callback
+   * @param options Optional size/ETag validation and retry limit
    * @return DownloadError indicating success or failure type
    */
   static DownloadError downloadToFile(const std::string& url, const std::string& destPath,
-                                      ProgressCallback progress = nullptr);
-
- private:
-  static constexpr size_t DOWNLOAD_CHUNK_SIZE = 1024;
+                                      ProgressCallback progress, const DownloadOptions& options);
+  static DownloadError downloadToFile(const std::string& url, const std::string& destPath,
+                                      ProgressCallback progress = nullptr) {
+    return downloadToFile(url, destPath, std::move(progress), DownloadOptions{});
+  }
 };
@@ -0,0 +1,150 @@
+#include "OpdsFeedCache.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <functional>
+
+uint32_t OpdsFeedCache::urlKey(const std::string& url) { return std::hash<std::string>{}(url); }
+
+std::string OpdsFeedCache::feedPath(const uint32_t key) const {
+  return cacheDir + "/feed_" + std::to_string(key) + ".bin";
+}
+
+std::string OpdsFeedCache::indexPath() const { return cacheDir + "/index.bin"; }
+
+bool OpdsFeedCache::openFeed(const std::string& url, FsFile& file, HttpDownloader::CacheValidators& validators) const {
+  const std::string path = feedPath(urlKey(url));
+  if (!SdMan.exists(path.c_str()) || !SdMan.openFileForRead("OFC", path, file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != CACHE_FILE_VERSION) {
+    Serial.printf("[%lu] [OFC] Ignoring cache file with version %u\n", millis(), version);
+    file.close();
+    return false;
+  }
+
+  // Guard against hash collisions between feed URLs
+  std::string cachedUrl;
+  serialization::readString(file, cachedUrl);
+  if (cachedUrl != url) {
+    file.close();
+    return false;
+  }
+
+  serialization::readString(file, validators.etag);
+  serialization::readString(file, validators.lastModified);
+  return true;
+}
+
+bool OpdsFeedCache::loadValidators(const std::string& url, HttpDownloader::CacheValidators& validators) const {
+  FsFile file;
+  if (!openFeed(url, file, validators)) {
+    return false;
+  }
+  file.close();
+  return true;
+}
+
+bool OpdsFeedCache::loadEntries(const std::string& url, std::vector<OpdsEntry>& entries, std::string& nextUrl) const {
+  FsFile file;
+  HttpDownloader::CacheValidators validators;
+  if (!openFeed(url, file, validators)) {
+    return false;
+  }
+
+  serialization::readString(file, nextUrl);
+  uint32_t count;
+  serialization::readPod(file, count);
+  if (count > MAX_ENTRIES) {
+    Serial.printf("[%lu] [OFC] Corrupt cache file for %s\n", millis(), url.c_str());
+    file.close();
+    return false;
+  }
+
+  entries.clear();
+  entries.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    OpdsEntry entry;
+    uint8_t type;
+    serialization::readPod(file, type);
+    entry.type = static_cast<OpdsEntryType>(type);
+    serialization::readString(file, entry.title);
+    serialization::readString(file, entry.author);
+    serialization::readString(file, entry.href);
+    entries.push_back(std::move(entry));
+  }
+  file.close();
+
+  Serial.printf("[%lu] [OFC] Loaded %zu cached entries for %s\n", millis(), entries.size(), url.c_str());
+  return true;
+}
+
+bool OpdsFeedCache::store(const std::string& url, const HttpDownloader::CacheValidators& validators,
+                          const std::vector<OpdsEntry>& entries, const std::string& nextUrl) const {
+  if (entries.size() > MAX_ENTRIES) {
+    return false;
+  }
+
+  SdMan.mkdir(cacheDir.c_str());
+
+  const uint32_t key = urlKey(url);
+  FsFile file;
+  if (!SdMan.openFileForWrite("OFC", feedPath(key), file)) {
+    return false;
+  }
+
+  serialization::writePod(file, CACHE_FILE_VERSION);
+  serialization::writeString(file, url);
+  serialization::writeString(file, validators.etag);
+  serialization::writeString(file, validators.lastModified);
+  serialization::writeString(file, nextUrl);
+  serialization::writePod(file, static_cast<uint32_t>(entries.size()));
+  for (const auto& entry : entries) {
+    serialization::writePod(file, static_cast<uint8_t>(entry.type));
+    serialization::writeString(file, entry.title);
+    serialization::writeString(file, entry.author);
+    serialization::writeString(file, entry.href);
+  }
+  file.close();
+
+  touch(key);
+  return true;
+}
+
+void OpdsFeedCache::touch(const uint32_t key) const {
+  // The index lists cached pages, most recently stored first
+  std::vector<uint32_t> keys;
+  FsFile file;
+  if (SdMan.exists(indexPath().c_str()) && SdMan.openFileForRead("OFC", indexPath(), file)) {
+    uint8_t count = 0;
+    serialization::readPod(file, count);
+    for (uint8_t i = 0; i < count && i < MAX_FEEDS; i++) {
+      uint32_t k;
+      serialization::readPod(file, k);
+      keys.push_back(k);
+    }
+    file.close();
+  }
+
+  keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+  keys.insert(keys.begin(), key);
+  while (keys.size() > MAX_FEEDS) {
+    SdMan.remove(feedPath(keys.back()).c_str());
+    keys.pop_back();
+  }
+
+  if (!SdMan.openFileForWrite("OFC", indexPath(), file)) {
+    return;
+  }
+  serialization::writePod(file, static_cast<uint8_t>(keys.size()));
+  for (const uint32_t k : keys) {
+    serialization::writePod(file, k);
+  }
+  file.close();
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <OpdsParser.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "HttpDownloader.h"
+
+/**
+ * Compact on-SD cache of recently visited OPDS feed pages.
+ *
+ * Each page is stored with the ETag/Last-Modified validators it was served with, so revisiting a feed only
+ * costs a conditional request (304) instead of a full download and parse. The cached copy is also used
+ * when the server can't be reached. Only the fields the browser shows are kept (type, title, author, href).
+ * The MAX_FEEDS most recently stored pages are kept; older ones are deleted.
+ */
+class OpdsFeedCache {
+ public:
+  explicit OpdsFeedCache(std::string cacheDir) : cacheDir(std::move(cacheDir)) {}
+
+  /**
+   * Read only the validators of a cached page.
+   * @return false if the page isn't cached
+   */
+  bool loadValidators(const std::string& url, HttpDownloader::CacheValidators& validators) const;
+
+  /**
+   * Read the entries and next-page link of a cached page.
+   * @return false if the page isn't cached or the cache file is unreadable
+   */
+  bool loadEntries(const std::string& url, std::vector<OpdsEntry>& entries, std::string& nextUrl) const;
+
+  /**
+   * Store a page, replacing any previous copy, and evict the least recently stored pages.
+   */
+  bool store(const std::string& url, const HttpDownloader::CacheValidators& validators,
+             const std::vector<OpdsEntry>& entries, const std::string& nextUrl) const;
+
+ private:
+  static constexpr uint8_t CACHE_FILE_VERSION = 1;
+  static constexpr size_t MAX_FEEDS = 16;
+  static constexpr uint32_t MAX_ENTRIES = 2000;
+
+  std::string cacheDir;
+
+  static uint32_t urlKey(const std::string& url);
+  std::string feedPath(uint32_t key) const;
+  std::string indexPath() const;
+  bool openFeed(const std::string& url, FsFile& file, HttpDownloader::CacheValidators& validators) const;
+  void touch(uint32_t key) const;
+};
@@ -0,0 +1,85 @@
+#include "OtaImageStream.h"
+
+#include <HardwareSerial.h>
+
+#include <cctype>
+#include <utility>
+
+OtaImageStream::OtaImageStream(const size_t imageSize, std::string expectedSha256, Sink sink)
+    : imageSize(imageSize), expectedSha256(std::move(expectedSha256)), sink(std::move(sink)) {
+  mbedtls_md_init(&hashContext);
+  hashReady = mbedtls_md_setup(&hashContext, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0) == 0 &&
+              mbedtls_md_starts(&hashContext) == 0;
+  if (!hashReady) {
+    Serial.printf("[%lu] [OTA] Failed to set up SHA-256\n", millis());
+  }
+}
+
+OtaImageStream::~OtaImageStream() { mbedtls_md_free(&hashContext); }
+
+bool OtaImageStream::write(const uint8_t* data, const size_t length) {
+  if (!hashReady || length > imageSize - offset) {
+    return false;
+  }
+  if (!sink(data, length)) {
+    return false;
+  }
+  // Hash only what the sink accepted, so a retry never hashes a byte twice
+  mbedtls_md_update(&hashContext, data, length);
+  offset += length;
+  return true;
+}
+
+bool OtaImageStream::verify() {
+  if (!hashReady || !isComplete()) {
+    return false;
+  }
+
+  uint8_t hash[32];
+  if (mbedtls_md_finish(&hashContext, hash) != 0) {
+    return false;
+  }
+  hashReady = false;
+
+  static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+  digest.clear();
+  for (const uint8_t b : hash) {
+    digest += HEX_DIGITS[b >> 4];
+    digest += HEX_DIGITS[b & 0x0F];
+  }
+
+  if (expectedSha256.empty()) {
+    Serial.printf("[%lu] [OTA] No published SHA-256, image hash %s\n", millis(), digest.c_str());
+    return true;
+  }
+  if (digest != expectedSha256) {
+    Serial.printf("[%lu] [OTA] SHA-256 mismatch: got %s, expected %s\n", millis(), digest.c_str(),
+                  expectedSha256.c_str());
+    return false;
+  }
+  Serial.printf("[%lu] [OTA] SHA-256 verified: %s\n", millis(), digest.c_str());
+  return true;
+}
+
+bool OtaImageStream::parseSha256(const std::string& text, std::string& hexOut) {
+  // Find the first run of exactly 64 hex digits
+  size_t runStart = 0;
+  size_t runLength = 0;
+  for (size_t i = 0; i <= text.size(); i++) {
+    if (i < text.size() && isxdigit(static_cast<unsigned char>(text[i]))) {
+      if (runLength++ == 0) {
+        runStart = i;
+      }
+      continue;
+    }
+    if (runLength == 64) {
+      hexOut = text.substr(runStart, 64);
+      for (auto& c : hexOut) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+      }
+      return true;
+    }
+    runLength = 0;
+  }
+  return false;
+}
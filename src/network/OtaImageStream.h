@@ -0,0 +1,62 @@
+#pragma once
+#include <mbedtls/md.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * Ordered firmware image sink that hashes every byte (SHA-256) on its way to the flash writer.
+ *
+ * The image can arrive over several HTTP responses: getOffset() is where the next Range request has to
+ * start, and bytes are only counted once the sink accepted them, so a dropped connection never leaves a gap.
+ * verify() must pass before the new partition is made bootable.
+ *
+ * Independent of the Update library and the network so it can be exercised on the host.
+ */
+class OtaImageStream {
+ public:
+  // Receives image bytes in order (Update.write on the device); return false on a write error
+  using Sink = std::function<bool(const uint8_t* data, size_t length)>;
+
+  OtaImageStream(size_t imageSize, std::string expectedSha256, Sink sink);
+  ~OtaImageStream();
+
+  OtaImageStream(const OtaImageStream&) = delete;
+  OtaImageStream& operator=(const OtaImageStream&) = delete;
+
+  // Hash and forward the next bytes of the image. Fails on sink errors and on data past the image size.
+  bool write(const uint8_t* data, size_t length);
+
+  size_t getOffset() const { return offset; }
+  size_t getImageSize() const { return imageSize; }
+  bool isComplete() const { return offset == imageSize; }
+
+  /**
+   * Finish the hash and compare it with the expected digest.
+   * @return false if the image is incomplete or the digest differs. With no expected digest only
+   *         completeness is checked.
+   */
+  bool verify();
+
+  // Lowercase hex SHA-256 of the image, available after verify()
+  const std::string& getDigest() const { return digest; }
+  bool hasExpectedDigest() const { return !expectedSha256.empty(); }
+
+  /**
+   * Extract the hex SHA-256 from a release asset digest ("sha256:<64 hex digits>") or a checksum file line
+   * ("<64 hex digits>  firmware.bin").
+   * @return false if no SHA-256 was found
+   */
+  static bool parseSha256(const std::string& text, std::string& hexOut);
+
+ private:
+  size_t imageSize;
+  std::string expectedSha256;
+  Sink sink;
+  size_t offset = 0;
+  mbedtls_md_context_t hashContext;
+  bool hashReady = false;
+  std::string digest;
+};
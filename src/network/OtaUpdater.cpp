@@ -2,15 +2,159 @@
 
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
+#include <SDCardManager.h>
 #include <Update.h>
+#include <WiFiClientSecure.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "HttpDownloader.h"
+#include "OtaImageStream.h"
+#include "util/UrlUtils.h"
+
+// Can be pointed at a local stand-in (scripts/ota_standin.py) with a build flag
+#ifndef CROSSPOINT_OTA_RELEASE_URL
+#define CROSSPOINT_OTA_RELEASE_URL "https://api.github.com/repos/crosspoint-reader/crosspoint-reader/releases/latest"
+#endif
 
 namespace {
-constexpr char latestReleaseUrl[] = "https://api.github.com/repos/crosspoint-reader/crosspoint-reader/releases/latest";
+constexpr char latestReleaseUrl[] = CROSSPOINT_OTA_RELEASE_URL;
+constexpr char OTA_LOG_FILE[] = "/.crosspoint/ota.log";
+constexpr size_t OTA_LOG_MAX_SIZE = 4096;
+constexpr size_t OTA_BUFFER_SIZE = 4096;  // One flash sector
+constexpr uint8_t OTA_MAX_RETRIES = 5;
+constexpr unsigned long OTA_RETRY_DELAY_MS = 1000;
+constexpr unsigned long OTA_STALL_TIMEOUT_MS = 15000;
+
+enum class StreamResult { DONE, RETRY, HTTP_FAILED, WRITE_FAILED };
+
+std::unique_ptr<WiFiClient> makeClient(const std::string& url) {
+  if (UrlUtils::isHttpsUrl(url)) {
+    auto* secureClient = new WiFiClientSecure();
+    secureClient->setInsecure();
+    return std::unique_ptr<WiFiClient>(secureClient);
+  }
+  return std::unique_ptr<WiFiClient>(new WiFiClient());
+}
+
+// Fetch the image from image.getOffset() onwards and feed it through the hashing stream
+StreamResult streamImage(const std::string& url, OtaImageStream& image, uint8_t* buffer,
+                         const std::function<void()>& onData) {
+  const std::unique_ptr<WiFiClient> client = makeClient(url);
+  HTTPClient http;
+
+  const size_t offset = image.getOffset();
+  Serial.printf("[%lu] [OTA] Fetching: %s from %zu\n", millis(), url.c_str(), offset);
+
+  http.begin(*client, url.c_str());
+  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+  // The body is read straight from the socket, so rule out chunked transfer encoding
+  http.useHTTP10(true);
+  http.addHeader("User-Agent", "CrossPoint-ESP32-" CROSSPOINT_VERSION);
+  if (offset > 0) {
+    http.addHeader("Range", ("bytes=" + std::to_string(offset) + "-").c_str());
+  }
+
+  const int httpCode = http.GET();
+  if (offset > 0 && httpCode == HTTP_CODE_OK) {
+    // The partition is written sequentially, so a server without Range support can't be resumed
+    Serial.printf("[%lu] [OTA] Server ignored the Range request\n", millis());
+    http.end();
+    return StreamResult::HTTP_FAILED;
+  }
+  if (httpCode != (offset > 0 ? HTTP_CODE_PARTIAL_CONTENT : HTTP_CODE_OK)) {
+    Serial.printf("[%lu] [OTA] Download failed: %d\n", millis(), httpCode);
+    http.end();
+    return httpCode < 0 || httpCode >= 500 ? StreamResult::RETRY : StreamResult::HTTP_FAILED;
+  }
+
+  const int contentLength = http.getSize();
+  if (contentLength >= 0 && static_cast<size_t>(contentLength) != image.getImageSize() - offset) {
+    Serial.printf("[%lu] [OTA] Invalid content length: %d\n", millis(), contentLength);
+    http.end();
+    return StreamResult::HTTP_FAILED;
+  }
+
+  WiFiClient* stream = http.getStreamPtr();
+  StreamResult result = StreamResult::DONE;
+  unsigned long lastDataMs = millis();
+  while (!image.isComplete()) {
+    const size_t available = stream->available();
+    if (available == 0) {
+      if (!http.connected()) {
+        result = StreamResult::RETRY;
+        break;
+      }
+      if (millis() - lastDataMs > OTA_STALL_TIMEOUT_MS) {
+        Serial.printf("[%lu] [OTA] Download stalled\n", millis());
+        result = StreamResult::RETRY;
+        break;
+      }
+      delay(1);
+      continue;
+    }
+
+    const size_t remaining = image.getImageSize() - image.getOffset();
+    const size_t toRead = std::min(std::min(available, OTA_BUFFER_SIZE), remaining);
+    const size_t bytesRead = stream->readBytes(buffer, toRead);
+    if (bytesRead == 0) {
+      result = StreamResult::RETRY;
+      break;
+    }
+    if (!image.write(buffer, bytesRead)) {
+      Serial.printf("[%lu] [OTA] Flash write failed: %s\n", millis(), Update.errorString());
+      result = StreamResult::WRITE_FAILED;
+      break;
+    }
+    lastDataMs = millis();
+    onData();
+  }
+
+  http.end();
+  return result;
+}
+}  // namespace
+
+void OtaUpdater::recordMetrics(const char* result) const {
+  Serial.printf("[%lu] [OTA] %s: check %lums, download %zu bytes in %lums (%lu B/s, %u retries, %zu resumed), "
+                "verify %lums\n",
+                millis(), result, metrics.check.durationMs, metrics.download.bytes, metrics.download.durationMs,
+                static_cast<unsigned long>(metrics.download.bytesPerSecond()), metrics.retries,
+                metrics.resumedBytes, metrics.verify.durationMs);
+
+  // Keep a small history on the SD card so failed updates can be diagnosed after a reboot
+  if (SdMan.exists(OTA_LOG_FILE)) {
+    FsFile existing = SdMan.open(OTA_LOG_FILE);
+    const size_t size = existing ? existing.size() : 0;
+    existing.close();
+    if (size > OTA_LOG_MAX_SIZE) {
+      SdMan.remove(OTA_LOG_FILE);
+    }
+  }
+  FsFile log = SdMan.open(OTA_LOG_FILE, O_WRONLY | O_CREAT | O_APPEND);
+  if (!log) {
+    return;
+  }
+  char line[224];
+  const int len = snprintf(line, sizeof(line),
+                           "%s -> %s: %s check=%lums download=%lums/%zuB/%luB/s retries=%u resumed=%zuB "
+                           "verify=%lums sha256=%s\n",
+                           CROSSPOINT_VERSION, latestVersion.c_str(), result, metrics.check.durationMs,
+                           metrics.download.durationMs, metrics.download.bytes,
+                           static_cast<unsigned long>(metrics.download.bytesPerSecond()), metrics.retries,
+                           metrics.resumedBytes, metrics.verify.durationMs,
+                           otaSha256.empty() ? "unpublished" : "published");
+  if (len > 0) {
+    log.write(reinterpret_cast<const uint8_t*>(line), std::min(static_cast<size_t>(len), sizeof(line) - 1));
+  }
+  log.close();
 }
 
 OtaUpdater::OtaUpdaterError OtaUpdater::checkForUpdate() {
-  const std::unique_ptr<WiFiClientSecure> client(new WiFiClientSecure);
-  client->setInsecure();
+  const unsigned long checkStart = millis();
+  const std::unique_ptr<WiFiClient> client = makeClient(latestReleaseUrl);
   HTTPClient http;
 
   Serial.printf("[%lu] [OTA] Fetching: %s\n", millis(), latestReleaseUrl);
@@ -31,6 +175,7 @@ OtaUpdater::OtaUpdaterError OtaUpdater::checkForUpdate() {
   filter["assets"][0]["name"] = true;
   filter["assets"][0]["browser_download_url"] = true;
   filter["assets"][0]["size"] = true;
+  filter["assets"][0]["digest"] = true;
   const DeserializationError error = deserializeJson(doc, *client, DeserializationOption::Filter(filter));
   http.end();
   if (error) {
@@ -54,11 +199,17 @@ OtaUpdater::OtaUpdaterError OtaUpdater::checkForUpdate() {
       otaUrl = doc["assets"][i]["browser_download_url"].as<std::string>();
       otaSize = doc["assets"][i]["size"].as<size_t>();
       totalSize = otaSize;
+      // GitHub publishes "sha256:<hex>" per asset
+      otaSha256.clear();
+      OtaImageStream::parseSha256(doc["assets"][i]["digest"] | "", otaSha256);
       updateAvailable = true;
-      break;
+    } else if (doc["assets"][i]["name"] == "firmware.bin.sha256") {
+      otaChecksumUrl = doc["assets"][i]["browser_download_url"].as<std::string>();
     }
   }
 
+  metrics.check.durationMs = millis() - checkStart;
+
   if (!updateAvailable) {
     Serial.printf("[%lu] [OTA] No firmware.bin asset found\n", millis());
     return NO_UPDATE;
@@ -109,62 +260,86 @@ OtaUpdater::OtaUpdaterError OtaUpdater::installUpdate(const std::function<void(s
     return UPDATE_OLDER_ERROR;
   }
 
-  const std::unique_ptr<WiFiClientSecure> client(new WiFiClientSecure);
-  client->setInsecure();
-  HTTPClient http;
-
-  Serial.printf("[%lu] [OTA] Fetching: %s\n", millis(), otaUrl.c_str());
-
-  http.begin(*client, otaUrl.c_str());
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.addHeader("User-Agent", "CrossPoint-ESP32-" CROSSPOINT_VERSION);
-  const int httpCode = http.GET();
+  metrics.download = {};
+  metrics.verify = {};
+  metrics.retries = 0;
+  metrics.resumedBytes = 0;
 
-  if (httpCode != HTTP_CODE_OK) {
-    Serial.printf("[%lu] [OTA] Download failed: %d\n", millis(), httpCode);
-    http.end();
-    return HTTP_ERROR;
+  // Fall back to a published checksum file when the asset carries no digest
+  if (otaSha256.empty() && !otaChecksumUrl.empty()) {
+    std::string checksum;
+    if (HttpDownloader::fetchUrl(otaChecksumUrl, checksum)) {
+      OtaImageStream::parseSha256(checksum, otaSha256);
+    }
+  }
+  if (otaSha256.empty()) {
+    Serial.printf("[%lu] [OTA] No SHA-256 published for this release, only the size is checked\n", millis());
   }
 
-  // 2. Get length and stream
-  const size_t contentLength = http.getSize();
-
-  if (contentLength != otaSize) {
-    Serial.printf("[%lu] [OTA] Invalid content length\n", millis());
-    http.end();
-    return HTTP_ERROR;
+  const std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[OTA_BUFFER_SIZE]);
+  if (!buffer) {
+    return OOM_ERROR;
   }
 
-  // 3. Begin the ESP-IDF Update process
+  // Begin the ESP-IDF Update process
   if (!Update.begin(otaSize)) {
     Serial.printf("[%lu] [OTA] Not enough space. Error: %s\n", millis(), Update.errorString());
-    http.end();
     return INTERNAL_UPDATE_ERROR;
   }
 
+  this->processedSize = 0;
   this->totalSize = otaSize;
   Serial.printf("[%lu] [OTA] Update started\n", millis());
-  Update.onProgress([this, onProgress](const size_t progress, const size_t total) {
-    this->processedSize = progress;
-    this->totalSize = total;
-    onProgress(progress, total);
+
+  OtaImageStream image(otaSize, otaSha256, [](const uint8_t* data, const size_t length) {
+    return Update.write(const_cast<uint8_t*>(data), length) == length;
   });
-  const size_t written = Update.writeStream(*client);
-  http.end();
 
-  if (written == otaSize) {
-    Serial.printf("[%lu] [OTA] Successfully written %u bytes\n", millis(), written);
-  } else {
-    Serial.printf("[%lu] [OTA] Written only %u/%u bytes. Error: %s\n", millis(), written, otaSize,
-                  Update.errorString());
-    return INTERNAL_UPDATE_ERROR;
+  const unsigned long downloadStart = millis();
+  StreamResult result = StreamResult::RETRY;
+  for (uint8_t attempt = 0; attempt <= OTA_MAX_RETRIES && result == StreamResult::RETRY; attempt++) {
+    if (attempt > 0) {
+      metrics.retries++;
+      // Each resume keeps everything the earlier ones kept, so this is not summed over the retries
+      metrics.resumedBytes = image.getOffset();
+      Serial.printf("[%lu] [OTA] Retry %u, resuming at %zu\n", millis(), metrics.retries, image.getOffset());
+      delay(OTA_RETRY_DELAY_MS * attempt);
+    }
+    result = streamImage(otaUrl, image, buffer.get(), [this, &image, &onProgress]() {
+      this->processedSize = image.getOffset();
+      onProgress(this->processedSize, this->totalSize);
+    });
+  }
+  metrics.download.durationMs = millis() - downloadStart;
+  metrics.download.bytes = image.getOffset();
+
+  if (result != StreamResult::DONE || !image.isComplete()) {
+    Serial.printf("[%lu] [OTA] Written only %zu/%zu bytes\n", millis(), image.getOffset(), otaSize);
+    Update.abort();
+    recordMetrics("download failed");
+    return result == StreamResult::WRITE_FAILED ? INTERNAL_UPDATE_ERROR : HTTP_ERROR;
+  }
+
+  // Only make the new partition bootable if the image is exactly what was published
+  const unsigned long verifyStart = millis();
+  if (!image.verify()) {
+    Update.abort();
+    metrics.verify.durationMs = millis() - verifyStart;
+    recordMetrics("hash mismatch");
+    return HASH_MISMATCH_ERROR;
   }
 
-  if (Update.end() && Update.isFinished()) {
-    Serial.printf("[%lu] [OTA] Update complete\n", millis());
-    return OK;
-  } else {
+  const bool finished = Update.end() && Update.isFinished();
+  metrics.verify.durationMs = millis() - verifyStart;
+  metrics.verify.bytes = otaSize;
+
+  if (!finished) {
     Serial.printf("[%lu] [OTA] Error Occurred: %s\n", millis(), Update.errorString());
+    recordMetrics("finalise failed");
     return INTERNAL_UPDATE_ERROR;
   }
+
+  Serial.printf("[%lu] [OTA] Update complete\n", millis());
+  recordMetrics("ok");
+  return OK;
 }
@@ -1,13 +1,38 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
 class OtaUpdater {
+ public:
+  // Duration and volume of one phase of an update
+  struct PhaseMetrics {
+    unsigned long durationMs = 0;
+    size_t bytes = 0;
+    uint32_t bytesPerSecond() const {
+      return durationMs > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(bytes) * 1000 / durationMs) : 0;
+    }
+  };
+
+  struct Metrics {
+    PhaseMetrics check;     // Release lookup
+    PhaseMetrics download;  // Download, hash and flash write (streamed together)
+    PhaseMetrics verify;    // Digest comparison and finalising the partition
+    uint8_t retries = 0;
+    size_t resumedBytes = 0;  // Image bytes kept across dropped connections: where the last Range request started
+  };
+
+ private:
   bool updateAvailable = false;
   std::string latestVersion;
   std::string otaUrl;
   size_t otaSize = 0;
+  std::string otaSha256;       // From the release asset's digest, empty if unknown
+  std::string otaChecksumUrl;  // firmware.bin.sha256 asset, used when the digest isn't published
+  Metrics metrics;
+
+  void recordMetrics(const char* result) const;
 
  public:
   enum OtaUpdaterError {
@@ -18,6 +43,7 @@ class OtaUpdater {
     UPDATE_OLDER_ERROR,
     INTERNAL_UPDATE_ERROR,
     OOM_ERROR,
+    HASH_MISMATCH_ERROR,
   };
   size_t processedSize = 0;
   size_t totalSize = 0;
@@ -26,5 +52,11 @@ class OtaUpdater {
   bool isUpdateNewer() const;
   const std::string& getLatestVersion() const;
   OtaUpdaterError checkForUpdate();
+  /**
+   * Download the firmware straight into the inactive OTA partition, hashing it on the way.
+   * Dropped connections are resumed with Range requests. The boot partition is only switched if the
+   * image is complete and its SHA-256 matches the published one.
+   */
   OtaUpdaterError installUpdate(const std::function<void(size_t, size_t)>& onProgress);
+  const Metrics& getMetrics() const { return metrics; }
 };
@@ -0,0 +1,72 @@
+#include "UploadSession.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <miniz.h>
+
+#include <cstdio>
+
+namespace UploadSession {
+
+std::string makeId(const std::string& filePath, const size_t totalSize) {
+  const std::string key = filePath + ":" + std::to_string(totalSize);
+  char id[9];
+  snprintf(id, sizeof(id), "%08lx",
+           static_cast<unsigned long>(crc32(0, reinterpret_cast<const uint8_t*>(key.data()), key.size())));
+  return id;
+}
+
+std::string partPath(const std::string& dirPath, const std::string& id) {
+  std::string path = dirPath;
+  if (path.empty() || path.back() != '/') path += '/';
+  return path + "." + id + ".part";
+}
+
+size_t committedSize(const std::string& partPath) {
+  if (!SdMan.exists(partPath.c_str())) {
+    return 0;
+  }
+  FsFile file = SdMan.open(partPath.c_str());
+  if (!file) {
+    return 0;
+  }
+  const size_t size = file.size();
+  file.close();
+  return size;
+}
+
+bool truncate(const std::string& partPath, const size_t size) {
+  FsFile file = SdMan.open(partPath.c_str(), O_RDWR);
+  if (!file) {
+    Serial.printf("[%lu] [UPS] Failed to open %s for truncation\n", millis(), partPath.c_str());
+    return false;
+  }
+  const bool ok = file.truncate(size);
+  file.close();
+  Serial.printf("[%lu] [UPS] Rolled %s back to %zu bytes\n", millis(), partPath.c_str(), size);
+  return ok;
+}
+
+bool commit(const std::string& partPath, const std::string& filePath) {
+  if (SdMan.exists(filePath.c_str())) {
+    SdMan.remove(filePath.c_str());
+  }
+
+  FsFile file = SdMan.open(partPath.c_str(), O_RDWR);
+  if (!file) {
+    Serial.printf("[%lu] [UPS] Failed to open %s for commit\n", millis(), partPath.c_str());
+    return false;
+  }
+  const bool ok = file.rename(filePath.c_str());
+  file.close();
+  if (!ok) {
+    Serial.printf("[%lu] [UPS] Failed to rename %s to %s\n", millis(), partPath.c_str(), filePath.c_str());
+  }
+  return ok;
+}
+
+uint32_t crc32(const uint32_t crc, const uint8_t* data, const size_t len) {
+  return static_cast<uint32_t>(mz_crc32(crc, data, len));
+}
+
+}  // namespace UploadSession
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Bookkeeping for resumable uploads, shared by the HTTP and WebSocket upload paths.
+ *
+ * A session is identified by a hash of the destination path and total size, so a client that lost its
+ * state can recompute the same id by describing the file again. Data that has been written so far lives
+ * next to the destination in a hidden ".<id>.part" file (hidden from the web file browser), and the size
+ * of that file is the committed offset a client resumes from. Once the last byte arrives the part file
+ * is renamed over the destination.
+ */
+namespace UploadSession {
+
+// Session id: 8 lowercase hex digits
+std::string makeId(const std::string& filePath, size_t totalSize);
+
+// Path of the partial file for a session in the given destination directory
+std::string partPath(const std::string& dirPath, const std::string& id);
+
+// Bytes already committed to the partial file (0 if there is none)
+size_t committedSize(const std::string& partPath);
+
+// Drop everything after `size` bytes, used to roll back a chunk that failed verification
+bool truncate(const std::string& partPath, size_t size);
+
+// Replace the destination with the completed partial file
+bool commit(const std::string& partPath, const std::string& filePath);
+
+// Running CRC-32 (IEEE, same as zlib), start with crc = 0
+uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+}  // namespace UploadSession
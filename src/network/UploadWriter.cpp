@@ -0,0 +1,348 @@
+#include "UploadWriter.h"
+
+#include <HardwareSerial.h>
+#include <esp_task_wdt.h>
+
+#include <algorithm>
+#include <cstring>
+
+UploadWriter::~UploadWriter() { deinit(); }
+
+void UploadWriter::taskTrampoline(void* param) {
+  auto* self = static_cast<UploadWriter*>(param);
+  self->writerTaskLoop();
+}
+
+bool UploadWriter::init() {
+  if (taskHandle) {
+    return true;
+  }
+
+  dataReady = xSemaphoreCreateBinary();
+  spaceReady = xSemaphoreCreateBinary();
+  drained = xSemaphoreCreateBinary();
+  if (!dataReady || !spaceReady || !drained) {
+    Serial.printf("[%lu] [UPW] Failed to create semaphores\n", millis());
+    deinit();
+    return false;
+  }
+
+  // Same priority as the Arduino loop task so SD writes time-slice with network handling
+  // instead of starving it while the card is busy
+  if (xTaskCreate(&UploadWriter::taskTrampoline, "UploadWriterTask",
+                  4096,        // Stack size
+                  this,        // Parameters
+                  1,           // Priority
+                  &taskHandle  // Task handle
+                  ) != pdPASS) {
+    Serial.printf("[%lu] [UPW] Failed to create writer task\n", millis());
+    taskHandle = nullptr;
+    deinit();
+    return false;
+  }
+
+  return true;
+}
+
+bool UploadWriter::deinit() {
+  if (active) {
+    abort();
+  }
+  if (!reclaimHungWriter()) {
+    // The task uses this object until its write returns, so neither can go
+    Serial.printf("[%lu] [UPW] Leaving the stuck SD writer task running\n", millis());
+    return false;
+  }
+
+  if (taskHandle) {
+    vTaskDelete(taskHandle);
+    taskHandle = nullptr;
+  }
+  if (dataReady) {
+    vSemaphoreDelete(dataReady);
+    dataReady = nullptr;
+  }
+  if (spaceReady) {
+    vSemaphoreDelete(spaceReady);
+    spaceReady = nullptr;
+  }
+  if (drained) {
+    vSemaphoreDelete(drained);
+    drained = nullptr;
+  }
+  return true;
+}
+
+bool UploadWriter::begin(const char* moduleName, const char* path, const bool append) {
+  if (!taskHandle || active || !reclaimHungWriter()) {
+    return false;
+  }
+
+  // Prefer a double buffer so the network can fill one chunk while the other is written. Fall back to
+  // a single chunk (effectively synchronous writes) if the heap is too fragmented for that.
+  capacity = WRITE_CHUNK_SIZE * RING_CHUNKS;
+  ring = static_cast<uint8_t*>(malloc(capacity));
+  if (!ring) {
+    capacity = WRITE_CHUNK_SIZE;
+    ring = static_cast<uint8_t*>(malloc(capacity));
+  }
+  if (!ring) {
+    Serial.printf("[%lu] [UPW] Failed to allocate upload buffer (free heap: %d)\n", millis(), ESP.getFreeHeap());
+    capacity = 0;
+    return false;
+  }
+
+  if (append) {
+    file = SdMan.open(path, O_RDWR | O_CREAT);
+    if (!file || !file.seekEnd()) {
+      Serial.printf("[%lu] [%s] Failed to open %s for append\n", millis(), moduleName, path);
+      file.close();
+      releaseRing();
+      return false;
+    }
+  } else {
+    if (SdMan.exists(path)) {
+      SdMan.remove(path);
+    }
+    if (!SdMan.openFileForWrite(moduleName, path, file)) {
+      releaseRing();
+      return false;
+    }
+  }
+
+  filePath = path;
+  head = 0;
+  tail = 0;
+  fill = 0;
+  flushRequested = false;
+  abortRequested = false;
+  error = false;
+  portENTER_CRITICAL(&statsLock);
+  stats = Stats{};
+  stats.startMs = millis();
+  portEXIT_CRITICAL(&statsLock);
+  // Clear any stale signals from the previous upload
+  xSemaphoreTake(dataReady, 0);
+  xSemaphoreTake(spaceReady, 0);
+  xSemaphoreTake(drained, 0);
+  active = true;
+
+  Serial.printf("[%lu] [UPW] Buffering upload to %s with %zu byte ring\n", millis(), path, capacity);
+  return true;
+}
+
+bool UploadWriter::write(const uint8_t* data, size_t len) {
+  if (!active) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&statsLock);
+  stats.bytesReceived += len;
+  portEXIT_CRITICAL(&statsLock);
+
+  while (len > 0) {
+    if (error) {
+      return false;
+    }
+
+    const size_t space = capacity - fill.load();
+    if (space == 0) {
+      // Ring is full - block the network side until the writer frees a chunk
+      const unsigned long stallStart = millis();
+      xSemaphoreGive(dataReady);
+      const bool gotSpace = waitForSignal(spaceReady);
+      portENTER_CRITICAL(&statsLock);
+      stats.stallMs += millis() - stallStart;
+      portEXIT_CRITICAL(&statsLock);
+      if (!gotSpace) {
+        error = true;
+        return false;
+      }
+      continue;
+    }
+
+    const size_t toCopy = std::min({len, space, capacity - head});
+    memcpy(ring + head, data, toCopy);
+    head = (head + toCopy) % capacity;
+    data += toCopy;
+    len -= toCopy;
+
+    const size_t newFill = fill.fetch_add(toCopy) + toCopy;
+    portENTER_CRITICAL(&statsLock);
+    stats.peakFill = std::max(stats.peakFill, newFill);
+    portEXIT_CRITICAL(&statsLock);
+    if (newFill >= WRITE_CHUNK_SIZE) {
+      xSemaphoreGive(dataReady);
+    }
+  }
+
+  return !error;
+}
+
+bool UploadWriter::waitForSignal(SemaphoreHandle_t semaphore) {
+  // Wait in short slices so the calling task keeps feeding the watchdog while the card is busy
+  const unsigned long waitStart = millis();
+  while (xSemaphoreTake(semaphore, pdMS_TO_TICKS(STALL_WAIT_MS)) != pdTRUE) {
+    esp_task_wdt_reset();
+    if (millis() - waitStart >= STALL_TIMEOUT_MS) {
+      Serial.printf("[%lu] [UPW] Timed out waiting for SD writer (%zu bytes pending)\n", millis(), fill.load());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UploadWriter::waitForWriter() {
+  if (waitForSignal(drained)) {
+    return true;
+  }
+  // The writer may still be inside file.write() on the ring. Deleting it there could leave the SPI bus and the FAT
+  // state broken, so it is told to drop the rest and keeps the file and ring until it signals drained.
+  Serial.printf("[%lu] [UPW] SD writer is not responding, failing the upload\n", millis());
+  abortRequested = true;
+  xSemaphoreGive(dataReady);
+  writerHung = true;
+  return false;
+}
+
+bool UploadWriter::reclaimHungWriter() {
+  if (!writerHung) {
+    return true;
+  }
+  if (xSemaphoreTake(drained, 0) != pdTRUE) {
+    Serial.printf("[%lu] [UPW] SD writer is still stuck in a write of the last upload\n", millis());
+    return false;
+  }
+
+  file.close();
+  if (removeAfterHang) {
+    SdMan.remove(filePath.c_str());
+  }
+  releaseRing();
+  writerHung = false;
+  removeAfterHang = false;
+  Serial.printf("[%lu] [UPW] SD writer is back, released %s\n", millis(), filePath.c_str());
+  return true;
+}
+
+bool UploadWriter::finish() {
+  if (!active) {
+    return false;
+  }
+
+  flushRequested = true;
+  xSemaphoreGive(dataReady);
+  if (!waitForWriter()) {
+    error = true;
+  } else {
+    file.close();
+    releaseRing();
+  }
+  active = false;
+  portENTER_CRITICAL(&statsLock);
+  stats.endMs = millis();
+  const Stats done = stats;
+  portEXIT_CRITICAL(&statsLock);
+
+  const bool ok = !error && done.bytesWritten == done.bytesReceived;
+  Serial.printf("[%lu] [UPW] Finished %s: %zu bytes, %zu writes, %lu ms writing, %lu ms stalled, peak fill %zu (%s)\n",
+                millis(), filePath.c_str(), done.bytesWritten, done.sdWrites, done.sdWriteMs, done.stallMs,
+                done.peakFill, ok ? "ok" : "failed");
+  return ok;
+}
+
+void UploadWriter::abort() {
+  if (!active) {
+    return;
+  }
+
+  abortRequested = true;
+  xSemaphoreGive(dataReady);
+  if (waitForWriter()) {
+    file.close();
+    SdMan.remove(filePath.c_str());
+    releaseRing();
+  } else {
+    removeAfterHang = true;
+  }
+  active = false;
+  portENTER_CRITICAL(&statsLock);
+  stats.endMs = millis();
+  portEXIT_CRITICAL(&statsLock);
+  Serial.printf("[%lu] [UPW] Aborted upload, deleted %s\n", millis(), filePath.c_str());
+}
+
+UploadWriter::Stats UploadWriter::getStats() const {
+  portENTER_CRITICAL(&statsLock);
+  const Stats copy = stats;
+  portEXIT_CRITICAL(&statsLock);
+  return copy;
+}
+
+float UploadWriter::getKbps() const {
+  const Stats current = getStats();
+  if (current.startMs == 0) {
+    return 0;
+  }
+  const unsigned long end = active ? millis() : current.endMs;
+  const unsigned long elapsed = end - current.startMs;
+  return elapsed > 0 ? (current.bytesWritten / 1024.0f) / (elapsed / 1000.0f) : 0;
+}
+
+void UploadWriter::releaseRing() {
+  free(ring);
+  ring = nullptr;
+  capacity = 0;
+}
+
+void UploadWriter::drain() {
+  while (true) {
+    if (abortRequested) {
+      tail = 0;
+      fill = 0;
+      break;
+    }
+
+    const size_t available = fill.load();
+    const bool flushing = flushRequested.load();
+    if (available == 0 || (available < WRITE_CHUNK_SIZE && !flushing)) {
+      break;
+    }
+
+    // Tail always advances in whole chunks until the final flush, so writes stay cluster-aligned
+    const size_t toWrite = std::min({available, WRITE_CHUNK_SIZE, capacity - tail});
+    if (!error) {
+      const unsigned long writeStart = millis();
+      const size_t written = file.write(ring + tail, toWrite);
+      const unsigned long writeMs = millis() - writeStart;
+      portENTER_CRITICAL(&statsLock);
+      stats.sdWriteMs += writeMs;
+      stats.sdWrites++;
+      if (written == toWrite) {
+        stats.bytesWritten += written;
+      }
+      portEXIT_CRITICAL(&statsLock);
+      if (written != toWrite) {
+        Serial.printf("[%lu] [UPW] SD write failed: expected %zu, wrote %zu\n", millis(), toWrite, written);
+        error = true;
+      }
+    }
+
+    tail = (tail + toWrite) % capacity;
+    fill.fetch_sub(toWrite);
+    xSemaphoreGive(spaceReady);
+  }
+
+  if (abortRequested || (flushRequested && fill.load() == 0)) {
+    abortRequested = false;
+    flushRequested = false;
+    xSemaphoreGive(drained);
+  }
+}
+
+void UploadWriter::writerTaskLoop() {
+  while (true) {
+    xSemaphoreTake(dataReady, portMAX_DELAY);
+    drain();
+  }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <SDCardManager.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Write-behind sink for network uploads.
+ *
+ * Incoming data is copied into a ring buffer and a dedicated writer task drains it to the SD card in
+ * cluster-aligned chunks. The network side (HTTP upload callback or WebSocket event) only blocks when
+ * the ring is full, which stalls the socket and lets TCP flow control apply backpressure to the client.
+ *
+ * Only one upload can be active at a time. The ring is allocated in begin() and freed when the upload
+ * finishes or is aborted, so it does not hold heap while the server is idle.
+ */
+class UploadWriter {
+ public:
+  struct Stats {
+    size_t bytesReceived = 0;
+    size_t bytesWritten = 0;
+    size_t sdWrites = 0;
+    unsigned long sdWriteMs = 0;
+    unsigned long stallMs = 0;  // Time the network side spent waiting for ring space
+    size_t peakFill = 0;
+    unsigned long startMs = 0;
+    unsigned long endMs = 0;
+  };
+
+  UploadWriter() = default;
+  ~UploadWriter();
+
+  // Start the writer task. Call once before the first upload.
+  bool init();
+  // Stop the writer task, aborting any upload in progress. False if the task is still stuck in an SD write, it then
+  // keeps using this object, which must not be deleted.
+  bool deinit();
+
+  // Create (overwrite) the file at path and start buffering into it. With append, an existing file is
+  // kept and new data goes after its current end (used to resume partial uploads).
+  bool begin(const char* moduleName, const char* path, bool append = false);
+  // Queue data for writing, blocking while the ring is full. Returns false if the upload has failed.
+  bool write(const uint8_t* data, size_t len);
+  // Drain the ring, close the file and return whether all data reached the card. Also used to suspend a
+  // resumable upload, since everything queued so far has already been verified.
+  bool finish();
+  // Drop buffered data, close and delete the partial file
+  void abort();
+
+  bool isActive() const { return active; }
+  bool hasError() const { return error.load(); }
+  size_t getCapacity() const { return capacity; }
+  size_t getFill() const { return fill.load(); }
+  // Copy taken under the lock, the writer task updates the SD side while an upload runs
+  Stats getStats() const;
+  // Average throughput of the current (or last) upload in KB/s
+  float getKbps() const;
+
+ private:
+  // Writes to the card are issued in multiples of this size (matches a typical 32KB FAT32 cluster)
+  static constexpr size_t WRITE_CHUNK_SIZE = 32 * 1024;
+  static constexpr size_t RING_CHUNKS = 2;
+  static constexpr uint32_t STALL_WAIT_MS = 50;
+  static constexpr unsigned long STALL_TIMEOUT_MS = 10000;
+
+  TaskHandle_t taskHandle = nullptr;
+  SemaphoreHandle_t dataReady = nullptr;   // Producer -> writer: data queued or flush/abort requested
+  SemaphoreHandle_t spaceReady = nullptr;  // Writer -> producer: ring space released
+  SemaphoreHandle_t drained = nullptr;     // Writer -> producer: flush/abort completed
+
+  FsFile file;
+  std::string filePath;
+  uint8_t* ring = nullptr;
+  size_t capacity = 0;
+  size_t head = 0;  // Producer position (only touched by the network side)
+  size_t tail = 0;  // Writer position (only touched by the writer task)
+  std::atomic<size_t> fill{0};
+  std::atomic<bool> flushRequested{false};
+  std::atomic<bool> abortRequested{false};
+  std::atomic<bool> error{false};
+  bool active = false;
+  // The writer did not finish a flush or abort in time, it keeps the file and ring until it does
+  bool writerHung = false;
+  // The upload was aborted while the writer hung, its file is deleted once the writer is done with it
+  bool removeAfterHang = false;
+  // Guards stats, shared between the network side and the writer task
+  mutable portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+  Stats stats;
+
+  static void taskTrampoline(void* param);
+  [[noreturn]] void writerTaskLoop();
+  void drain();
+  void releaseRing();
+  bool waitForSignal(SemaphoreHandle_t semaphore);
+  // Wait for the writer to finish a flush or abort. If it does not (the card hangs), the upload fails and the writer
+  // is left to finish its write, see reclaimHungWriter.
+  bool waitForWriter();
+  // Close the file and free the ring of an upload whose writer hung, once it is done. False while it is still busy.
+  bool reclaimHungWriter();
+};
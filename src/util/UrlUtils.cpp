@@ -1,5 +1,36 @@
 #include "UrlUtils.h"
 
+#include <algorithm>
+
+namespace {
+// RFC 3986 section 5.2.4
+std::string removeDotSegments(std::string in) {
+  std::string out;
+  while (!in.empty()) {
+    if (in.rfind("../", 0) == 0) {
+      in.erase(0, 3);
+    } else if (in.rfind("./", 0) == 0) {
+      in.erase(0, 2);
+    } else if (in.rfind("/./", 0) == 0) {
+      in.replace(0, 3, "/");
+    } else if (in == "/.") {
+      in = "/";
+    } else if (in.rfind("/../", 0) == 0 || in == "/..") {
+      in.replace(0, in == "/.." ? 3 : 4, "/");
+      const size_t lastSlash = out.rfind('/');
+      out.erase(lastSlash == std::string::npos ? 0 : lastSlash);
+    } else if (in == "." || in == "..") {
+      in.clear();
+    } else {
+      const size_t segmentEnd = in.find('/', 1);
+      out += in.substr(0, segmentEnd);
+      in.erase(0, segmentEnd);
+    }
+  }
+  return out;
+}
+}  // namespace
+
 namespace UrlUtils {
 
 bool isHttpsUrl(const std::string& url) { return url.rfind("https://", 0) == 0; }
@@ -29,6 +60,10 @@ std::string buildUrl(const std::string& serverUrl, const std::string& path) {
   if (path.empty()) {
     return urlWithProtocol;
   }
+  if (path.find("://") != std::string::npos) {
+    // Already a full URL (e.g. pagination links on another host)
+    return path;
+  }
   if (path[0] == '/') {
     // Absolute path - use just the host
     return extractHost(urlWithProtocol) + path;
@@ -40,4 +75,45 @@ std::string buildUrl(const std::string& serverUrl, const std::string& path) {
   return urlWithProtocol + "/" + path;
 }
 
+std::string resolveUrl(const std::string& baseUrl, const std::string& reference) {
+  // A reference with its own scheme is already absolute
+  const size_t colon = reference.find(':');
+  if (colon != std::string::npos && colon > 0 && colon < reference.find_first_of("/?#")) {
+    return reference;
+  }
+
+  // Split the base into <scheme://authority><path><?query>, its fragment is never kept
+  const std::string base = ensureProtocol(baseUrl.substr(0, baseUrl.find('#')));
+  const size_t schemeEnd = base.find("://");
+  const size_t pathStart = std::min(base.find_first_of("/?", schemeEnd + 3), base.size());
+  const size_t queryStart = std::min(base.find('?', pathStart), base.size());
+  const std::string origin = base.substr(0, pathStart);
+  const std::string basePath = base.substr(pathStart, queryStart - pathStart);
+
+  if (reference.empty()) {
+    return base;
+  }
+  if (reference[0] == '#') {
+    return base + reference;
+  }
+  if (reference[0] == '?') {
+    return origin + basePath + reference;
+  }
+  if (reference.rfind("//", 0) == 0) {
+    return base.substr(0, schemeEnd + 1) + reference;
+  }
+
+  // Only the path of the reference has its dot segments removed
+  const size_t refPathEnd = std::min(reference.find_first_of("?#"), reference.size());
+  const std::string refPath = reference.substr(0, refPathEnd);
+  const std::string refRest = reference.substr(refPathEnd);
+  if (refPath[0] == '/') {
+    return origin + removeDotSegments(refPath) + refRest;
+  }
+  // Merge with the base path up to its last segment
+  const size_t lastSlash = basePath.rfind('/');
+  const std::string merged = (lastSlash == std::string::npos ? "/" : basePath.substr(0, lastSlash + 1)) + refPath;
+  return origin + removeDotSegments(merged) + refRest;
+}
+
 }  // namespace UrlUtils
@@ -20,9 +20,16 @@ std::string extractHost(const std::string& url);
 
 /**
  * Build full URL from server URL and path.
+ * If path is already a full URL it is returned unchanged.
  * If path starts with /, it's an absolute path from the host root.
  * Otherwise, it's relative to the server URL.
  */
 std::string buildUrl(const std::string& serverUrl, const std::string& path);
 
+/**
+ * Resolve a reference (e.g. a link found in a document) against the full URL of the document it came from, as in
+ * RFC 3986 section 5.2: "../feed?page=2" found in "http://host/opds/books" gives "http://host/feed?page=2".
+ */
+std::string resolveUrl(const std::string& baseUrl, const std::string& reference);
+
 }  // namespace UrlUtils